@@ -0,0 +1,182 @@
+// Microbenchmark runner for the Godot-free core.
+// Usage: overlay_bench [--filter text] [--min-time ms] [--repetitions n] [--json path|-]
+
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace bench {
+
+namespace {
+
+uint64_t now_nsec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct BenchCase {
+    const char *name;
+    BenchFunction function;
+};
+
+std::vector<BenchCase> &get_registry() {
+    static std::vector<BenchCase> registry;
+    return registry;
+}
+
+struct CaseResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double ns_per_op_min = 0.0;
+    double ns_per_op_median = 0.0;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+// Run once with the given iteration count, returning the measured time
+uint64_t run_once(BenchFunction function, uint64_t iterations, std::vector<std::pair<std::string, double>> *r_counters) {
+    BenchRun run(iterations);
+    run.start_timer();
+    function(run);
+    run.stop_timer();
+    if (r_counters) {
+        *r_counters = run.get_counters();
+    }
+    return run.get_elapsed_nsec();
+}
+
+CaseResult run_case(const BenchCase &bench_case, uint64_t min_time_nsec, int repetitions) {
+    // Grow the iteration count until one run lasts at least the minimum time
+    uint64_t iterations = 1;
+    for (;;) {
+        uint64_t elapsed = run_once(bench_case.function, iterations, nullptr);
+        if (elapsed >= min_time_nsec || iterations >= (uint64_t(1) << 40)) {
+            break;
+        }
+        double scale = elapsed > 0 ? 1.4 * min_time_nsec / elapsed : 100.0;
+        scale = std::min(std::max(scale, 2.0), 100.0);
+        iterations = static_cast<uint64_t>(iterations * scale);
+    }
+
+    CaseResult result;
+    result.name = bench_case.name;
+    result.iterations = iterations;
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; i++) {
+        uint64_t elapsed = run_once(bench_case.function, iterations, i == 0 ? &result.counters : nullptr);
+        samples.push_back(static_cast<double>(elapsed) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    result.ns_per_op_min = samples.front();
+    result.ns_per_op_median = samples[samples.size() / 2];
+    return result;
+}
+
+void write_json(FILE *file, const std::vector<CaseResult> &results, uint64_t min_time_nsec, int repetitions) {
+    fprintf(file, "{\n");
+    fprintf(file, "  \"schema\": 1,\n");
+    fprintf(file, "  \"timestamp\": %lld,\n", (long long)std::time(nullptr));
+#if defined(__clang__)
+    fprintf(file, "  \"compiler\": \"clang %s\",\n", __clang_version__);
+#elif defined(__GNUC__)
+    fprintf(file, "  \"compiler\": \"gcc %s\",\n", __VERSION__);
+#elif defined(_MSC_VER)
+    fprintf(file, "  \"compiler\": \"msvc %d\",\n", _MSC_VER);
+#endif
+    fprintf(file, "  \"min_time_ns\": %llu,\n", (unsigned long long)min_time_nsec);
+    fprintf(file, "  \"repetitions\": %d,\n", repetitions);
+    fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const CaseResult &result = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"ns_per_op_median\": %.3f",
+                result.name.c_str(), (unsigned long long)result.iterations, result.ns_per_op_min, result.ns_per_op_median);
+        if (!result.counters.empty()) {
+            fprintf(file, ", \"counters\": {");
+            for (size_t c = 0; c < result.counters.size(); c++) {
+                fprintf(file, "%s\"%s\": %.6g", c ? ", " : "", result.counters[c].first.c_str(), result.counters[c].second);
+            }
+            fprintf(file, "}");
+        }
+        fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+} // namespace
+
+void BenchRun::start_timer() {
+    timer_start = now_nsec();
+    elapsed = 0;
+    timer_running = true;
+}
+
+void BenchRun::stop_timer() {
+    if (timer_running) {
+        elapsed += now_nsec() - timer_start;
+        timer_running = false;
+    }
+}
+
+void BenchRun::resume_timer() {
+    if (!timer_running) {
+        timer_start = now_nsec();
+        timer_running = true;
+    }
+}
+
+BenchRegistrar::BenchRegistrar(const char *name, BenchFunction function) {
+    get_registry().push_back({ name, function });
+}
+
+} // namespace bench
+
+int main(int argc, char **argv) {
+    const char *filter = nullptr;
+    const char *json_path = nullptr;
+    uint64_t min_time_nsec = 200000000;
+    int repetitions = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time_nsec = strtoull(argv[++i], nullptr, 10) * 1000000;
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--filter text] [--min-time ms] [--repetitions n] [--json path|-]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<bench::CaseResult> results;
+    for (const bench::BenchCase &bench_case : bench::get_registry()) {
+        if (filter && !strstr(bench_case.name, filter)) {
+            continue;
+        }
+        results.push_back(bench::run_case(bench_case, min_time_nsec, repetitions));
+        const bench::CaseResult &result = results.back();
+        fprintf(stderr, "%-40s %12.2f ns/op  (median %.2f, %llu iterations)\n", result.name.c_str(),
+                result.ns_per_op_min, result.ns_per_op_median, (unsigned long long)result.iterations);
+    }
+
+    if (json_path) {
+        FILE *file = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+        if (!file) {
+            fprintf(stderr, "Cannot write %s\n", json_path);
+            return 1;
+        }
+        bench::write_json(file, results, min_time_nsec, repetitions);
+        if (file != stdout) {
+            fclose(file);
+        }
+    }
+    return 0;
+}
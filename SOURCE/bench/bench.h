@@ -0,0 +1,72 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Handed to every benchmark case. The case runs its body get_iterations() times.
+// The whole call is timed; calling start_timer drops the time spent so far (setup),
+// stop_timer pauses the measurement and resume_timer continues it.
+class BenchRun {
+public:
+    explicit BenchRun(uint64_t p_iterations) :
+            iterations(p_iterations) {}
+
+    uint64_t get_iterations() const {
+        return iterations;
+    }
+
+    void start_timer();
+    void stop_timer();
+    void resume_timer();
+
+    // Extra value reported next to the timing, e.g. items per iteration
+    void set_counter(const char *name, double value) {
+        counters.emplace_back(name, value);
+    }
+
+    uint64_t get_elapsed_nsec() const {
+        return elapsed;
+    }
+    const std::vector<std::pair<std::string, double>> &get_counters() const {
+        return counters;
+    }
+
+private:
+    uint64_t iterations;
+    uint64_t timer_start = 0;
+    uint64_t elapsed = 0;
+    bool timer_running = false;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+using BenchFunction = void (*)(BenchRun &);
+
+// Adds a case to the global registry from a static initializer
+struct BenchRegistrar {
+    BenchRegistrar(const char *name, BenchFunction function);
+};
+
+// Keep a value alive so the optimizer cannot drop the work producing it
+template <typename T>
+inline void keep(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+
+#define BENCH_CASE(name)                                                          \
+    static void bench_##name(::bench::BenchRun &run);                             \
+    static ::bench::BenchRegistrar bench_registrar_##name(#name, &bench_##name); \
+    static void bench_##name(::bench::BenchRun &run)
+
+#endif // BENCH_H
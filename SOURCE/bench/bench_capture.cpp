@@ -0,0 +1,82 @@
+// Screen capture throughput, grabbing and converting like Overlay does each frame.
+// Needs a display: run under Xvfb on a headless Linux machine, e.g.
+//   xvfb-run -s "-screen 0 3840x2160x24" bin/overlay_bench --filter capture
+// Without one the cases report available = 0 and no timing.
+
+#include "bench.h"
+
+#include "core/pixel_convert.h"
+#include "screen_capture.h"
+
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+ScreenCapture *get_capture() {
+    static std::unique_ptr<ScreenCapture> capture = []() {
+        std::unique_ptr<ScreenCapture> result = ScreenCapture::create();
+        if (result && !result->open()) {
+            result.reset();
+        }
+        return result;
+    }();
+    return capture.get();
+}
+
+void run_capture(bench::BenchRun &run, int32_t width, int32_t height) {
+    ScreenCapture *capture = get_capture();
+    if (!capture) {
+        run.set_counter("available", 0);
+        return;
+    }
+
+    // First grab allocates the surface, the measured ones reuse it
+    std::unique_ptr<CaptureSurface> surface;
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    CaptureFrame frame;
+    capture->capture({ 0, 0, width, height }, surface, frame);
+
+    run.start_timer();
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        if (capture->capture({ 0, 0, width, height }, surface, frame)) {
+            convert_bgrx_to_rgba(frame.pixels, frame.stride, rgba.data(), static_cast<size_t>(width) * 4, frame.width, frame.height);
+            frames++;
+            bytes += static_cast<uint64_t>(frame.width) * frame.height * 4;
+        }
+    }
+    run.stop_timer();
+    bench::keep(rgba.data());
+
+    double seconds = run.get_elapsed_nsec() / 1e9;
+    run.set_counter("available", 1);
+    run.set_counter("zero_copy", capture->is_zero_copy() ? 1 : 0);
+    run.set_counter("frames_per_s", seconds > 0.0 ? frames / seconds : 0.0);
+    run.set_counter("mb_per_s", seconds > 0.0 ? bytes / seconds / 1e6 : 0.0);
+    capture->release(std::move(surface));
+}
+
+} // namespace
+
+BENCH_CASE(capture_256) {
+    // A typical backdrop behind one widget
+    run_capture(run, 256, 256);
+}
+
+BENCH_CASE(capture_1080p) {
+    run_capture(run, 1920, 1080);
+}
+
+BENCH_CASE(pixel_convert_256) {
+    std::vector<uint8_t> bgrx(256 * 256 * 4, 0x7F);
+    std::vector<uint8_t> rgba(bgrx.size());
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        convert_bgrx_to_rgba(bgrx.data(), 256 * 4, rgba.data(), 256 * 4, 256, 256);
+        bench::keep(rgba.data());
+    }
+    run.set_counter("bytes_per_op", double(bgrx.size()));
+}
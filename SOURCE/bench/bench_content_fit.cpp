@@ -0,0 +1,120 @@
+// Auto-fit: keeping the content bounds current as controls move, and how often a window
+// shrink-wrapped around a jittering HUD is resized. Bounds must equal a full recompute,
+// and the window must cover the content on every frame; differences are reported as
+// mismatches, which must be 0.
+
+#include "bench.h"
+
+#include "core/content_fit.h"
+
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+// xorshift32, deterministic across platforms
+struct Random {
+    uint32_t state = 2463534242u;
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int32_t range(int32_t low, int32_t high) {
+        return low + int32_t(next() % uint32_t(high - low + 1));
+    }
+};
+
+const int32_t FRAME_WIDTH = 1920;
+const int32_t FRAME_HEIGHT = 1080;
+const uint64_t FRAME_USEC = 16667;
+
+// A 300x200 panel whose edges wobble a few pixels every frame, as tweened or
+// text-sized content does, and a tooltip shown for 2 s out of every 10
+RegionRect hud_content(uint64_t frame, Random &random) {
+    RegionRect panel = { 100 + random.range(-3, 3), 100 + random.range(-3, 3), 300 + random.range(-3, 3), 200 + random.range(-3, 3) };
+    uint64_t second = frame * FRAME_USEC / 1000000;
+    if (second % 10 >= 8) {
+        panel = union_rects(panel, RegionRect{ 420, 260, 200, 80 });
+    }
+    return panel;
+}
+
+struct FitResult {
+    uint64_t resizes = 0;
+    int mismatches = 0;
+    double mean_area_saved = 0.0;
+};
+
+FitResult run_fit(WindowFit &fit, uint64_t frames) {
+    Random random;
+    FitResult result;
+    fit.set_frame(FRAME_WIDTH, FRAME_HEIGHT);
+    for (uint64_t frame = 0; frame < frames; frame++) {
+        RegionRect content = hud_content(frame, random);
+        if (fit.update(content, (frame + 1) * FRAME_USEC)) {
+            result.resizes++;
+        }
+        result.mismatches += !contains_rect(fit.get_rect(), content);
+    }
+    result.mean_area_saved = fit.get_mean_area_saved();
+    return result;
+}
+
+} // namespace
+
+BENCH_CASE(content_bounds_move) {
+    // One of 256 controls moves per update, the bounds are read every time
+    const int count = 256;
+    ContentBounds bounds;
+    std::vector<RegionRect> rects(count);
+    Random random;
+    for (int i = 0; i < count; i++) {
+        rects[i] = { random.range(0, 1800), random.range(0, 1000), random.range(8, 120), random.range(8, 80) };
+        bounds.set_rect(i, rects[i]);
+    }
+
+    int mismatches = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        int id = int(random.next() % count);
+        rects[id].x = random.range(0, 1800);
+        rects[id].y = random.range(0, 1000);
+        bounds.set_rect(id, rects[id]);
+        bench::keep(bounds.get_bounds());
+    }
+    run.stop_timer();
+
+    RegionRect expected;
+    for (const RegionRect &rect : rects) {
+        expected = union_rects(expected, rect);
+    }
+    mismatches += bounds.get_bounds() != expected;
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("recomputes_per_update", double(bounds.get_recompute_count()) / run.get_iterations());
+}
+
+BENCH_CASE(window_fit_jitter) {
+    // One minute of 60 Hz frames per iteration, against fitting every frame exactly
+    const uint64_t frames = 3600 * run.get_iterations();
+    WindowFit fit;
+    run.start_timer();
+    FitResult result = run_fit(fit, frames);
+    run.stop_timer();
+
+    WindowFit exact;
+    exact.set_margin(0);
+    exact.set_snap(1);
+    exact.set_shrink_delay_usec(0);
+    FitResult exact_result = run_fit(exact, frames);
+
+    double minutes = double(frames) * FRAME_USEC / 60e6;
+    run.set_counter("mismatches", result.mismatches + exact_result.mismatches);
+    run.set_counter("resizes_per_minute", result.resizes / minutes);
+    run.set_counter("exact_resizes_per_minute", exact_result.resizes / minutes);
+    run.set_counter("mean_area_saved", result.mean_area_saved);
+    run.set_counter("exact_mean_area_saved", exact_result.mean_area_saved);
+}
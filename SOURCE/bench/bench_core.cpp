@@ -0,0 +1,254 @@
+// Benchmarks for the hot paths of the core: hook queue and fan-out, keybind matching,
+// keycode translation, input regions, statistics and state transitions.
+
+#include "bench.h"
+
+#include "core/input_region.h"
+#include "core/key_event_fanout.h"
+#include "core/key_event_queue.h"
+#include "core/keybind_table.h"
+#include "core/keycode_tables.h"
+#include "core/overlay_log.h"
+#include "core/overlay_state_machine.h"
+#include "core/overlay_stats.h"
+
+#include <thread>
+#include <unordered_map>
+
+using namespace godot;
+
+namespace {
+
+// Keys a typical session presses, bound and unbound
+const uint16_t SAMPLE_VKS[] = { 0x41, 0x57, 0x53, 0x44, 0x20, 0x70, 0x71, 0x1B, 0x0D, 0x10, 0x11, 0x31, 0x32, 0x33, 0x09, 0x51 };
+constexpr size_t SAMPLE_COUNT = sizeof(SAMPLE_VKS) / sizeof(SAMPLE_VKS[0]);
+
+void build_keybinds(KeybindTable &table, std::unordered_map<uint32_t, uint16_t> &map) {
+    const KeybindTable::Binding bindings[] = {
+        { 0x70, MODIFIER_CTRL, 0 }, // Ctrl+F1
+        { 0x71, MODIFIER_CTRL, 1 }, // Ctrl+F2
+        { 0x41, MODIFIER_CTRL | MODIFIER_SHIFT, 2 },
+        { 0x51, MODIFIER_ALT, 3 },
+        { 0x20, 0, 4 },
+    };
+    table.compile(bindings, sizeof(bindings) / sizeof(bindings[0]));
+    for (const KeybindTable::Binding &binding : bindings) {
+        map[uint32_t(binding.keycode) | (uint32_t(binding.modifiers) << 16)] = binding.action;
+    }
+}
+
+} // namespace
+
+BENCH_CASE(spsc_push_pop) {
+    static KeyEventQueue queue;
+    KeyEvent event;
+    KeyEvent out;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        event.keycode = uint16_t(i);
+        queue.push(event);
+        queue.pop(out);
+        bench::keep(out);
+    }
+}
+
+BENCH_CASE(spsc_two_threads) {
+    // Producer on its own thread like the hook, time per item delivered
+    static KeyEventQueue queue;
+    uint64_t count = run.get_iterations();
+    std::thread producer([count]() {
+        KeyEvent event;
+        for (uint64_t i = 0; i < count; i++) {
+            event.timestamp_usec = i;
+            while (!queue.push(event)) {
+            }
+        }
+    });
+    uint64_t received = 0;
+    KeyEvent out;
+    while (received < count) {
+        if (queue.pop(out)) {
+            received++;
+        }
+    }
+    producer.join();
+    bench::keep(out);
+}
+
+BENCH_CASE(fanout_publish_4) {
+    // One hook record delivered to four overlays, each draining its own queue
+    static KeyEventQueue queues[4];
+    KeyEventFanout fanout;
+    for (KeyEventQueue &queue : queues) {
+        fanout.subscribe(&queue);
+    }
+    KeyEvent event;
+    KeyEvent out;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        event.keycode = uint16_t(i);
+        fanout.publish(event);
+        for (KeyEventQueue &queue : queues) {
+            queue.pop(out);
+        }
+        bench::keep(out);
+    }
+    run.set_counter("subscribers", fanout.get_subscriber_count());
+}
+
+BENCH_CASE(keybind_match_table) {
+    KeybindTable table;
+    std::unordered_map<uint32_t, uint16_t> map;
+    build_keybinds(table, map);
+    run.start_timer();
+    uint32_t hits = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        uint16_t action = table.match(SAMPLE_VKS[i % SAMPLE_COUNT], uint8_t(i & MODIFIER_CTRL));
+        hits += action != KeybindTable::NO_ACTION;
+    }
+    bench::keep(hits);
+}
+
+BENCH_CASE(keybind_match_unordered_map) {
+    // Baseline: the hash map lookup the table replaced
+    KeybindTable table;
+    std::unordered_map<uint32_t, uint16_t> map;
+    build_keybinds(table, map);
+    run.start_timer();
+    uint32_t hits = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        uint32_t key = uint32_t(SAMPLE_VKS[i % SAMPLE_COUNT]) | (uint32_t(i & MODIFIER_CTRL) << 16);
+        hits += map.find(key) != map.end();
+    }
+    bench::keep(hits);
+}
+
+BENCH_CASE(modifier_tracker_update) {
+    ModifierTracker tracker;
+    tracker.set_windows_keycodes();
+    uint8_t modifiers = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        modifiers ^= tracker.update(SAMPLE_VKS[i % SAMPLE_COUNT], (i & 1) == 0);
+    }
+    bench::keep(modifiers);
+}
+
+BENCH_CASE(keycode_godot_to_vk_table) {
+    uint32_t sum = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        sum += keycodes::godot_to_windows_vk(keycodes::KEY_ROWS[i % keycodes::KEY_ROW_COUNT].godot);
+    }
+    bench::keep(sum);
+}
+
+BENCH_CASE(keycode_godot_to_vk_unordered_map) {
+    // Baseline: the runtime map the constexpr tables replaced
+    std::unordered_map<uint32_t, uint32_t> map;
+    for (const keycodes::KeyRow &row : keycodes::KEY_ROWS) {
+        map.emplace(row.godot, row.windows_vk);
+    }
+    run.start_timer();
+    uint32_t sum = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        auto found = map.find(keycodes::KEY_ROWS[i % keycodes::KEY_ROW_COUNT].godot);
+        sum += found != map.end() ? found->second : 0;
+    }
+    bench::keep(sum);
+}
+
+BENCH_CASE(keycode_evdev_to_godot_table) {
+    uint32_t sum = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        sum += keycodes::evdev_to_godot(uint32_t(i & 0xFF));
+    }
+    bench::keep(sum);
+}
+
+BENCH_CASE(region_hit_test_64) {
+    InputRegionIndex index;
+    for (uint64_t id = 0; id < 64; id++) {
+        index.set_rect(id, { int32_t((id % 8) * 240), int32_t((id / 8) * 135), 200, 100 });
+    }
+    index.update_region();
+    run.start_timer();
+    uint32_t hits = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        hits += index.hit_test(int32_t((i * 7919) % 1920), int32_t((i * 104729) % 1080));
+    }
+    bench::keep(hits);
+}
+
+BENCH_CASE(region_move_one_of_64) {
+    // One control moving per frame, the common case for animated UI
+    InputRegionIndex index;
+    for (uint64_t id = 0; id < 64; id++) {
+        index.set_rect(id, { int32_t((id % 8) * 240), int32_t((id / 8) * 135), 200, 100 });
+    }
+    index.update_region();
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        index.set_rect(0, { int32_t(i % 40), 0, 200, 100 });
+        bench::keep(index.update_region());
+    }
+    run.set_counter("region_rects", double(index.get_region().size()));
+}
+
+BENCH_CASE(region_coalesce_64) {
+    std::vector<RegionRect> rects;
+    for (int32_t i = 0; i < 64; i++) {
+        rects.push_back({ (i % 8) * 180, (i / 8) * 90, 200, 100 });
+    }
+    std::vector<RegionRect> region;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        coalesce_region(rects, region);
+        bench::keep(region.data());
+    }
+    run.set_counter("region_rects", double(region.size()));
+}
+
+BENCH_CASE(histogram_record) {
+    static LatencyHistogram histogram;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        histogram.record(i & 0xFFFF);
+    }
+    bench::keep(histogram.get_count());
+}
+
+BENCH_CASE(state_toggle_and_diff) {
+    // A hotkey toggle as seen by the backend: transition, then diff against applied
+    OverlayStateMachine machine;
+    machine.enable();
+    OverlayState applied = machine.get_desired();
+    uint32_t changed = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        machine.toggle_passthrough();
+        changed |= diff_overlay_state(applied, machine.get_desired());
+        applied = machine.get_desired();
+        bench::keep(machine.take_focus_request());
+    }
+    bench::keep(changed);
+}
+
+BENCH_CASE(log_write_filtered) {
+    // Cost of a log call below the runtime level, what every hot path pays
+    OverlayLog::set_level(OVERLAY_LOG_ERROR);
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        if (OverlayLog::is_enabled(OVERLAY_LOG_WARNING)) {
+            OverlayLog::write(OVERLAY_LOG_WARNING, "filtered %llu\n", (unsigned long long)i);
+        }
+    }
+}
+
+BENCH_CASE(log_write_enqueue) {
+    OverlayLog::set_level(OVERLAY_LOG_INFO);
+    size_t flushed = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        OverlayLog::write(OVERLAY_LOG_INFO, "toggle %llu\n", (unsigned long long)i);
+        if ((i & 127) == 127) {
+            run.stop_timer();
+            flushed += OverlayLog::flush([](const OverlayLogRecord &) {});
+            run.resume_timer();
+        }
+    }
+    bench::keep(flushed);
+}
@@ -0,0 +1,131 @@
+// Timed gesture recognition: the timer wheel on its own and a long random typing
+// stream. What the recognizer produces is checked in tests/test_gesture_recognizer.cpp.
+
+#include "bench.h"
+
+#include "core/gesture_recognizer.h"
+#include "core/keybind_table.h"
+#include "core/keycode_tables.h"
+#include "core/timer_wheel.h"
+
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+// Windows virtual keys as WH_KEYBOARD_LL reports them
+constexpr uint16_t VK_SPACE = 0x20;
+constexpr uint16_t VK_A = 0x41;
+constexpr uint16_t VK_D = 0x44;
+constexpr uint16_t VK_G = 0x47;
+constexpr uint16_t VK_H = 0x48;
+constexpr uint16_t VK_X = 0x58;
+constexpr uint16_t VK_SHIFT = 0x10;
+constexpr uint16_t VK_LSHIFT = 0xA0;
+constexpr uint16_t VK_LCONTROL = 0xA2;
+
+enum Action : uint16_t {
+    ACTION_HOLD_H,
+    ACTION_DOUBLE_D,
+    ACTION_SEQUENCE_GGX,
+    ACTION_DOUBLE_SHIFT,
+    ACTION_HOLD_CTRL_SPACE,
+};
+
+GestureRecognizer::Gesture make_gesture(GestureRecognizer::Kind kind, uint16_t action, uint64_t duration_msec, std::vector<GestureRecognizer::Step> steps) {
+    GestureRecognizer::Gesture gesture;
+    gesture.kind = kind;
+    gesture.action = action;
+    gesture.duration_usec = duration_msec * 1000;
+    gesture.steps = std::move(steps);
+    return gesture;
+}
+
+void build_gestures(GestureRecognizer &recognizer) {
+    const GestureRecognizer::Gesture gestures[] = {
+        make_gesture(GestureRecognizer::KIND_HOLD, ACTION_HOLD_H, 300, { { VK_H, 0 } }),
+        make_gesture(GestureRecognizer::KIND_DOUBLE_TAP, ACTION_DOUBLE_D, 250, { { VK_D, 0 } }),
+        make_gesture(GestureRecognizer::KIND_SEQUENCE, ACTION_SEQUENCE_GGX, 500, { { VK_G, 0 }, { VK_G, 0 }, { VK_X, 0 } }),
+        make_gesture(GestureRecognizer::KIND_DOUBLE_TAP, ACTION_DOUBLE_SHIFT, 300, { { VK_SHIFT, 0 } }),
+        make_gesture(GestureRecognizer::KIND_HOLD, ACTION_HOLD_CTRL_SPACE, 200, { { VK_SPACE, MODIFIER_CTRL } }),
+    };
+    ModifierTracker modifier_keys;
+    modifier_keys.set_windows_keycodes();
+    recognizer.set_modifier_keys(modifier_keys);
+    recognizer.compile(gestures, sizeof(gestures) / sizeof(gestures[0]));
+}
+
+// Key records as the hook publishes them, sided modifiers folded onto the generic keys
+struct StreamBuilder {
+    ModifierTracker tracker;
+    std::vector<KeyEvent> events;
+
+    StreamBuilder() {
+        tracker.set_windows_keycodes();
+    }
+
+    void key(uint64_t msec, uint16_t vk, bool pressed) {
+        KeyEvent event;
+        event.timestamp_usec = msec * 1000;
+        event.keycode = uint16_t(keycodes::windows_generic_vk(vk));
+        event.flags = pressed ? KEY_EVENT_PRESSED : 0;
+        event.modifiers = tracker.update(vk, pressed);
+        events.push_back(event);
+    }
+};
+
+} // namespace
+
+BENCH_CASE(timer_wheel_schedule_cancel) {
+    static TimerWheel wheel;
+    wheel.clear();
+    std::mt19937 random(7);
+    std::vector<uint64_t> offsets(4096);
+    for (uint64_t &offset : offsets) {
+        offset = random() % 2000000; // Up to two seconds ahead, the gesture range
+    }
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        uint32_t timer = wheel.schedule(offsets[i & 4095], uint32_t(i));
+        bench::keep(wheel.cancel(timer));
+    }
+}
+
+BENCH_CASE(gesture_random_typing) {
+    // Fast typing over 40 keys, a third of them with gestures, time per key record
+    GestureRecognizer recognizer;
+    build_gestures(recognizer);
+    const uint16_t keys[] = { VK_A, VK_D, VK_G, VK_H, VK_X, VK_SPACE, VK_LSHIFT, VK_LCONTROL };
+    std::mt19937 random(3);
+    StreamBuilder stream;
+    uint64_t msec = 0;
+    bool held[256] = {};
+    for (int i = 0; i < 1 << 16; i++) {
+        uint16_t keycode = (random() % 5) ? uint16_t(0x30 + random() % 32) : keys[random() % 8];
+        msec += 5 + random() % 120;
+        stream.key(msec, keycode, !held[keycode]);
+        held[keycode] = !held[keycode];
+    }
+
+    std::vector<GestureRecognizer::Result> results;
+    results.reserve(1 << 16);
+    size_t recognized = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        const KeyEvent &event = stream.events[i & 0xFFFF];
+        if ((i & 0xFFFF) == 0) {
+            // Time starts over with the stream
+            run.stop_timer();
+            recognized += results.size();
+            results.clear();
+            build_gestures(recognizer);
+            run.resume_timer();
+        }
+        recognizer.process(event, results);
+    }
+    run.stop_timer();
+    recognized += results.size();
+    run.set_counter("recognized_per_1k", double(recognized) * 1000.0 / run.get_iterations());
+}
@@ -0,0 +1,377 @@
+// Global keys on X11: translating raw keycodes through the cached keysym table, and the
+// listener end to end. Keys are sent through XTest, as xdotool does, while the listener
+// records them from raw XInput2 events; key-to-toggle is the time from sending a Ctrl+F12
+// press to a consumer draining it and matching the toggle binding, as Overlay::process
+// does. Needs a display for that case: run under Xvfb, e.g.
+//   xvfb-run bin/overlay_bench --filter global_keys
+// Without one it reports available = 0. Keys that never arrive, arrive with the wrong
+// code, flags or modifiers, a remapped key that does not follow its new keysym, or a key
+// sent right after a focus switch that is not delivered are reported as mismatches, which
+// must be 0. A second display case makes windows active and destroys them at once, the
+// listener must ignore the BadWindow from reading them and still follow the next switch.
+
+#include "bench.h"
+
+#include "core/keybind_table.h"
+#include "core/keycode_tables.h"
+#include "core/overlay_stats.h"
+#include "core/x11_keymap.h"
+
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) || defined(__FreeBSD__)
+#include "hook_dispatcher.h"
+#include "x11_display.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#endif
+
+using namespace godot;
+
+namespace {
+
+// The keysyms Xvfb's default evdev layout gives each keycode, one per keycode
+std::vector<unsigned long> standard_keysyms(int first_keycode, int keycode_count) {
+    std::vector<unsigned long> keysyms(keycode_count, 0);
+    for (const keycodes::KeyRow &row : keycodes::KEY_ROWS) {
+        int keycode = int(row.evdev + keycodes::X11_EVDEV_KEYCODE_OFFSET);
+        if (row.evdev && row.x11_keysym && keycode >= first_keycode && keycode < first_keycode + keycode_count &&
+                !keysyms[keycode - first_keycode]) {
+            keysyms[keycode - first_keycode] = row.x11_keysym;
+        }
+    }
+    for (unsigned long &keysym : keysyms) {
+        if (keysym >= 'A' && keysym <= 'Z') {
+            keysym += 'a' - 'A'; // Letters are listed lower case first
+        }
+    }
+    return keysyms;
+}
+
+} // namespace
+
+BENCH_CASE(x11_keymap_translate) {
+    const int first_keycode = 8;
+    const int keycode_count = 248;
+    std::vector<unsigned long> keysyms = standard_keysyms(first_keycode, keycode_count);
+    X11Keymap keymap;
+    keymap.rebuild(keysyms.data(), first_keycode, keycode_count, 1);
+
+    // On the standard layout every key with a Godot key maps to itself
+    int mismatches = keymap.get_remapped_count() != 0;
+    const uint16_t key_q = 24;
+    const uint16_t key_a = 38;
+    const uint16_t key_w = 25;
+    const uint16_t key_z = 52;
+
+    // AZERTY swaps A with Q and Z with W, a binding on A follows the a keysym
+    std::swap(keysyms[key_q - first_keycode], keysyms[key_a - first_keycode]);
+    std::swap(keysyms[key_w - first_keycode], keysyms[key_z - first_keycode]);
+    keymap.rebuild(keysyms.data(), first_keycode, keycode_count, 1);
+    mismatches += keymap.get_remapped_count() != 4;
+    mismatches += keymap.get_keycode(key_q) != key_a || keymap.get_keycode(key_a) != key_q;
+    mismatches += keymap.get_keycode(key_w) != key_z || keymap.get_keycode(key_z) != key_w;
+    mismatches += keymap.get_keycode(105) != 105; // Right Ctrl has no Godot key of its own
+
+    uint32_t sum = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        sum += keymap.get_keycode(uint32_t(8 + (i & 0xFF) % keycode_count));
+    }
+    run.stop_timer();
+    bench::keep(sum);
+    run.set_counter("mismatches", mismatches);
+}
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+namespace {
+
+// Waits for a record the predicate accepts, every record drained on the way is counted
+template <typename Predicate>
+bool wait_for_key(KeyEventQueue &queue, int &r_received, Predicate &&predicate) {
+    uint64_t deadline = get_monotonic_usec() + 2000000;
+    bool found = false;
+    while (!found) {
+        queue.drain([&](const KeyEvent &event) {
+            r_received++;
+            found = found || predicate(event);
+        });
+        if (!found && get_monotonic_usec() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void send_key(Display *client, KeyCode keycode, bool pressed) {
+    XTestFakeKeyEvent(client, keycode, pressed ? True : False, CurrentTime);
+    XFlush(client);
+}
+
+} // namespace
+
+BENCH_CASE(global_keys_x11) {
+    Display *client = XOpenDisplay(nullptr);
+    int event_base = 0;
+    int error_base = 0;
+    int major = 0;
+    int minor = 0;
+    if (!client || !XTestQueryExtension(client, &event_base, &error_base, &major, &minor)) {
+        if (client) {
+            XCloseDisplay(client);
+        }
+        run.set_counter("available", 0);
+        return;
+    }
+    std::shared_ptr<HookDispatcher> dispatcher = HookDispatcher::acquire();
+    std::unique_ptr<KeyEventQueue> queue(new KeyEventQueue());
+    if (!dispatcher->is_hooked() || !dispatcher->subscribe(queue.get())) {
+        XCloseDisplay(client);
+        run.set_counter("available", 0);
+        return;
+    }
+
+    // Ctrl+F12 toggles input, bound the way Overlay compiles an InputMap event
+    KeyCode ctrl = XKeysymToKeycode(client, XK_Control_L);
+    KeyCode f12 = XKeysymToKeycode(client, XK_F12);
+    KeybindTable table;
+    KeybindTable::Binding binding;
+    binding.keycode = uint16_t(keycodes::godot_to_evdev(keycodes::special(0x27)) + keycodes::X11_EVDEV_KEYCODE_OFFSET);
+    binding.modifiers = MODIFIER_CTRL;
+    binding.action = 0;
+    table.compile(&binding, 1);
+    auto is_toggle = [&](const KeyEvent &event) {
+        return (event.flags & KEY_EVENT_PRESSED) && table.match(event.keycode, event.modifiers) == 0;
+    };
+
+    // The listener selects raw keys when its thread starts, the first key may be sent before
+    int received = 0;
+    bool ready = false;
+    for (int attempt = 0; attempt < 20 && !ready; attempt++) {
+        send_key(client, f12, true);
+        send_key(client, f12, false);
+        ready = wait_for_key(*queue, received, [](const KeyEvent &) { return true; });
+    }
+    if (!ready) {
+        dispatcher->unsubscribe(queue.get());
+        XCloseDisplay(client);
+        run.set_counter("available", 1);
+        run.set_counter("mismatches", 1);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue->drain([](const KeyEvent &) {});
+
+    LatencyHistogram record_usec;
+    LatencyHistogram toggle_usec;
+    int mismatches = 0;
+    received = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        send_key(client, ctrl, true);
+        uint64_t start = get_monotonic_usec();
+        send_key(client, f12, true);
+        KeyEvent toggle;
+        if (wait_for_key(*queue, received, [&](const KeyEvent &event) {
+                    toggle = event;
+                    return is_toggle(event);
+                })) {
+            toggle_usec.record(get_monotonic_usec() - start);
+            record_usec.record(toggle.timestamp_usec - start);
+            mismatches += !(toggle.flags & KEY_EVENT_INJECTED);
+            mismatches += toggle.scancode + keycodes::X11_EVDEV_KEYCODE_OFFSET != f12;
+        } else {
+            mismatches++;
+        }
+        send_key(client, f12, false);
+        send_key(client, ctrl, false);
+
+        // Both releases arrive with Ctrl let go last
+        if (!wait_for_key(*queue, received, [&](const KeyEvent &event) {
+                    return !(event.flags & KEY_EVENT_PRESSED) && event.scancode + keycodes::X11_EVDEV_KEYCODE_OFFSET == ctrl && event.modifiers == 0;
+                })) {
+            mismatches++;
+        }
+    }
+    run.stop_timer();
+    mismatches += uint64_t(received) != run.get_iterations() * 4;
+
+    // A keycode with no keysym is given F12: the listener reloads its table on
+    // MappingNotify and the key then matches the F12 binding
+    int first_keycode = 0;
+    int last_keycode = 0;
+    XDisplayKeycodes(client, &first_keycode, &last_keycode);
+    int per_keycode = 0;
+    KeySym *keysyms = XGetKeyboardMapping(client, KeyCode(first_keycode), last_keycode - first_keycode + 1, &per_keycode);
+    KeyCode spare = 0;
+    for (int keycode = last_keycode; keycode >= first_keycode && !spare && keysyms; keycode--) {
+        bool empty = true;
+        for (int level = 0; level < per_keycode; level++) {
+            empty = empty && keysyms[(keycode - first_keycode) * per_keycode + level] == NoSymbol;
+        }
+        spare = empty ? KeyCode(keycode) : 0;
+    }
+    if (keysyms) {
+        XFree(keysyms);
+    }
+    double remap_usec = 0.0;
+    if (spare) {
+        KeySym remapped = XK_F12;
+        KeySym cleared = NoSymbol;
+        uint64_t start = get_monotonic_usec();
+        XChangeKeyboardMapping(client, spare, 1, &remapped, 1);
+        XSync(client, False);
+        bool matched = false;
+        for (int attempt = 0; attempt < 50 && !matched; attempt++) {
+            send_key(client, ctrl, true);
+            send_key(client, spare, true);
+            send_key(client, spare, false);
+            send_key(client, ctrl, false);
+            matched = wait_for_key(*queue, received, is_toggle);
+        }
+        remap_usec = double(get_monotonic_usec() - start);
+        mismatches += !matched;
+        XChangeKeyboardMapping(client, spare, 1, &cleared, 1);
+        XSync(client, False);
+    }
+
+    // Every switch of _NET_ACTIVE_WINDOW makes the listener read window properties. A key
+    // sent right behind it can land in Xlib's queue during those round trips and must still
+    // be delivered, with nothing else arriving to wake the listener.
+    ::Window root = DefaultRootWindow(client);
+    Atom net_active_window = XInternAtom(client, "_NET_ACTIVE_WINDOW", False);
+    Atom actual_type = None;
+    int actual_format = 0;
+    unsigned long previous_count = 0;
+    unsigned long bytes_after = 0;
+    unsigned char *previous = nullptr;
+    XGetWindowProperty(client, root, net_active_window, 0, 1, False, XA_WINDOW, &actual_type, &actual_format,
+            &previous_count, &bytes_after, &previous);
+    ::Window windows[2];
+    for (::Window &window : windows) {
+        window = XCreateSimpleWindow(client, root, 0, 0, 64, 64, 0, 0, 0);
+        XMapWindow(client, window);
+    }
+    XSync(client, False);
+    const int focus_switches = 100;
+    int focus_misses = 0;
+    for (int i = 0; i < focus_switches; i++) {
+        ::Window active = windows[i & 1];
+        XChangeProperty(client, root, net_active_window, XA_WINDOW, 32, PropModeReplace,
+                reinterpret_cast<const unsigned char *>(&active), 1);
+        send_key(client, f12, true);
+        send_key(client, f12, false);
+        if (!wait_for_key(*queue, received, [&](const KeyEvent &event) {
+                    return !(event.flags & KEY_EVENT_PRESSED) && event.scancode + keycodes::X11_EVDEV_KEYCODE_OFFSET == f12;
+                })) {
+            focus_misses++;
+        }
+        uint64_t deadline = get_monotonic_usec() + 2000000;
+        while (dispatcher->get_foreground_window() != active && get_monotonic_usec() < deadline) {
+            std::this_thread::yield();
+        }
+        focus_misses += dispatcher->get_foreground_window() != active;
+    }
+    mismatches += focus_misses;
+    if (previous && previous_count == 1) {
+        XChangeProperty(client, root, net_active_window, XA_WINDOW, 32, PropModeReplace, previous, 1);
+    } else {
+        XDeleteProperty(client, root, net_active_window);
+    }
+    if (previous) {
+        XFree(previous);
+    }
+    for (::Window window : windows) {
+        XDestroyWindow(client, window);
+    }
+    XSync(client, False);
+
+    dispatcher->unsubscribe(queue.get());
+    XCloseDisplay(client);
+    run.set_counter("available", 1);
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("record_p50_usec", double(record_usec.get_percentile(50.0)));
+    run.set_counter("toggle_p50_usec", double(toggle_usec.get_percentile(50.0)));
+    run.set_counter("toggle_p99_usec", double(toggle_usec.get_percentile(99.0)));
+    run.set_counter("hook_p99_nsec", double(dispatcher->get_stats().hook_nsec.get_percentile(99.0)));
+    run.set_counter("remap_usec", remap_usec);
+    run.set_counter("focus_switch_misses", focus_misses);
+}
+
+BENCH_CASE(foreground_destroyed_x11) {
+    Display *client = XOpenDisplay(nullptr);
+    if (!client) {
+        run.set_counter("available", 0);
+        return;
+    }
+    std::shared_ptr<HookDispatcher> dispatcher = HookDispatcher::acquire();
+
+    ::Window root = DefaultRootWindow(client);
+    Atom net_active_window = XInternAtom(client, "_NET_ACTIVE_WINDOW", False);
+    Atom actual_type = None;
+    int actual_format = 0;
+    unsigned long previous_count = 0;
+    unsigned long bytes_after = 0;
+    unsigned char *previous = nullptr;
+    XGetWindowProperty(client, root, net_active_window, 0, 1, False, XA_WINDOW, &actual_type, &actual_format,
+            &previous_count, &bytes_after, &previous);
+    ::Window survivors[2];
+    for (::Window &window : survivors) {
+        window = XCreateSimpleWindow(client, root, 0, 0, 64, 64, 0, 0, 0);
+        XMapWindow(client, window);
+    }
+    XSync(client, False);
+
+    const uint64_t ignored_before = get_ignored_x11_error_count();
+    int mismatches = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        // Activated and destroyed right away, the listener reads the pid and title of
+        // windows that are gone by then
+        for (int burst = 0; burst < 32; burst++) {
+            ::Window doomed = XCreateSimpleWindow(client, root, 0, 0, 16, 16, 0, 0, 0);
+            XChangeProperty(client, root, net_active_window, XA_WINDOW, 32, PropModeReplace,
+                    reinterpret_cast<const unsigned char *>(&doomed), 1);
+            XDestroyWindow(client, doomed);
+            XFlush(client);
+        }
+        ::Window active = survivors[i & 1];
+        XChangeProperty(client, root, net_active_window, XA_WINDOW, 32, PropModeReplace,
+                reinterpret_cast<const unsigned char *>(&active), 1);
+        XSync(client, False);
+        uint64_t deadline = get_monotonic_usec() + 2000000;
+        while (dispatcher->get_foreground_window() != active && get_monotonic_usec() < deadline) {
+            std::this_thread::yield();
+        }
+        mismatches += dispatcher->get_foreground_window() != active;
+    }
+    run.stop_timer();
+
+    if (previous && previous_count == 1) {
+        XChangeProperty(client, root, net_active_window, XA_WINDOW, 32, PropModeReplace, previous, 1);
+    } else {
+        XDeleteProperty(client, root, net_active_window);
+    }
+    if (previous) {
+        XFree(previous);
+    }
+    for (::Window window : survivors) {
+        XDestroyWindow(client, window);
+    }
+    XSync(client, False);
+    XCloseDisplay(client);
+    run.set_counter("available", 1);
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("ignored_errors_per_cycle", double(get_ignored_x11_error_count() - ignored_before) / run.get_iterations());
+}
+
+#endif
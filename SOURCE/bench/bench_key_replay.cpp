@@ -0,0 +1,199 @@
+// Key recordings: appending records, reading a file back and replaying a stream through
+// the hook path. The replay cases use a synthetic typing session, or the recording named
+// by GODOVERIT_KEY_RECORDING so a stream captured in the field runs as a regression case.
+// Round trip differences are reported as mismatches, which must be 0.
+
+#include "bench.h"
+
+#include "core/key_recording.h"
+#include "core/key_replay.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+// Windows virtual keys
+constexpr uint16_t VK_LCONTROL = 0xA2;
+constexpr uint16_t VK_F1 = 0x70;
+constexpr uint16_t VK_F2 = 0x71;
+
+std::string temp_path(const char *name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Typing with the occasional Ctrl+F1 / Ctrl+F2 toggle, records as the hook stamps them
+std::vector<KeyEvent> make_session(size_t count, uint64_t mean_gap_usec) {
+    std::mt19937 random(5);
+    std::vector<KeyEvent> events;
+    events.reserve(count + 8);
+    uint64_t timestamp = 1000000;
+    bool held[256] = {};
+    while (events.size() < count) {
+        KeyEvent event;
+        timestamp += 1 + random() % (2 * mean_gap_usec);
+        event.timestamp_usec = timestamp;
+        if (random() % 200 == 0) {
+            // Ctrl down, F-key tap, Ctrl up
+            uint16_t keys[] = { VK_LCONTROL, uint16_t(random() % 2 ? VK_F1 : VK_F2), 0, VK_LCONTROL };
+            keys[2] = keys[1];
+            for (int i = 0; i < 4; i++) {
+                event.keycode = keys[i];
+                event.scancode = uint16_t(keys[i] & 0x7F);
+                event.flags = (i < 2) ? KEY_EVENT_PRESSED : 0;
+                events.push_back(event);
+                event.timestamp_usec = (timestamp += 20000);
+            }
+            continue;
+        }
+        uint16_t keycode = uint16_t(0x30 + random() % 42);
+        event.keycode = keycode;
+        event.scancode = uint16_t(keycode - 0x20);
+        event.flags = held[keycode] ? 0 : KEY_EVENT_PRESSED;
+        held[keycode] = !held[keycode];
+        events.push_back(event);
+    }
+    return events;
+}
+
+// Default toggles, in the keycodes of the recording's platform
+void bind_toggles(KeyReplayer &replayer, KeyRecordingPlatform platform) {
+    const KeybindTable::Binding windows[] = {
+        { VK_F1, MODIFIER_CTRL, KeyReplayer::ACTION_TOGGLE_INPUT },
+        { VK_F2, MODIFIER_CTRL, KeyReplayer::ACTION_TOGGLE_VISIBILITY },
+    };
+    const KeybindTable::Binding x11[] = {
+        { 67, MODIFIER_CTRL, KeyReplayer::ACTION_TOGGLE_INPUT }, // KEY_F1 + 8
+        { 68, MODIFIER_CTRL, KeyReplayer::ACTION_TOGGLE_VISIBILITY },
+    };
+    replayer.set_platform(platform);
+    replayer.get_keybind_table().compile(platform == KEY_RECORDING_WINDOWS ? windows : x11, 2);
+}
+
+// The field recording when one is given, the synthetic session otherwise
+bool load_stream(std::vector<KeyEvent> &r_events, KeyRecordingPlatform &r_platform, size_t synthetic_count, uint64_t mean_gap_usec) {
+    const char *path = getenv("GODOVERIT_KEY_RECORDING");
+    if (path && *path) {
+        KeyRecordingInfo info;
+        if (!read_key_recording(path, info, r_events)) {
+            fprintf(stderr, "Could not read key recording %s\n", path);
+            return false;
+        }
+        r_platform = info.platform;
+        return true;
+    }
+    r_events = make_session(synthetic_count, mean_gap_usec);
+    r_platform = KEY_RECORDING_WINDOWS;
+    return true;
+}
+
+void set_report_counters(bench::BenchRun &run, const KeyReplayer::Report &report) {
+    run.set_counter("events", double(report.events));
+    run.set_counter("toggles", double(report.toggles));
+    run.set_counter("dropped", double(report.dropped));
+    run.set_counter("p50_nsec", double(report.latency_p50_nsec));
+    run.set_counter("p99_nsec", double(report.latency_p99_nsec));
+    run.set_counter("p999_nsec", double(report.latency_p999_nsec));
+    run.set_counter("max_nsec", double(report.latency_max_nsec));
+}
+
+} // namespace
+
+BENCH_CASE(key_recording_append) {
+    std::vector<KeyEvent> events = make_session(1 << 16, 80000);
+    std::string path = temp_path("overlay_bench_append.gdkeys");
+    KeyRecordingWriter writer;
+    if (!writer.open(path.c_str(), KEY_RECORDING_WINDOWS)) {
+        run.set_counter("available", 0);
+        return;
+    }
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        writer.append(events[i & 0xFFFF]);
+    }
+    writer.close(0);
+    run.stop_timer();
+    run.set_counter("bytes_per_record", double(writer.get_bytes_written()) / run.get_iterations());
+    std::filesystem::remove(path);
+}
+
+BENCH_CASE(key_recording_roundtrip) {
+    // Written, read back and compared, with a torn record at the end as after a crash
+    std::vector<KeyEvent> events = make_session(100000, 80000);
+    std::string path = temp_path("overlay_bench_roundtrip.gdkeys");
+    int mismatches = 0;
+    std::vector<KeyEvent> read_back;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        KeyRecordingWriter writer;
+        if (!writer.open(path.c_str(), KEY_RECORDING_X11)) {
+            run.set_counter("available", 0);
+            return;
+        }
+        for (const KeyEvent &event : events) {
+            writer.append(event);
+        }
+        writer.close(7);
+        FILE *file = fopen(path.c_str(), "ab");
+        fwrite("torn", 1, 4, file);
+        fclose(file);
+
+        KeyRecordingInfo info;
+        if (!read_key_recording(path.c_str(), info, read_back) || info.platform != KEY_RECORDING_X11 || info.dropped != 7 ||
+                read_back.size() != events.size()) {
+            mismatches++;
+            continue;
+        }
+        for (size_t e = 0; e < events.size(); e++) {
+            const KeyEvent &a = events[e];
+            const KeyEvent &b = read_back[e];
+            if (a.timestamp_usec != b.timestamp_usec || a.keycode != b.keycode || a.scancode != b.scancode ||
+                    a.flags != b.flags || a.modifiers != b.modifiers) {
+                mismatches++;
+            }
+        }
+    }
+    std::filesystem::remove(path);
+    run.set_counter("records", double(events.size()));
+    run.set_counter("mismatches", mismatches);
+}
+
+BENCH_CASE(key_replay_fast) {
+    // As fast as possible, time per record from publish to settled state
+    std::vector<KeyEvent> events;
+    KeyRecordingPlatform platform;
+    if (!load_stream(events, platform, 1 << 16, 80000)) {
+        run.set_counter("available", 0);
+        return;
+    }
+    KeyReplayer replayer;
+    bind_toggles(replayer, platform);
+    KeyReplayer::Report report;
+    uint64_t replayed = 0;
+    run.start_timer();
+    while (replayed < run.get_iterations()) {
+        report = replayer.run(events, KeyReplayer::PACING_FAST);
+        replayed += events.size();
+    }
+    run.stop_timer();
+    set_report_counters(run, report);
+    run.set_counter("records_per_op", double(replayed) / run.get_iterations());
+}
+
+BENCH_CASE(key_replay_recorded) {
+    // A fast typing burst at recorded speed, 2000 records with a dozen toggles in about a second
+    std::vector<KeyEvent> events = make_session(2000, 125);
+    KeyReplayer replayer;
+    bind_toggles(replayer, KEY_RECORDING_WINDOWS);
+    KeyReplayer::Report report;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        report = replayer.run(events, KeyReplayer::PACING_RECORDED);
+    }
+    set_report_counters(run, report);
+    run.set_counter("lag_p99_usec", double(report.lag_p99_usec));
+    run.set_counter("lag_max_usec", double(report.lag_max_usec));
+}
@@ -0,0 +1,210 @@
+// Global mouse coalescing: what the hook pays per record, and what the main thread sees
+// when an 8 kHz mouse reports while frames are drawn at 60 Hz. Motion, wheel and presses
+// taken by a reader must add up to exactly what the hook was given, however the takes
+// interleave with the writes; differences are reported as mismatches, which must be 0.
+
+#include "bench.h"
+
+#include "core/key_event_queue.h"
+#include "core/mouse_accumulator.h"
+#include "core/overlay_stats.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace godot;
+
+namespace {
+
+// Sums of every frame a reader took
+struct Taken {
+    uint64_t events = 0;
+    uint64_t motion_events = 0;
+    int64_t motion_x = 0;
+    int64_t motion_y = 0;
+    uint64_t presses = 0;
+    int64_t wheel = 0;
+    uint64_t frames = 0;
+    uint64_t max_events = 0;
+
+    void add(const MouseAccumulator::Frame &frame) {
+        events += frame.events;
+        motion_events += frame.motion_events;
+        motion_x += frame.motion_x;
+        motion_y += frame.motion_y;
+        for (int button = 0; button < MouseAccumulator::PRESS_BUTTONS; button++) {
+            for (int modifiers = 0; modifiers < MouseAccumulator::MODIFIER_COMBINATIONS; modifiers++) {
+                presses += frame.presses[button][modifiers];
+            }
+        }
+        for (int modifiers = 0; modifiers < MouseAccumulator::MODIFIER_COMBINATIONS; modifiers++) {
+            wheel += frame.wheel[MouseAccumulator::WHEEL_VERTICAL][modifiers];
+        }
+        frames++;
+        max_events = frame.events > max_events ? frame.events : max_events;
+    }
+};
+
+// What the synthetic mouse sends: a wobbling path, a Ctrl+wheel notch every 64 records
+// alternating direction and a side button press every 512
+struct SyntheticMouse {
+    uint64_t sent = 0;
+    uint64_t positions = 0;
+    int32_t x = 1000;
+    int32_t y = 500;
+    int32_t origin_x = 0; // First position, which only sets the origin
+    int32_t origin_y = 0;
+    uint64_t presses = 0;
+    uint64_t wheel_events = 0;
+    int64_t wheel = 0;
+
+    void send(MouseAccumulator &mouse, uint64_t timestamp_usec) {
+        uint64_t i = sent++;
+        if ((i & 63) == 63) {
+            int32_t delta = (i & 64) ? -MouseAccumulator::WHEEL_NOTCH : MouseAccumulator::WHEEL_NOTCH;
+            mouse.add_wheel(MouseAccumulator::WHEEL_VERTICAL, delta, MODIFIER_CTRL, timestamp_usec);
+            wheel_events++;
+            wheel += delta;
+        } else if ((i & 511) == 256) {
+            mouse.add_press(MouseAccumulator::BUTTON_X1, 0, timestamp_usec);
+            presses++;
+        } else {
+            x += int32_t(i % 7) - 3;
+            y += int32_t(i % 5) - 2;
+            if (positions++ == 0) {
+                origin_x = x;
+                origin_y = y;
+            }
+            mouse.add_position(x, y, timestamp_usec);
+        }
+    }
+
+    uint64_t get_motion_events() const {
+        return positions ? positions - 1 : 0;
+    }
+    uint64_t get_events() const {
+        return get_motion_events() + presses + wheel_events;
+    }
+};
+
+int count_mismatches(const SyntheticMouse &sent, const Taken &taken) {
+    int mismatches = 0;
+    mismatches += taken.motion_events != sent.get_motion_events();
+    mismatches += taken.motion_x != int64_t(sent.x) - sent.origin_x;
+    mismatches += taken.motion_y != int64_t(sent.y) - sent.origin_y;
+    mismatches += taken.presses != sent.presses;
+    mismatches += taken.wheel != sent.wheel;
+    mismatches += taken.events != sent.get_events();
+    return mismatches;
+}
+
+} // namespace
+
+BENCH_CASE(mouse_accumulate) {
+    // Cost of one hook record, the work done per event at any report rate
+    MouseAccumulator mouse;
+    MouseAccumulator::Reader reader;
+    SyntheticMouse sent;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        sent.send(mouse, i);
+    }
+    run.stop_timer();
+
+    Taken taken;
+    MouseAccumulator::Frame frame;
+    if (reader.take(mouse, frame)) {
+        taken.add(frame);
+    }
+    run.set_counter("mismatches", count_mismatches(sent, taken));
+}
+
+BENCH_CASE(mouse_coalesce_8khz) {
+    // 100 ms of an 8 kHz mouse per iteration, taken once every 60 Hz frame
+    const uint64_t report_usec = 125;
+    const uint64_t frame_usec = 16667;
+    MouseAccumulator mouse;
+    MouseAccumulator::Reader reader;
+    SyntheticMouse sent;
+    LatencyHistogram hook_nsec;
+    LatencyHistogram take_nsec;
+    std::atomic<bool> done{ false };
+
+    uint64_t start = get_monotonic_usec();
+    uint64_t end = start + 100000 * run.get_iterations();
+    std::thread writer([&]() {
+        // Paced by spinning, sleeping is far coarser than 125 us on most systems
+        uint64_t next = get_monotonic_usec();
+        while (next < end) {
+            while (get_monotonic_usec() < next) {
+                std::this_thread::yield();
+            }
+            uint64_t begin_nsec = get_monotonic_nsec();
+            sent.send(mouse, next);
+            hook_nsec.record(get_monotonic_nsec() - begin_nsec);
+            next += report_usec;
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    Taken taken;
+    MouseAccumulator::Frame frame;
+    while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(frame_usec));
+        uint64_t begin_nsec = get_monotonic_nsec();
+        if (reader.take(mouse, frame)) {
+            taken.add(frame);
+        }
+        take_nsec.record(get_monotonic_nsec() - begin_nsec);
+    }
+    writer.join();
+    if (reader.take(mouse, frame)) {
+        taken.add(frame);
+    }
+    double seconds = (get_monotonic_usec() - start) / 1e6;
+
+    run.set_counter("mismatches", count_mismatches(sent, taken));
+    run.set_counter("report_hz", sent.sent / seconds);
+    run.set_counter("frames", double(taken.frames));
+    run.set_counter("records_per_frame", taken.frames ? double(taken.events) / taken.frames : 0.0);
+    run.set_counter("max_records_per_frame", double(taken.max_events));
+    run.set_counter("hook_p99_nsec", double(hook_nsec.get_percentile(99.0)));
+    run.set_counter("take_p99_nsec", double(take_nsec.get_percentile(99.0)));
+}
+
+BENCH_CASE(mouse_coalesce_flood) {
+    // Writer flat out against a reader taking as fast as it can, the worst interleaving
+    const uint64_t records = 1 << 20;
+    int mismatches = 0;
+    uint64_t frames = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        MouseAccumulator mouse;
+        MouseAccumulator::Reader reader;
+        SyntheticMouse sent;
+        std::atomic<bool> done{ false };
+        std::thread writer([&]() {
+            for (uint64_t r = 0; r < records; r++) {
+                sent.send(mouse, r);
+            }
+            done.store(true, std::memory_order_release);
+        });
+        Taken taken;
+        MouseAccumulator::Frame frame;
+        while (!done.load(std::memory_order_acquire)) {
+            if (reader.take(mouse, frame)) {
+                taken.add(frame);
+            }
+        }
+        writer.join();
+        if (reader.take(mouse, frame)) {
+            taken.add(frame);
+        }
+        mismatches += count_mismatches(sent, taken);
+        frames += taken.frames;
+    }
+    run.stop_timer();
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("records_per_take", frames ? double(records * run.get_iterations()) / frames : 0.0);
+}
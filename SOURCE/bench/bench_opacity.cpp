@@ -0,0 +1,152 @@
+// Opacity fades: sampling the curves, and whole fades on the animator's thread with a
+// sink standing in for the native window. Curves must start and end exactly on their
+// alphas and never move backwards; fades must land on their target, pass every alpha
+// to the sink once and end no later than a step after their duration. Differences are
+// reported as mismatches, which must be 0.
+
+#include "bench.h"
+
+#include "core/key_event_queue.h"
+#include "core/opacity_animator.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+struct Step {
+    uint64_t usec;
+    uint8_t alpha;
+};
+
+// Collects what a native window would have been given
+struct RecordingSink {
+    std::mutex mutex;
+    std::vector<Step> steps;
+
+    OpacityAnimator::Sink make() {
+        return [this](uint8_t alpha) {
+            std::lock_guard<std::mutex> lock(mutex);
+            steps.push_back({ get_monotonic_usec(), alpha });
+            return true;
+        };
+    }
+};
+
+bool wait_for_serial(const OpacityAnimator &animator, uint64_t serial, uint64_t timeout_usec) {
+    uint64_t deadline = get_monotonic_usec() + timeout_usec;
+    while (animator.get_finished_serial() == serial) {
+        if (get_monotonic_usec() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return true;
+}
+
+} // namespace
+
+BENCH_CASE(opacity_curve_sample) {
+    // Every curve in both directions over a second, one sample per microsecond step
+    const uint64_t duration = 1000000;
+    int mismatches = 0;
+    for (int curve = 0; curve < OpacityAnimator::CURVE_COUNT; curve++) {
+        for (int direction = 0; direction < 2; direction++) {
+            uint8_t from = direction ? 255 : 0;
+            uint8_t to = direction ? 0 : 255;
+            OpacityAnimator::Curve c = static_cast<OpacityAnimator::Curve>(curve);
+            if (OpacityAnimator::sample(from, to, 0, duration, c) != from || OpacityAnimator::sample(from, to, duration, duration, c) != to) {
+                mismatches++;
+            }
+            uint8_t previous = from;
+            for (uint64_t t = 0; t <= duration; t += 97) {
+                uint8_t alpha = OpacityAnimator::sample(from, to, t, duration, c);
+                if (direction ? alpha > previous : alpha < previous) {
+                    mismatches++;
+                }
+                previous = alpha;
+            }
+        }
+    }
+
+    run.start_timer();
+    uint32_t sum = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        sum += OpacityAnimator::sample(40, 230, (i * 7919) % duration, duration, static_cast<OpacityAnimator::Curve>(i & 3));
+    }
+    run.stop_timer();
+    bench::keep(sum);
+    run.set_counter("mismatches", mismatches);
+}
+
+BENCH_CASE(opacity_fade_thread) {
+    // A 250 ms fade out and back in at 120 steps a second, as fade_to runs them
+    const uint64_t duration = 250000;
+    const int step_rate = 120;
+    RecordingSink sink;
+    OpacityAnimator animator;
+    animator.set_sink(sink.make());
+    animator.set_step_rate(step_rate);
+
+    int mismatches = 0;
+    uint64_t late_max = 0;
+    size_t steps = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        for (int direction = 0; direction < 2; direction++) {
+            uint8_t target = direction ? 255 : 20;
+            uint8_t from = animator.get_alpha();
+            sink.steps.clear();
+            uint64_t serial = animator.get_finished_serial();
+            uint64_t start = get_monotonic_usec();
+            animator.fade_to(target, duration, OpacityAnimator::CURVE_EASE_IN_OUT);
+            if (!wait_for_serial(animator, serial, 4 * duration)) {
+                mismatches++;
+                continue;
+            }
+            uint64_t finished = get_monotonic_usec();
+
+            std::lock_guard<std::mutex> lock(sink.mutex);
+            if (animator.get_alpha() != target || animator.is_fading() || sink.steps.empty() || sink.steps.back().alpha != target) {
+                mismatches++;
+            }
+
+            // Each call changes the alpha, always towards the target
+            uint8_t previous = from;
+            for (const Step &step : sink.steps) {
+                if (step.alpha == previous || (target > from ? step.alpha < previous : step.alpha > previous)) {
+                    mismatches++;
+                }
+                previous = step.alpha;
+            }
+            steps += sink.steps.size();
+
+            // The last alpha arrives on time, the thread wakes a step at most after it
+            uint64_t end = start + duration;
+            uint64_t last = sink.steps.empty() ? finished : sink.steps.back().usec;
+            uint64_t late = last > end ? last - end : 0;
+            late_max = late > late_max ? late : late_max;
+        }
+    }
+
+    // Replacing a fade continues from where it got to, cancelling leaves the alpha alone
+    animator.fade_to(0, duration, OpacityAnimator::CURVE_LINEAR);
+    std::this_thread::sleep_for(std::chrono::microseconds(duration / 2));
+    uint8_t midway = animator.get_alpha();
+    animator.fade_to(255, duration, OpacityAnimator::CURVE_LINEAR);
+    animator.cancel();
+    std::this_thread::sleep_for(std::chrono::microseconds(20000));
+    if (midway == 0 || midway == 255 || animator.is_fading() || animator.get_alpha() != midway) {
+        mismatches++;
+    }
+
+    const OpacityAnimator::Stats &stats = animator.get_stats();
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("steps_per_fade", double(steps) / (2 * run.get_iterations()));
+    run.set_counter("late_max_usec", double(late_max));
+    run.set_counter("step_lag_p99_usec", double(stats.step_lag_usec.get_percentile(99.0)));
+    run.set_counter("step_failures", double(stats.step_failures.load()));
+}
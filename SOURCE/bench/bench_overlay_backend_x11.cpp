@@ -0,0 +1,276 @@
+// OverlayBackendX11 against a real server, on a 32 bit ARGB window like the one Godot
+// creates with per-pixel transparency. The overlay is enabled, disabled and toggled in
+// and out of passthrough, each timed from apply_state to an XSync, when the server has
+// processed every request. After each step the window is read back: the XFixes input
+// shape must be empty exactly while passing input through, _NET_WM_WINDOW_OPACITY must
+// match the alpha, _MOTIF_WM_HINTS the borders and _NET_WM_STATE_ABOVE the topmost flag.
+// Needs a display: run under Xvfb, e.g.
+//   xvfb-run bin/overlay_bench --filter overlay_backend_x11
+// Without one the case reports available = 0. Xvfb runs no window manager, the
+// _NET_WM_STATE requests are then applied by a stand-in, as an EWMH window manager
+// would. Read-backs that differ from the state applied are reported as mismatches,
+// which must be 0.
+
+#include "bench.h"
+
+#include "core/key_event_queue.h"
+#include "core/overlay_stats.h"
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "overlay_backend_x11.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/shape.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+const int WINDOW_WIDTH = 320;
+const int WINDOW_HEIGHT = 200;
+
+// Reads a 32 bit property as a list, empty when the window does not have it
+std::vector<unsigned long> read_list(Display *display, ::Window window, Atom property, Atom type) {
+    Atom actual_type = None;
+    int actual_format = 0;
+    unsigned long count = 0;
+    unsigned long bytes_after = 0;
+    unsigned char *data = nullptr;
+    std::vector<unsigned long> values;
+    if (XGetWindowProperty(display, window, property, 0, 64, False, type, &actual_type, &actual_format, &count,
+                &bytes_after, &data) == Success && data && actual_type == type && actual_format == 32) {
+        const unsigned long *items = reinterpret_cast<const unsigned long *>(data);
+        values.assign(items, items + count);
+    }
+    if (data) {
+        XFree(data);
+    }
+    return values;
+}
+
+// Applies _NET_WM_STATE client messages to the window property when no window manager
+// runs, otherwise only counts them and leaves the property to the window manager
+struct WmStandIn {
+    Display *display = nullptr;
+    ::Window root = 0;
+    Atom net_wm_state = None;
+    bool apply = false;
+    uint64_t requests = 0;
+
+    bool open() {
+        display = XOpenDisplay(nullptr);
+        if (!display) {
+            return false;
+        }
+        root = DefaultRootWindow(display);
+        net_wm_state = XInternAtom(display, "_NET_WM_STATE", False);
+        Atom supporting = XInternAtom(display, "_NET_SUPPORTING_WM_CHECK", False);
+        apply = read_list(display, root, supporting, XA_WINDOW).empty();
+        XSelectInput(display, root, SubstructureNotifyMask);
+        XSync(display, False);
+        return true;
+    }
+
+    void close() {
+        if (display) {
+            XCloseDisplay(display);
+            display = nullptr;
+        }
+    }
+
+    // Handle what was sent so far, the sender has synced before
+    void pump() {
+        XSync(display, False);
+        while (XPending(display) > 0) {
+            XEvent event;
+            XNextEvent(display, &event);
+            if (event.type != ClientMessage || event.xclient.message_type != net_wm_state) {
+                continue;
+            }
+            requests++;
+            if (!apply) {
+                continue;
+            }
+            ::Window window = event.xclient.window;
+            std::vector<unsigned long> states = read_list(display, window, net_wm_state, XA_ATOM);
+            for (int i = 1; i <= 2; i++) {
+                unsigned long state = static_cast<unsigned long>(event.xclient.data.l[i]);
+                if (state == 0) {
+                    continue;
+                }
+                std::vector<unsigned long>::iterator found = std::find(states.begin(), states.end(), state);
+                bool add = event.xclient.data.l[0] == 1 || (event.xclient.data.l[0] == 2 && found == states.end());
+                if (add && found == states.end()) {
+                    states.push_back(state);
+                } else if (!add && found != states.end()) {
+                    states.erase(found);
+                }
+            }
+            XChangeProperty(display, window, net_wm_state, XA_ATOM, 32, PropModeReplace,
+                    reinterpret_cast<const unsigned char *>(states.data()), int(states.size()));
+        }
+        XSync(display, False);
+    }
+};
+
+struct Atoms {
+    Atom net_wm_state = None;
+    Atom net_wm_state_above = None;
+    Atom net_wm_window_opacity = None;
+    Atom motif_wm_hints = None;
+};
+
+// Differences between what the server holds for the window and the state applied
+int check_window(Display *display, ::Window window, const Atoms &atoms, const OverlayState &state, WmStandIn &wm) {
+    int mismatches = 0;
+
+    // Passthrough is an empty input shape, the default shape is the whole window
+    int count = 0;
+    int ordering = 0;
+    XRectangle *rects = XShapeGetRectangles(display, window, ShapeInput, &count, &ordering);
+    if (state.passthrough) {
+        mismatches += count != 0;
+    } else {
+        mismatches += count != 1 || !rects || rects[0].x != 0 || rects[0].y != 0 ||
+                rects[0].width != WINDOW_WIDTH || rects[0].height != WINDOW_HEIGHT;
+    }
+    if (rects) {
+        XFree(rects);
+    }
+
+    // Opaque and visible is no property at all, hidden is alpha 0
+    std::vector<unsigned long> opacity = read_list(display, window, atoms.net_wm_window_opacity, XA_CARDINAL);
+    if (state.visible && state.alpha == 255) {
+        mismatches += !opacity.empty();
+    } else {
+        unsigned long expected = state.visible ? state.alpha * 0x01010101UL : 0;
+        mismatches += opacity.size() != 1 || (opacity[0] & 0xFFFFFFFFUL) != expected;
+    }
+
+    // Borderless is a Motif hint without decorations
+    std::vector<unsigned long> hints = read_list(display, window, atoms.motif_wm_hints, atoms.motif_wm_hints);
+    if (state.borderless) {
+        mismatches += hints.size() != 5 || !(hints[0] & (1UL << 1)) || hints[2] != 0;
+    } else {
+        mismatches += !hints.empty();
+    }
+
+    // Topmost is asked of the window manager, which may take a moment to apply it
+    uint64_t deadline = get_monotonic_usec() + 1000000;
+    bool above = false;
+    for (;;) {
+        wm.pump();
+        std::vector<unsigned long> states = read_list(display, window, atoms.net_wm_state, XA_ATOM);
+        above = std::find(states.begin(), states.end(), atoms.net_wm_state_above) != states.end();
+        if (above == state.topmost || get_monotonic_usec() > deadline) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    mismatches += above != state.topmost;
+    return mismatches;
+}
+
+} // namespace
+
+BENCH_CASE(overlay_backend_x11) {
+    // Stands in for Godot's connection and window
+    Display *display = XOpenDisplay(nullptr);
+    if (!display) {
+        run.set_counter("available", 0);
+        return;
+    }
+    WmStandIn wm;
+    wm.open();
+
+    int screen = DefaultScreen(display);
+    ::Window root = RootWindow(display, screen);
+    XVisualInfo visual_info = {};
+    bool argb = XMatchVisualInfo(display, screen, 32, TrueColor, &visual_info);
+    XSetWindowAttributes attributes = {};
+    unsigned long mask = CWBackPixel | CWBorderPixel;
+    if (argb) {
+        attributes.colormap = XCreateColormap(display, root, visual_info.visual, AllocNone);
+        mask |= CWColormap;
+    }
+    ::Window window = XCreateWindow(display, root, 50, 60, WINDOW_WIDTH, WINDOW_HEIGHT, 0,
+            argb ? 32 : CopyFromParent, InputOutput, argb ? visual_info.visual : nullptr, mask, &attributes);
+    XMapWindow(display, window);
+    XSync(display, False);
+
+    Atoms atoms;
+    atoms.net_wm_state = XInternAtom(display, "_NET_WM_STATE", False);
+    atoms.net_wm_state_above = XInternAtom(display, "_NET_WM_STATE_ABOVE", False);
+    atoms.net_wm_window_opacity = XInternAtom(display, "_NET_WM_WINDOW_OPACITY", False);
+    atoms.motif_wm_hints = XInternAtom(display, "_MOTIF_WM_HINTS", False);
+
+    OverlayBackendX11 backend;
+    int mismatches = 0;
+    if (!backend.attach(static_cast<int64_t>(window), static_cast<int64_t>(reinterpret_cast<intptr_t>(display)), "")) {
+        mismatches++;
+    }
+
+    // Every transition is timed to the server having processed it, then read back untimed
+    const OverlayState normal = OverlayState::normal_window();
+    const OverlayState overlay = OverlayState::overlay_window();
+    OverlayState captured = overlay;
+    captured.passthrough = false;
+    OverlayState faded = overlay;
+    faded.alpha = 128;
+    OverlayState hidden = overlay;
+    hidden.visible = false;
+    LatencyHistogram enable_usec;
+    LatencyHistogram disable_usec;
+    LatencyHistogram passthrough_usec;
+    LatencyHistogram alpha_usec;
+    auto step = [&](const OverlayState &state, LatencyHistogram &latency) {
+        uint64_t start = get_monotonic_usec();
+        backend.apply_state(state);
+        XSync(display, False);
+        latency.record(get_monotonic_usec() - start);
+        run.stop_timer();
+        mismatches += check_window(display, window, atoms, state, wm);
+        mismatches += diff_overlay_state(backend.get_applied_state(), state) != 0;
+        run.resume_timer();
+    };
+
+    uint64_t calls_before = backend.get_native_call_count();
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        step(overlay, enable_usec);
+        step(captured, passthrough_usec);
+        step(overlay, passthrough_usec);
+        step(faded, alpha_usec);
+        step(hidden, alpha_usec);
+        step(normal, disable_usec);
+    }
+    run.stop_timer();
+    uint64_t calls = backend.get_native_call_count() - calls_before;
+
+    XDestroyWindow(display, window);
+    if (argb) {
+        XFreeColormap(display, attributes.colormap);
+    }
+    XSync(display, False);
+    wm.close();
+    run.set_counter("available", 1);
+    run.set_counter("argb_visual", argb ? 1 : 0);
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("enable_p50_usec", double(enable_usec.get_percentile(50.0)));
+    run.set_counter("disable_p50_usec", double(disable_usec.get_percentile(50.0)));
+    run.set_counter("passthrough_p50_usec", double(passthrough_usec.get_percentile(50.0)));
+    run.set_counter("passthrough_p99_usec", double(passthrough_usec.get_percentile(99.0)));
+    run.set_counter("alpha_p50_usec", double(alpha_usec.get_percentile(50.0)));
+    run.set_counter("native_calls_per_cycle", double(calls) / run.get_iterations());
+    run.set_counter("wm_state_requests_per_cycle", double(wm.requests) / run.get_iterations());
+    XCloseDisplay(display);
+}
+
+#endif // __linux__ || __FreeBSD__
@@ -0,0 +1,189 @@
+// Conversion kernels for per-pixel alpha presentation at common window sizes, once per
+// instruction set. Every case first checks its output against the scalar kernel and
+// reports the differing bytes as mismatches, which must be 0.
+
+#include "bench.h"
+
+#include "core/dirty_tiles.h"
+#include "core/pixel_convert.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+enum Kernel {
+    KERNEL_SWAP,
+    KERNEL_PREMULTIPLY,
+    KERNEL_COLOR_KEY,
+};
+
+constexpr uint32_t COLOR_KEY = 0x000000;
+
+void convert(Kernel kernel, const uint8_t *src, uint8_t *dst, int32_t width, int32_t height) {
+    size_t stride = static_cast<size_t>(width) * 4;
+    switch (kernel) {
+        case KERNEL_SWAP:
+            convert_bgrx_to_rgba(src, stride, dst, stride, width, height);
+            break;
+        case KERNEL_PREMULTIPLY:
+            convert_rgba_to_premultiplied_bgra(src, stride, dst, stride, width, height);
+            break;
+        case KERNEL_COLOR_KEY:
+            convert_rgba_keyed_to_bgra(src, stride, dst, stride, width, height, COLOR_KEY);
+            break;
+    }
+}
+
+// Rendered UI: random colors and alpha, with runs of the key color and of fully transparent pixels
+std::vector<uint8_t> make_frame(int32_t width, int32_t height) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    std::mt19937 random(1234);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        uint32_t value = random();
+        if ((value & 0x700) == 0) {
+            value &= 0xFF000000u; // Key colored, alpha left random
+        } else if ((value & 0x700) == 0x100) {
+            value = 0;
+        }
+        memcpy(&pixels[i], &value, 4);
+    }
+    return pixels;
+}
+
+size_t count_mismatches(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        mismatches += a[i] != b[i];
+    }
+    return mismatches;
+}
+
+void run_kernel(bench::BenchRun &run, Kernel kernel, PixelIsa isa, int32_t width, int32_t height) {
+    if (!set_pixel_isa(isa)) {
+        run.set_counter("available", 0);
+        return;
+    }
+
+    // Odd widths too, so the scalar tail after the vector loop is covered
+    std::vector<uint8_t> src = make_frame(width, height);
+    std::vector<uint8_t> dst(src.size());
+    std::vector<uint8_t> expected(src.size());
+    size_t mismatches = 0;
+    for (int32_t check_width : { width, width - 3 }) {
+        set_pixel_isa(PIXEL_ISA_SCALAR);
+        convert(kernel, src.data(), expected.data(), check_width, height);
+        set_pixel_isa(isa);
+        convert(kernel, src.data(), dst.data(), check_width, height);
+        mismatches += count_mismatches(expected, dst);
+    }
+
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        convert(kernel, src.data(), dst.data(), width, height);
+        bench::keep(dst.data());
+    }
+    run.stop_timer();
+    set_pixel_isa(get_best_pixel_isa());
+
+    double seconds = run.get_elapsed_nsec() / 1e9;
+    run.set_counter("available", 1);
+    run.set_counter("mismatches", double(mismatches));
+    run.set_counter("mpixels_per_s", seconds > 0.0 ? double(width) * height * run.get_iterations() / seconds / 1e6 : 0.0);
+}
+
+} // namespace
+
+#define PIXEL_CONVERT_CASES(name, kernel, isa, ISA)                         \
+    BENCH_CASE(name##_##isa##_1080p) {                                      \
+        run_kernel(run, kernel, PIXEL_ISA_##ISA, 1920, 1080);               \
+    }                                                                       \
+    BENCH_CASE(name##_##isa##_1440p) {                                      \
+        run_kernel(run, kernel, PIXEL_ISA_##ISA, 2560, 1440);               \
+    }                                                                       \
+    BENCH_CASE(name##_##isa##_4k) {                                         \
+        run_kernel(run, kernel, PIXEL_ISA_##ISA, 3840, 2160);               \
+    }
+
+PIXEL_CONVERT_CASES(premultiply, KERNEL_PREMULTIPLY, scalar, SCALAR)
+PIXEL_CONVERT_CASES(premultiply, KERNEL_PREMULTIPLY, sse2, SSE2)
+PIXEL_CONVERT_CASES(premultiply, KERNEL_PREMULTIPLY, avx2, AVX2)
+PIXEL_CONVERT_CASES(color_key, KERNEL_COLOR_KEY, scalar, SCALAR)
+PIXEL_CONVERT_CASES(color_key, KERNEL_COLOR_KEY, sse2, SSE2)
+PIXEL_CONVERT_CASES(color_key, KERNEL_COLOR_KEY, avx2, AVX2)
+PIXEL_CONVERT_CASES(swap_rb, KERNEL_SWAP, scalar, SCALAR)
+PIXEL_CONVERT_CASES(swap_rb, KERNEL_SWAP, sse2, SSE2)
+PIXEL_CONVERT_CASES(swap_rb, KERNEL_SWAP, avx2, AVX2)
+
+BENCH_CASE(premultiply_all_values) {
+    // Every color and alpha pair through every instruction set, against the exact division
+    std::vector<uint8_t> src(256 * 256 * 4);
+    for (int alpha = 0; alpha < 256; alpha++) {
+        for (int color = 0; color < 256; color++) {
+            uint8_t *pixel = &src[(alpha * 256 + color) * 4];
+            pixel[0] = static_cast<uint8_t>(color);
+            pixel[1] = static_cast<uint8_t>(255 - color);
+            pixel[2] = static_cast<uint8_t>(color ^ 0x5A);
+            pixel[3] = static_cast<uint8_t>(alpha);
+        }
+    }
+    std::vector<uint8_t> dst(src.size());
+    size_t mismatches = 0;
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        for (int isa = PIXEL_ISA_SCALAR; isa < PIXEL_ISA_COUNT; isa++) {
+            if (!set_pixel_isa(static_cast<PixelIsa>(isa))) {
+                continue;
+            }
+            convert_rgba_to_premultiplied_bgra(src.data(), 256 * 4, dst.data(), 256 * 4, 256, 256);
+            for (size_t p = 0; p < src.size(); p += 4) {
+                uint32_t alpha = src[p + 3];
+                mismatches += dst[p] != (src[p + 2] * alpha + 127) / 255;
+                mismatches += dst[p + 1] != (src[p + 1] * alpha + 127) / 255;
+                mismatches += dst[p + 2] != (src[p] * alpha + 127) / 255;
+                mismatches += dst[p + 3] != alpha;
+            }
+        }
+    }
+    set_pixel_isa(get_best_pixel_isa());
+    run.set_counter("mismatches", double(mismatches));
+    run.set_counter("best_isa", double(get_best_pixel_isa()));
+}
+
+BENCH_CASE(dirty_tiles_4k_unchanged) {
+    // The common overlay frame: nothing moved, every tile is compared and none converted
+    std::vector<uint8_t> frame = make_frame(3840, 2160);
+    DirtyTiles tiles;
+    tiles.reset(3840, 2160);
+    std::vector<RegionRect> rects;
+    tiles.diff(frame.data(), 3840 * 4, rects);
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        tiles.diff(frame.data(), 3840 * 4, rects);
+    }
+    run.stop_timer();
+    run.set_counter("rects", double(rects.size()));
+}
+
+BENCH_CASE(dirty_tiles_4k_one_widget) {
+    // A 300x200 widget redrawn every frame, found as a handful of tiles
+    std::vector<uint8_t> frame = make_frame(3840, 2160);
+    DirtyTiles tiles;
+    tiles.reset(3840, 2160);
+    std::vector<RegionRect> rects;
+    tiles.diff(frame.data(), 3840 * 4, rects);
+    size_t changed = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        for (int32_t y = 1000; y < 1200; y++) {
+            frame[(static_cast<size_t>(y) * 3840 + 2000) * 4] ^= 1;
+            frame[(static_cast<size_t>(y) * 3840 + 2299) * 4] ^= 1;
+        }
+        changed = tiles.diff(frame.data(), 3840 * 4, rects);
+    }
+    run.stop_timer();
+    run.set_counter("tiles", double(changed));
+    run.set_counter("rects", double(rects.size()));
+}
@@ -0,0 +1,127 @@
+// Time series for overlay graphs: what a push costs, and a HUD of many series sampled at
+// 1 kHz, summarized and plotted every 60 Hz frame. Summaries and percentiles must match a
+// plain recompute, min-max plots must reach the window's extremes and LTTB plots must
+// keep the end points within the width; differences are reported as mismatches, which
+// must be 0. A second plot without a push must come from the cache.
+
+#include "bench.h"
+
+#include "core/time_series.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+// Frame times with noise and a spike every 997 samples
+double sample_value(uint64_t i, int series) {
+    double noise = double((i * 2654435761u + series * 40503u) % 1000) / 1000.0;
+    return 16.0 + series * 0.1 + noise + ((i % 997) == 0 ? 30.0 : 0.0);
+}
+
+int check_series(TimeSeries &series, double span) {
+    int mismatches = 0;
+    size_t start = series.find_window_start(span);
+    std::vector<double> window;
+    for (size_t i = start; i < series.get_count(); i++) {
+        window.push_back(series.get_value(i));
+    }
+    if (window.empty()) {
+        return 1;
+    }
+    const TimeSeries::Summary &summary = series.summarize(span);
+    double sum = 0.0;
+    for (double value : window) {
+        sum += value;
+    }
+    std::vector<double> sorted = window;
+    std::sort(sorted.begin(), sorted.end());
+    mismatches += summary.count != window.size();
+    mismatches += summary.min != sorted.front() || summary.max != sorted.back();
+    mismatches += std::fabs(summary.mean - sum / window.size()) > 1e-9;
+    mismatches += summary.last != window.back();
+    size_t rank = size_t(std::ceil(0.99 * sorted.size())) - 1;
+    mismatches += series.get_percentile(span, 99.0) != sorted[rank];
+
+    // The highest value is drawn at y 0 and the lowest at the height
+    TimeSeries::PlotRequest request;
+    request.span = span;
+    request.width = 300;
+    request.height = 100.0f;
+    const std::vector<SeriesPoint> &envelope = series.plot(request);
+    float top = 1e9f;
+    float bottom = -1e9f;
+    for (const SeriesPoint &point : envelope) {
+        top = std::min(top, point.y);
+        bottom = std::max(bottom, point.y);
+    }
+    mismatches += envelope.size() > size_t(request.width) * 2;
+    mismatches += std::fabs(top) > 1e-3f || std::fabs(bottom - request.height) > 1e-3f;
+
+    request.mode = TimeSeries::DECIMATION_LTTB;
+    const std::vector<SeriesPoint> &shape = series.plot(request);
+    mismatches += shape.size() > size_t(request.width);
+    mismatches += shape.empty() || std::fabs(shape.back().x - request.width) > 1e-3f;
+    return mismatches;
+}
+
+} // namespace
+
+BENCH_CASE(series_push) {
+    TimeSeries series(8192);
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        series.push(i * 0.001, sample_value(i, 0));
+    }
+    run.stop_timer();
+    bench::keep(series.get_serial());
+    run.set_counter("mismatches", series.get_count() != std::min<uint64_t>(run.get_iterations(), 8192));
+}
+
+BENCH_CASE(series_hud_1khz) {
+    // 64 series sampled at 1 kHz, each frame pushes 1/60 s of samples, then reads the
+    // last 5 s of every series as a summary, a p99 and a 300 px min-max plot
+    const int series_count = 64;
+    const double span = 5.0;
+    std::vector<TimeSeries> series(series_count, TimeSeries(8192));
+    TimeSeries::PlotRequest request;
+    request.span = span;
+    request.width = 300;
+    request.height = 100.0f;
+
+    uint64_t sample = 0;
+    uint64_t frames = run.get_iterations();
+    run.start_timer();
+    for (uint64_t frame = 0; frame < frames; frame++) {
+        uint64_t frame_end = (frame + 1) * 1000 / 60;
+        for (; sample < frame_end; sample++) {
+            for (int s = 0; s < series_count; s++) {
+                series[s].push(sample * 0.001, sample_value(sample, s));
+            }
+        }
+        for (TimeSeries &one : series) {
+            bench::keep(one.summarize(span).mean);
+            bench::keep(one.get_percentile(span, 99.0));
+            bench::keep(one.plot(request).size());
+        }
+    }
+    run.stop_timer();
+    double frame_usec = run.get_elapsed_nsec() / 1000.0 / frames;
+
+    // Drawn again without new samples, nothing is recomputed
+    uint64_t version = series[0].get_plot_version();
+    series[0].plot(request);
+    int mismatches = series[0].get_plot_version() != version;
+    for (TimeSeries &one : series) {
+        mismatches += check_series(one, span);
+        mismatches += check_series(one, 0.0);
+    }
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("series", series_count);
+    run.set_counter("usec_per_series_frame", frame_usec / series_count);
+    run.set_counter("samples_per_frame", double(sample) * series_count / frames);
+    run.set_counter("points_per_plot", double(series[0].plot(request).size()));
+}
@@ -0,0 +1,186 @@
+// Shared memory telemetry: a producer in a separate process pushes as fast as
+// it can while this process reads like Overlay does. On Windows the producer
+// runs on a thread instead, the memory path is the same.
+
+#include "bench.h"
+
+#include "core/telemetry_reader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace godot;
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_VALUES = 16;
+constexpr uint32_t RING_RECORDS = 4096;
+constexpr uint32_t RECORD_SIZE = 32;
+
+// Runs producer(name) in another process where fork exists, returns a handle to stop it
+struct Producer {
+#ifdef _WIN32
+    std::thread thread;
+    volatile bool stop = false;
+#else
+    pid_t pid = -1;
+#endif
+};
+
+template <typename Function>
+void start_producer(Producer &producer, Function function) {
+#ifdef _WIN32
+    producer.thread = std::thread([&producer, function]() {
+        function(&producer.stop);
+    });
+#else
+    producer.pid = fork();
+    if (producer.pid == 0) {
+        static volatile bool never = false;
+        function(&never);
+        _exit(0);
+    }
+#endif
+}
+
+void stop_producer(Producer &producer) {
+#ifdef _WIN32
+    producer.stop = true;
+    producer.thread.join();
+#else
+    if (producer.pid > 0) {
+        kill(producer.pid, SIGKILL);
+        waitpid(producer.pid, nullptr, 0);
+    }
+#endif
+}
+
+void make_name(char *name, size_t size, const char *kind) {
+#ifdef _WIN32
+    snprintf(name, size, "bench_%s_%d", kind, _getpid());
+#else
+    snprintf(name, size, "bench_%s_%d", kind, (int)getpid());
+#endif
+}
+
+} // namespace
+
+BENCH_CASE(telemetry_drain_from_process) {
+    // Time per record moved from the producer process into an overlay-sized drain buffer
+    char name[64];
+    make_name(name, sizeof(name), "ring");
+    TelemetryReader reader;
+    if (reader.open(name, SNAPSHOT_VALUES, RING_RECORDS, RECORD_SIZE) != 0) {
+        run.set_counter("available", 0);
+        return;
+    }
+
+    Producer producer;
+    start_producer(producer, [&name](volatile bool *stop) {
+        godoverit_telemetry channel;
+        if (godoverit_telemetry_open(&channel, name, SNAPSHOT_VALUES, RING_RECORDS, RECORD_SIZE) != 0) {
+            return;
+        }
+        uint64_t record[RECORD_SIZE / 8] = {};
+        while (!*stop) {
+            // Waits instead of dropping, so the reader is the bottleneck being measured
+            if (godoverit_telemetry_can_push(&channel)) {
+                godoverit_telemetry_push(&channel, record, sizeof(record));
+                record[0]++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        godoverit_telemetry_close(&channel, 0);
+    });
+
+    std::vector<uint8_t> buffer(RING_RECORDS * RECORD_SIZE);
+    run.start_timer();
+    uint64_t received = 0;
+    while (received < run.get_iterations()) {
+        size_t count = reader.drain(buffer.data(), RING_RECORDS);
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        received += count;
+    }
+    run.stop_timer();
+    bench::keep(buffer.data());
+    stop_producer(producer);
+
+    double seconds = run.get_elapsed_nsec() / 1e9;
+    run.set_counter("available", 1);
+    run.set_counter("records_per_s", seconds > 0.0 ? received / seconds : 0.0);
+    run.set_counter("mb_per_s", seconds > 0.0 ? received * RECORD_SIZE / seconds / 1e6 : 0.0);
+    run.set_counter("dropped", double(reader.get_dropped_count()));
+}
+
+BENCH_CASE(telemetry_snapshot_while_writing) {
+    // Reading a 16 value snapshot while another process rewrites it nonstop, the worst case for the seqlock.
+    // Every value of a snapshot is the same generation number, so a read mixing two writes shows up as
+    // torn, and a failed read must leave the previous snapshot in place.
+    char name[64];
+    make_name(name, sizeof(name), "snapshot");
+    TelemetryReader reader;
+    if (reader.open(name, SNAPSHOT_VALUES, RING_RECORDS, RECORD_SIZE) != 0) {
+        run.set_counter("available", 0);
+        return;
+    }
+
+    Producer producer;
+    start_producer(producer, [&name](volatile bool *stop) {
+        godoverit_telemetry channel;
+        if (godoverit_telemetry_open(&channel, name, SNAPSHOT_VALUES, RING_RECORDS, RECORD_SIZE) != 0) {
+            return;
+        }
+        double values[SNAPSHOT_VALUES] = {};
+        double generation = 0.0;
+        while (!*stop) {
+            generation += 1.0;
+            for (double &value : values) {
+                value = generation;
+            }
+            godoverit_telemetry_write_snapshot(&channel, values, SNAPSHOT_VALUES);
+        }
+        godoverit_telemetry_close(&channel, 0);
+    });
+
+    double values[SNAPSHOT_VALUES] = {};
+    double previous[SNAPSHOT_VALUES] = {};
+    uint32_t count = 0;
+    uint64_t failed = 0;
+    uint64_t torn = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        if (reader.read_snapshot(values, count)) {
+            for (uint32_t k = 1; k < count; k++) {
+                if (values[k] != values[0]) {
+                    torn++;
+                    break;
+                }
+            }
+            memcpy(previous, values, sizeof(values));
+        } else {
+            failed++;
+            torn += memcmp(previous, values, sizeof(values)) != 0;
+        }
+    }
+    run.stop_timer();
+    bench::keep(values);
+    stop_producer(producer);
+
+    run.set_counter("available", 1);
+    run.set_counter("retries_per_read", double(reader.get_snapshot_retries()) / run.get_iterations());
+    run.set_counter("failed_reads", double(failed));
+    run.set_counter("torn_reads", double(torn));
+}
@@ -0,0 +1,195 @@
+// Following another application's window, as attach_to_window does. A dummy client on
+// a second connection creates, moves, resizes, unmaps, maps and destroys a window while
+// the tracker follows it from notifications. Needs a display: run under Xvfb, e.g.
+//   xvfb-run bin/overlay_bench --filter window_tracker
+// Without one the case reports available = 0. States that never arrive, or that arrive
+// when nothing changed, are reported as mismatches, which must be 0. A second case
+// destroys windows while the tracker reads them during its search: the BadWindow
+// errors that follow must be ignored, not exit the process, and the tracker must
+// still find the window it waits for.
+
+#include "bench.h"
+
+#include "core/key_event_queue.h"
+#include "core/overlay_stats.h"
+#include "window_tracker.h"
+#include "x11_display.h"
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+using namespace godot;
+
+namespace {
+
+// Wait for the tracker to publish a state the predicate accepts, false on timeout
+bool wait_for_state(const WindowTracker &tracker, const std::function<bool(const TrackedWindow &)> &predicate) {
+    uint64_t deadline = get_monotonic_usec() + 2000000;
+    while (!predicate(tracker.get_state())) {
+        if (get_monotonic_usec() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return true;
+}
+
+} // namespace
+
+BENCH_CASE(window_tracker_x11) {
+    Display *client = XOpenDisplay(nullptr);
+    if (!client) {
+        run.set_counter("available", 0);
+        return;
+    }
+    std::unique_ptr<WindowTracker> tracker = WindowTracker::create();
+    WindowMatch match;
+    match.title = "overlay bench target";
+    match.window_class = "OverlayBench";
+    if (!tracker || !tracker->start(match)) {
+        XCloseDisplay(client);
+        run.set_counter("available", 0);
+        return;
+    }
+
+    // Started before the window exists, so every cycle is found by searching again
+    ::Window root = DefaultRootWindow(client);
+    LatencyHistogram found_usec;
+    LatencyHistogram change_usec;
+    int mismatches = 0;
+    auto expect = [&](LatencyHistogram &latency, const std::function<bool(const TrackedWindow &)> &predicate) {
+        uint64_t start = get_monotonic_usec();
+        if (wait_for_state(*tracker, predicate)) {
+            latency.record(get_monotonic_usec() - start);
+        } else {
+            mismatches++;
+        }
+    };
+
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        ::Window window = XCreateSimpleWindow(client, root, 100, 120, 320, 200, 0, 0, 0);
+        XStoreName(client, window, "GodoverIt overlay bench target");
+        XClassHint hint = { const_cast<char *>("overlay_bench"), const_cast<char *>("OverlayBench") };
+        XSetClassHint(client, window, &hint);
+        XMapWindow(client, window);
+        XSync(client, False);
+        expect(found_usec, [&](const TrackedWindow &state) {
+            return state.window == window && state.rect == RegionRect{ 100, 120, 320, 200 } && !state.minimized;
+        });
+
+        XMoveResizeWindow(client, window, 200, 240, 400, 300);
+        XSync(client, False);
+        expect(change_usec, [&](const TrackedWindow &state) {
+            return state.rect == RegionRect{ 200, 240, 400, 300 };
+        });
+
+        // The same geometry again is a notification but no change
+        uint64_t serial = tracker->get_serial();
+        uint64_t events = tracker->get_stats().events.load();
+        XMoveResizeWindow(client, window, 200, 240, 400, 300);
+        XSync(client, False);
+        uint64_t deadline = get_monotonic_usec() + 2000000;
+        while (tracker->get_stats().events.load() == events && get_monotonic_usec() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(1000));
+        if (tracker->get_serial() != serial) {
+            mismatches++;
+        }
+
+        // Unmapped is how ICCCM windows are minimized
+        XUnmapWindow(client, window);
+        XSync(client, False);
+        expect(change_usec, [&](const TrackedWindow &state) {
+            return state.window == window && state.minimized;
+        });
+        XMapWindow(client, window);
+        XSync(client, False);
+        expect(change_usec, [&](const TrackedWindow &state) {
+            return state.window == window && !state.minimized;
+        });
+
+        XDestroyWindow(client, window);
+        XSync(client, False);
+        expect(change_usec, [](const TrackedWindow &state) {
+            return state.window == 0;
+        });
+    }
+    run.stop_timer();
+
+    const WindowTracker::Stats &stats = tracker->get_stats();
+    run.set_counter("available", 1);
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("found_p50_usec", double(found_usec.get_percentile(50.0)));
+    run.set_counter("change_p50_usec", double(change_usec.get_percentile(50.0)));
+    run.set_counter("change_p99_usec", double(change_usec.get_percentile(99.0)));
+    run.set_counter("events_per_cycle", double(stats.events.load()) / run.get_iterations());
+    run.set_counter("changes_per_cycle", double(stats.changes.load()) / run.get_iterations());
+    tracker->stop();
+    XCloseDisplay(client);
+}
+
+BENCH_CASE(window_tracker_x11_destroyed_during_search) {
+    Display *client = XOpenDisplay(nullptr);
+    if (!client) {
+        run.set_counter("available", 0);
+        return;
+    }
+    std::unique_ptr<WindowTracker> tracker = WindowTracker::create();
+    WindowMatch match;
+    match.title = "overlay bench survivor";
+    match.window_class = "OverlayBench";
+    if (!tracker || !tracker->start(match)) {
+        XCloseDisplay(client);
+        run.set_counter("available", 0);
+        return;
+    }
+
+    ::Window root = DefaultRootWindow(client);
+    const uint64_t ignored_before = get_ignored_x11_error_count();
+    int mismatches = 0;
+    run.start_timer();
+    for (uint64_t i = 0; i < run.get_iterations(); i++) {
+        // Each map starts a search that reads the title and class of every top-level
+        // window, most of these are gone by the time it gets to them
+        for (int burst = 0; burst < 64; burst++) {
+            ::Window window = XCreateSimpleWindow(client, root, 10, 10, 40, 30, 0, 0, 0);
+            XStoreName(client, window, "overlay bench short lived");
+            XMapWindow(client, window);
+            XFlush(client);
+            XDestroyWindow(client, window);
+        }
+
+        ::Window window = XCreateSimpleWindow(client, root, 100, 120, 320, 200, 0, 0, 0);
+        XStoreName(client, window, "overlay bench survivor");
+        XClassHint hint = { const_cast<char *>("overlay_bench"), const_cast<char *>("OverlayBench") };
+        XSetClassHint(client, window, &hint);
+        XMapWindow(client, window);
+        XSync(client, False);
+        if (!wait_for_state(*tracker, [&](const TrackedWindow &state) { return state.window == window; })) {
+            mismatches++;
+        }
+        XDestroyWindow(client, window);
+        XSync(client, False);
+        if (!wait_for_state(*tracker, [](const TrackedWindow &state) { return state.window == 0; })) {
+            mismatches++;
+        }
+    }
+    run.stop_timer();
+
+    run.set_counter("available", 1);
+    run.set_counter("mismatches", mismatches);
+    run.set_counter("searches_per_cycle", double(tracker->get_stats().searches.load()) / run.get_iterations());
+    run.set_counter("ignored_errors_per_cycle", double(get_ignored_x11_error_count() - ignored_before) / run.get_iterations());
+    tracker->stop();
+    XCloseDisplay(client);
+}
+
+#endif // __linux__ || __FreeBSD__
@@ -0,0 +1,334 @@
+/*
+ * GodoverIt telemetry channel, header-only C99 (also compiles as C++).
+ *
+ * Feeds overlay data from another process through a named shared memory
+ * segment, with no sockets, files or parsing. Two parts live in the segment:
+ *
+ *   - a snapshot of up to snapshot_capacity doubles, published under a seqlock.
+ *     The producer overwrites it whenever it likes, readers always see a
+ *     consistent set of values (e.g. current FPS, tick time, player count);
+ *   - a single-producer single-consumer ring of fixed-size records for events
+ *     that must not be lost between overlay frames. When the ring is full the
+ *     producer drops the record and counts it, it never waits for the reader.
+ *
+ * Producer usage:
+ *
+ *   #include "godoverit_telemetry.h"
+ *
+ *   godoverit_telemetry channel;
+ *   if (godoverit_telemetry_open(&channel, "game_stats", 16, 1024, 32) == 0) {
+ *       double values[2] = { fps, tick_ms };
+ *       godoverit_telemetry_write_snapshot(&channel, values, 2);
+ *       godoverit_telemetry_push(&channel, &event, sizeof(event));
+ *       godoverit_telemetry_close(&channel, 1);
+ *   }
+ *
+ * In Godot: overlay.open_telemetry("game_stats", 16, 1024, 32), then
+ * get_telemetry_snapshot() and drain_telemetry() each frame.
+ *
+ * Either side may create the segment, both must pass the same capacities.
+ * On Linux link with -lrt when the C library is older than glibc 2.34.
+ */
+
+#ifndef GODOVERIT_TELEMETRY_H
+#define GODOVERIT_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GODOVERIT_TELEMETRY_MAGIC 0x4D4C4554u /* "TELM" */
+#define GODOVERIT_TELEMETRY_VERSION 1u
+#define GODOVERIT_TELEMETRY_NAME_MAX 64
+
+/* Fixed layout, each side's hot fields on their own cache line */
+typedef struct godoverit_telemetry_header {
+    /* 0: written once by the creator, magic last */
+    uint32_t magic;
+    uint32_t version;
+    uint32_t snapshot_capacity; /* doubles */
+    uint32_t ring_capacity; /* records, power of two */
+    uint32_t record_size; /* bytes, multiple of 8 */
+    uint32_t reserved;
+    uint8_t pad0[40];
+
+    /* 64: snapshot seqlock, odd while the producer writes */
+    uint64_t snapshot_sequence;
+    uint32_t snapshot_count;
+    uint8_t pad1[52];
+
+    /* 128: producer side of the ring */
+    uint64_t ring_head;
+    uint64_t ring_dropped;
+    uint8_t pad2[48];
+
+    /* 192: consumer side of the ring */
+    uint64_t ring_tail;
+    uint8_t pad3[56];
+} godoverit_telemetry_header;
+
+typedef struct godoverit_telemetry {
+    godoverit_telemetry_header *header;
+    double *snapshot;
+    uint8_t *records;
+    size_t size;
+    int created;
+    char name[GODOVERIT_TELEMETRY_NAME_MAX + 16];
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+} godoverit_telemetry;
+
+/* Atomics on plain fields, so producers need no C11 or C++ runtime */
+#if defined(_MSC_VER) && !defined(__clang__)
+static __inline uint64_t godoverit__load_acquire(const volatile uint64_t *p) {
+    uint64_t value = *p;
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+    _ReadWriteBarrier();
+    return value;
+}
+static __inline uint64_t godoverit__load_relaxed(const volatile uint64_t *p) {
+    return *p;
+}
+static __inline void godoverit__store_release(volatile uint64_t *p, uint64_t value) {
+    _ReadWriteBarrier();
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+    *p = value;
+}
+static __inline void godoverit__fence_acquire(void) {
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+    _ReadWriteBarrier();
+}
+static __inline void godoverit__fence_release(void) {
+    _ReadWriteBarrier();
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+}
+#else
+static inline uint64_t godoverit__load_acquire(const uint64_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+static inline uint64_t godoverit__load_relaxed(const uint64_t *p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+static inline void godoverit__store_release(uint64_t *p, uint64_t value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+static inline void godoverit__fence_acquire(void) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+static inline void godoverit__fence_release(void) {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+#endif
+
+static inline size_t godoverit_telemetry_segment_size(uint32_t snapshot_capacity, uint32_t ring_capacity, uint32_t record_size) {
+    return sizeof(godoverit_telemetry_header) + (size_t)snapshot_capacity * sizeof(double) + (size_t)ring_capacity * record_size;
+}
+
+static inline int godoverit_telemetry__check(const godoverit_telemetry_header *header, uint32_t snapshot_capacity,
+        uint32_t ring_capacity, uint32_t record_size) {
+    return header->version == GODOVERIT_TELEMETRY_VERSION && header->snapshot_capacity == snapshot_capacity &&
+            header->ring_capacity == ring_capacity && header->record_size == record_size;
+}
+
+/*
+ * Create or open the segment called name (letters, digits, '_' and '-').
+ * ring_capacity must be a power of two, record_size a multiple of 8.
+ * Returns 0 on success, -1 on failure, -2 while the creator is still initializing.
+ */
+static inline int godoverit_telemetry_open(godoverit_telemetry *channel, const char *name, uint32_t snapshot_capacity,
+        uint32_t ring_capacity, uint32_t record_size) {
+    size_t size = godoverit_telemetry_segment_size(snapshot_capacity, ring_capacity, record_size);
+    void *base = NULL;
+    godoverit_telemetry_header *header;
+    uint32_t i;
+
+    memset(channel, 0, sizeof(*channel));
+    if (!name || !name[0] || strlen(name) > GODOVERIT_TELEMETRY_NAME_MAX || ring_capacity == 0 ||
+            (ring_capacity & (ring_capacity - 1)) != 0 || record_size == 0 || (record_size & 7) != 0) {
+        return -1;
+    }
+    for (i = 0; name[i]; i++) {
+        char c = name[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+            return -1;
+        }
+    }
+
+#ifdef _WIN32
+    snprintf(channel->name, sizeof(channel->name), "Local\\godoverit_%s", name);
+    channel->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+            (DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xFFFFFFFFu), channel->name);
+    if (!channel->mapping) {
+        return -1;
+    }
+    channel->created = GetLastError() != ERROR_ALREADY_EXISTS;
+    base = MapViewOfFile(channel->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!base) {
+        CloseHandle(channel->mapping);
+        channel->mapping = NULL;
+        return -1;
+    }
+#else
+    {
+        int fd;
+        struct stat info;
+        snprintf(channel->name, sizeof(channel->name), "/godoverit_%s", name);
+        fd = shm_open(channel->name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            channel->created = 1;
+            if (ftruncate(fd, (off_t)size) != 0) {
+                close(fd);
+                shm_unlink(channel->name);
+                return -1;
+            }
+        } else if (errno == EEXIST) {
+            fd = shm_open(channel->name, O_RDWR, 0600);
+            if (fd < 0) {
+                return -1;
+            }
+            /* The creator truncates right after creating, until then there is nothing to map */
+            if (fstat(fd, &info) != 0 || (size_t)info.st_size < size) {
+                close(fd);
+                return -2;
+            }
+        } else {
+            return -1;
+        }
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            if (channel->created) {
+                shm_unlink(channel->name);
+            }
+            return -1;
+        }
+    }
+#endif
+
+    header = (godoverit_telemetry_header *)base;
+    if (channel->created) {
+        /* New mappings are zero filled, only the description needs writing */
+        header->version = GODOVERIT_TELEMETRY_VERSION;
+        header->snapshot_capacity = snapshot_capacity;
+        header->ring_capacity = ring_capacity;
+        header->record_size = record_size;
+        godoverit__fence_release();
+        *(volatile uint32_t *)&header->magic = GODOVERIT_TELEMETRY_MAGIC;
+    } else {
+        uint32_t value = *(volatile uint32_t *)&header->magic;
+        godoverit__fence_acquire();
+        if (value != GODOVERIT_TELEMETRY_MAGIC || !godoverit_telemetry__check(header, snapshot_capacity, ring_capacity, record_size)) {
+#ifdef _WIN32
+            UnmapViewOfFile(base);
+            CloseHandle(channel->mapping);
+            channel->mapping = NULL;
+#else
+            munmap(base, size);
+#endif
+            return value == 0 ? -2 : -1;
+        }
+    }
+
+    channel->header = header;
+    channel->snapshot = (double *)((uint8_t *)base + sizeof(godoverit_telemetry_header));
+    channel->records = (uint8_t *)(channel->snapshot + snapshot_capacity);
+    channel->size = size;
+    return 0;
+}
+
+/* Unmap, and remove the name when unlink_segment is set (POSIX, Windows drops it with the last handle) */
+static inline void godoverit_telemetry_close(godoverit_telemetry *channel, int unlink_segment) {
+    if (!channel->header) {
+        return;
+    }
+#ifdef _WIN32
+    (void)unlink_segment;
+    UnmapViewOfFile(channel->header);
+    CloseHandle(channel->mapping);
+    channel->mapping = NULL;
+#else
+    munmap(channel->header, channel->size);
+    if (unlink_segment) {
+        shm_unlink(channel->name);
+    }
+#endif
+    channel->header = NULL;
+    channel->snapshot = NULL;
+    channel->records = NULL;
+}
+
+/* Producer: replace the snapshot with count values (extra values are ignored) */
+static inline void godoverit_telemetry_write_snapshot(godoverit_telemetry *channel, const double *values, uint32_t count) {
+    godoverit_telemetry_header *header = channel->header;
+    uint64_t sequence = godoverit__load_relaxed(&header->snapshot_sequence);
+    if (count > header->snapshot_capacity) {
+        count = header->snapshot_capacity;
+    }
+    godoverit__store_release(&header->snapshot_sequence, sequence + 1);
+    godoverit__fence_release();
+    memcpy(channel->snapshot, values, count * sizeof(double));
+    header->snapshot_count = count;
+    godoverit__store_release(&header->snapshot_sequence, sequence + 2);
+}
+
+/* Producer: whether push would succeed now, for producers that prefer waiting over dropping */
+static inline int godoverit_telemetry_can_push(const godoverit_telemetry *channel) {
+    const godoverit_telemetry_header *header = channel->header;
+    return godoverit__load_relaxed(&header->ring_head) - godoverit__load_acquire(&header->ring_tail) < header->ring_capacity;
+}
+
+/* Producer: append a record, shorter ones are zero padded. Returns 0 when the ring was full. */
+static inline int godoverit_telemetry_push(godoverit_telemetry *channel, const void *record, uint32_t size) {
+    godoverit_telemetry_header *header = channel->header;
+    uint64_t head = godoverit__load_relaxed(&header->ring_head);
+    uint64_t tail = godoverit__load_acquire(&header->ring_tail);
+    uint8_t *slot;
+    if (head - tail >= header->ring_capacity) {
+        godoverit__store_release(&header->ring_dropped, godoverit__load_relaxed(&header->ring_dropped) + 1);
+        return 0;
+    }
+    slot = channel->records + (size_t)(head & (header->ring_capacity - 1)) * header->record_size;
+    if (size > header->record_size) {
+        size = header->record_size;
+    }
+    memcpy(slot, record, size);
+    memset(slot + size, 0, header->record_size - size);
+    godoverit__store_release(&header->ring_head, head + 1);
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GODOVERIT_TELEMETRY_H */
@@ -0,0 +1,92 @@
+#ifndef CAPTURE_SURFACE_H
+#define CAPTURE_SURFACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+// Native memory a screen grab lands in (a shared memory segment, a DIB section).
+// Creating one costs system calls and page faults, so they are kept and reused.
+class CaptureSurface {
+public:
+    virtual ~CaptureSurface() {}
+
+    // Whether a grab of this size fits without reallocating
+    virtual bool fits(int32_t width, int32_t height) const = 0;
+    virtual size_t get_bytes() const = 0;
+};
+
+// Pixels of the last grab into a surface: 32-bit BGRX rows, stride bytes apart.
+// Valid until the next grab into the same surface. x and y are the screen position
+// of the first pixel, which moves when the requested rectangle was clipped.
+struct CaptureFrame {
+    const uint8_t *pixels = nullptr;
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t stride = 0;
+};
+
+// Small free list of surfaces. Regions that shrink, grow or go away hand their
+// surface back, and the next request takes the smallest one that fits.
+class CaptureSurfacePool {
+public:
+    static constexpr size_t MAX_FREE = 4;
+
+    // Null when nothing in the pool fits
+    std::unique_ptr<CaptureSurface> acquire(int32_t width, int32_t height) {
+        size_t best = free_surfaces.size();
+        for (size_t i = 0; i < free_surfaces.size(); i++) {
+            if (free_surfaces[i]->fits(width, height) &&
+                    (best == free_surfaces.size() || free_surfaces[i]->get_bytes() < free_surfaces[best]->get_bytes())) {
+                best = i;
+            }
+        }
+        if (best == free_surfaces.size()) {
+            misses++;
+            return nullptr;
+        }
+        std::unique_ptr<CaptureSurface> surface = std::move(free_surfaces[best]);
+        free_surfaces.erase(free_surfaces.begin() + best);
+        hits++;
+        return surface;
+    }
+
+    // The oldest surface is dropped when the pool is full
+    void release(std::unique_ptr<CaptureSurface> surface) {
+        if (!surface) {
+            return;
+        }
+        if (free_surfaces.size() >= MAX_FREE) {
+            free_surfaces.erase(free_surfaces.begin());
+        }
+        free_surfaces.push_back(std::move(surface));
+    }
+
+    void clear() {
+        free_surfaces.clear();
+    }
+
+    size_t get_free_count() const {
+        return free_surfaces.size();
+    }
+    uint64_t get_hits() const {
+        return hits;
+    }
+    uint64_t get_misses() const {
+        return misses;
+    }
+
+private:
+    std::vector<std::unique_ptr<CaptureSurface>> free_surfaces;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+} // namespace godot
+
+#endif // CAPTURE_SURFACE_H
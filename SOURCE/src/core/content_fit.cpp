@@ -0,0 +1,212 @@
+#include "content_fit.h"
+
+#include <algorithm>
+
+namespace godot {
+
+RegionRect union_rects(const RegionRect &a, const RegionRect &b) {
+    if (a.is_empty()) {
+        return b;
+    }
+    if (b.is_empty()) {
+        return a;
+    }
+    int32_t left = std::min(a.x, b.x);
+    int32_t top = std::min(a.y, b.y);
+    int32_t right = std::max(a.x + a.width, b.x + b.width);
+    int32_t bottom = std::max(a.y + a.height, b.y + b.height);
+    return { left, top, right - left, bottom - top };
+}
+
+bool contains_rect(const RegionRect &outer, const RegionRect &inner) {
+    if (inner.is_empty()) {
+        return true;
+    }
+    return inner.x >= outer.x && inner.y >= outer.y &&
+            inner.x + inner.width <= outer.x + outer.width &&
+            inner.y + inner.height <= outer.y + outer.height;
+}
+
+bool ContentBounds::touches_edge(const RegionRect &rect) const {
+    return rect.x == bounds.x || rect.y == bounds.y ||
+            rect.x + rect.width == bounds.x + bounds.width ||
+            rect.y + rect.height == bounds.y + bounds.height;
+}
+
+void ContentBounds::set_rect(uint64_t id, const RegionRect &rect) {
+    if (rect.is_empty()) {
+        remove(id);
+        return;
+    }
+
+    auto it = rects.find(id);
+    if (it != rects.end()) {
+        if (it->second == rect) {
+            return;
+        }
+        // The old rectangle may have been the one holding an edge out
+        if (!stale && touches_edge(it->second) && !contains_rect(rect, it->second)) {
+            stale = true;
+        }
+        it->second = rect;
+    } else {
+        rects.emplace(id, rect);
+    }
+    if (!stale) {
+        bounds = union_rects(bounds, rect);
+    }
+}
+
+void ContentBounds::remove(uint64_t id) {
+    auto it = rects.find(id);
+    if (it == rects.end()) {
+        return;
+    }
+    if (!stale && touches_edge(it->second)) {
+        stale = true;
+    }
+    rects.erase(it);
+    if (rects.empty()) {
+        bounds = RegionRect();
+        stale = false;
+    }
+}
+
+void ContentBounds::clear() {
+    rects.clear();
+    bounds = RegionRect();
+    stale = false;
+}
+
+const RegionRect &ContentBounds::get_bounds() {
+    if (stale) {
+        bounds = RegionRect();
+        for (const auto &entry : rects) {
+            bounds = union_rects(bounds, entry.second);
+        }
+        stale = false;
+        recomputes++;
+    }
+    return bounds;
+}
+
+void WindowFit::set_frame(int32_t width, int32_t height) {
+    // A moved frame keeps the fit, a resized one lays content out anew
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    if (width == frame_width && height == frame_height) {
+        return;
+    }
+    frame_width = width;
+    frame_height = height;
+    rect = { 0, 0, frame_width, frame_height };
+    shrink_pending = false;
+}
+
+void WindowFit::set_margin(int32_t pixels) {
+    margin = std::max(pixels, 0);
+}
+
+void WindowFit::set_snap(int32_t pixels) {
+    snap = std::max(pixels, 1);
+}
+
+RegionRect WindowFit::get_target(const RegionRect &content, int32_t padding) const {
+    // Nothing to show keeps one grid cell where the window is, it is never zero sized
+    if (content.is_empty()) {
+        int32_t width = std::min(snap, frame_width);
+        int32_t height = std::min(snap, frame_height);
+        return { std::min(rect.x, frame_width - width), std::min(rect.y, frame_height - height), width, height };
+    }
+
+    // Floor and ceil to the grid, negative coordinates included
+    auto snap_down = [this](int32_t value) {
+        return value - ((value % snap) + snap) % snap;
+    };
+    auto snap_up = [&](int32_t value) {
+        int32_t down = snap_down(value);
+        return down == value ? value : down + snap;
+    };
+    int32_t left = std::max(snap_down(content.x - padding), 0);
+    int32_t top = std::max(snap_down(content.y - padding), 0);
+    int32_t right = std::min(snap_up(content.x + content.width + padding), frame_width);
+    int32_t bottom = std::min(snap_up(content.y + content.height + padding), frame_height);
+
+    // Content entirely outside the frame is clipped away, keep a cell at the nearest edge
+    left = std::min(left, frame_width - 1);
+    top = std::min(top, frame_height - 1);
+    right = std::max(right, left + 1);
+    bottom = std::max(bottom, top + 1);
+    return { left, top, right - left, bottom - top };
+}
+
+bool WindowFit::update(const RegionRect &content, uint64_t now_usec) {
+    if (last_update_usec != 0 && now_usec > last_update_usec) {
+        uint64_t elapsed = now_usec - last_update_usec;
+        stats.area_usec += uint64_t(rect.width) * rect.height * elapsed;
+        stats.frame_area_usec += uint64_t(frame_width) * frame_height * elapsed;
+    }
+    last_update_usec = now_usec;
+    stats.updates++;
+
+    // Content must never be cut off, grow now and keep what was covered
+    RegionRect grow_target = get_target(content, margin);
+    if (!contains_rect(rect, grow_target)) {
+        rect = union_rects(rect, grow_target);
+        if (shrink_pending) {
+            shrink_pending = false;
+            stats.shrinks_abandoned++;
+        }
+        stats.grows++;
+        return true;
+    }
+
+    // Shrinking stops short of where growing starts, never past the current window
+    RegionRect wide = get_target(content, margin * 2);
+    int32_t left = std::max(wide.x, rect.x);
+    int32_t top = std::max(wide.y, rect.y);
+    int32_t right = std::min(wide.x + wide.width, rect.x + rect.width);
+    int32_t bottom = std::min(wide.y + wide.height, rect.y + rect.height);
+    RegionRect target = { left, top, right - left, bottom - top };
+    if (!shrink_pending) {
+        if (target != rect) {
+            shrink_pending = true;
+            shrink_since_usec = now_usec;
+            shrink_rect = target;
+        }
+        return false;
+    }
+
+    // Jittering content widens the waiting shrink instead of restarting it
+    shrink_rect = union_rects(shrink_rect, target);
+    if (shrink_rect == rect) {
+        shrink_pending = false;
+        stats.shrinks_abandoned++;
+        return false;
+    }
+    if (now_usec - shrink_since_usec < shrink_delay_usec) {
+        return false;
+    }
+    rect = shrink_rect;
+    shrink_pending = false;
+    stats.shrinks++;
+    return true;
+}
+
+double WindowFit::get_area_saved() const {
+    double frame_area = double(frame_width) * frame_height;
+    return frame_area > 0.0 ? 1.0 - double(rect.width) * rect.height / frame_area : 0.0;
+}
+
+double WindowFit::get_mean_area_saved() const {
+    if (stats.frame_area_usec == 0) {
+        return get_area_saved();
+    }
+    return 1.0 - double(stats.area_usec) / double(stats.frame_area_usec);
+}
+
+void WindowFit::reset_stats() {
+    stats = Stats();
+}
+
+} // namespace godot
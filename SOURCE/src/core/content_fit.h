@@ -0,0 +1,126 @@
+#ifndef CONTENT_FIT_H
+#define CONTENT_FIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "input_region.h"
+
+namespace godot {
+
+// Union bounding box of content rectangles, kept current as single rectangles move.
+// Growing is folded in directly; the union is only recomputed from every rectangle
+// when one that touched its edge shrank or went away.
+class ContentBounds {
+public:
+    // Insert or move a rectangle, an empty rectangle removes it
+    void set_rect(uint64_t id, const RegionRect &rect);
+    void remove(uint64_t id);
+    void clear();
+
+    // Empty when there is no content
+    const RegionRect &get_bounds();
+
+    size_t get_rect_count() const {
+        return rects.size();
+    }
+    uint64_t get_recompute_count() const {
+        return recomputes;
+    }
+
+private:
+    bool touches_edge(const RegionRect &rect) const;
+
+    std::unordered_map<uint64_t, RegionRect> rects;
+    RegionRect bounds;
+    bool stale = false;
+    uint64_t recomputes = 0;
+};
+
+// Smallest rectangle containing both, either may be empty
+RegionRect union_rects(const RegionRect &a, const RegionRect &b);
+
+// True when outer covers all of inner, an empty inner is always covered
+bool contains_rect(const RegionRect &outer, const RegionRect &inner);
+
+// Window rectangle around content inside a larger frame, the area the window would
+// cover without fitting. The content box is padded by the margin and snapped outward
+// to the snap grid, so content moving a few pixels keeps the same window. Content
+// leaving the window grows it at once; a window larger than its content only shrinks
+// after staying larger for the shrink delay, to the largest box seen meanwhile. Shrinks
+// keep twice the margin, so content hovering at a grid line does not flip between two
+// sizes. Everything runs on the main thread.
+class WindowFit {
+public:
+    struct Stats {
+        uint64_t updates = 0;
+        uint64_t grows = 0;
+        uint64_t shrinks = 0;
+        uint64_t shrinks_abandoned = 0; // Waiting shrinks given up because content grew back
+        uint64_t area_usec = 0; // Window area integrated over time, for the mean
+        uint64_t frame_area_usec = 0;
+    };
+
+    // Frame size in window pixels. A new size starts the window out covering all of it,
+    // the same size keeps the current fit.
+    void set_frame(int32_t width, int32_t height);
+    int32_t get_frame_width() const {
+        return frame_width;
+    }
+    int32_t get_frame_height() const {
+        return frame_height;
+    }
+
+    void set_margin(int32_t pixels);
+    int32_t get_margin() const {
+        return margin;
+    }
+    void set_snap(int32_t pixels);
+    int32_t get_snap() const {
+        return snap;
+    }
+    void set_shrink_delay_usec(uint64_t usec) {
+        shrink_delay_usec = usec;
+    }
+    uint64_t get_shrink_delay_usec() const {
+        return shrink_delay_usec;
+    }
+
+    // Fit to the content bounds in frame pixels, true when the window rectangle changed
+    bool update(const RegionRect &content, uint64_t now_usec);
+
+    // Window rectangle in frame pixels
+    const RegionRect &get_rect() const {
+        return rect;
+    }
+
+    // Fraction of the frame the window does not cover, now and averaged over time
+    double get_area_saved() const;
+    double get_mean_area_saved() const;
+
+    const Stats &get_stats() const {
+        return stats;
+    }
+    void reset_stats();
+
+private:
+    RegionRect get_target(const RegionRect &content, int32_t padding) const;
+
+    int32_t frame_width = 0;
+    int32_t frame_height = 0;
+    int32_t margin = 16;
+    int32_t snap = 32;
+    uint64_t shrink_delay_usec = 500000;
+
+    RegionRect rect;
+    bool shrink_pending = false;
+    uint64_t shrink_since_usec = 0;
+    RegionRect shrink_rect; // Union of the targets seen while the shrink waits
+    uint64_t last_update_usec = 0;
+    Stats stats;
+};
+
+} // namespace godot
+
+#endif // CONTENT_FIT_H
@@ -0,0 +1,94 @@
+#include "dirty_tiles.h"
+
+#include <cstring>
+
+namespace godot {
+
+DirtyTiles::DirtyTiles(int32_t p_tile_size) :
+        tile_size(p_tile_size > 0 ? p_tile_size : 64) {}
+
+void DirtyTiles::reset(int32_t p_width, int32_t p_height) {
+    width = p_width > 0 ? p_width : 0;
+    height = p_height > 0 ? p_height : 0;
+    columns = (width + tile_size - 1) / tile_size;
+    rows = (height + tile_size - 1) / tile_size;
+    previous.assign(static_cast<size_t>(width) * height * 4, 0);
+    dirty.assign(columns, 0);
+    full = true;
+}
+
+void DirtyTiles::invalidate() {
+    full = true;
+}
+
+size_t DirtyTiles::diff(const uint8_t *pixels, size_t stride, std::vector<RegionRect> &r_rects) {
+    r_rects.clear();
+    size_t row_bytes = static_cast<size_t>(width) * 4;
+    if (full) {
+        for (int32_t y = 0; y < height; y++) {
+            memcpy(previous.data() + y * row_bytes, pixels + y * stride, row_bytes);
+        }
+        full = false;
+        if (width > 0 && height > 0) {
+            r_rects.push_back({ 0, 0, width, height });
+        }
+        return get_tile_count();
+    }
+
+    size_t changed = 0;
+    open_rects.clear();
+    for (int32_t row = 0; row < rows; row++) {
+        int32_t top = row * tile_size;
+        int32_t bottom = top + tile_size < height ? top + tile_size : height;
+        memset(dirty.data(), 0, dirty.size());
+
+        // Once a tile differs its remaining rows are copied without comparing
+        for (int32_t y = top; y < bottom; y++) {
+            const uint8_t *source = pixels + y * stride;
+            uint8_t *kept = previous.data() + y * row_bytes;
+            for (int32_t column = 0; column < columns; column++) {
+                size_t offset = static_cast<size_t>(column) * tile_size * 4;
+                size_t bytes = column == columns - 1 ? row_bytes - offset : static_cast<size_t>(tile_size) * 4;
+                if (dirty[column] || memcmp(source + offset, kept + offset, bytes) != 0) {
+                    dirty[column] = 1;
+                    memcpy(kept + offset, source + offset, bytes);
+                }
+            }
+        }
+
+        // Runs of changed tiles, a rectangle that ended on the row above with the
+        // same columns grows downwards instead of starting a new one
+        next_open_rects.clear();
+        for (int32_t column = 0; column < columns;) {
+            if (!dirty[column]) {
+                column++;
+                continue;
+            }
+            int32_t first = column;
+            while (column < columns && dirty[column]) {
+                column++;
+            }
+            changed += column - first;
+            int32_t left = first * tile_size;
+            int32_t right = column * tile_size < width ? column * tile_size : width;
+
+            size_t index = r_rects.size();
+            for (size_t open : open_rects) {
+                if (r_rects[open].x == left && r_rects[open].width == right - left) {
+                    index = open;
+                    break;
+                }
+            }
+            if (index == r_rects.size()) {
+                r_rects.push_back({ left, top, right - left, bottom - top });
+            } else {
+                r_rects[index].height = bottom - r_rects[index].y;
+            }
+            next_open_rects.push_back(index);
+        }
+        open_rects.swap(next_open_rects);
+    }
+    return changed;
+}
+
+} // namespace godot
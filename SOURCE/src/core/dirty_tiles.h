@@ -0,0 +1,54 @@
+#ifndef DIRTY_TILES_H
+#define DIRTY_TILES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "input_region.h"
+
+namespace godot {
+
+// Finds the parts of a 32-bit frame that changed since the previous one, in square tiles.
+// Keeps a copy of the last frame, compares it row by row per tile and refreshes the copy
+// only where a tile differs. Changed tiles are merged into runs along each tile row and
+// runs spanning the same columns into taller rectangles, a full redraw is one rectangle.
+class DirtyTiles {
+public:
+    explicit DirtyTiles(int32_t tile_size = 64);
+
+    // Start over at a new size, the next diff reports the whole frame
+    void reset(int32_t width, int32_t height);
+    void invalidate();
+
+    int32_t get_width() const {
+        return width;
+    }
+    int32_t get_height() const {
+        return height;
+    }
+
+    // Compare a frame of the reset size, replace r_rects with the changed rectangles.
+    // Returns the number of changed tiles.
+    size_t diff(const uint8_t *pixels, size_t stride, std::vector<RegionRect> &r_rects);
+
+    size_t get_tile_count() const {
+        return static_cast<size_t>(columns) * rows;
+    }
+
+private:
+    int32_t tile_size;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t columns = 0;
+    int32_t rows = 0;
+    bool full = true; // Next diff reports everything without comparing
+    std::vector<uint8_t> previous;
+    std::vector<uint8_t> dirty; // Per column of the tile row being compared
+    std::vector<size_t> open_rects; // Rectangles reaching the bottom of the previous tile row
+    std::vector<size_t> next_open_rects;
+};
+
+} // namespace godot
+
+#endif // DIRTY_TILES_H
@@ -0,0 +1,82 @@
+#include "frame_pacer.h"
+
+namespace godot {
+
+void FramePacer::set_enabled(bool p_enabled) {
+    enabled = p_enabled;
+    if (!enabled) {
+        wake_until_usec = 0;
+    }
+}
+
+void FramePacer::wake(uint64_t now_usec) {
+    if (now_usec >= wake_until_usec) {
+        stats.wakeups++;
+    }
+    wake_until_usec = now_usec + wake_duration_usec;
+}
+
+bool FramePacer::update(uint64_t now_usec, bool active, bool visible, bool passthrough) {
+    if (wake_requested.exchange(false, std::memory_order_acquire)) {
+        wake(now_usec);
+    }
+
+    Mode next = MODE_FULL;
+    if (enabled && active) {
+        if (!visible) {
+            next = MODE_SUSPENDED; // Nothing to see, waking does not help
+        } else if (passthrough && now_usec >= wake_until_usec) {
+            next = MODE_IDLE;
+        }
+    }
+
+    if (next == mode) {
+        return false;
+    }
+    mode = next;
+    stats.mode_changes++;
+    return true;
+}
+
+void FramePacer::record_frame(uint64_t now_usec, uint64_t frames_drawn, double refresh_rate) {
+    if (last_frame_usec == 0) {
+        last_frame_usec = now_usec;
+        last_frames_drawn = frames_drawn;
+        return;
+    }
+
+    uint64_t elapsed_usec = now_usec - last_frame_usec;
+    uint64_t drawn = frames_drawn - last_frames_drawn;
+    last_frame_usec = now_usec;
+    last_frames_drawn = frames_drawn;
+
+    stats.frames_drawn += drawn;
+    stats.mode_usec[mode] += elapsed_usec;
+
+    // Full rate is the baseline, only reduced modes count toward the savings
+    if (mode != MODE_FULL && refresh_rate > 0.0) {
+        double expected = elapsed_usec * refresh_rate / 1000000.0;
+        if (expected > drawn) {
+            stats.frames_skipped += expected - drawn;
+        }
+    }
+}
+
+void FramePacer::reset_stats() {
+    stats = Stats();
+}
+
+const char *FramePacer::get_mode_name(Mode p_mode) {
+    switch (p_mode) {
+        case MODE_FULL:
+            return "full";
+        case MODE_IDLE:
+            return "idle";
+        case MODE_SUSPENDED:
+            return "suspended";
+        default:
+            return "unknown";
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,82 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace godot {
+
+// Picks how fast the overlay should render from its visibility and passthrough state.
+// Hidden overlays stop rendering, passive passthrough overlays drop to an idle rate,
+// and any interaction or hotkey returns to full rate for a short while.
+// Only the frame methods run on the main thread, request_wake may be called from any thread.
+class FramePacer {
+public:
+    enum Mode : uint8_t {
+        MODE_FULL, // Engine settings as the project configured them
+        MODE_IDLE, // Low processor mode, frames only drawn when content changes
+        MODE_SUSPENDED, // Render loop stopped, the main loop only polls for input
+        MODE_COUNT,
+    };
+
+    struct Stats {
+        uint64_t frames_drawn = 0;
+        uint64_t wakeups = 0;
+        uint64_t mode_changes = 0;
+        uint64_t mode_usec[MODE_COUNT] = {};
+        // Frames the display would have shown at full rate but were not drawn
+        double frames_skipped = 0.0;
+    };
+
+    void set_enabled(bool enabled);
+    bool is_enabled() const {
+        return enabled;
+    }
+
+    // How long full rate is kept after a wake before going idle again
+    void set_wake_duration_usec(uint64_t usec) {
+        wake_duration_usec = usec;
+    }
+    uint64_t get_wake_duration_usec() const {
+        return wake_duration_usec;
+    }
+
+    // Return to full rate now, main thread only
+    void wake(uint64_t now_usec);
+
+    // Return to full rate on the next update, safe from input threads
+    void request_wake() {
+        wake_requested.store(true, std::memory_order_release);
+    }
+
+    // Choose the mode for the coming frame, true when it differs from the previous one
+    bool update(uint64_t now_usec, bool active, bool visible, bool passthrough);
+    Mode get_mode() const {
+        return mode;
+    }
+
+    // Account one main loop iteration. frames_drawn is the engine's running total.
+    void record_frame(uint64_t now_usec, uint64_t frames_drawn, double refresh_rate);
+
+    const Stats &get_stats() const {
+        return stats;
+    }
+    void reset_stats();
+
+    static const char *get_mode_name(Mode mode);
+
+private:
+    bool enabled = true;
+    Mode mode = MODE_FULL;
+    uint64_t wake_duration_usec = 1000000;
+    uint64_t wake_until_usec = 0;
+    std::atomic<bool> wake_requested{ false };
+
+    uint64_t last_frame_usec = 0;
+    uint64_t last_frames_drawn = 0;
+    Stats stats;
+};
+
+} // namespace godot
+
+#endif // FRAME_PACER_H
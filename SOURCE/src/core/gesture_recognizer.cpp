@@ -0,0 +1,269 @@
+#include "gesture_recognizer.h"
+
+#include <algorithm>
+
+namespace godot {
+
+namespace {
+
+inline bool step_matches(const GestureRecognizer::Step &step, uint16_t key, uint8_t modifiers) {
+    return step.keycode == key && step.modifiers == modifiers;
+}
+
+} // namespace
+
+GestureRecognizer::GestureRecognizer() {
+    clear();
+}
+
+void GestureRecognizer::clear() {
+    gestures.clear();
+    key_gesture_list.clear();
+    for (uint32_t &start : key_gesture_start) {
+        start = 0;
+    }
+    active.clear();
+    wheel.clear();
+    for (uint64_t &word : held_keys) {
+        word = 0;
+    }
+    previous_modifiers = 0;
+}
+
+int GestureRecognizer::compile(const Gesture *p_gestures, size_t count) {
+    clear();
+
+    int rejected = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Gesture &gesture = p_gestures[i];
+        bool valid = !gesture.steps.empty() && gesture.steps.size() <= 255;
+        for (const Step &step : gesture.steps) {
+            valid = valid && step.keycode < KeybindTable::KEY_SLOTS && step.modifiers < KeybindTable::MODIFIER_COMBINATIONS;
+        }
+        if (!valid) {
+            rejected++;
+            continue;
+        }
+        Machine machine;
+        machine.gesture = gesture;
+        if (gesture.kind != KIND_SEQUENCE) {
+            machine.gesture.steps.resize(1);
+        }
+        gestures.push_back(std::move(machine));
+    }
+
+    // Counting sort of (key, gesture) pairs, a gesture is listed once per distinct key
+    std::vector<std::pair<uint16_t, uint32_t>> pairs;
+    for (uint32_t index = 0; index < gestures.size(); index++) {
+        for (const Step &step : gestures[index].gesture.steps) {
+            pairs.emplace_back(step.keycode, index);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    for (const std::pair<uint16_t, uint32_t> &pair : pairs) {
+        key_gesture_start[pair.first + 1]++;
+    }
+    for (int key = 0; key < KeybindTable::KEY_SLOTS; key++) {
+        key_gesture_start[key + 1] += key_gesture_start[key];
+    }
+    key_gesture_list.reserve(pairs.size());
+    for (const std::pair<uint16_t, uint32_t> &pair : pairs) {
+        key_gesture_list.push_back(pair.second);
+    }
+    active.reserve(gestures.size());
+    return rejected;
+}
+
+void GestureRecognizer::process(const KeyEvent &event, std::vector<Result> &r_results) {
+    // Whatever timed out before this record happened first
+    advance(event.timestamp_usec, r_results);
+
+    const uint16_t key = use_scancodes ? event.scancode : event.keycode;
+    const bool pressed = event.flags & KEY_EVENT_PRESSED;
+    const bool is_modifier = modifier_keys.is_modifier(event.keycode);
+    const uint8_t modifiers = is_modifier ? previous_modifiers : event.modifiers;
+    previous_modifiers = event.modifiers;
+
+    if (key >= KeybindTable::KEY_SLOTS) {
+        // Not a key any gesture can use, but a press still interrupts
+        if (pressed && !is_modifier) {
+            for (size_t i = active.size(); i > 0; i--) {
+                if (!expects(gestures[active[i - 1]], key, modifiers)) {
+                    enter(active[i - 1], STATE_IDLE);
+                }
+            }
+        }
+        return;
+    }
+
+    uint64_t &held_word = held_keys[key >> 6];
+    const uint64_t held_bit = uint64_t(1) << (key & 63);
+    const uint32_t *first = key_gesture_list.data() + key_gesture_start[key];
+    const uint32_t *last = key_gesture_list.data() + key_gesture_start[key + 1];
+
+    if (!pressed) {
+        held_word &= ~held_bit;
+        for (const uint32_t *index = first; index != last; index++) {
+            on_release(*index, event.timestamp_usec, r_results);
+        }
+        return;
+    }
+
+    // Auto-repeat never advances a gesture
+    if (held_word & held_bit) {
+        return;
+    }
+    held_word |= held_bit;
+
+    if (!is_modifier) {
+        for (size_t i = active.size(); i > 0; i--) {
+            if (!expects(gestures[active[i - 1]], key, modifiers)) {
+                enter(active[i - 1], STATE_IDLE);
+            }
+        }
+    }
+    for (const uint32_t *index = first; index != last; index++) {
+        on_press(*index, key, modifiers, event.timestamp_usec, r_results);
+    }
+}
+
+void GestureRecognizer::advance(uint64_t now_usec, std::vector<Result> &r_results) {
+    wheel.advance(now_usec, [this, &r_results](uint32_t index, uint64_t deadline_usec) {
+        gestures[index].timer = TimerWheel::INVALID_TIMER;
+        on_timeout(index, deadline_usec, r_results);
+    });
+}
+
+void GestureRecognizer::reset(uint64_t now_usec, std::vector<Result> &r_results) {
+    while (!active.empty()) {
+        const uint32_t index = active.back();
+        if (gestures[index].state == STATE_ACTIVE) {
+            r_results.push_back({ gestures[index].gesture.action, PHASE_RELEASED, now_usec });
+        }
+        enter(index, STATE_IDLE);
+    }
+    for (uint64_t &word : held_keys) {
+        word = 0;
+    }
+    previous_modifiers = 0;
+
+    // Nothing is armed any more, the clock starts over with the next record
+    wheel.clear();
+}
+
+bool GestureRecognizer::expects(const Machine &machine, uint16_t key, uint8_t modifiers) const {
+    switch (machine.state) {
+        case STATE_ACTIVE:
+            return true; // Other keys may be used while a hold is active
+        case STATE_WAITING:
+            return step_matches(machine.gesture.steps[0], key, modifiers) ||
+                    (machine.gesture.kind == KIND_SEQUENCE && step_matches(machine.gesture.steps[machine.step], key, modifiers));
+        default:
+            return false;
+    }
+}
+
+void GestureRecognizer::on_press(uint32_t index, uint16_t key, uint8_t modifiers, uint64_t timestamp_usec, std::vector<Result> &r_results) {
+    Machine &machine = gestures[index];
+    const Gesture &gesture = machine.gesture;
+
+    switch (gesture.kind) {
+        case KIND_HOLD:
+            if (machine.state == STATE_IDLE && step_matches(gesture.steps[0], key, modifiers)) {
+                enter(index, STATE_PRESSED);
+                machine.last_usec = timestamp_usec;
+                arm(index, timestamp_usec + gesture.duration_usec);
+            }
+            break;
+
+        case KIND_DOUBLE_TAP:
+            if (!step_matches(gesture.steps[0], key, modifiers)) {
+                break;
+            }
+            if (machine.state == STATE_WAITING && timestamp_usec - machine.last_usec < gesture.duration_usec) {
+                r_results.push_back({ gesture.action, PHASE_RECOGNIZED, timestamp_usec });
+                enter(index, STATE_IDLE);
+            } else {
+                enter(index, STATE_WAITING);
+                machine.last_usec = timestamp_usec;
+                arm(index, timestamp_usec + gesture.duration_usec);
+            }
+            break;
+
+        case KIND_SEQUENCE: {
+            const size_t count = gesture.steps.size();
+            if (machine.state == STATE_WAITING && step_matches(gesture.steps[machine.step], key, modifiers) &&
+                    timestamp_usec - machine.last_usec < gesture.duration_usec) {
+                machine.step++;
+            } else if (step_matches(gesture.steps[0], key, modifiers)) {
+                // A fresh start, also when a started sequence went astray on its first key
+                enter(index, STATE_WAITING);
+                machine.step = 1;
+            } else {
+                enter(index, STATE_IDLE);
+                break;
+            }
+            if (machine.step >= count) {
+                r_results.push_back({ gesture.action, PHASE_RECOGNIZED, timestamp_usec });
+                enter(index, STATE_IDLE);
+            } else {
+                machine.last_usec = timestamp_usec;
+                arm(index, timestamp_usec + gesture.duration_usec);
+            }
+            break;
+        }
+    }
+}
+
+void GestureRecognizer::on_release(uint32_t index, uint64_t timestamp_usec, std::vector<Result> &r_results) {
+    Machine &machine = gestures[index];
+    if (machine.gesture.kind != KIND_HOLD) {
+        return;
+    }
+
+    if (machine.state == STATE_PRESSED) {
+        // The threshold passed within the last tick, before its timer could fire
+        if (timestamp_usec - machine.last_usec >= machine.gesture.duration_usec) {
+            r_results.push_back({ machine.gesture.action, PHASE_RECOGNIZED, machine.last_usec + machine.gesture.duration_usec });
+            r_results.push_back({ machine.gesture.action, PHASE_RELEASED, timestamp_usec });
+        }
+        enter(index, STATE_IDLE);
+    } else if (machine.state == STATE_ACTIVE) {
+        r_results.push_back({ machine.gesture.action, PHASE_RELEASED, timestamp_usec });
+        enter(index, STATE_IDLE);
+    }
+}
+
+void GestureRecognizer::on_timeout(uint32_t index, uint64_t deadline_usec, std::vector<Result> &r_results) {
+    Machine &machine = gestures[index];
+    if (machine.state == STATE_PRESSED) {
+        r_results.push_back({ machine.gesture.action, PHASE_RECOGNIZED, deadline_usec });
+        enter(index, STATE_ACTIVE);
+    } else {
+        enter(index, STATE_IDLE);
+    }
+}
+
+void GestureRecognizer::arm(uint32_t index, uint64_t deadline_usec) {
+    Machine &machine = gestures[index];
+    wheel.cancel(machine.timer);
+    machine.timer = wheel.schedule(deadline_usec, index);
+}
+
+void GestureRecognizer::enter(uint32_t index, State state) {
+    Machine &machine = gestures[index];
+    if (state == STATE_IDLE) {
+        if (machine.state != STATE_IDLE) {
+            active.erase(std::find(active.begin(), active.end(), index));
+        }
+        wheel.cancel(machine.timer);
+        machine.timer = TimerWheel::INVALID_TIMER;
+        machine.step = 0;
+    } else if (machine.state == STATE_IDLE) {
+        active.push_back(index);
+    }
+    machine.state = state;
+}
+
+} // namespace godot
@@ -0,0 +1,131 @@
+#ifndef GESTURE_RECOGNIZER_H
+#define GESTURE_RECOGNIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "key_event_queue.h"
+#include "keybind_table.h"
+#include "timer_wheel.h"
+
+namespace godot {
+
+// Key gestures recognized from the hook's timestamped key-down and key-up records.
+// Each gesture is a small state machine, time only comes from record timestamps and
+// from one shared timer wheel, so recognition does not depend on how often it is fed.
+//
+//  HOLD        key held for duration: recognized when it is reached, released on key-up
+//  DOUBLE_TAP  two presses of the key less than duration apart
+//  SEQUENCE    the keys pressed in order, each less than duration after the previous one
+//
+// Auto-repeat presses are ignored. Pressing another key, modifiers aside, interrupts
+// a pending gesture that does not expect it. Modifier keys can be gesture keys too,
+// they are matched against the modifiers held before them. Single thread.
+class GestureRecognizer {
+public:
+    enum Kind : uint8_t {
+        KIND_HOLD,
+        KIND_DOUBLE_TAP,
+        KIND_SEQUENCE,
+    };
+
+    struct Step {
+        uint16_t keycode = 0; // OS keycode, or scancode in physical mode
+        uint8_t modifiers = 0; // KeyModifierMask, matched exactly
+    };
+
+    struct Gesture {
+        Kind kind = KIND_HOLD;
+        uint16_t action = 0;
+        uint64_t duration_usec = 0;
+        std::vector<Step> steps; // Hold and double tap use the first one
+    };
+
+    enum Phase : uint8_t {
+        PHASE_RECOGNIZED,
+        PHASE_RELEASED, // Holds only
+    };
+
+    struct Result {
+        uint16_t action = 0;
+        Phase phase = PHASE_RECOGNIZED;
+        uint64_t timestamp_usec = 0; // When the gesture completed, not when it was noticed
+    };
+
+    GestureRecognizer();
+
+    // Replace every gesture, in-flight state is dropped.
+    // Returns the number of gestures that could not be compiled.
+    int compile(const Gesture *gestures, size_t count);
+    void clear();
+
+    // Keys that only change the modifier mask, they never interrupt a gesture
+    void set_modifier_keys(const ModifierTracker &keys) {
+        modifier_keys = keys;
+    }
+
+    // Match scancodes instead of keycodes
+    void set_use_scancodes(bool enabled) {
+        use_scancodes = enabled;
+    }
+
+    // Feed one hook record, timeouts due before it fire first. Results are appended.
+    void process(const KeyEvent &event, std::vector<Result> &r_results);
+
+    // Fire the timeouts due by now
+    void advance(uint64_t now_usec, std::vector<Result> &r_results);
+
+    // Forget held keys and pending gestures, active holds are released at the given time
+    void reset(uint64_t now_usec, std::vector<Result> &r_results);
+
+    size_t get_gesture_count() const {
+        return gestures.size();
+    }
+    size_t get_pending_timer_count() const {
+        return wheel.get_pending_count();
+    }
+
+private:
+    enum State : uint8_t {
+        STATE_IDLE,
+        STATE_PRESSED, // Hold key down, threshold not reached yet
+        STATE_ACTIVE, // Hold recognized, waiting for key-up
+        STATE_WAITING, // Double tap or sequence waiting for the next press
+    };
+
+    struct Machine {
+        Gesture gesture;
+        State state = STATE_IDLE;
+        uint8_t step = 0; // Next sequence step
+        uint64_t last_usec = 0; // Last press that advanced the machine
+        uint32_t timer = TimerWheel::INVALID_TIMER;
+    };
+
+    std::vector<Machine> gestures;
+    TimerWheel wheel;
+    ModifierTracker modifier_keys;
+    bool use_scancodes = false;
+    uint8_t previous_modifiers = 0; // Mask before the current record
+
+    // Gestures using each key, as ranges into key_gesture_list
+    uint32_t key_gesture_start[KeybindTable::KEY_SLOTS + 1];
+    std::vector<uint32_t> key_gesture_list;
+
+    // Machines out of the idle state, checked for interruption on every press
+    std::vector<uint32_t> active;
+
+    // Held keys, to tell auto-repeat from a new press
+    uint64_t held_keys[KeybindTable::KEY_SLOTS / 64];
+
+    void on_press(uint32_t index, uint16_t key, uint8_t modifiers, uint64_t timestamp_usec, std::vector<Result> &r_results);
+    void on_release(uint32_t index, uint64_t timestamp_usec, std::vector<Result> &r_results);
+    void on_timeout(uint32_t index, uint64_t deadline_usec, std::vector<Result> &r_results);
+    bool expects(const Machine &machine, uint16_t key, uint8_t modifiers) const;
+    void arm(uint32_t index, uint64_t deadline_usec);
+    void enter(uint32_t index, State state);
+};
+
+} // namespace godot
+
+#endif // GESTURE_RECOGNIZER_H
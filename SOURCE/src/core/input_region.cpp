@@ -0,0 +1,213 @@
+#include "input_region.h"
+
+#include <algorithm>
+
+namespace godot {
+
+InputRegionIndex::InputRegionIndex(int32_t cell_size) :
+        cell_size(cell_size > 0 ? cell_size : 128) {
+}
+
+InputRegionIndex::CellRange InputRegionIndex::get_cell_range(const RegionRect &rect) const {
+    // Floor division so negative coordinates land in the right cell
+    auto cell_of = [this](int32_t value) {
+        return value >= 0 ? value / cell_size : -((-value + cell_size - 1) / cell_size);
+    };
+    CellRange range;
+    range.min_x = cell_of(rect.x);
+    range.min_y = cell_of(rect.y);
+    range.max_x = cell_of(rect.x + rect.width - 1);
+    range.max_y = cell_of(rect.y + rect.height - 1);
+    return range;
+}
+
+void InputRegionIndex::insert_into_cells(uint64_t id, const RegionRect &rect) {
+    const CellRange range = get_cell_range(rect);
+    for (int32_t cy = range.min_y; cy <= range.max_y; cy++) {
+        for (int32_t cx = range.min_x; cx <= range.max_x; cx++) {
+            cells[get_cell_key(cx, cy)].push_back(id);
+        }
+    }
+}
+
+void InputRegionIndex::remove_from_cells(uint64_t id, const RegionRect &rect) {
+    const CellRange range = get_cell_range(rect);
+    for (int32_t cy = range.min_y; cy <= range.max_y; cy++) {
+        for (int32_t cx = range.min_x; cx <= range.max_x; cx++) {
+            auto cell = cells.find(get_cell_key(cx, cy));
+            if (cell == cells.end()) {
+                continue;
+            }
+            std::vector<uint64_t> &ids = cell->second;
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+            if (ids.empty()) {
+                cells.erase(cell);
+            }
+        }
+    }
+}
+
+void InputRegionIndex::set_rect(uint64_t id, const RegionRect &rect) {
+    if (rect.is_empty()) {
+        remove(id);
+        return;
+    }
+
+    auto it = entries.find(id);
+    if (it != entries.end()) {
+        if (it->second == rect) {
+            return; // Unchanged, nothing to re-insert
+        }
+        remove_from_cells(id, it->second);
+        it->second = rect;
+    } else {
+        entries.emplace(id, rect);
+    }
+    insert_into_cells(id, rect);
+    dirty = true;
+}
+
+void InputRegionIndex::remove(uint64_t id) {
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        return;
+    }
+    remove_from_cells(id, it->second);
+    entries.erase(it);
+    dirty = true;
+}
+
+void InputRegionIndex::clear() {
+    if (entries.empty()) {
+        return;
+    }
+    entries.clear();
+    cells.clear();
+    dirty = true;
+}
+
+bool InputRegionIndex::hit_test(int32_t x, int32_t y) const {
+    const CellRange range = get_cell_range({ x, y, 1, 1 });
+    auto cell = cells.find(get_cell_key(range.min_x, range.min_y));
+    if (cell == cells.end()) {
+        return false;
+    }
+    for (uint64_t id : cell->second) {
+        if (entries.at(id).has_point(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool InputRegionIndex::update_region() {
+    if (!dirty) {
+        return false;
+    }
+    dirty = false;
+
+    std::vector<RegionRect> rects;
+    rects.reserve(entries.size());
+    for (const auto &entry : entries) {
+        rects.push_back(entry.second);
+    }
+
+    std::vector<RegionRect> coalesced;
+    coalesce_region(rects, coalesced);
+    if (coalesced == region) {
+        return false; // Rectangles moved but the union is the same
+    }
+    region.swap(coalesced);
+    return true;
+}
+
+void coalesce_region(const std::vector<RegionRect> &rects, std::vector<RegionRect> &r_region) {
+    r_region.clear();
+
+    // Rectangles sorted by top edge feed the active set as the sweep moves down
+    std::vector<RegionRect> by_top;
+    by_top.reserve(rects.size());
+    std::vector<int32_t> edges;
+    edges.reserve(rects.size() * 2);
+    for (const RegionRect &rect : rects) {
+        if (rect.is_empty()) {
+            continue;
+        }
+        by_top.push_back(rect);
+        edges.push_back(rect.y);
+        edges.push_back(rect.y + rect.height);
+    }
+    if (by_top.empty()) {
+        return;
+    }
+    std::sort(by_top.begin(), by_top.end(), [](const RegionRect &a, const RegionRect &b) {
+        return a.y < b.y;
+    });
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    struct Span {
+        int32_t start, end;
+        bool operator==(const Span &other) const {
+            return start == other.start && end == other.end;
+        }
+    };
+
+    std::vector<RegionRect> active;
+    std::vector<Span> spans;
+    std::vector<Span> previous_spans;
+    size_t previous_band_start = 0;
+    size_t next = 0;
+
+    for (size_t band = 0; band + 1 < edges.size(); band++) {
+        const int32_t top = edges[band];
+        const int32_t bottom = edges[band + 1];
+
+        // Drop rectangles that ended, add those starting at this band
+        active.erase(std::remove_if(active.begin(), active.end(), [top](const RegionRect &rect) {
+            return rect.y + rect.height <= top;
+        }),
+                active.end());
+        while (next < by_top.size() && by_top[next].y <= top) {
+            active.push_back(by_top[next++]);
+        }
+
+        // Merge the horizontal spans covered in this band
+        spans.clear();
+        for (const RegionRect &rect : active) {
+            spans.push_back({ rect.x, rect.x + rect.width });
+        }
+        std::sort(spans.begin(), spans.end(), [](const Span &a, const Span &b) {
+            return a.start < b.start;
+        });
+        size_t merged = 0;
+        for (size_t i = 0; i < spans.size(); i++) {
+            if (merged > 0 && spans[i].start <= spans[merged - 1].end) {
+                spans[merged - 1].end = std::max(spans[merged - 1].end, spans[i].end);
+            } else {
+                spans[merged++] = spans[i];
+            }
+        }
+        spans.resize(merged);
+
+        // Same spans as the band above: grow those rectangles instead of adding new ones
+        if (!spans.empty() && spans == previous_spans) {
+            for (size_t i = previous_band_start; i < r_region.size(); i++) {
+                r_region[i].height += bottom - top;
+            }
+            continue;
+        }
+
+        previous_band_start = r_region.size();
+        for (const Span &span : spans) {
+            r_region.push_back({ span.start, top, span.end - span.start, bottom - top });
+        }
+        previous_spans.swap(spans);
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,84 @@
+#ifndef INPUT_REGION_H
+#define INPUT_REGION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+// Integer rectangle in window pixels
+struct RegionRect {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+
+    bool is_empty() const {
+        return width <= 0 || height <= 0;
+    }
+    bool has_point(int32_t px, int32_t py) const {
+        return px >= x && py >= y && px < x + width && py < y + height;
+    }
+    bool operator==(const RegionRect &other) const {
+        return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+    bool operator!=(const RegionRect &other) const {
+        return !(*this == other);
+    }
+};
+
+// Rectangles that should capture input, kept in a uniform grid so single
+// rectangles can be moved without touching the rest. The union is coalesced
+// into a banded list of disjoint rectangles only when something changed.
+class InputRegionIndex {
+public:
+    explicit InputRegionIndex(int32_t cell_size = 128);
+
+    // Insert or move a rectangle, an empty rectangle removes it
+    void set_rect(uint64_t id, const RegionRect &rect);
+    void remove(uint64_t id);
+    void clear();
+
+    // True when any rectangle contains the point
+    bool hit_test(int32_t x, int32_t y) const;
+
+    // Recompute the coalesced region if rectangles changed since the last call.
+    // Returns true only when the resulting region differs from the previous one.
+    bool update_region();
+    const std::vector<RegionRect> &get_region() const {
+        return region;
+    }
+
+    size_t get_rect_count() const {
+        return entries.size();
+    }
+
+private:
+    struct CellRange {
+        int32_t min_x, min_y, max_x, max_y;
+    };
+
+    CellRange get_cell_range(const RegionRect &rect) const;
+    static int64_t get_cell_key(int32_t cell_x, int32_t cell_y) {
+        return (int64_t(cell_x) << 32) ^ uint32_t(cell_y);
+    }
+    void insert_into_cells(uint64_t id, const RegionRect &rect);
+    void remove_from_cells(uint64_t id, const RegionRect &rect);
+
+    int32_t cell_size;
+    std::unordered_map<uint64_t, RegionRect> entries;
+    std::unordered_map<int64_t, std::vector<uint64_t>> cells;
+    bool dirty = false;
+    std::vector<RegionRect> region;
+};
+
+// Coalesce rectangles into y-x banded disjoint rectangles, the same form
+// X11 and Win32 use for regions. Vertically adjacent bands with identical
+// spans are merged, so a plain union of rectangles stays small.
+void coalesce_region(const std::vector<RegionRect> &rects, std::vector<RegionRect> &r_region);
+
+} // namespace godot
+
+#endif // INPUT_REGION_H
@@ -0,0 +1,69 @@
+#ifndef KEY_EVENT_FANOUT_H
+#define KEY_EVENT_FANOUT_H
+
+#include <atomic>
+#include <thread>
+
+#include "key_event_queue.h"
+
+namespace godot {
+
+// Delivers each record from one input thread to every subscribed queue.
+// Subscribers occupy fixed atomic slots, so publishing never locks or allocates.
+// subscribe/unsubscribe are called from the main thread; unsubscribe waits for
+// a publish in progress so the queue can be destroyed right after it returns.
+class KeyEventFanout {
+public:
+    static constexpr int MAX_SUBSCRIBERS = 16;
+
+    bool subscribe(KeyEventQueue *queue) {
+        for (std::atomic<KeyEventQueue *> &slot : slots) {
+            KeyEventQueue *expected = nullptr;
+            if (slot.compare_exchange_strong(expected, queue, std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void unsubscribe(KeyEventQueue *queue) {
+        for (std::atomic<KeyEventQueue *> &slot : slots) {
+            KeyEventQueue *expected = queue;
+            slot.compare_exchange_strong(expected, nullptr);
+        }
+
+        // Sequentially consistent on both sides: either the publisher sees the
+        // cleared slot, or this sees the publisher's count and waits for it
+        while (publishing.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Input thread
+    void publish(const KeyEvent &event) {
+        publishing.fetch_add(1);
+        for (std::atomic<KeyEventQueue *> &slot : slots) {
+            KeyEventQueue *queue = slot.load();
+            if (queue) {
+                queue->push(event);
+            }
+        }
+        publishing.fetch_sub(1, std::memory_order_release);
+    }
+
+    int get_subscriber_count() const {
+        int count = 0;
+        for (const std::atomic<KeyEventQueue *> &slot : slots) {
+            count += slot.load(std::memory_order_relaxed) != nullptr;
+        }
+        return count;
+    }
+
+private:
+    std::atomic<KeyEventQueue *> slots[MAX_SUBSCRIBERS] = {};
+    std::atomic<int> publishing{ 0 };
+};
+
+} // namespace godot
+
+#endif // KEY_EVENT_FANOUT_H
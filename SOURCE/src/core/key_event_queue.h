@@ -0,0 +1,125 @@
+#ifndef KEY_EVENT_QUEUE_H
+#define KEY_EVENT_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+// Flags carried by a KeyEvent
+enum KeyEventFlags : uint8_t {
+    KEY_EVENT_PRESSED = 1 << 0,  // Key went down (otherwise it went up)
+    KEY_EVENT_INJECTED = 1 << 1, // Event was synthesized (SendInput, xdotool, ...)
+    KEY_EVENT_EXTENDED = 1 << 2, // Extended scancode (E0 prefix)
+};
+
+// Modifier bits carried by a KeyEvent
+enum KeyModifierMask : uint8_t {
+    MODIFIER_CTRL = 1 << 0,
+    MODIFIER_SHIFT = 1 << 1,
+    MODIFIER_ALT = 1 << 2,
+    MODIFIER_META = 1 << 3,
+};
+
+// Compact record pushed by the global input hook.
+// Kept at 16 bytes so a cache line holds four of them.
+struct KeyEvent {
+    uint64_t timestamp_usec = 0; // Monotonic time the hook saw the event
+    uint16_t keycode = 0;        // OS keycode (virtual key on Windows)
+    uint16_t scancode = 0;       // Hardware scancode
+    uint8_t flags = 0;           // KeyEventFlags
+    uint8_t modifiers = 0;       // KeyModifierMask at the time of the event
+};
+
+// Monotonic clock shared by the hook and the main thread
+inline uint64_t get_monotonic_usec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Same clock in nanoseconds, for timing sections shorter than a microsecond
+inline uint64_t get_monotonic_nsec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Bounded lock-free single-producer/single-consumer ring.
+// The producer never blocks: when the ring is full the item is dropped and counted.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T &item) {
+        const size_t current_head = head.load(std::memory_order_relaxed);
+        if (current_head - cached_tail >= Capacity) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (current_head - cached_tail >= Capacity) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buffer[current_head & (Capacity - 1)] = item;
+        head.store(current_head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &r_item) {
+        const size_t current_tail = tail.load(std::memory_order_relaxed);
+        if (current_tail == cached_head) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (current_tail == cached_head) {
+                return false;
+            }
+        }
+        r_item = buffer[current_tail & (Capacity - 1)];
+        tail.store(current_tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: hands every item available right now to p_func and
+    // publishes the new tail once, so a burst costs a single release store.
+    template <typename F>
+    size_t drain(F &&p_func) {
+        const size_t current_tail = tail.load(std::memory_order_relaxed);
+        const size_t available_head = head.load(std::memory_order_acquire);
+        for (size_t i = current_tail; i != available_head; i++) {
+            p_func(buffer[i & (Capacity - 1)]);
+        }
+        tail.store(available_head, std::memory_order_release);
+        cached_head = available_head;
+        return available_head - current_tail;
+    }
+
+    bool is_empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    uint64_t get_dropped_count() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    // Producer and consumer indices live on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> head{ 0 };
+    size_t cached_tail = 0;
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    size_t cached_head = 0;
+    alignas(64) std::atomic<uint64_t> dropped{ 0 };
+    T buffer[Capacity];
+};
+
+// Queue between the global input hook and Overlay::process
+using KeyEventQueue = SpscRing<KeyEvent, 1024>;
+
+} // namespace godot
+
+#endif // KEY_EVENT_QUEUE_H
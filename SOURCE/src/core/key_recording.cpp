@@ -0,0 +1,168 @@
+#include "key_recording.h"
+
+#include <cstring>
+
+namespace godot {
+
+namespace {
+
+const char MAGIC[8] = { 'G', 'D', 'O', 'V', 'K', 'E', 'Y', 'S' };
+constexpr uint16_t VERSION = 1;
+
+// Header field offsets
+constexpr size_t OFFSET_VERSION = 8;
+constexpr size_t OFFSET_PLATFORM = 10;
+constexpr size_t OFFSET_RECORD_SIZE = 12;
+constexpr size_t OFFSET_START_USEC = 16;
+constexpr size_t OFFSET_DROPPED = 24;
+
+void put_u16(uint8_t *p, uint16_t value) {
+    p[0] = uint8_t(value);
+    p[1] = uint8_t(value >> 8);
+}
+
+void put_u32(uint8_t *p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = uint8_t(value >> (8 * i));
+    }
+}
+
+void put_u64(uint8_t *p, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = uint8_t(value >> (8 * i));
+    }
+}
+
+uint16_t get_u16(const uint8_t *p) {
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+uint32_t get_u32(const uint8_t *p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint64_t get_u64(const uint8_t *p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+} // namespace
+
+bool KeyRecordingWriter::open(const char *path, KeyRecordingPlatform platform) {
+    close(0);
+    file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    // Start time and lost records are filled in on close
+    uint8_t header[HEADER_SIZE] = {};
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    put_u16(header + OFFSET_VERSION, VERSION);
+    header[OFFSET_PLATFORM] = platform;
+    put_u16(header + OFFSET_RECORD_SIZE, RECORD_SIZE);
+    if (fwrite(header, 1, HEADER_SIZE, file) != HEADER_SIZE) {
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    first_usec = 0;
+    last_usec = 0;
+    record_count = 0;
+    buffer_used = 0;
+    started = false;
+    return true;
+}
+
+void KeyRecordingWriter::encode(const KeyEvent &event, uint8_t *r_record) {
+    if (!started) {
+        started = true;
+        last_usec = event.timestamp_usec;
+        first_usec = event.timestamp_usec;
+    }
+    // Gaps past 71 minutes are shortened, out of order stamps count as simultaneous
+    uint64_t delta = event.timestamp_usec > last_usec ? event.timestamp_usec - last_usec : 0;
+    if (delta > UINT32_MAX) {
+        delta = UINT32_MAX;
+    }
+    last_usec += delta;
+
+    put_u32(r_record, static_cast<uint32_t>(delta));
+    put_u16(r_record + 4, event.keycode);
+    put_u16(r_record + 6, event.scancode);
+    r_record[8] = event.flags;
+    r_record[9] = event.modifiers;
+}
+
+bool KeyRecordingWriter::flush() {
+    if (!file) {
+        buffer_used = 0;
+        return false;
+    }
+    bool written = fwrite(buffer, 1, buffer_used, file) == buffer_used;
+    buffer_used = 0;
+    return fflush(file) == 0 && written;
+}
+
+void KeyRecordingWriter::close(uint64_t dropped) {
+    if (!file) {
+        return;
+    }
+    flush();
+
+    uint8_t fields[16];
+    put_u64(fields, first_usec);
+    put_u64(fields + 8, dropped);
+    if (fseek(file, OFFSET_START_USEC, SEEK_SET) == 0) {
+        fwrite(fields, 1, sizeof(fields), file);
+    }
+    fclose(file);
+    file = nullptr;
+}
+
+bool read_key_recording(const char *path, KeyRecordingInfo &r_info, std::vector<KeyEvent> &r_events) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t header[KeyRecordingWriter::HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, MAGIC, sizeof(MAGIC)) != 0 ||
+            get_u16(header + OFFSET_VERSION) != VERSION || get_u16(header + OFFSET_RECORD_SIZE) != KeyRecordingWriter::RECORD_SIZE) {
+        fclose(file);
+        return false;
+    }
+    r_info.platform = static_cast<KeyRecordingPlatform>(header[OFFSET_PLATFORM]);
+    r_info.start_usec = get_u64(header + OFFSET_START_USEC);
+    r_info.dropped = get_u64(header + OFFSET_DROPPED);
+
+    // Whole records only, a torn last record is left out
+    r_events.clear();
+    uint8_t chunk[4096 * KeyRecordingWriter::RECORD_SIZE];
+    uint64_t timestamp = r_info.start_usec;
+    size_t read = 0;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) >= KeyRecordingWriter::RECORD_SIZE) {
+        for (size_t offset = 0; offset + KeyRecordingWriter::RECORD_SIZE <= read; offset += KeyRecordingWriter::RECORD_SIZE) {
+            const uint8_t *record = chunk + offset;
+            KeyEvent event;
+            timestamp += get_u32(record);
+            event.timestamp_usec = timestamp;
+            event.keycode = get_u16(record + 4);
+            event.scancode = get_u16(record + 6);
+            event.flags = record[8];
+            event.modifiers = record[9];
+            r_events.push_back(event);
+        }
+        if (read < sizeof(chunk)) {
+            break;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+} // namespace godot
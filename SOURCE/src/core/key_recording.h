@@ -0,0 +1,89 @@
+#ifndef KEY_RECORDING_H
+#define KEY_RECORDING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "key_event_queue.h"
+
+namespace godot {
+
+// Keycodes in a recording, so one made on Windows replays with Windows modifier keys
+enum KeyRecordingPlatform : uint8_t {
+    KEY_RECORDING_WINDOWS, // Virtual keys and set 1 scancodes
+    KEY_RECORDING_X11, // X11 keycodes and evdev scancodes
+};
+
+// Binary key recording, little-endian:
+//   header  32 bytes: "GDOVKEYS", version, platform, record size, start time,
+//           records the recorder lost (written when it is closed)
+//   records 10 bytes: microseconds since the previous record (u32), keycode (u16),
+//           scancode (u16), flags (u8), modifiers (u8)
+// Records are only ever appended, a file cut short by a crash reads up to its last
+// whole record.
+struct KeyRecordingInfo {
+    KeyRecordingPlatform platform = KEY_RECORDING_WINDOWS;
+    uint64_t start_usec = 0; // Timestamp of the first record
+    uint64_t dropped = 0;
+};
+
+// Appends key records through a 64 KiB buffer, a write reaches the file when the
+// buffer fills or on flush. Single thread.
+class KeyRecordingWriter {
+public:
+    static constexpr size_t RECORD_SIZE = 10;
+    static constexpr size_t HEADER_SIZE = 32;
+
+    ~KeyRecordingWriter() {
+        close(0);
+    }
+
+    bool open(const char *path, KeyRecordingPlatform platform);
+
+    // Writes the lost record count into the header and closes the file
+    void close(uint64_t dropped);
+
+    bool is_open() const {
+        return file != nullptr;
+    }
+
+    void append(const KeyEvent &event) {
+        if (buffer_used + RECORD_SIZE > BUFFER_SIZE) {
+            flush();
+        }
+        encode(event, buffer + buffer_used);
+        buffer_used += RECORD_SIZE;
+        record_count++;
+    }
+
+    bool flush();
+
+    uint64_t get_record_count() const {
+        return record_count;
+    }
+    uint64_t get_bytes_written() const {
+        return HEADER_SIZE + record_count * RECORD_SIZE;
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024 / RECORD_SIZE * RECORD_SIZE;
+
+    FILE *file = nullptr;
+    uint64_t first_usec = 0;
+    uint64_t last_usec = 0;
+    uint64_t record_count = 0;
+    size_t buffer_used = 0;
+    bool started = false;
+    uint8_t buffer[BUFFER_SIZE];
+
+    void encode(const KeyEvent &event, uint8_t *r_record);
+};
+
+// Reads a whole recording, timestamps are rebuilt from the start time
+bool read_key_recording(const char *path, KeyRecordingInfo &r_info, std::vector<KeyEvent> &r_events);
+
+} // namespace godot
+
+#endif // KEY_RECORDING_H
@@ -0,0 +1,137 @@
+#include "key_replay.h"
+
+#include "keycode_tables.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace godot {
+
+namespace {
+
+uint64_t percentile(const std::vector<uint64_t> &sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(sorted.size() * percentile / 100.0);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+} // namespace
+
+void KeyReplayer::set_platform(KeyRecordingPlatform platform) {
+    modifier_tracker = ModifierTracker();
+    windows_keycodes = platform == KEY_RECORDING_WINDOWS;
+    if (platform == KEY_RECORDING_WINDOWS) {
+        modifier_tracker.set_windows_keycodes();
+    } else {
+        modifier_tracker.set_x11_keycodes();
+    }
+    gesture_recognizer.set_modifier_keys(modifier_tracker);
+}
+
+void KeyReplayer::set_use_scancodes(bool enabled) {
+    use_scancodes = enabled;
+    gesture_recognizer.set_use_scancodes(enabled);
+}
+
+KeyReplayer::Report KeyReplayer::run(const std::vector<KeyEvent> &events, Pacing pacing) {
+    Report report;
+    if (events.empty()) {
+        return report;
+    }
+
+    // The queue is the one the hook fills, too large for the stack
+    std::unique_ptr<KeyEventQueue> queue(new KeyEventQueue());
+    KeyEventFanout fanout;
+    fanout.subscribe(queue.get());
+
+    OverlayStateMachine state_machine;
+    state_machine.enable();
+    OverlayState applied = state_machine.get_desired();
+    modifier_tracker.reset();
+    std::vector<GestureRecognizer::Result> gesture_results;
+    gesture_results.reserve(16);
+
+    std::vector<uint64_t> latencies;
+    std::vector<uint64_t> lags;
+    latencies.reserve(events.size());
+    if (pacing == PACING_RECORDED) {
+        lags.reserve(events.size());
+    }
+
+    const uint64_t first_usec = events.front().timestamp_usec;
+    const uint64_t start_usec = get_monotonic_usec();
+    for (const KeyEvent &recorded : events) {
+        if (pacing == PACING_RECORDED) {
+            uint64_t due_usec = start_usec + (recorded.timestamp_usec - first_usec);
+            uint64_t now_usec = get_monotonic_usec();
+            if (due_usec > now_usec) {
+                std::this_thread::sleep_for(std::chrono::microseconds(due_usec - now_usec));
+                now_usec = get_monotonic_usec();
+            }
+            lags.push_back(now_usec > due_usec ? now_usec - due_usec : 0);
+        }
+
+        const uint64_t begin_nsec = get_monotonic_nsec();
+
+        // What the hook callback does, modifiers are derived again rather than trusted
+        KeyEvent event = recorded;
+        event.modifiers = modifier_tracker.update(event.keycode, event.flags & KEY_EVENT_PRESSED);
+        if (windows_keycodes) {
+            event.keycode = static_cast<uint16_t>(keycodes::windows_generic_vk(event.keycode));
+        }
+        fanout.publish(event);
+
+        // What Overlay::process does with the drained records
+        queue->drain([&](const KeyEvent &drained) {
+            if (drained.flags & KEY_EVENT_PRESSED) {
+                uint16_t action = keybind_table.match(use_scancodes ? drained.scancode : drained.keycode, drained.modifiers);
+                if (action != KeybindTable::NO_ACTION) {
+                    report.matched++;
+                    if (action == ACTION_TOGGLE_INPUT) {
+                        state_machine.toggle_passthrough();
+                    } else if (action == ACTION_TOGGLE_VISIBILITY) {
+                        state_machine.toggle_visible();
+                    }
+                    if (diff_overlay_state(applied, state_machine.get_desired())) {
+                        applied = state_machine.get_desired();
+                        report.toggles++;
+                    }
+                }
+            }
+            if (gesture_recognizer.get_gesture_count() > 0) {
+                gesture_recognizer.process(drained, gesture_results);
+            }
+        });
+        report.gestures += gesture_results.size();
+        gesture_results.clear();
+
+        latencies.push_back(get_monotonic_nsec() - begin_nsec);
+    }
+    report.wall_usec = get_monotonic_usec() - start_usec;
+    report.events = events.size();
+    report.dropped = queue->get_dropped_count();
+    fanout.unsubscribe(queue.get());
+
+    std::sort(latencies.begin(), latencies.end());
+    report.latency_p50_nsec = percentile(latencies, 50.0);
+    report.latency_p90_nsec = percentile(latencies, 90.0);
+    report.latency_p99_nsec = percentile(latencies, 99.0);
+    report.latency_p999_nsec = percentile(latencies, 99.9);
+    report.latency_max_nsec = latencies.back();
+    if (!lags.empty()) {
+        std::sort(lags.begin(), lags.end());
+        report.lag_p99_usec = percentile(lags, 99.0);
+        report.lag_max_usec = lags.back();
+    }
+
+    // Holds still pressed at the end of the recording are let go
+    gesture_recognizer.reset(events.back().timestamp_usec, gesture_results);
+    gesture_results.clear();
+    return report;
+}
+
+} // namespace godot
@@ -0,0 +1,77 @@
+#ifndef KEY_REPLAY_H
+#define KEY_REPLAY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "gesture_recognizer.h"
+#include "key_event_fanout.h"
+#include "key_event_queue.h"
+#include "key_recording.h"
+#include "keybind_table.h"
+#include "overlay_state_machine.h"
+
+namespace godot {
+
+// Feeds recorded key records through the code the live hook path runs: modifier
+// tracking, fan-out into a queue, keybind matching, gesture recognition and the
+// overlay state machine, and times each record from publish to settled state.
+// The OS side (hook callback, focus checks, native window calls) is left out, so
+// a recording from any platform replays headless. Single thread.
+class KeyReplayer {
+public:
+    enum Pacing {
+        PACING_FAST, // Back to back
+        PACING_RECORDED, // Each record at its recorded offset from the first
+    };
+
+    // Actions 0 and 1 toggle passthrough and visibility, as the overlay numbers them
+    static constexpr uint16_t ACTION_TOGGLE_INPUT = 0;
+    static constexpr uint16_t ACTION_TOGGLE_VISIBILITY = 1;
+
+    struct Report {
+        uint64_t events = 0;
+        uint64_t matched = 0;
+        uint64_t toggles = 0; // Matches that changed the window state
+        uint64_t gestures = 0;
+        uint64_t dropped = 0; // Lost in the queue, 0 unless the replay falls behind
+        uint64_t wall_usec = 0;
+        // Per record processing time
+        uint64_t latency_p50_nsec = 0;
+        uint64_t latency_p90_nsec = 0;
+        uint64_t latency_p99_nsec = 0;
+        uint64_t latency_p999_nsec = 0;
+        uint64_t latency_max_nsec = 0;
+        // Recorded pacing only, how late records were published
+        uint64_t lag_p99_usec = 0;
+        uint64_t lag_max_usec = 0;
+    };
+
+    KeyReplayer() {
+        set_platform(KEY_RECORDING_WINDOWS);
+    }
+
+    // Modifier keys and key matching as on the platform the recording was made on
+    void set_platform(KeyRecordingPlatform platform);
+    void set_use_scancodes(bool enabled);
+
+    KeybindTable &get_keybind_table() {
+        return keybind_table;
+    }
+    GestureRecognizer &get_gesture_recognizer() {
+        return gesture_recognizer;
+    }
+
+    Report run(const std::vector<KeyEvent> &events, Pacing pacing);
+
+private:
+    KeybindTable keybind_table;
+    GestureRecognizer gesture_recognizer;
+    ModifierTracker modifier_tracker;
+    bool use_scancodes = false;
+    bool windows_keycodes = true;
+};
+
+} // namespace godot
+
+#endif // KEY_REPLAY_H
@@ -0,0 +1,74 @@
+#include "keybind_table.h"
+
+#include <cstring>
+
+namespace godot {
+
+KeybindTable::KeybindTable() {
+    clear();
+}
+
+void KeybindTable::clear() {
+    for (int key = 0; key < KEY_SLOTS; key++) {
+        for (int mods = 0; mods < MODIFIER_COMBINATIONS; mods++) {
+            table[key][mods] = NO_ACTION;
+        }
+    }
+    binding_count = 0;
+}
+
+int KeybindTable::compile(const Binding *bindings, size_t count) {
+    clear();
+
+    int rejected = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Binding &binding = bindings[i];
+        if (binding.keycode >= KEY_SLOTS || binding.modifiers >= MODIFIER_COMBINATIONS || binding.action == NO_ACTION) {
+            rejected++;
+            continue;
+        }
+        table[binding.keycode][binding.modifiers] = binding.action;
+        binding_count++;
+    }
+    return rejected;
+}
+
+ModifierTracker::ModifierTracker() {
+    memset(modifier_key, NOT_A_MODIFIER, sizeof(modifier_key));
+}
+
+void ModifierTracker::set_modifier_keycode(uint16_t keycode, ModifierKey key) {
+    if (keycode < KeybindTable::KEY_SLOTS) {
+        modifier_key[keycode] = key;
+    }
+}
+
+void ModifierTracker::set_windows_keycodes() {
+    // Low-level hooks report the sided virtual keys, the generic ones are
+    // mapped as well for input injected with VK_CONTROL and friends
+    set_modifier_keycode(0xA2, LEFT_CTRL);   // VK_LCONTROL
+    set_modifier_keycode(0xA3, RIGHT_CTRL);  // VK_RCONTROL
+    set_modifier_keycode(0x11, LEFT_CTRL);   // VK_CONTROL
+    set_modifier_keycode(0xA0, LEFT_SHIFT);  // VK_LSHIFT
+    set_modifier_keycode(0xA1, RIGHT_SHIFT); // VK_RSHIFT
+    set_modifier_keycode(0x10, LEFT_SHIFT);  // VK_SHIFT
+    set_modifier_keycode(0xA4, LEFT_ALT);    // VK_LMENU
+    set_modifier_keycode(0xA5, RIGHT_ALT);   // VK_RMENU
+    set_modifier_keycode(0x12, LEFT_ALT);    // VK_MENU
+    set_modifier_keycode(0x5B, LEFT_META);   // VK_LWIN
+    set_modifier_keycode(0x5C, RIGHT_META);  // VK_RWIN
+}
+
+void ModifierTracker::set_x11_keycodes() {
+    // X11 keycodes are evdev codes offset by 8
+    set_modifier_keycode(37, LEFT_CTRL);   // KEY_LEFTCTRL
+    set_modifier_keycode(105, RIGHT_CTRL); // KEY_RIGHTCTRL
+    set_modifier_keycode(50, LEFT_SHIFT);  // KEY_LEFTSHIFT
+    set_modifier_keycode(62, RIGHT_SHIFT); // KEY_RIGHTSHIFT
+    set_modifier_keycode(64, LEFT_ALT);    // KEY_LEFTALT
+    set_modifier_keycode(108, RIGHT_ALT);  // KEY_RIGHTALT
+    set_modifier_keycode(133, LEFT_META);  // KEY_LEFTMETA
+    set_modifier_keycode(134, RIGHT_META); // KEY_RIGHTMETA
+}
+
+} // namespace godot
@@ -0,0 +1,105 @@
+#ifndef KEYBIND_TABLE_H
+#define KEYBIND_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "key_event_queue.h"
+
+namespace godot {
+
+// Flat lookup table from (OS keycode or scancode, modifier mask) to an action index.
+// Rebuilt whenever bindings change so a keystroke resolves with two loads.
+class KeybindTable {
+public:
+    static constexpr int KEY_SLOTS = 512; // Extended Windows scancodes use bit 8
+    static constexpr int MODIFIER_COMBINATIONS = 16; // Ctrl, Shift, Alt, Meta
+    static constexpr uint16_t NO_ACTION = 0xFFFF;
+
+    struct Binding {
+        uint16_t keycode = 0;   // OS keycode, or scancode in physical mode
+        uint8_t modifiers = 0;  // KeyModifierMask
+        uint16_t action = NO_ACTION;
+    };
+
+    KeybindTable();
+
+    // Replace every binding, later entries win on conflicts.
+    // Returns the number of bindings that could not be placed.
+    int compile(const Binding *bindings, size_t count);
+    void clear();
+
+    inline uint16_t match(uint16_t keycode, uint8_t modifiers) const {
+        return keycode < KEY_SLOTS ? table[keycode][modifiers & (MODIFIER_COMBINATIONS - 1)] : NO_ACTION;
+    }
+
+    size_t get_binding_count() const {
+        return binding_count;
+    }
+
+private:
+    // One 32 byte row per key keeps every modifier variant on the same cache line
+    uint16_t table[KEY_SLOTS][MODIFIER_COMBINATIONS];
+    size_t binding_count = 0;
+};
+
+// Tracks held modifier keys from the hook's own key stream, so the hook
+// never has to query the OS for modifier state.
+class ModifierTracker {
+public:
+    // Physical modifier keys, left and right tracked separately
+    enum ModifierKey : uint8_t {
+        LEFT_CTRL,
+        RIGHT_CTRL,
+        LEFT_SHIFT,
+        RIGHT_SHIFT,
+        LEFT_ALT,
+        RIGHT_ALT,
+        LEFT_META,
+        RIGHT_META,
+        MODIFIER_KEY_MAX,
+    };
+
+    ModifierTracker();
+
+    // Declare which OS keycode drives a modifier key
+    void set_modifier_keycode(uint16_t keycode, ModifierKey key);
+
+    // Platform defaults for the keycodes reported by the global hook
+    void set_windows_keycodes();
+    void set_x11_keycodes();
+
+    // Feed every hook event through here, returns the mask after the event
+    inline uint8_t update(uint16_t keycode, bool pressed) {
+        if (keycode < KeybindTable::KEY_SLOTS && modifier_key[keycode] != NOT_A_MODIFIER) {
+            const uint8_t bit = uint8_t(1u << modifier_key[keycode]);
+            held = pressed ? uint8_t(held | bit) : uint8_t(held & ~bit);
+        }
+        return get_modifiers();
+    }
+
+    inline uint8_t get_modifiers() const {
+        return uint8_t(((held & 0x03) ? MODIFIER_CTRL : 0) |
+                ((held & 0x0C) ? MODIFIER_SHIFT : 0) |
+                ((held & 0x30) ? MODIFIER_ALT : 0) |
+                ((held & 0xC0) ? MODIFIER_META : 0));
+    }
+
+    bool is_modifier(uint16_t keycode) const {
+        return keycode < KeybindTable::KEY_SLOTS && modifier_key[keycode] != NOT_A_MODIFIER;
+    }
+
+    // Forget held keys, e.g. after the session was locked and key-ups were missed
+    void reset() {
+        held = 0;
+    }
+
+private:
+    static constexpr uint8_t NOT_A_MODIFIER = 0xFF;
+    uint8_t modifier_key[KeybindTable::KEY_SLOTS];
+    uint8_t held = 0;
+};
+
+} // namespace godot
+
+#endif // KEYBIND_TABLE_H
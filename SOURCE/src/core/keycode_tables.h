@@ -0,0 +1,397 @@
+#ifndef KEYCODE_TABLES_H
+#define KEYCODE_TABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+namespace keycodes {
+
+// Translation between Godot keycodes and the codes each OS reports.
+// Every table is built at compile time from the row list below; lookups
+// are a masked index into a flat array and return 0 for unmapped codes.
+
+// Godot encodes non-printable keys as SPECIAL | n and printable keys as
+// their Latin-1 code point, so both fit a 512 entry dense index
+constexpr uint32_t GODOT_KEY_SPECIAL = 1u << 22;
+constexpr uint32_t GODOT_KEY_SLOTS = 512;
+
+// Windows scancodes carry the E0 prefix as bit 8
+constexpr uint32_t WINDOWS_SCANCODE_EXTENDED = 0x100;
+constexpr uint32_t WINDOWS_SCANCODE_SLOTS = 512;
+
+// X11 keycodes are evdev codes shifted by 8 under the evdev/libinput drivers
+constexpr uint32_t X11_EVDEV_KEYCODE_OFFSET = 8;
+constexpr uint32_t EVDEV_SLOTS = 256;
+constexpr uint32_t WINDOWS_VK_SLOTS = 256;
+constexpr uint32_t X11_KEYSYM_SLOTS = 1024;
+
+struct KeyRow {
+    uint32_t godot;
+    uint16_t windows_vk;
+    uint16_t windows_scancode;
+    uint32_t x11_keysym;
+    uint16_t evdev;
+};
+
+constexpr uint32_t special(uint32_t code) {
+    return GODOT_KEY_SPECIAL | code;
+}
+
+constexpr uint16_t extended(uint16_t scancode) {
+    return uint16_t(WINDOWS_SCANCODE_EXTENDED | scancode);
+}
+
+// Rows sharing an OS code keep the first Godot key for the reverse lookup,
+// so the canonical key comes first (Enter before Keypad Enter, etc.)
+constexpr KeyRow KEY_ROWS[] = {
+    // Godot, Windows VK, Windows scancode, X11 keysym, evdev
+    { special(0x01), 0x1B, 0x01, 0xFF1B, 1 }, // Escape
+    { special(0x02), 0x09, 0x0F, 0xFF09, 15 }, // Tab
+    { special(0x03), 0x00, 0x00, 0xFE20, 0 }, // Backtab (ISO_Left_Tab)
+    { special(0x04), 0x08, 0x0E, 0xFF08, 14 }, // Backspace
+    { special(0x05), 0x0D, 0x1C, 0xFF0D, 28 }, // Enter
+    { special(0x06), 0x0D, extended(0x1C), 0xFF8D, 96 }, // Keypad Enter
+    { special(0x07), 0x2D, extended(0x52), 0xFF63, 110 }, // Insert
+    { special(0x08), 0x2E, extended(0x53), 0xFFFF, 111 }, // Delete
+    { special(0x09), 0x13, 0x45, 0xFF13, 119 }, // Pause
+    { special(0x0A), 0x2C, extended(0x37), 0xFF61, 99 }, // Print
+    { special(0x0B), 0x00, 0x54, 0xFF15, 0 }, // SysReq
+    { special(0x0C), 0x0C, 0x00, 0xFF0B, 0 }, // Clear
+    { special(0x0D), 0x24, extended(0x47), 0xFF50, 102 }, // Home
+    { special(0x0E), 0x23, extended(0x4F), 0xFF57, 107 }, // End
+    { special(0x0F), 0x25, extended(0x4B), 0xFF51, 105 }, // Left
+    { special(0x10), 0x26, extended(0x48), 0xFF52, 103 }, // Up
+    { special(0x11), 0x27, extended(0x4D), 0xFF53, 106 }, // Right
+    { special(0x12), 0x28, extended(0x50), 0xFF54, 108 }, // Down
+    { special(0x13), 0x21, extended(0x49), 0xFF55, 104 }, // Page Up
+    { special(0x14), 0x22, extended(0x51), 0xFF56, 109 }, // Page Down
+    { special(0x15), 0x10, 0x2A, 0xFFE1, 42 }, // Shift
+    { special(0x16), 0x11, 0x1D, 0xFFE3, 29 }, // Ctrl
+    { special(0x17), 0x5B, extended(0x5B), 0xFFEB, 125 }, // Meta
+    { special(0x18), 0x12, 0x38, 0xFFE9, 56 }, // Alt
+    { special(0x19), 0x14, 0x3A, 0xFFE5, 58 }, // Caps Lock
+    { special(0x1A), 0x90, extended(0x45), 0xFF7F, 69 }, // Num Lock
+    { special(0x1B), 0x91, 0x46, 0xFF14, 70 }, // Scroll Lock
+    { special(0x1C), 0x70, 0x3B, 0xFFBE, 59 }, // F1
+    { special(0x1D), 0x71, 0x3C, 0xFFBF, 60 }, // F2
+    { special(0x1E), 0x72, 0x3D, 0xFFC0, 61 }, // F3
+    { special(0x1F), 0x73, 0x3E, 0xFFC1, 62 }, // F4
+    { special(0x20), 0x74, 0x3F, 0xFFC2, 63 }, // F5
+    { special(0x21), 0x75, 0x40, 0xFFC3, 64 }, // F6
+    { special(0x22), 0x76, 0x41, 0xFFC4, 65 }, // F7
+    { special(0x23), 0x77, 0x42, 0xFFC5, 66 }, // F8
+    { special(0x24), 0x78, 0x43, 0xFFC6, 67 }, // F9
+    { special(0x25), 0x79, 0x44, 0xFFC7, 68 }, // F10
+    { special(0x26), 0x7A, 0x57, 0xFFC8, 87 }, // F11
+    { special(0x27), 0x7B, 0x58, 0xFFC9, 88 }, // F12
+    { special(0x28), 0x7C, 0x64, 0xFFCA, 183 }, // F13
+    { special(0x29), 0x7D, 0x65, 0xFFCB, 184 }, // F14
+    { special(0x2A), 0x7E, 0x66, 0xFFCC, 185 }, // F15
+    { special(0x2B), 0x7F, 0x67, 0xFFCD, 186 }, // F16
+    { special(0x2C), 0x80, 0x68, 0xFFCE, 187 }, // F17
+    { special(0x2D), 0x81, 0x69, 0xFFCF, 188 }, // F18
+    { special(0x2E), 0x82, 0x6A, 0xFFD0, 189 }, // F19
+    { special(0x2F), 0x83, 0x6B, 0xFFD1, 190 }, // F20
+    { special(0x30), 0x84, 0x6C, 0xFFD2, 191 }, // F21
+    { special(0x31), 0x85, 0x6D, 0xFFD3, 192 }, // F22
+    { special(0x32), 0x86, 0x6E, 0xFFD4, 193 }, // F23
+    { special(0x33), 0x87, 0x76, 0xFFD5, 194 }, // F24
+    { special(0x34), 0x00, 0x00, 0xFFD6, 0 }, // F25
+    { special(0x35), 0x00, 0x00, 0xFFD7, 0 }, // F26
+    { special(0x36), 0x00, 0x00, 0xFFD8, 0 }, // F27
+    { special(0x37), 0x00, 0x00, 0xFFD9, 0 }, // F28
+    { special(0x38), 0x00, 0x00, 0xFFDA, 0 }, // F29
+    { special(0x39), 0x00, 0x00, 0xFFDB, 0 }, // F30
+    { special(0x3A), 0x00, 0x00, 0xFFDC, 0 }, // F31
+    { special(0x3B), 0x00, 0x00, 0xFFDD, 0 }, // F32
+    { special(0x3C), 0x00, 0x00, 0xFFDE, 0 }, // F33
+    { special(0x3D), 0x00, 0x00, 0xFFDF, 0 }, // F34
+    { special(0x3E), 0x00, 0x00, 0xFFE0, 0 }, // F35
+    { special(0x81), 0x6A, 0x37, 0xFFAA, 55 }, // Keypad *
+    { special(0x82), 0x6F, extended(0x35), 0xFFAF, 98 }, // Keypad /
+    { special(0x83), 0x6D, 0x4A, 0xFFAD, 74 }, // Keypad -
+    { special(0x84), 0x6E, 0x53, 0xFFAE, 83 }, // Keypad .
+    { special(0x85), 0x6B, 0x4E, 0xFFAB, 78 }, // Keypad +
+    { special(0x86), 0x60, 0x52, 0xFFB0, 82 }, // Keypad 0
+    { special(0x87), 0x61, 0x4F, 0xFFB1, 79 }, // Keypad 1
+    { special(0x88), 0x62, 0x50, 0xFFB2, 80 }, // Keypad 2
+    { special(0x89), 0x63, 0x51, 0xFFB3, 81 }, // Keypad 3
+    { special(0x8A), 0x64, 0x4B, 0xFFB4, 75 }, // Keypad 4
+    { special(0x8B), 0x65, 0x4C, 0xFFB5, 76 }, // Keypad 5
+    { special(0x8C), 0x66, 0x4D, 0xFFB6, 77 }, // Keypad 6
+    { special(0x8D), 0x67, 0x47, 0xFFB7, 71 }, // Keypad 7
+    { special(0x8E), 0x68, 0x48, 0xFFB8, 72 }, // Keypad 8
+    { special(0x8F), 0x69, 0x49, 0xFFB9, 73 }, // Keypad 9
+    { special(0x42), 0x5D, extended(0x5D), 0xFF67, 127 }, // Menu
+    { special(0x43), 0x00, 0x00, 0xFFED, 0 }, // Hyper
+    { special(0x45), 0x2F, 0x00, 0xFF6A, 138 }, // Help
+    { special(0x48), 0xA6, extended(0x6A), 0x1008FF26, 158 }, // Back
+    { special(0x49), 0xA7, extended(0x69), 0x1008FF27, 159 }, // Forward
+    { special(0x4A), 0xA9, extended(0x68), 0x1008FF28, 128 }, // Stop
+    { special(0x4B), 0xA8, extended(0x67), 0x1008FF29, 173 }, // Refresh
+    { special(0x4C), 0xAE, extended(0x2E), 0x1008FF11, 114 }, // Volume Down
+    { special(0x4D), 0xAD, extended(0x20), 0x1008FF12, 113 }, // Volume Mute
+    { special(0x4E), 0xAF, extended(0x30), 0x1008FF13, 115 }, // Volume Up
+    { special(0x54), 0xB3, extended(0x22), 0x1008FF14, 164 }, // Media Play
+    { special(0x55), 0xB2, extended(0x24), 0x1008FF15, 166 }, // Media Stop
+    { special(0x56), 0xB1, extended(0x10), 0x1008FF16, 165 }, // Media Previous
+    { special(0x57), 0xB0, extended(0x19), 0x1008FF17, 163 }, // Media Next
+    { special(0x58), 0x00, 0x00, 0x1008FF1C, 167 }, // Media Record
+    { special(0x59), 0xAC, extended(0x32), 0x1008FF18, 172 }, // Home Page
+    { special(0x5A), 0xAB, extended(0x66), 0x1008FF30, 156 }, // Favorites
+    { special(0x5B), 0xAA, extended(0x65), 0x1008FF1B, 217 }, // Search
+    { special(0x5C), 0x5F, extended(0x5F), 0x1008FF10, 142 }, // Standby
+    { special(0x5D), 0x00, 0x00, 0x1008FF38, 0 }, // Open URL
+    { special(0x5E), 0xB4, extended(0x6C), 0x1008FF19, 155 }, // Launch Mail
+    { special(0x5F), 0xB5, extended(0x6D), 0x1008FF32, 226 }, // Launch Media
+    { special(0x60), 0xB6, 0x00, 0x1008FF40, 0 }, // Launch 0
+    { special(0x61), 0xB7, 0x00, 0x1008FF41, 0 }, // Launch 1
+    { special(0x62), 0x00, 0x00, 0x1008FF42, 0 }, // Launch 2
+    { special(0x63), 0x00, 0x00, 0x1008FF43, 0 }, // Launch 3
+    { special(0x64), 0x00, 0x00, 0x1008FF44, 0 }, // Launch 4
+    { special(0x65), 0x00, 0x00, 0x1008FF45, 0 }, // Launch 5
+    { special(0x66), 0x00, 0x00, 0x1008FF46, 0 }, // Launch 6
+    { special(0x67), 0x00, 0x00, 0x1008FF47, 0 }, // Launch 7
+    { special(0x68), 0x00, 0x00, 0x1008FF48, 0 }, // Launch 8
+    { special(0x69), 0x00, 0x00, 0x1008FF49, 0 }, // Launch 9
+    { special(0x6A), 0x00, 0x00, 0x1008FF4A, 0 }, // Launch A
+    { special(0x6B), 0x00, 0x00, 0x1008FF4B, 0 }, // Launch B
+    { special(0x6C), 0x00, 0x00, 0x1008FF4C, 0 }, // Launch C
+    { special(0x6D), 0x00, 0x00, 0x1008FF4D, 0 }, // Launch D
+    { special(0x6E), 0x00, 0x00, 0x1008FF4E, 0 }, // Launch E
+    { special(0x6F), 0x00, 0x00, 0x1008FF4F, 0 }, // Launch F
+    { 0x20, 0x20, 0x39, 0x0020, 57 }, // Space
+    { 0x27, 0xDE, 0x28, 0x0027, 40 }, // Apostrophe (VK_OEM_7)
+    { 0x2C, 0xBC, 0x33, 0x002C, 51 }, // Comma (VK_OEM_COMMA)
+    { 0x2D, 0xBD, 0x0C, 0x002D, 12 }, // Minus (VK_OEM_MINUS)
+    { 0x2E, 0xBE, 0x34, 0x002E, 52 }, // Period (VK_OEM_PERIOD)
+    { 0x2F, 0xBF, 0x35, 0x002F, 53 }, // Slash (VK_OEM_2)
+    { 0x30, 0x30, 0x0B, 0x0030, 11 }, // 0
+    { 0x31, 0x31, 0x02, 0x0031, 2 }, // 1
+    { 0x32, 0x32, 0x03, 0x0032, 3 }, // 2
+    { 0x33, 0x33, 0x04, 0x0033, 4 }, // 3
+    { 0x34, 0x34, 0x05, 0x0034, 5 }, // 4
+    { 0x35, 0x35, 0x06, 0x0035, 6 }, // 5
+    { 0x36, 0x36, 0x07, 0x0036, 7 }, // 6
+    { 0x37, 0x37, 0x08, 0x0037, 8 }, // 7
+    { 0x38, 0x38, 0x09, 0x0038, 9 }, // 8
+    { 0x39, 0x39, 0x0A, 0x0039, 10 }, // 9
+    { 0x3B, 0xBA, 0x27, 0x003B, 39 }, // Semicolon (VK_OEM_1)
+    { 0x3D, 0xBB, 0x0D, 0x003D, 13 }, // Equal (VK_OEM_PLUS)
+    { 0x41, 0x41, 0x1E, 0x0061, 30 }, // A
+    { 0x42, 0x42, 0x30, 0x0062, 48 }, // B
+    { 0x43, 0x43, 0x2E, 0x0063, 46 }, // C
+    { 0x44, 0x44, 0x20, 0x0064, 32 }, // D
+    { 0x45, 0x45, 0x12, 0x0065, 18 }, // E
+    { 0x46, 0x46, 0x21, 0x0066, 33 }, // F
+    { 0x47, 0x47, 0x22, 0x0067, 34 }, // G
+    { 0x48, 0x48, 0x23, 0x0068, 35 }, // H
+    { 0x49, 0x49, 0x17, 0x0069, 23 }, // I
+    { 0x4A, 0x4A, 0x24, 0x006A, 36 }, // J
+    { 0x4B, 0x4B, 0x25, 0x006B, 37 }, // K
+    { 0x4C, 0x4C, 0x26, 0x006C, 38 }, // L
+    { 0x4D, 0x4D, 0x32, 0x006D, 50 }, // M
+    { 0x4E, 0x4E, 0x31, 0x006E, 49 }, // N
+    { 0x4F, 0x4F, 0x18, 0x006F, 24 }, // O
+    { 0x50, 0x50, 0x19, 0x0070, 25 }, // P
+    { 0x51, 0x51, 0x10, 0x0071, 16 }, // Q
+    { 0x52, 0x52, 0x13, 0x0072, 19 }, // R
+    { 0x53, 0x53, 0x1F, 0x0073, 31 }, // S
+    { 0x54, 0x54, 0x14, 0x0074, 20 }, // T
+    { 0x55, 0x55, 0x16, 0x0075, 22 }, // U
+    { 0x56, 0x56, 0x2F, 0x0076, 47 }, // V
+    { 0x57, 0x57, 0x11, 0x0077, 17 }, // W
+    { 0x58, 0x58, 0x2D, 0x0078, 45 }, // X
+    { 0x59, 0x59, 0x15, 0x0079, 21 }, // Y
+    { 0x5A, 0x5A, 0x2C, 0x007A, 44 }, // Z
+    { 0x5B, 0xDB, 0x1A, 0x005B, 26 }, // Bracket Left (VK_OEM_4)
+    { 0x5C, 0xDC, 0x2B, 0x005C, 43 }, // Backslash (VK_OEM_5)
+    { 0x5D, 0xDD, 0x1B, 0x005D, 27 }, // Bracket Right (VK_OEM_6)
+    { 0x60, 0xC0, 0x29, 0x0060, 41 }, // Quote Left (VK_OEM_3)
+    { 0xA5, 0x00, 0x7D, 0x00A5, 124 }, // Yen
+    { 0xA7, 0x00, 0x00, 0x00A7, 0 }, // Section
+};
+
+constexpr size_t KEY_ROW_COUNT = sizeof(KEY_ROWS) / sizeof(KEY_ROWS[0]);
+
+// Dense index helpers, out of range codes land on slot 0 which is always 0
+
+constexpr uint32_t godot_slot(uint32_t godot_keycode) {
+    const uint32_t valid = (godot_keycode & ~(GODOT_KEY_SPECIAL | 0xFFu)) == 0;
+    return ((godot_keycode & 0xFFu) | ((godot_keycode >> 14) & 0x100u)) * valid;
+}
+
+constexpr uint32_t bounded_slot(uint32_t code, uint32_t slots) {
+    return code * (code < slots);
+}
+
+// Latin-1 keysyms, the 0xFE00-0xFFFF function page and the XF86 media page
+constexpr uint32_t x11_keysym_slot(uint32_t keysym) {
+    const uint32_t latin = keysym < 0x100u;
+    const uint32_t function = (keysym >> 9) == 0x7Fu;
+    const uint32_t xf86 = (keysym >> 8) == 0x1008FFu;
+    return latin * keysym + function * (0x100u + (keysym & 0x1FFu)) + xf86 * (0x300u + (keysym & 0xFFu));
+}
+
+// Compile-time table builders
+
+template <size_t Slots>
+using KeyTable = std::array<uint32_t, Slots>;
+
+template <size_t Slots, typename Source>
+constexpr KeyTable<Slots> build_from_godot(Source source) {
+    KeyTable<Slots> table{};
+    for (size_t i = 0; i < KEY_ROW_COUNT; i++) {
+        table[godot_slot(KEY_ROWS[i].godot)] = source(KEY_ROWS[i]);
+    }
+    table[0] = 0;
+    return table;
+}
+
+template <size_t Slots, typename Source, typename Slot>
+constexpr KeyTable<Slots> build_to_godot(Source source, Slot slot) {
+    KeyTable<Slots> table{};
+    for (size_t i = 0; i < KEY_ROW_COUNT; i++) {
+        const uint32_t code = source(KEY_ROWS[i]);
+        if (code != 0 && table[slot(code)] == 0) {
+            table[slot(code)] = KEY_ROWS[i].godot;
+        }
+    }
+    table[0] = 0;
+    return table;
+}
+
+struct WindowsVkColumn {
+    constexpr uint32_t operator()(const KeyRow &row) const { return row.windows_vk; }
+};
+struct WindowsScancodeColumn {
+    constexpr uint32_t operator()(const KeyRow &row) const { return row.windows_scancode; }
+};
+struct X11KeysymColumn {
+    constexpr uint32_t operator()(const KeyRow &row) const { return row.x11_keysym; }
+};
+struct EvdevColumn {
+    constexpr uint32_t operator()(const KeyRow &row) const { return row.evdev; }
+};
+struct IdentitySlot {
+    constexpr uint32_t operator()(uint32_t code) const { return code; }
+};
+struct X11KeysymSlot {
+    constexpr uint32_t operator()(uint32_t code) const { return x11_keysym_slot(code); }
+};
+
+constexpr KeyTable<GODOT_KEY_SLOTS> GODOT_TO_WINDOWS_VK = build_from_godot<GODOT_KEY_SLOTS>(WindowsVkColumn());
+constexpr KeyTable<GODOT_KEY_SLOTS> GODOT_TO_WINDOWS_SCANCODE = build_from_godot<GODOT_KEY_SLOTS>(WindowsScancodeColumn());
+constexpr KeyTable<GODOT_KEY_SLOTS> GODOT_TO_X11_KEYSYM = build_from_godot<GODOT_KEY_SLOTS>(X11KeysymColumn());
+constexpr KeyTable<GODOT_KEY_SLOTS> GODOT_TO_EVDEV = build_from_godot<GODOT_KEY_SLOTS>(EvdevColumn());
+
+constexpr KeyTable<WINDOWS_VK_SLOTS> WINDOWS_VK_TO_GODOT = build_to_godot<WINDOWS_VK_SLOTS>(WindowsVkColumn(), IdentitySlot());
+constexpr KeyTable<WINDOWS_SCANCODE_SLOTS> WINDOWS_SCANCODE_TO_GODOT = build_to_godot<WINDOWS_SCANCODE_SLOTS>(WindowsScancodeColumn(), IdentitySlot());
+constexpr KeyTable<EVDEV_SLOTS> EVDEV_TO_GODOT = build_to_godot<EVDEV_SLOTS>(EvdevColumn(), IdentitySlot());
+
+constexpr KeyTable<X11_KEYSYM_SLOTS> build_x11_keysym_to_godot() {
+    KeyTable<X11_KEYSYM_SLOTS> table = build_to_godot<X11_KEYSYM_SLOTS>(X11KeysymColumn(), X11KeysymSlot());
+    // Upper case letter keysyms arrive with Shift or Caps Lock held
+    for (uint32_t letter = 'A'; letter <= 'Z'; letter++) {
+        table[x11_keysym_slot(letter)] = letter;
+    }
+    return table;
+}
+
+constexpr KeyTable<X11_KEYSYM_SLOTS> X11_KEYSYM_TO_GODOT = build_x11_keysym_to_godot();
+
+// Lookups
+
+constexpr uint32_t godot_to_windows_vk(uint32_t godot_keycode) {
+    return GODOT_TO_WINDOWS_VK[godot_slot(godot_keycode)];
+}
+
+constexpr uint32_t windows_vk_to_godot(uint32_t vk) {
+    return WINDOWS_VK_TO_GODOT[bounded_slot(vk, WINDOWS_VK_SLOTS)];
+}
+
+constexpr uint32_t godot_to_windows_scancode(uint32_t godot_keycode) {
+    return GODOT_TO_WINDOWS_SCANCODE[godot_slot(godot_keycode)];
+}
+
+constexpr uint32_t windows_scancode_to_godot(uint32_t scancode) {
+    return WINDOWS_SCANCODE_TO_GODOT[bounded_slot(scancode, WINDOWS_SCANCODE_SLOTS)];
+}
+
+constexpr uint32_t godot_to_x11_keysym(uint32_t godot_keycode) {
+    return GODOT_TO_X11_KEYSYM[godot_slot(godot_keycode)];
+}
+
+constexpr uint32_t x11_keysym_to_godot(uint32_t keysym) {
+    return X11_KEYSYM_TO_GODOT[x11_keysym_slot(keysym)];
+}
+
+constexpr uint32_t godot_to_evdev(uint32_t godot_keycode) {
+    return GODOT_TO_EVDEV[godot_slot(godot_keycode)];
+}
+
+constexpr uint32_t evdev_to_godot(uint32_t evdev_code) {
+    return EVDEV_TO_GODOT[bounded_slot(evdev_code, EVDEV_SLOTS)];
+}
+
+// WH_KEYBOARD_LL reports the sided modifier keys (VK_LSHIFT to VK_RMENU, VK_RWIN) while
+// Godot has one Shift, Ctrl, Alt and Meta, listed with the generic or left virtual key.
+// The hook publishes the generic key so bindings on a bare modifier match either side.
+constexpr uint32_t windows_generic_vk(uint32_t vk) {
+    switch (vk) {
+        case 0xA0: // VK_LSHIFT
+        case 0xA1: // VK_RSHIFT
+            return 0x10; // VK_SHIFT
+        case 0xA2: // VK_LCONTROL
+        case 0xA3: // VK_RCONTROL
+            return 0x11; // VK_CONTROL
+        case 0xA4: // VK_LMENU
+        case 0xA5: // VK_RMENU
+            return 0x12; // VK_MENU
+        case 0x5C: // VK_RWIN
+            return 0x5B; // VK_LWIN
+        default:
+            return vk;
+    }
+}
+
+// Exhaustive round trip over KEY_ROWS for one OS column, returns the index of the first
+// failing row or KEY_ROW_COUNT. Every row must translate to its own code, and its code
+// back to a Godot key translating to the same code: the row itself or the first one
+// sharing the code. A code colliding with another in its table's slot fails the second.
+template <typename Column>
+constexpr size_t find_round_trip_failure(Column column, uint32_t (*to_os)(uint32_t), uint32_t (*to_godot)(uint32_t)) {
+    for (size_t i = 0; i < KEY_ROW_COUNT; i++) {
+        const uint32_t code = column(KEY_ROWS[i]);
+        if (godot_slot(KEY_ROWS[i].godot) == 0 || to_os(KEY_ROWS[i].godot) != code) {
+            return i;
+        }
+        if (code != 0 && to_os(to_godot(code)) != code) {
+            return i;
+        }
+    }
+    return KEY_ROW_COUNT;
+}
+
+static_assert(find_round_trip_failure(WindowsVkColumn(), godot_to_windows_vk, windows_vk_to_godot) == KEY_ROW_COUNT,
+        "Every KEY_ROWS entry must round-trip through Windows virtual keys");
+static_assert(find_round_trip_failure(WindowsScancodeColumn(), godot_to_windows_scancode, windows_scancode_to_godot) == KEY_ROW_COUNT,
+        "Every KEY_ROWS entry must round-trip through Windows scancodes");
+static_assert(find_round_trip_failure(X11KeysymColumn(), godot_to_x11_keysym, x11_keysym_to_godot) == KEY_ROW_COUNT,
+        "Every KEY_ROWS entry must round-trip through X11 keysyms");
+static_assert(find_round_trip_failure(EvdevColumn(), godot_to_evdev, evdev_to_godot) == KEY_ROW_COUNT,
+        "Every KEY_ROWS entry must round-trip through evdev codes");
+static_assert(windows_vk_to_godot(windows_generic_vk(0xA3)) == special(0x16) && godot_to_windows_vk(special(0x16)) == windows_generic_vk(0xA2),
+        "Both Ctrl keys reported by the hook must match a Ctrl binding");
+static_assert(godot_to_windows_vk(special(0x1C)) == 0x70, "F1 must map to VK_F1");
+static_assert(windows_vk_to_godot(0x0D) == special(0x05), "VK_RETURN must map back to Enter");
+static_assert(x11_keysym_to_godot(0x61) == 0x41 && x11_keysym_to_godot(0x41) == 0x41, "Letter keysyms must map to Godot letters");
+static_assert(evdev_to_godot(godot_to_evdev(special(0x10))) == special(0x10), "Arrow keys must round-trip through evdev");
+static_assert(godot_to_windows_vk(special(0x7FFFFF)) == 0, "Unknown keys must not map");
+
+} // namespace keycodes
+} // namespace godot
+
+#endif // KEYCODE_TABLES_H
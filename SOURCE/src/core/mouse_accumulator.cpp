@@ -0,0 +1,65 @@
+#include "mouse_accumulator.h"
+
+namespace godot {
+
+double MouseAccumulator::Frame::get_notches(Button button, uint8_t modifiers) const {
+    if (!is_wheel(button)) {
+        return 0.0;
+    }
+    bool vertical = button == BUTTON_WHEEL_UP || button == BUTTON_WHEEL_DOWN;
+    int64_t delta = wheel[vertical ? WHEEL_VERTICAL : WHEEL_HORIZONTAL][modifiers & (MODIFIER_COMBINATIONS - 1)];
+    if (button == BUTTON_WHEEL_DOWN || button == BUTTON_WHEEL_LEFT) {
+        delta = -delta;
+    }
+    return delta > 0 ? double(delta) / WHEEL_NOTCH : 0.0;
+}
+
+void MouseAccumulator::Reader::sync(const MouseAccumulator &source) {
+    Frame discarded;
+    take(source, discarded);
+}
+
+bool MouseAccumulator::Reader::take(const MouseAccumulator &source, Frame &r_frame) {
+    // One load when nothing happened, which is most frames
+    uint64_t current_events = source.events.load(std::memory_order_acquire);
+    if (current_events == events) {
+        return false;
+    }
+    r_frame.events = current_events - events;
+    events = current_events;
+
+    // Totals may already include records after the count, the next take then
+    // finds them missing from the difference instead of counting them twice
+    uint64_t current_motion_events = source.motion_events.load(std::memory_order_relaxed);
+    int64_t current_motion_x = source.motion_x.load(std::memory_order_relaxed);
+    int64_t current_motion_y = source.motion_y.load(std::memory_order_relaxed);
+    r_frame.motion_events = current_motion_events - motion_events;
+    r_frame.motion_x = current_motion_x - motion_x;
+    r_frame.motion_y = current_motion_y - motion_y;
+    motion_events = current_motion_events;
+    motion_x = current_motion_x;
+    motion_y = current_motion_y;
+
+    uint64_t packed = source.position.load(std::memory_order_relaxed);
+    r_frame.x = int32_t(uint32_t(packed >> 32));
+    r_frame.y = int32_t(uint32_t(packed));
+    r_frame.last_usec = source.last_usec.load(std::memory_order_relaxed);
+
+    for (int button = 0; button < PRESS_BUTTONS; button++) {
+        for (int modifiers = 0; modifiers < MODIFIER_COMBINATIONS; modifiers++) {
+            uint64_t total = source.presses[button][modifiers].load(std::memory_order_relaxed);
+            r_frame.presses[button][modifiers] = uint32_t(total - presses[button][modifiers]);
+            presses[button][modifiers] = total;
+        }
+    }
+    for (int axis = 0; axis < WHEEL_AXES; axis++) {
+        for (int modifiers = 0; modifiers < MODIFIER_COMBINATIONS; modifiers++) {
+            int64_t total = source.wheel[axis][modifiers].load(std::memory_order_relaxed);
+            r_frame.wheel[axis][modifiers] = total - wheel[axis][modifiers];
+            wheel[axis][modifiers] = total;
+        }
+    }
+    return true;
+}
+
+} // namespace godot
@@ -0,0 +1,156 @@
+#ifndef MOUSE_ACCUMULATOR_H
+#define MOUSE_ACCUMULATOR_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "keybind_table.h"
+
+namespace godot {
+
+// Coalesces global mouse input on the listener thread. A 1000-8000 Hz mouse reports far
+// more often than a frame is drawn, so nothing is queued per event: the hook adds into
+// running totals with plain stores and returns. Each reader remembers the totals it took
+// last and gets the difference once a frame, one record however many events went by.
+// Only the listener thread writes; any number of readers may take from the same totals.
+class MouseAccumulator {
+public:
+    // Buttons a binding can name, wheel directions count as buttons
+    enum Button : uint8_t {
+        BUTTON_LEFT,
+        BUTTON_RIGHT,
+        BUTTON_MIDDLE,
+        BUTTON_X1, // Back
+        BUTTON_X2, // Forward
+        BUTTON_WHEEL_UP,
+        BUTTON_WHEEL_DOWN,
+        BUTTON_WHEEL_LEFT,
+        BUTTON_WHEEL_RIGHT,
+        BUTTON_COUNT,
+    };
+    static constexpr int PRESS_BUTTONS = BUTTON_WHEEL_UP; // Buttons before the wheel are pressed
+    static constexpr int MODIFIER_COMBINATIONS = KeybindTable::MODIFIER_COMBINATIONS;
+
+    // Wheel delta of one notch, as Windows reports it. Precise wheels send fractions.
+    static constexpr int32_t WHEEL_NOTCH = 120;
+
+    enum WheelAxis : uint8_t {
+        WHEEL_VERTICAL, // Positive away from the user
+        WHEEL_HORIZONTAL, // Positive to the right
+        WHEEL_AXES,
+    };
+
+    static bool is_wheel(Button button) {
+        return button >= BUTTON_WHEEL_UP && button < BUTTON_COUNT;
+    }
+
+    // Input since a reader's last take
+    struct Frame {
+        uint64_t events = 0; // Hook records folded into this frame
+        uint64_t motion_events = 0;
+        int64_t motion_x = 0; // Summed motion in screen pixels
+        int64_t motion_y = 0;
+        int32_t x = 0; // Last position, where the platform reports one
+        int32_t y = 0;
+        uint64_t last_usec = 0; // Time of the newest record
+        uint32_t presses[PRESS_BUTTONS][MODIFIER_COMBINATIONS] = {};
+        int64_t wheel[WHEEL_AXES][MODIFIER_COMBINATIONS] = {}; // Net delta per modifier mask
+
+        uint32_t get_presses(Button button, uint8_t modifiers) const {
+            return button < PRESS_BUTTONS ? presses[button][modifiers & (MODIFIER_COMBINATIONS - 1)] : 0;
+        }
+
+        // Net notches in the direction the wheel button names, 0 when it went the other way
+        double get_notches(Button button, uint8_t modifiers) const;
+    };
+
+    // Totals one reader has taken so far, owned by that reader's thread
+    class Reader {
+    public:
+        // Start from the current totals, earlier input is not reported
+        void sync(const MouseAccumulator &source);
+
+        // Fill the frame with input since the last take, false when there was none.
+        // Input arriving while this runs lands in this frame or the next, never both.
+        bool take(const MouseAccumulator &source, Frame &r_frame);
+
+    private:
+        uint64_t events = 0;
+        uint64_t motion_events = 0;
+        int64_t motion_x = 0;
+        int64_t motion_y = 0;
+        uint64_t presses[PRESS_BUTTONS][MODIFIER_COMBINATIONS] = {};
+        int64_t wheel[WHEEL_AXES][MODIFIER_COMBINATIONS] = {};
+    };
+
+    // Listener thread. Absolute positions are turned into motion here, the first one
+    // only sets the origin.
+    void add_position(int32_t x, int32_t y, uint64_t timestamp_usec) {
+        if (has_position) {
+            add_motion(x - last_x, y - last_y, timestamp_usec);
+        }
+        has_position = true;
+        last_x = x;
+        last_y = y;
+        position.store(pack_position(x, y), std::memory_order_relaxed);
+    }
+
+    void add_motion(int32_t dx, int32_t dy, uint64_t timestamp_usec) {
+        add(motion_events, 1);
+        add(motion_x, dx);
+        add(motion_y, dy);
+        finish(timestamp_usec);
+    }
+
+    void add_press(Button button, uint8_t modifiers, uint64_t timestamp_usec) {
+        if (button < PRESS_BUTTONS) {
+            add(presses[button][modifiers & (MODIFIER_COMBINATIONS - 1)], 1);
+            finish(timestamp_usec);
+        }
+    }
+
+    void add_wheel(WheelAxis axis, int32_t delta, uint8_t modifiers, uint64_t timestamp_usec) {
+        add(wheel[axis][modifiers & (MODIFIER_COMBINATIONS - 1)], delta);
+        finish(timestamp_usec);
+    }
+
+    // Records added so far
+    uint64_t get_event_count() const {
+        return events.load(std::memory_order_acquire);
+    }
+
+private:
+    // Single writer: plain load/store pairs avoid locked read-modify-writes
+    template <typename T, typename V>
+    static void add(std::atomic<T> &total, V value) {
+        total.store(total.load(std::memory_order_relaxed) + static_cast<T>(value), std::memory_order_relaxed);
+    }
+
+    // Published last, a reader that sees the count sees the totals it covers
+    void finish(uint64_t timestamp_usec) {
+        last_usec.store(timestamp_usec, std::memory_order_relaxed);
+        events.store(events.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    static uint64_t pack_position(int32_t x, int32_t y) {
+        return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+    }
+
+    std::atomic<uint64_t> events{ 0 };
+    std::atomic<uint64_t> last_usec{ 0 };
+    std::atomic<uint64_t> position{ 0 };
+    std::atomic<uint64_t> motion_events{ 0 };
+    std::atomic<int64_t> motion_x{ 0 };
+    std::atomic<int64_t> motion_y{ 0 };
+    std::atomic<uint64_t> presses[PRESS_BUTTONS][MODIFIER_COMBINATIONS] = {};
+    std::atomic<int64_t> wheel[WHEEL_AXES][MODIFIER_COMBINATIONS] = {};
+
+    // Listener thread only
+    bool has_position = false;
+    int32_t last_x = 0;
+    int32_t last_y = 0;
+};
+
+} // namespace godot
+
+#endif // MOUSE_ACCUMULATOR_H
@@ -0,0 +1,112 @@
+#ifndef NATIVE_WORKER_H
+#define NATIVE_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace godot {
+
+// Single background thread for native calls that can block on other
+// processes (e.g. focusing a window while the foreground app is hung).
+// Callers never wait for a job, they only queue it, and stop never waits either:
+// the thread is detached and owns the queue together with the worker, so a job
+// stuck in the OS finishes on its own after the worker is gone. Jobs therefore
+// capture values only, never the object that posted them.
+class NativeWorker {
+public:
+    // Returns false when the native call failed
+    using Job = std::function<bool()>;
+
+    NativeWorker() :
+            state(std::make_shared<State>()) {}
+    ~NativeWorker() {
+        stop();
+    }
+
+    NativeWorker(const NativeWorker &) = delete;
+    NativeWorker &operator=(const NativeWorker &) = delete;
+
+    // Queue a job, starting the thread on first use.
+    // Jobs with the same non-zero key replace a queued one instead of piling up.
+    void post(int key, Job job) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->started) {
+            state->started = true;
+            std::thread(&NativeWorker::run, state).detach();
+        }
+        if (key != 0) {
+            for (Entry &queued : state->jobs) {
+                if (queued.key == key) {
+                    queued.job = std::move(job);
+                    return;
+                }
+            }
+        }
+        state->jobs.push_back({ key, std::move(job) });
+        state->condition.notify_one();
+    }
+
+    // Drop queued jobs and let the thread go, a job already running finishes on its
+    // own. The next post starts a fresh thread.
+    void stop() {
+        std::shared_ptr<State> fresh = std::make_shared<State>();
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->stopped = true;
+            state->jobs.clear();
+            state->condition.notify_one();
+            fresh->failures.store(state->failures.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        state = std::move(fresh);
+    }
+
+    // Jobs that returned false, since the worker was made
+    uint64_t get_failure_count() const {
+        return state->failures.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        int key;
+        Job job;
+    };
+
+    // Shared by the worker and its thread, freed by whichever lets go last
+    struct State {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Entry> jobs;
+        bool started = false;
+        bool stopped = false;
+        std::atomic<uint64_t> failures{ 0 };
+    };
+
+    static void run(std::shared_ptr<State> state) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (!state->stopped) {
+            if (state->jobs.empty()) {
+                state->condition.wait(lock);
+                continue;
+            }
+            Entry entry = std::move(state->jobs.front());
+            state->jobs.pop_front();
+            lock.unlock();
+            if (!entry.job()) {
+                state->failures.fetch_add(1, std::memory_order_relaxed);
+            }
+            lock.lock();
+        }
+    }
+
+    std::shared_ptr<State> state;
+};
+
+} // namespace godot
+
+#endif // NATIVE_WORKER_H
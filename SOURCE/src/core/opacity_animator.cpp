@@ -0,0 +1,187 @@
+#include "opacity_animator.h"
+
+#include "key_event_queue.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace godot {
+
+double OpacityAnimator::evaluate_curve(Curve curve, double t) {
+    if (t <= 0.0) {
+        return 0.0;
+    }
+    if (t >= 1.0) {
+        return 1.0;
+    }
+    switch (curve) {
+        case CURVE_EASE_IN:
+            return t * t * t;
+        case CURVE_EASE_OUT: {
+            double u = 1.0 - t;
+            return 1.0 - u * u * u;
+        }
+        case CURVE_EASE_IN_OUT:
+            // Smoothstep, zero slope at both ends
+            return t * t * (3.0 - 2.0 * t);
+        default:
+            return t;
+    }
+}
+
+uint8_t OpacityAnimator::sample(uint8_t from, uint8_t to, uint64_t elapsed_usec, uint64_t duration_usec, Curve curve) {
+    if (elapsed_usec >= duration_usec) {
+        return to;
+    }
+    double progress = evaluate_curve(curve, static_cast<double>(elapsed_usec) / static_cast<double>(duration_usec));
+    return static_cast<uint8_t>(std::lround(from + (static_cast<double>(to) - from) * progress));
+}
+
+void OpacityAnimator::set_sink(Sink new_sink) {
+    std::lock_guard<std::mutex> lock(mutex);
+    sink = std::move(new_sink);
+}
+
+void OpacityAnimator::set_step_rate(int steps_per_second) {
+    step_rate.store(steps_per_second < 1 ? 1 : (steps_per_second > 1000 ? 1000 : steps_per_second), std::memory_order_relaxed);
+}
+
+void OpacityAnimator::set_alpha(uint8_t value) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fading.load(std::memory_order_relaxed)) {
+        fading.store(false, std::memory_order_release);
+        stats.fades_interrupted.fetch_add(1, std::memory_order_relaxed);
+        generation++;
+    }
+    step_done.wait(lock, [this] { return !stepping; });
+    alpha.store(value, std::memory_order_release);
+}
+
+void OpacityAnimator::fade_to(uint8_t new_target, uint64_t new_duration_usec, Curve new_curve) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!thread.joinable()) {
+        running = true;
+        thread = std::thread(&OpacityAnimator::run, this);
+    }
+    if (fading.load(std::memory_order_relaxed)) {
+        stats.fades_interrupted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A replaced fade continues from wherever it got to
+    from = alpha.load(std::memory_order_relaxed);
+    target = new_target;
+    start_usec = get_monotonic_usec();
+    duration_usec = new_duration_usec;
+    curve = new_curve < CURVE_COUNT ? new_curve : CURVE_LINEAR;
+    generation++;
+    fading.store(true, std::memory_order_release);
+    stats.fades_started.fetch_add(1, std::memory_order_relaxed);
+    condition.notify_one();
+}
+
+void OpacityAnimator::cancel() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fading.load(std::memory_order_relaxed)) {
+        fading.store(false, std::memory_order_release);
+        stats.fades_interrupted.fetch_add(1, std::memory_order_relaxed);
+        generation++;
+        condition.notify_one();
+    }
+    // The caller sets alpha or visibility next, a step still in the sink would land after it
+    step_done.wait(lock, [this] { return !stepping; });
+}
+
+uint8_t OpacityAnimator::get_target() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return fading.load(std::memory_order_relaxed) ? target : alpha.load(std::memory_order_relaxed);
+}
+
+void OpacityAnimator::stop() {
+    cancel();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        condition.notify_one();
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void OpacityAnimator::reset_stats() {
+    stats.fades_started.store(0, std::memory_order_relaxed);
+    stats.fades_finished.store(0, std::memory_order_relaxed);
+    stats.fades_interrupted.store(0, std::memory_order_relaxed);
+    stats.steps.store(0, std::memory_order_relaxed);
+    stats.step_failures.store(0, std::memory_order_relaxed);
+    stats.step_lag_usec.reset();
+}
+
+void OpacityAnimator::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t seen_generation = 0;
+    uint64_t due_usec = 0;
+    while (running) {
+        if (!fading.load(std::memory_order_relaxed)) {
+            condition.wait(lock);
+            continue;
+        }
+
+        // A new fade takes its first step right away
+        uint64_t now_usec = get_monotonic_usec();
+        if (generation != seen_generation) {
+            seen_generation = generation;
+            due_usec = now_usec;
+        } else if (now_usec < due_usec) {
+            // Woken early by a change that left this fade running
+            condition.wait_for(lock, std::chrono::microseconds(due_usec - now_usec));
+            continue;
+        }
+        stats.step_lag_usec.record(now_usec - due_usec);
+
+        uint64_t elapsed_usec = now_usec > start_usec ? now_usec - start_usec : 0;
+        uint8_t value = sample(from, target, elapsed_usec, duration_usec, curve);
+        bool reached = elapsed_usec >= duration_usec;
+        if (value != alpha.load(std::memory_order_relaxed)) {
+            // The window call is made unlocked, cancel and set_alpha wait for it
+            stepping = true;
+            lock.unlock();
+            bool accepted = sink && sink(value);
+            lock.lock();
+            stepping = false;
+            step_done.notify_all();
+            stats.steps.fetch_add(1, std::memory_order_relaxed);
+            if (generation != seen_generation) {
+                continue; // Replaced or cancelled meanwhile, the new owner of alpha decides
+            }
+            if (!accepted) {
+                stats.step_failures.fetch_add(1, std::memory_order_relaxed);
+                stats.fades_interrupted.fetch_add(1, std::memory_order_relaxed);
+                fading.store(false, std::memory_order_release);
+                finished_serial.fetch_add(1, std::memory_order_release);
+                continue;
+            }
+            alpha.store(value, std::memory_order_release);
+        }
+        if (reached) {
+            stats.fades_finished.fetch_add(1, std::memory_order_relaxed);
+            fading.store(false, std::memory_order_release);
+            finished_serial.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+
+        // Steps keep a fixed cadence, the last one lands on the end of the fade
+        uint64_t step_usec = 1000000 / step_rate.load(std::memory_order_relaxed);
+        uint64_t end_usec = start_usec + duration_usec;
+        due_usec += step_usec;
+        if (due_usec < now_usec) {
+            due_usec = now_usec + step_usec; // Missed steps are skipped, not caught up
+        }
+        if (due_usec > end_usec) {
+            due_usec = end_usec;
+        }
+        condition.wait_for(lock, std::chrono::microseconds(due_usec > now_usec ? due_usec - now_usec : 0));
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,130 @@
+#ifndef OPACITY_ANIMATOR_H
+#define OPACITY_ANIMATOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "overlay_stats.h"
+
+namespace godot {
+
+// Animates window-level alpha on its own thread, so a fade needs no rendered frame.
+// The thread sleeps until a fade starts, then wakes step_rate times a second and hands
+// every new alpha to the sink, which sets it on the native window. An alpha equal to
+// the last one is not passed on, a fade makes at most 255 sink calls.
+// Control methods are called from one thread, the sink runs on the animator thread.
+class OpacityAnimator {
+public:
+    enum Curve : uint8_t {
+        CURVE_LINEAR,
+        CURVE_EASE_IN, // Slow start
+        CURVE_EASE_OUT, // Slow end
+        CURVE_EASE_IN_OUT, // Slow start and end
+        CURVE_COUNT,
+    };
+
+    // Returns false when the window refused the alpha, which ends the fade
+    using Sink = std::function<bool(uint8_t alpha)>;
+
+    struct Stats {
+        std::atomic<uint64_t> fades_started{ 0 };
+        std::atomic<uint64_t> fades_finished{ 0 };
+        std::atomic<uint64_t> fades_interrupted{ 0 }; // Replaced, cancelled or failed
+        std::atomic<uint64_t> steps{ 0 }; // Sink calls
+        std::atomic<uint64_t> step_failures{ 0 };
+        LatencyHistogram step_lag_usec; // How late each wake-up was
+    };
+
+    // Progress along the curve for t in [0, 1], exactly 0 and 1 at the ends
+    static double evaluate_curve(Curve curve, double t);
+
+    // Alpha at elapsed_usec into a fade from one alpha to another
+    static uint8_t sample(uint8_t from, uint8_t to, uint64_t elapsed_usec, uint64_t duration_usec, Curve curve);
+
+    OpacityAnimator() = default;
+    ~OpacityAnimator() {
+        stop();
+    }
+
+    OpacityAnimator(const OpacityAnimator &) = delete;
+    OpacityAnimator &operator=(const OpacityAnimator &) = delete;
+
+    // Set before the first fade, the sink is not swapped under a running fade
+    void set_sink(Sink sink);
+
+    void set_step_rate(int steps_per_second);
+    int get_step_rate() const {
+        return step_rate.load(std::memory_order_relaxed);
+    }
+
+    // Alpha the window was last given, by a step or by set_alpha
+    uint8_t get_alpha() const {
+        return alpha.load(std::memory_order_acquire);
+    }
+
+    // Record an alpha applied elsewhere, a running fade is cancelled where it is.
+    // Like cancel, returns once no step is in the sink.
+    void set_alpha(uint8_t value);
+
+    // Start fading from the current alpha, replacing a running fade.
+    // A zero duration or an unchanged alpha finishes on the first step.
+    void fade_to(uint8_t target, uint64_t duration_usec, Curve curve);
+
+    // Stop a running fade at the alpha it reached. A step already handed to the sink is
+    // waited for, so nothing from the fade reaches the window after this returns.
+    void cancel();
+
+    bool is_fading() const {
+        return fading.load(std::memory_order_acquire);
+    }
+
+    // Target of the running fade, the current alpha otherwise
+    uint8_t get_target() const;
+
+    // Bumped by the thread when a fade reaches its target or the sink refuses an alpha,
+    // so the owner notices without a callback. Cancelled and replaced fades do not count.
+    uint64_t get_finished_serial() const {
+        return finished_serial.load(std::memory_order_acquire);
+    }
+
+    // Cancel and join the thread, it starts again with the next fade
+    void stop();
+
+    const Stats &get_stats() const {
+        return stats;
+    }
+    void reset_stats();
+
+private:
+    void run();
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::condition_variable step_done;
+    std::thread thread;
+    bool running = false;
+    bool stepping = false; // The sink is running, unlocked
+    Sink sink;
+
+    // Fade parameters, guarded by the mutex. A new generation tells the thread to restart.
+    uint8_t from = 255;
+    uint8_t target = 255;
+    uint64_t start_usec = 0;
+    uint64_t duration_usec = 0;
+    Curve curve = CURVE_LINEAR;
+    uint64_t generation = 0;
+
+    std::atomic<int> step_rate{ 120 };
+    std::atomic<uint8_t> alpha{ 255 };
+    std::atomic<bool> fading{ false };
+    std::atomic<uint64_t> finished_serial{ 0 };
+    Stats stats;
+};
+
+} // namespace godot
+
+#endif // OPACITY_ANIMATOR_H
@@ -0,0 +1,153 @@
+#include "overlay_log.h"
+
+#include <cstdarg>
+#include <cstring>
+
+#include "key_event_queue.h"
+
+namespace godot {
+
+std::atomic<int> OverlayLog::runtime_level{ OVERLAY_LOG_INFO };
+std::atomic<uint64_t> OverlayLog::dropped{ 0 };
+OverlayLog::Cell OverlayLog::cells[OverlayLog::CAPACITY];
+std::atomic<size_t> OverlayLog::enqueue_position{ 0 };
+std::atomic<size_t> OverlayLog::dequeue_position{ 0 };
+FILE *OverlayLog::file = nullptr;
+
+void OverlayLog::set_level(int level) {
+    if (level < OVERLAY_LOG_NONE) {
+        level = OVERLAY_LOG_NONE;
+    } else if (level > OVERLAY_LOG_VERBOSE) {
+        level = OVERLAY_LOG_VERBOSE;
+    }
+    runtime_level.store(level, std::memory_order_relaxed);
+}
+
+int OverlayLog::get_level() {
+    return runtime_level.load(std::memory_order_relaxed);
+}
+
+bool OverlayLog::set_file(const char *path) {
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    if (!path || !path[0]) {
+        return true;
+    }
+    file = fopen(path, "a");
+    return file != nullptr;
+}
+
+const char *OverlayLog::get_level_name(int level) {
+    switch (level) {
+        case OVERLAY_LOG_ERROR:
+            return "ERROR";
+        case OVERLAY_LOG_WARNING:
+            return "WARNING";
+        case OVERLAY_LOG_INFO:
+            return "INFO";
+        case OVERLAY_LOG_VERBOSE:
+            return "VERBOSE";
+        default:
+            return "NONE";
+    }
+}
+
+void OverlayLog::write(int level, const char *format, ...) {
+    char text[sizeof(OverlayLogRecord::text)];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    // Messages keep their trailing newline out of the record, sinks add their own
+    size_t length = strlen(text);
+    while (length > 0 && text[length - 1] == '\n') {
+        text[--length] = '\0';
+    }
+
+    if (!push(level, text)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Cells start with their own index as sequence, set once before first use
+void OverlayLog::initialize_cells() {
+    static const bool initialized = []() {
+        for (size_t i = 0; i < CAPACITY; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        return true;
+    }();
+    (void)initialized;
+}
+
+// Bounded MPMC queue (Vyukov): each cell's sequence number tells producers
+// and consumers whether the slot is free for the current lap
+bool OverlayLog::push(int level, const char *text) {
+    initialize_cells();
+
+    size_t position = enqueue_position.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+        cell = &cells[position & (CAPACITY - 1)];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false; // Full
+        } else {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record.timestamp_usec = get_monotonic_usec();
+    cell->record.level = level;
+    strncpy(cell->record.text, text, sizeof(cell->record.text) - 1);
+    cell->record.text[sizeof(cell->record.text) - 1] = '\0';
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool OverlayLog::pop(OverlayLogRecord &r_record) {
+    initialize_cells();
+
+    size_t position = dequeue_position.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+        cell = &cells[position & (CAPACITY - 1)];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+        if (difference == 0) {
+            if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false; // Empty
+        } else {
+            position = dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    r_record = cell->record;
+    cell->sequence.store(position + CAPACITY, std::memory_order_release);
+    return true;
+}
+
+void OverlayLog::write_to_file(const OverlayLogRecord &record) {
+    if (file) {
+        fprintf(file, "%llu [%s] %s\n", (unsigned long long)record.timestamp_usec, get_level_name(record.level), record.text);
+    }
+}
+
+void OverlayLog::flush_file() {
+    if (file) {
+        fflush(file);
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,115 @@
+#ifndef OVERLAY_LOG_H
+#define OVERLAY_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace godot {
+
+enum OverlayLogLevel : int {
+    OVERLAY_LOG_NONE,
+    OVERLAY_LOG_ERROR,
+    OVERLAY_LOG_WARNING,
+    OVERLAY_LOG_INFO,
+    OVERLAY_LOG_VERBOSE,
+};
+
+// Highest level compiled in. Release templates keep errors and warnings only,
+// everything above is removed by the compiler together with its arguments.
+#ifndef OVERLAY_LOG_COMPILE_LEVEL
+#ifdef DEBUG_ENABLED
+#define OVERLAY_LOG_COMPILE_LEVEL OVERLAY_LOG_VERBOSE
+#else
+#define OVERLAY_LOG_COMPILE_LEVEL OVERLAY_LOG_WARNING
+#endif
+#endif
+
+// Formatted message waiting to be flushed
+struct OverlayLogRecord {
+    uint64_t timestamp_usec = 0;
+    int level = OVERLAY_LOG_NONE;
+    char text[240];
+};
+
+// Process wide log. Writers format into a fixed slot of a bounded lock-free
+// MPMC ring and return; the main thread flushes the ring to Godot's output
+// or a file outside of any hot path.
+class OverlayLog {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    static bool is_enabled(int level) {
+        return level <= runtime_level.load(std::memory_order_relaxed);
+    }
+
+    static void set_level(int level);
+    static int get_level();
+
+    // Mirror flushed records to a file, an empty path closes it
+    static bool set_file(const char *path);
+
+    static void write(int level, const char *format, ...)
+#if defined(__GNUC__)
+            __attribute__((format(printf, 2, 3)))
+#endif
+            ;
+
+    // Pops every pending record into p_sink, then mirrors it to the log file
+    template <typename F>
+    static size_t flush(F &&p_sink) {
+        size_t count = 0;
+        OverlayLogRecord record;
+        while (pop(record)) {
+            p_sink(record);
+            write_to_file(record);
+            count++;
+        }
+        if (count > 0) {
+            flush_file();
+        }
+        return count;
+    }
+
+    static uint64_t get_dropped_count() {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    static const char *get_level_name(int level);
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        OverlayLogRecord record;
+    };
+
+    static void initialize_cells();
+    static bool push(int level, const char *text);
+    static bool pop(OverlayLogRecord &r_record);
+    static void write_to_file(const OverlayLogRecord &record);
+    static void flush_file();
+
+    static std::atomic<int> runtime_level;
+    static std::atomic<uint64_t> dropped;
+    static Cell cells[CAPACITY];
+    alignas(64) static std::atomic<size_t> enqueue_position;
+    alignas(64) static std::atomic<size_t> dequeue_position;
+    static FILE *file;
+};
+
+} // namespace godot
+
+#define OVERLAY_LOG(level, ...)                                                          \
+    do {                                                                                 \
+        if ((level) <= OVERLAY_LOG_COMPILE_LEVEL && ::godot::OverlayLog::is_enabled(level)) { \
+            ::godot::OverlayLog::write((level), __VA_ARGS__);                            \
+        }                                                                                \
+    } while (0)
+
+#define OVERLAY_LOG_ERROR(...) OVERLAY_LOG(::godot::OVERLAY_LOG_ERROR, __VA_ARGS__)
+#define OVERLAY_LOG_WARNING(...) OVERLAY_LOG(::godot::OVERLAY_LOG_WARNING, __VA_ARGS__)
+#define OVERLAY_LOG_INFO(...) OVERLAY_LOG(::godot::OVERLAY_LOG_INFO, __VA_ARGS__)
+#define OVERLAY_LOG_VERBOSE(...) OVERLAY_LOG(::godot::OVERLAY_LOG_VERBOSE, __VA_ARGS__)
+
+#endif // OVERLAY_LOG_H
@@ -0,0 +1,111 @@
+#ifndef OVERLAY_STATE_H
+#define OVERLAY_STATE_H
+
+#include <cstdint>
+
+namespace godot {
+
+// Fields of OverlayState, used as a change mask
+enum OverlayStateField : uint32_t {
+    OVERLAY_STATE_BORDERLESS = 1 << 0,
+    OVERLAY_STATE_TOPMOST = 1 << 1,
+    OVERLAY_STATE_LAYERED = 1 << 2,
+    OVERLAY_STATE_COLOR_KEY = 1 << 3,
+    OVERLAY_STATE_ALPHA = 1 << 4,
+    OVERLAY_STATE_PASSTHROUGH = 1 << 5,
+    OVERLAY_STATE_VISIBLE = 1 << 6,
+    OVERLAY_STATE_PER_PIXEL_ALPHA = 1 << 7,
+    OVERLAY_STATE_ALL = (1 << 8) - 1,
+};
+
+// Complete description of the native window state an overlay wants.
+// Backends diff it against what they last applied and only touch what changed.
+struct OverlayState {
+    bool borderless = false;
+    bool topmost = false;
+    bool layered = false; // Transparent background
+    bool use_color_key = true;
+    uint32_t color_key = 0x000000; // 0xRRGGBB made transparent while layered
+    uint8_t alpha = 255; // Whole window opacity while visible
+    bool passthrough = false; // Input falls through to the windows below
+    bool visible = true;
+    bool per_pixel_alpha = false; // Layered from the rendered alpha instead of the color key
+
+    // Default state of a normal window, what disable_overlay returns to
+    static OverlayState normal_window() {
+        return OverlayState();
+    }
+
+    // State enable_overlay applies
+    static OverlayState overlay_window() {
+        OverlayState state;
+        state.borderless = true;
+        state.topmost = true;
+        state.layered = true;
+        state.passthrough = true;
+        return state;
+    }
+};
+
+// Mask of fields that differ between two states
+inline uint32_t diff_overlay_state(const OverlayState &from, const OverlayState &to) {
+    uint32_t changed = 0;
+    if (from.borderless != to.borderless) {
+        changed |= OVERLAY_STATE_BORDERLESS;
+    }
+    if (from.topmost != to.topmost) {
+        changed |= OVERLAY_STATE_TOPMOST;
+    }
+    if (from.layered != to.layered) {
+        changed |= OVERLAY_STATE_LAYERED;
+    }
+    if (from.use_color_key != to.use_color_key || from.color_key != to.color_key) {
+        changed |= OVERLAY_STATE_COLOR_KEY;
+    }
+    if (from.alpha != to.alpha) {
+        changed |= OVERLAY_STATE_ALPHA;
+    }
+    if (from.passthrough != to.passthrough) {
+        changed |= OVERLAY_STATE_PASSTHROUGH;
+    }
+    if (from.visible != to.visible) {
+        changed |= OVERLAY_STATE_VISIBLE;
+    }
+    if (from.per_pixel_alpha != to.per_pixel_alpha) {
+        changed |= OVERLAY_STATE_PER_PIXEL_ALPHA;
+    }
+    return changed;
+}
+
+// Copy the fields in mask from source into target
+inline void merge_overlay_state(OverlayState &target, const OverlayState &source, uint32_t mask) {
+    if (mask & OVERLAY_STATE_BORDERLESS) {
+        target.borderless = source.borderless;
+    }
+    if (mask & OVERLAY_STATE_TOPMOST) {
+        target.topmost = source.topmost;
+    }
+    if (mask & OVERLAY_STATE_LAYERED) {
+        target.layered = source.layered;
+    }
+    if (mask & OVERLAY_STATE_COLOR_KEY) {
+        target.use_color_key = source.use_color_key;
+        target.color_key = source.color_key;
+    }
+    if (mask & OVERLAY_STATE_ALPHA) {
+        target.alpha = source.alpha;
+    }
+    if (mask & OVERLAY_STATE_PASSTHROUGH) {
+        target.passthrough = source.passthrough;
+    }
+    if (mask & OVERLAY_STATE_VISIBLE) {
+        target.visible = source.visible;
+    }
+    if (mask & OVERLAY_STATE_PER_PIXEL_ALPHA) {
+        target.per_pixel_alpha = source.per_pixel_alpha;
+    }
+}
+
+} // namespace godot
+
+#endif // OVERLAY_STATE_H
@@ -0,0 +1,63 @@
+#ifndef OVERLAY_STATE_APPLIER_H
+#define OVERLAY_STATE_APPLIER_H
+
+#include <cstdint>
+
+#include "overlay_state.h"
+
+namespace godot {
+
+// Brings a native window to an OverlayState in as few calls as possible: the state last
+// applied is cached and only fields that differ from it, or were marked stale, reach
+// apply_changes, all in one batch. Fields the OS refused stay stale and are applied
+// again on the next call. OverlayBackend builds on this, it is kept free of Godot so the
+// bookkeeping can be tested on its own.
+class OverlayStateApplier {
+public:
+    virtual ~OverlayStateApplier() {}
+
+    virtual bool is_attached() const = 0;
+
+    // Bring the native window to the given state. Returns the mask of fields applied,
+    // fields that failed stay different from get_applied_state() and stale.
+    uint32_t apply_state(const OverlayState &state) {
+        uint32_t changed = diff_overlay_state(applied_state, state) | stale_fields;
+        if (changed == 0 || !is_attached()) {
+            return 0;
+        }
+        uint32_t applied = apply_changes(state, changed) & changed;
+        merge_overlay_state(applied_state, state, applied);
+        // A refused field leaves the window in an unknown state, retried even if the
+        // next state asks for the value cached before
+        stale_fields = changed & ~applied;
+        return applied;
+    }
+
+    // Apply the given fields on the next apply_state even if they look unchanged,
+    // for when the native window was changed behind the cached state
+    void invalidate_state(uint32_t fields) {
+        stale_fields |= fields;
+    }
+
+    // State the native window is known to be in
+    const OverlayState &get_applied_state() const {
+        return applied_state;
+    }
+
+    // Fields the next apply_state sends whatever their value
+    uint32_t get_stale_fields() const {
+        return stale_fields;
+    }
+
+protected:
+    // Apply the fields in changed, returning the ones that succeeded
+    virtual uint32_t apply_changes(const OverlayState &state, uint32_t changed) = 0;
+
+private:
+    OverlayState applied_state;
+    uint32_t stale_fields = 0;
+};
+
+} // namespace godot
+
+#endif // OVERLAY_STATE_APPLIER_H
@@ -0,0 +1,53 @@
+#include "overlay_state_machine.h"
+
+namespace godot {
+
+void OverlayStateMachine::enable() {
+    desired.borderless = true;
+    desired.topmost = true;
+    desired.layered = true;
+    desired.passthrough = true;
+    enabled = true;
+}
+
+void OverlayStateMachine::disable() {
+    OverlayState state = OverlayState::normal_window();
+    state.use_color_key = desired.use_color_key;
+    state.color_key = desired.color_key;
+    state.per_pixel_alpha = desired.per_pixel_alpha;
+    desired = state;
+    enabled = false;
+    focus_pending = false;
+}
+
+bool OverlayStateMachine::set_passthrough(bool p_enabled) {
+    if (!enabled) {
+        return false;
+    }
+    desired.passthrough = p_enabled;
+    if (!p_enabled) {
+        focus_pending = true;
+    }
+    return true;
+}
+
+bool OverlayStateMachine::set_visible(bool visible) {
+    if (!enabled) {
+        return false;
+    }
+    desired.visible = visible;
+    return true;
+}
+
+void OverlayStateMachine::merge(const OverlayState &state, uint32_t fields) {
+    merge_overlay_state(desired, state, fields);
+}
+
+bool OverlayStateMachine::take_focus_request() {
+    // A disable followed by an enable within the same frame needs no focus
+    bool focus = focus_pending && !desired.passthrough;
+    focus_pending = false;
+    return focus;
+}
+
+} // namespace godot
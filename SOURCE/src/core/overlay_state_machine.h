@@ -0,0 +1,59 @@
+#ifndef OVERLAY_STATE_MACHINE_H
+#define OVERLAY_STATE_MACHINE_H
+
+#include <cstdint>
+
+#include "overlay_state.h"
+
+namespace godot {
+
+// Logical overlay state and the rules for changing it: toggles only apply
+// while the overlay is enabled, disabling returns to a normal window, and
+// giving input back to the window asks for focus. Knows nothing about Godot
+// or the OS, the result is committed to a backend as one OverlayState.
+class OverlayStateMachine {
+public:
+    // Borderless, always on top, transparent and ignoring input
+    void enable();
+
+    // Back to a normal window, the configured color key is kept for next time
+    void disable();
+
+    // Return false when ignored because the overlay is disabled
+    bool set_passthrough(bool enabled);
+    bool set_visible(bool visible);
+    bool toggle_passthrough() {
+        return set_passthrough(!desired.passthrough);
+    }
+    bool toggle_visible() {
+        return set_visible(!desired.visible);
+    }
+
+    // Overwrite the given OverlayStateField fields, whether enabled or not
+    void merge(const OverlayState &state, uint32_t fields);
+
+    // True once after the state settled on captured input following a passthrough disable
+    bool take_focus_request();
+
+    bool is_enabled() const {
+        return enabled;
+    }
+    bool is_passthrough() const {
+        return desired.passthrough;
+    }
+    bool is_visible() const {
+        return desired.visible;
+    }
+    const OverlayState &get_desired() const {
+        return desired;
+    }
+
+private:
+    OverlayState desired;
+    bool enabled = false;
+    bool focus_pending = false;
+};
+
+} // namespace godot
+
+#endif // OVERLAY_STATE_MACHINE_H
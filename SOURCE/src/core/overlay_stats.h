@@ -0,0 +1,217 @@
+#ifndef OVERLAY_STATS_H
+#define OVERLAY_STATS_H
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace godot {
+
+// Index of the highest set bit, 0 for 0 and 1
+inline int log2_floor(uint64_t value) {
+    value |= 1;
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+// Fixed power-of-two bucket histogram. Bucket i counts values in [2^i, 2^(i+1)),
+// bucket 0 also holds 0. Recording is a handful of relaxed atomic adds, no allocation,
+// so it can run inside the hook callback. Meant for one writer thread per histogram.
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS = 40; // Up to about 18 minutes in microseconds
+
+    void record(uint64_t value) {
+        int bucket = log2_floor(value);
+        if (bucket >= BUCKETS) {
+            bucket = BUCKETS - 1;
+        }
+        // Single writer: plain load/store pairs avoid locked read-modify-writes
+        add(buckets[bucket], 1);
+        add(count, 1);
+        add(sum, value);
+        if (value > max.load(std::memory_order_relaxed)) {
+            max.store(value, std::memory_order_relaxed);
+        }
+        last.store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t get_count() const {
+        return count.load(std::memory_order_relaxed);
+    }
+    uint64_t get_sum() const {
+        return sum.load(std::memory_order_relaxed);
+    }
+    uint64_t get_max() const {
+        return max.load(std::memory_order_relaxed);
+    }
+    uint64_t get_last() const {
+        return last.load(std::memory_order_relaxed);
+    }
+    uint64_t get_bucket(int bucket) const {
+        return buckets[bucket].load(std::memory_order_relaxed);
+    }
+    double get_mean() const {
+        uint64_t samples = get_count();
+        return samples ? static_cast<double>(get_sum()) / samples : 0.0;
+    }
+
+    // Upper bound of the bucket holding the given percentile (0-100), capped at the max seen
+    uint64_t get_percentile(double percentile) const {
+        uint64_t samples = get_count();
+        if (samples == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(samples * percentile / 100.0);
+        if (rank >= samples) {
+            rank = samples - 1;
+        }
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += get_bucket(i);
+            if (seen > rank) {
+                uint64_t upper = (uint64_t(2) << i) - 1;
+                uint64_t highest = get_max();
+                return upper < highest ? upper : highest;
+            }
+        }
+        return get_max();
+    }
+
+    void reset() {
+        for (std::atomic<uint64_t> &bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+        last.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static void add(std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> max{ 0 };
+    std::atomic<uint64_t> last{ 0 };
+};
+
+// Always-on counters for the overlay hot paths.
+// The hook thread owns the hook fields, the main thread owns the rest.
+// Written by the input thread, shared by every Overlay listening to it
+struct HookStats {
+    std::atomic<uint64_t> hook_invocations{ 0 };
+    LatencyHistogram hook_nsec;
+    std::atomic<uint64_t> foreground_changes{ 0 };
+
+    // Mouse records are coalesced in the hook, motion included
+    std::atomic<uint64_t> mouse_invocations{ 0 };
+    LatencyHistogram mouse_nsec;
+
+    void reset() {
+        hook_invocations.store(0, std::memory_order_relaxed);
+        hook_nsec.reset();
+        foreground_changes.store(0, std::memory_order_relaxed);
+        mouse_invocations.store(0, std::memory_order_relaxed);
+        mouse_nsec.reset();
+    }
+};
+
+// Per Overlay, main thread
+struct OverlayStats {
+    std::atomic<uint64_t> keys_matched{ 0 };
+    std::atomic<uint64_t> keys_unmatched{ 0 };
+    std::atomic<uint64_t> toggles{ 0 };
+    LatencyHistogram toggle_usec; // Key press to applied window state
+    LatencyHistogram attach_usec; // Resolving the native window
+    LatencyHistogram enable_usec;
+    LatencyHistogram disable_usec;
+
+    // Global mouse bindings, frames that took a coalesced record and the hook records in them
+    std::atomic<uint64_t> mouse_frames{ 0 };
+    std::atomic<uint64_t> mouse_records{ 0 };
+    std::atomic<uint64_t> mouse_matched{ 0 };
+
+    // Timed gestures, latency runs from the gesture completing to its signal
+    std::atomic<uint64_t> gestures_recognized{ 0 };
+    LatencyHistogram gesture_usec;
+
+    // Opacity fades, frames the engine drew while one was running
+    std::atomic<uint64_t> fades{ 0 };
+    std::atomic<uint64_t> fade_frames_drawn{ 0 };
+    LatencyHistogram fade_usec; // Start to the alpha being committed
+
+    // Following another application's window, moves only count changed geometry
+    std::atomic<uint64_t> target_updates{ 0 }; // Tracker states taken in process()
+    std::atomic<uint64_t> target_moves{ 0 };
+    LatencyHistogram target_move_usec; // Moving and sizing the overlay window
+
+    // Auto-fit, controls measured after a change and the native resizes they led to
+    std::atomic<uint64_t> fit_measures{ 0 };
+    LatencyHistogram fit_resize_usec; // Moving and sizing the window and shifting the canvas
+
+    // Desktop capture, throughput is measured from capture_start_usec
+    std::atomic<uint64_t> capture_frames{ 0 };
+    std::atomic<uint64_t> capture_bytes{ 0 };
+    uint64_t capture_start_usec = 0;
+    LatencyHistogram capture_grab_usec; // OS copy into the shared surface
+    LatencyHistogram capture_upload_usec; // Conversion and texture update
+
+    // Per-pixel alpha presentation, frames without a changed tile are not pushed
+    std::atomic<uint64_t> layered_frames{ 0 };
+    std::atomic<uint64_t> layered_frames_unchanged{ 0 };
+    std::atomic<uint64_t> layered_pixels{ 0 }; // Converted and pushed, dirty tiles only
+    LatencyHistogram layered_readback_usec; // Rendered frame into system memory
+    LatencyHistogram layered_convert_usec; // Dirty tile diff and conversion
+    LatencyHistogram layered_present_usec;
+
+    void reset() {
+        keys_matched.store(0, std::memory_order_relaxed);
+        keys_unmatched.store(0, std::memory_order_relaxed);
+        toggles.store(0, std::memory_order_relaxed);
+        toggle_usec.reset();
+        attach_usec.reset();
+        enable_usec.reset();
+        disable_usec.reset();
+        mouse_frames.store(0, std::memory_order_relaxed);
+        mouse_records.store(0, std::memory_order_relaxed);
+        mouse_matched.store(0, std::memory_order_relaxed);
+        gestures_recognized.store(0, std::memory_order_relaxed);
+        gesture_usec.reset();
+        fades.store(0, std::memory_order_relaxed);
+        fade_frames_drawn.store(0, std::memory_order_relaxed);
+        fade_usec.reset();
+        target_updates.store(0, std::memory_order_relaxed);
+        target_moves.store(0, std::memory_order_relaxed);
+        target_move_usec.reset();
+        fit_measures.store(0, std::memory_order_relaxed);
+        fit_resize_usec.reset();
+        capture_frames.store(0, std::memory_order_relaxed);
+        capture_bytes.store(0, std::memory_order_relaxed);
+        capture_start_usec = 0;
+        capture_grab_usec.reset();
+        capture_upload_usec.reset();
+        layered_frames.store(0, std::memory_order_relaxed);
+        layered_frames_unchanged.store(0, std::memory_order_relaxed);
+        layered_pixels.store(0, std::memory_order_relaxed);
+        layered_readback_usec.reset();
+        layered_convert_usec.reset();
+        layered_present_usec.reset();
+    }
+};
+
+} // namespace godot
+
+#endif // OVERLAY_STATS_H
@@ -0,0 +1,308 @@
+#include "pixel_convert.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXEL_CONVERT_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only accept intrinsics inside functions built for their instruction set,
+// MSVC accepts them anywhere. Either way nothing above SSE2 runs before the CPU check.
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PIXEL_TARGET(isa)
+#endif
+
+namespace godot {
+
+namespace {
+
+// Row kernels, the public functions walk the rows
+struct PixelKernels {
+    void (*swap_opaque)(const uint8_t *src, uint8_t *dst, int32_t width);
+    void (*premultiply)(const uint8_t *src, uint8_t *dst, int32_t width);
+    void (*color_key)(const uint8_t *src, uint8_t *dst, int32_t width, uint32_t key);
+};
+
+// Whole pixels as little-endian words, byte 0 is the lowest
+inline uint32_t load_pixel(const uint8_t *src) {
+    uint32_t pixel;
+    memcpy(&pixel, src, 4);
+    return pixel;
+}
+
+inline void store_pixel(uint8_t *dst, uint32_t pixel) {
+    memcpy(dst, &pixel, 4);
+}
+
+inline uint32_t swap_opaque_pixel(uint32_t pixel) {
+    return ((pixel & 0x000000FFu) << 16) | (pixel & 0x0000FF00u) | ((pixel & 0x00FF0000u) >> 16) | 0xFF000000u;
+}
+
+void swap_opaque_scalar(const uint8_t *src, uint8_t *dst, int32_t width) {
+    for (int32_t x = 0; x < width; x++) {
+        store_pixel(dst + x * 4, swap_opaque_pixel(load_pixel(src + x * 4)));
+    }
+}
+
+void premultiply_scalar(const uint8_t *src, uint8_t *dst, int32_t width) {
+    for (int32_t x = 0; x < width; x++) {
+        const uint8_t *in = src + x * 4;
+        uint8_t *out = dst + x * 4;
+        uint32_t alpha = in[3];
+        out[0] = static_cast<uint8_t>((in[2] * alpha + 127) / 255);
+        out[1] = static_cast<uint8_t>((in[1] * alpha + 127) / 255);
+        out[2] = static_cast<uint8_t>((in[0] * alpha + 127) / 255);
+        out[3] = static_cast<uint8_t>(alpha);
+    }
+}
+
+// key is the color as it sits in an RGBA word, alpha excluded
+void color_key_scalar(const uint8_t *src, uint8_t *dst, int32_t width, uint32_t key) {
+    for (int32_t x = 0; x < width; x++) {
+        uint32_t pixel = load_pixel(src + x * 4);
+        store_pixel(dst + x * 4, (pixel & 0x00FFFFFFu) == key ? 0 : swap_opaque_pixel(pixel));
+    }
+}
+
+#ifdef PIXEL_CONVERT_X86
+
+// SSE2 and AVX2 premultiply widen to 16-bit lanes and divide by 255 exactly:
+// t = c * a + 128, (t + (t >> 8)) >> 8 equals (c * a + 127) / 255 for all 8-bit c and a.
+// The alpha lane is multiplied by 255, which gives alpha back unchanged.
+
+PIXEL_TARGET("sse2")
+inline __m128i swap_opaque_x4(__m128i pixels) {
+    const __m128i red_blue = _mm_set1_epi32(0x00FF00FF);
+    const __m128i green = _mm_set1_epi32(0x0000FF00);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    __m128i rb = _mm_and_si128(pixels, red_blue);
+    __m128i swapped = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+    return _mm_or_si128(_mm_or_si128(swapped, _mm_and_si128(pixels, green)), alpha);
+}
+
+PIXEL_TARGET("sse2")
+void swap_opaque_sse2(const uint8_t *src, uint8_t *dst, int32_t width) {
+    int32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), swap_opaque_x4(pixels));
+    }
+    swap_opaque_scalar(src + x * 4, dst + x * 4, width - x);
+}
+
+PIXEL_TARGET("sse2")
+inline __m128i premultiply_half_sse2(__m128i wide) {
+    const __m128i color_lanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alpha_255 = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i bias = _mm_set1_epi16(128);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(wide, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_or_si128(_mm_and_si128(alpha, color_lanes), alpha_255);
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(wide, alpha), bias);
+    t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    // R G B A to B G R A
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(t, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+PIXEL_TARGET("sse2")
+void premultiply_sse2(const uint8_t *src, uint8_t *dst, int32_t width) {
+    const __m128i zero = _mm_setzero_si128();
+    int32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+        __m128i low = premultiply_half_sse2(_mm_unpacklo_epi8(pixels, zero));
+        __m128i high = premultiply_half_sse2(_mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_packus_epi16(low, high));
+    }
+    premultiply_scalar(src + x * 4, dst + x * 4, width - x);
+}
+
+PIXEL_TARGET("sse2")
+void color_key_sse2(const uint8_t *src, uint8_t *dst, int32_t width, uint32_t key) {
+    const __m128i color_mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i key_vector = _mm_set1_epi32(static_cast<int>(key));
+    int32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+        __m128i keyed = _mm_cmpeq_epi32(_mm_and_si128(pixels, color_mask), key_vector);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_andnot_si128(keyed, swap_opaque_x4(pixels)));
+    }
+    color_key_scalar(src + x * 4, dst + x * 4, width - x, key);
+}
+
+// AVX2 works on two independent 128-bit halves for unpack, pack and shuffles,
+// every step stays within a pixel so the halves line up again after packing
+
+PIXEL_TARGET("avx2")
+inline __m256i swap_opaque_x8(__m256i pixels) {
+    const __m256i order = _mm256_setr_epi8(
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    return _mm256_or_si256(_mm256_shuffle_epi8(pixels, order), alpha);
+}
+
+PIXEL_TARGET("avx2")
+void swap_opaque_avx2(const uint8_t *src, uint8_t *dst, int32_t width) {
+    int32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4), swap_opaque_x8(pixels));
+    }
+    swap_opaque_scalar(src + x * 4, dst + x * 4, width - x);
+}
+
+PIXEL_TARGET("avx2")
+inline __m256i premultiply_half_avx2(__m256i wide) {
+    const __m256i color_lanes = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+    const __m256i alpha_255 = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+    const __m256i bias = _mm256_set1_epi16(128);
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(wide, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm256_or_si256(_mm256_and_si256(alpha, color_lanes), alpha_255);
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(wide, alpha), bias);
+    t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+PIXEL_TARGET("avx2")
+void premultiply_avx2(const uint8_t *src, uint8_t *dst, int32_t width) {
+    const __m256i zero = _mm256_setzero_si256();
+    int32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 4));
+        __m256i low = premultiply_half_avx2(_mm256_unpacklo_epi8(pixels, zero));
+        __m256i high = premultiply_half_avx2(_mm256_unpackhi_epi8(pixels, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4), _mm256_packus_epi16(low, high));
+    }
+    premultiply_scalar(src + x * 4, dst + x * 4, width - x);
+}
+
+PIXEL_TARGET("avx2")
+void color_key_avx2(const uint8_t *src, uint8_t *dst, int32_t width, uint32_t key) {
+    const __m256i color_mask = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i key_vector = _mm256_set1_epi32(static_cast<int>(key));
+    int32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 4));
+        __m256i keyed = _mm256_cmpeq_epi32(_mm256_and_si256(pixels, color_mask), key_vector);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4), _mm256_andnot_si256(keyed, swap_opaque_x8(pixels)));
+    }
+    color_key_scalar(src + x * 4, dst + x * 4, width - x, key);
+}
+
+bool cpu_supports(PixelIsa isa) {
+    if (isa == PIXEL_ISA_SCALAR) {
+        return true;
+    }
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    if (isa == PIXEL_ISA_SSE2) {
+        return (info[3] & (1 << 26)) != 0;
+    }
+    // AVX2 also needs the OS to save the YMM registers
+    bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+    // Also checks that the OS saves the YMM registers
+    return isa == PIXEL_ISA_SSE2 ? __builtin_cpu_supports("sse2") : __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+bool cpu_supports(PixelIsa isa) {
+    return isa == PIXEL_ISA_SCALAR;
+}
+
+#endif // PIXEL_CONVERT_X86
+
+const PixelKernels KERNELS[PIXEL_ISA_COUNT] = {
+    { swap_opaque_scalar, premultiply_scalar, color_key_scalar },
+#ifdef PIXEL_CONVERT_X86
+    { swap_opaque_sse2, premultiply_sse2, color_key_sse2 },
+    { swap_opaque_avx2, premultiply_avx2, color_key_avx2 },
+#else
+    { swap_opaque_scalar, premultiply_scalar, color_key_scalar },
+    { swap_opaque_scalar, premultiply_scalar, color_key_scalar },
+#endif
+};
+
+PixelIsa &active_isa() {
+    static PixelIsa isa = get_best_pixel_isa();
+    return isa;
+}
+
+} // namespace
+
+PixelIsa get_best_pixel_isa() {
+    static const PixelIsa best = []() {
+        for (int isa = PIXEL_ISA_COUNT - 1; isa > PIXEL_ISA_SCALAR; isa--) {
+            if (cpu_supports(static_cast<PixelIsa>(isa))) {
+                return static_cast<PixelIsa>(isa);
+            }
+        }
+        return PIXEL_ISA_SCALAR;
+    }();
+    return best;
+}
+
+PixelIsa get_pixel_isa() {
+    return active_isa();
+}
+
+const char *get_pixel_isa_name(PixelIsa isa) {
+    switch (isa) {
+        case PIXEL_ISA_SCALAR:
+            return "scalar";
+        case PIXEL_ISA_SSE2:
+            return "sse2";
+        case PIXEL_ISA_AVX2:
+            return "avx2";
+        default:
+            return "unknown";
+    }
+}
+
+bool set_pixel_isa(PixelIsa isa) {
+    if (isa < PIXEL_ISA_SCALAR || isa >= PIXEL_ISA_COUNT || !cpu_supports(isa)) {
+        return false;
+    }
+    active_isa() = isa;
+    return true;
+}
+
+void convert_bgrx_to_rgba(const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride,
+        int32_t width, int32_t height) {
+    // Swapping red and blue is its own inverse, the same kernel serves both directions
+    const PixelKernels &kernels = KERNELS[active_isa()];
+    for (int32_t y = 0; y < height; y++) {
+        kernels.swap_opaque(src + y * src_stride, dst + y * dst_stride, width);
+    }
+}
+
+void convert_rgba_to_premultiplied_bgra(const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride,
+        int32_t width, int32_t height) {
+    const PixelKernels &kernels = KERNELS[active_isa()];
+    for (int32_t y = 0; y < height; y++) {
+        kernels.premultiply(src + y * src_stride, dst + y * dst_stride, width);
+    }
+}
+
+void convert_rgba_keyed_to_bgra(const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride,
+        int32_t width, int32_t height, uint32_t color_key) {
+    // 0xRRGGBB to the RGBA byte order, red in the lowest byte
+    uint32_t key = ((color_key >> 16) & 0xFFu) | (color_key & 0xFF00u) | ((color_key & 0xFFu) << 16);
+    const PixelKernels &kernels = KERNELS[active_isa()];
+    for (int32_t y = 0; y < height; y++) {
+        kernels.color_key(src + y * src_stride, dst + y * dst_stride, width, key);
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,45 @@
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+// Instruction sets the conversion kernels are built for. The best one the CPU
+// supports is picked on first use, every set produces bit-identical output.
+enum PixelIsa {
+    PIXEL_ISA_SCALAR,
+    PIXEL_ISA_SSE2,
+    PIXEL_ISA_AVX2,
+    PIXEL_ISA_COUNT,
+};
+
+PixelIsa get_best_pixel_isa();
+PixelIsa get_pixel_isa();
+const char *get_pixel_isa_name(PixelIsa isa);
+
+// Force a kernel set, e.g. to compare them. False when the CPU does not support it.
+bool set_pixel_isa(PixelIsa isa);
+
+// All kernels take 32-bit pixels, rows may be padded on either side.
+// Source and destination must not overlap.
+
+// Screen grabs come as 32-bit BGRX, Godot textures want RGBA8.
+// Swaps red and blue and forces alpha opaque.
+void convert_bgrx_to_rgba(const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride,
+        int32_t width, int32_t height);
+
+// Godot renders straight alpha RGBA8, UpdateLayeredWindow wants premultiplied BGRA.
+// Each color is rounded as (c * a + 127) / 255, alpha is kept.
+void convert_rgba_to_premultiplied_bgra(const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride,
+        int32_t width, int32_t height);
+
+// Content drawn for a color keyed window: pixels whose color is color_key (0xRRGGBB)
+// become fully transparent, every other pixel becomes opaque BGRA.
+void convert_rgba_keyed_to_bgra(const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride,
+        int32_t width, int32_t height, uint32_t color_key);
+
+} // namespace godot
+
+#endif // PIXEL_CONVERT_H
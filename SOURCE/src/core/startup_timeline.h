@@ -0,0 +1,58 @@
+#ifndef STARTUP_TIMELINE_H
+#define STARTUP_TIMELINE_H
+
+#include <cstdint>
+
+#include "key_event_queue.h"
+
+namespace godot {
+
+// Milestones from loading the library to the first drawn frame, on the monotonic clock.
+// Each stage is stamped once, 0 until it is reached. Main thread only.
+class StartupTimeline {
+public:
+    enum Stage {
+        STAGE_LIBRARY_LOAD, // Entry point called by Godot
+        STAGE_SCENE_INIT, // Scene level module initialization, the main window exists
+        STAGE_WINDOW_RESOLVE, // Native handle of the main window attached
+        STAGE_STYLE_APPLY, // Overlay state applied to the native window
+        STAGE_FIRST_FRAME, // First frame drawn
+        STAGE_COUNT,
+    };
+
+    void mark(Stage stage) {
+        if (stamps[stage] == 0) {
+            stamps[stage] = get_monotonic_usec();
+        }
+    }
+
+    uint64_t get_stamp(Stage stage) const {
+        return stamps[stage];
+    }
+
+    // Microseconds from loading the library to the stage, -1 when not reached
+    int64_t get_offset_usec(Stage stage) const {
+        if (stamps[stage] == 0 || stamps[STAGE_LIBRARY_LOAD] == 0) {
+            return -1;
+        }
+        return static_cast<int64_t>(stamps[stage] - stamps[STAGE_LIBRARY_LOAD]);
+    }
+
+    static const char *get_stage_name(Stage stage) {
+        static const char *const names[STAGE_COUNT] = {
+            "library_load",
+            "scene_init",
+            "window_resolve",
+            "style_apply",
+            "first_frame",
+        };
+        return names[stage];
+    }
+
+private:
+    uint64_t stamps[STAGE_COUNT] = {};
+};
+
+} // namespace godot
+
+#endif // STARTUP_TIMELINE_H
@@ -0,0 +1,138 @@
+#include "telemetry_reader.h"
+
+#include <cstring>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace godot {
+
+namespace {
+
+// A producer rewriting the snapshot in a tight loop can starve the reader, give up after this
+constexpr int SNAPSHOT_ATTEMPTS = 8;
+// Retries spin this many times before yielding the rest of the time slice to the producer
+constexpr int SNAPSHOT_SPIN_ATTEMPTS = 4;
+
+inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Gives a producer in the middle of a write time to finish, longer on every attempt
+void back_off(int attempt) {
+    if (attempt < SNAPSHOT_SPIN_ATTEMPTS) {
+        for (int i = 0; i < (16 << attempt); i++) {
+            cpu_relax();
+        }
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+int TelemetryReader::open(const char *name, uint32_t snapshot_capacity, uint32_t ring_capacity, uint32_t record_size) {
+    close();
+    int result = godoverit_telemetry_open(&channel, name, snapshot_capacity, ring_capacity, record_size);
+    if (result == 0) {
+        scratch.resize(snapshot_capacity);
+    }
+    return result;
+}
+
+void TelemetryReader::close() {
+    if (channel.header) {
+        godoverit_telemetry_close(&channel, channel.created);
+    }
+}
+
+uint64_t TelemetryReader::get_snapshot_sequence() const {
+    return channel.header ? godoverit__load_acquire(&channel.header->snapshot_sequence) : 0;
+}
+
+bool TelemetryReader::read_snapshot(double *values, uint32_t &r_count) {
+    godoverit_telemetry_header *header = channel.header;
+    if (!header) {
+        return false;
+    }
+    // Copied to scratch first, the caller's values only ever receive a snapshot that checked out
+    for (int attempt = 0; attempt < SNAPSHOT_ATTEMPTS; attempt++) {
+        if (attempt > 0) {
+            snapshot_retries++;
+            back_off(attempt - 1);
+        }
+        uint64_t before = godoverit__load_acquire(&header->snapshot_sequence);
+        if (before & 1) {
+            continue; // Producer is in the middle of a write
+        }
+        uint32_t count = header->snapshot_count;
+        if (count > header->snapshot_capacity) {
+            count = header->snapshot_capacity;
+        }
+        memcpy(scratch.data(), channel.snapshot, count * sizeof(double));
+        godoverit__fence_acquire();
+        if (godoverit__load_relaxed(&header->snapshot_sequence) == before) {
+            memcpy(values, scratch.data(), count * sizeof(double));
+            r_count = count;
+            return true;
+        }
+    }
+    snapshot_retries++;
+    return false;
+}
+
+size_t TelemetryReader::get_pending_count() const {
+    godoverit_telemetry_header *header = channel.header;
+    if (!header) {
+        return 0;
+    }
+    uint64_t head = godoverit__load_acquire(&header->ring_head);
+    uint64_t tail = godoverit__load_relaxed(&header->ring_tail);
+    uint64_t pending = head - tail;
+    return static_cast<size_t>(pending < header->ring_capacity ? pending : header->ring_capacity);
+}
+
+size_t TelemetryReader::drain(uint8_t *buffer, size_t max_records) {
+    godoverit_telemetry_header *header = channel.header;
+    if (!header) {
+        return 0;
+    }
+    uint64_t head = godoverit__load_acquire(&header->ring_head);
+    uint64_t tail = godoverit__load_relaxed(&header->ring_tail);
+
+    // A producer that restarted on a reused segment cannot be more than one ring ahead
+    if (head - tail > header->ring_capacity) {
+        tail = head - header->ring_capacity;
+    }
+    size_t count = static_cast<size_t>(head - tail);
+    if (count > max_records) {
+        count = max_records;
+    }
+
+    // At most two contiguous runs, before and after the wrap
+    uint32_t record_size = header->record_size;
+    uint64_t mask = header->ring_capacity - 1;
+    size_t first = static_cast<size_t>(header->ring_capacity - (tail & mask));
+    if (first > count) {
+        first = count;
+    }
+    memcpy(buffer, channel.records + (tail & mask) * record_size, first * record_size);
+    memcpy(buffer + first * record_size, channel.records, (count - first) * record_size);
+
+    godoverit__store_release(&header->ring_tail, tail + count);
+    return count;
+}
+
+uint64_t TelemetryReader::get_dropped_count() const {
+    return channel.header ? godoverit__load_relaxed(&channel.header->ring_dropped) : 0;
+}
+
+} // namespace godot
@@ -0,0 +1,67 @@
+#ifndef TELEMETRY_READER_H
+#define TELEMETRY_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "godoverit_telemetry.h"
+
+namespace godot {
+
+// Consumer side of a godoverit_telemetry channel. After open, reading the
+// snapshot and draining records only touch the mapped memory, no system calls.
+// One reader per channel, all calls from the same thread.
+class TelemetryReader {
+public:
+    ~TelemetryReader() {
+        close();
+    }
+
+    // Returns 0, -1 on failure or -2 while the producer is still creating the segment
+    int open(const char *name, uint32_t snapshot_capacity, uint32_t ring_capacity, uint32_t record_size);
+    void close();
+    bool is_open() const {
+        return channel.header != nullptr;
+    }
+
+    // The creator removes the name when it closes, so a restarted producer gets a fresh segment
+    bool is_creator() const {
+        return channel.created != 0;
+    }
+
+    uint32_t get_snapshot_capacity() const {
+        return channel.header ? channel.header->snapshot_capacity : 0;
+    }
+    uint32_t get_record_size() const {
+        return channel.header ? channel.header->record_size : 0;
+    }
+
+    // Sequence of the last published snapshot, changes whenever the producer writes one
+    uint64_t get_snapshot_sequence() const;
+
+    // Copy a consistent snapshot into values (get_snapshot_capacity() doubles).
+    // Retries back off, spinning then yielding, while the producer is mid-write.
+    // False when the producer kept writing through every retry, values and r_count are then unchanged.
+    bool read_snapshot(double *values, uint32_t &r_count);
+
+    // Copy up to max_records records into buffer and free their slots, returns the count
+    size_t drain(uint8_t *buffer, size_t max_records);
+    size_t get_pending_count() const;
+
+    // Records the producer threw away because the ring was full
+    uint64_t get_dropped_count() const;
+
+    uint64_t get_snapshot_retries() const {
+        return snapshot_retries;
+    }
+
+private:
+    godoverit_telemetry channel = {};
+    std::vector<double> scratch;
+    uint64_t snapshot_retries = 0;
+};
+
+} // namespace godot
+
+#endif // TELEMETRY_READER_H
@@ -0,0 +1,235 @@
+#include "time_series.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace godot {
+
+TimeSeries::TimeSeries(size_t capacity) :
+        times(capacity > 0 ? capacity : 1),
+        values(capacity > 0 ? capacity : 1) {
+}
+
+void TimeSeries::clear() {
+    head = 0;
+    count = 0;
+    newest_time = 0.0;
+    serial++;
+}
+
+size_t TimeSeries::find_window_start(double span) const {
+    if (span <= 0.0 || count == 0) {
+        return 0;
+    }
+
+    // Times never go backwards, so the window start is a binary search away
+    double threshold = newest_time - span;
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (get_time(middle) < threshold) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+const TimeSeries::Summary &TimeSeries::summarize(double span) {
+    if (summary_serial == serial && summary_span == span) {
+        return summary;
+    }
+    summary = Summary();
+    size_t start = find_window_start(span);
+    if (start < count) {
+        double low = get_value(start);
+        double high = low;
+        double sum = 0.0;
+        for_each(start, [&](double, double value) {
+            low = std::min(low, value);
+            high = std::max(high, value);
+            sum += value;
+        });
+        summary.count = count - start;
+        summary.min = low;
+        summary.max = high;
+        summary.mean = sum / summary.count;
+        summary.last = get_value(count - 1);
+    }
+    summary_serial = serial;
+    summary_span = span;
+    return summary;
+}
+
+double TimeSeries::get_percentile(double span, double percentile) {
+    if (percentile_serial == serial && percentile_span == span && percentile_rank == percentile) {
+        return percentile_value;
+    }
+    size_t start = find_window_start(span);
+    size_t window = count - start;
+    percentile_value = 0.0;
+    if (window > 0) {
+        scratch.clear();
+        scratch.reserve(window);
+        for_each(start, [this](double, double value) {
+            scratch.push_back(value);
+        });
+        double clamped = std::min(std::max(percentile, 0.0), 100.0);
+        size_t rank = static_cast<size_t>(std::ceil(clamped / 100.0 * window));
+        rank = rank > 0 ? rank - 1 : 0;
+        std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+        percentile_value = scratch[rank];
+    }
+    percentile_serial = serial;
+    percentile_span = span;
+    percentile_rank = percentile;
+    return percentile_value;
+}
+
+const std::vector<SeriesPoint> &TimeSeries::plot(const PlotRequest &request) {
+    if (plot_serial == serial && plot_request == request) {
+        return points;
+    }
+    plot_serial = serial;
+    plot_request = request;
+    plot_version++;
+    points.clear();
+
+    size_t start = find_window_start(request.span);
+    if (start >= count || request.width <= 0) {
+        return points;
+    }
+
+    // A fixed span scrolls with the newest sample, otherwise the buffer fills the width
+    double x0 = request.span > 0.0 ? newest_time - request.span : get_time(start);
+    double x_range = newest_time - x0;
+    double x_scale = x_range > 0.0 ? request.width / x_range : 0.0;
+    double y_low = request.y_min;
+    double y_high = request.y_max;
+    if (y_low >= y_high) {
+        const Summary &window = summarize(request.span);
+        y_low = window.min;
+        y_high = window.max;
+    }
+    if (y_low >= y_high) {
+        y_low -= 0.5; // A flat line sits in the middle
+        y_high += 0.5;
+    }
+    double y_scale = request.height / (y_high - y_low);
+
+    if (request.mode == DECIMATION_LTTB) {
+        decimate_lttb(start, request, x0, x_scale, y_high, y_scale);
+    } else {
+        decimate_min_max(start, request, x0, x_scale, y_high, y_scale);
+    }
+    return points;
+}
+
+void TimeSeries::decimate_min_max(size_t start, const PlotRequest &request, double x0, double x_scale, double y_top, double y_scale) {
+    struct Extreme {
+        size_t index;
+        double time;
+        double value;
+    };
+    auto emit = [&](const Extreme &extreme) {
+        points.push_back({ float((extreme.time - x0) * x_scale), float((y_top - extreme.value) * y_scale) });
+    };
+
+    // Both extremes of a column in sample order, so the polyline draws the spike
+    Extreme low = {};
+    Extreme high = {};
+    auto flush = [&]() {
+        if (low.index == high.index) {
+            emit(low);
+        } else if (low.index < high.index) {
+            emit(low);
+            emit(high);
+        } else {
+            emit(high);
+            emit(low);
+        }
+    };
+
+    // Samples are in time order, a column ends when one reaches its right edge
+    points.reserve(std::min(count - start, size_t(request.width) * 2));
+    int32_t column = -1;
+    double column_end = -1e300;
+    size_t index = 0;
+    for_each(start, [&](double time, double value) {
+        if (time >= column_end) {
+            if (column >= 0) {
+                flush();
+            }
+            column = std::min(std::max(static_cast<int32_t>((time - x0) * x_scale), column + 1), request.width - 1);
+            column_end = column + 1 < request.width && x_scale > 0.0 ? x0 + (column + 1) / x_scale : 1e300;
+            low = { index, time, value };
+            high = low;
+        } else if (value < low.value) {
+            low = { index, time, value };
+        } else if (value > high.value) {
+            high = { index, time, value };
+        }
+        index++;
+    });
+    flush();
+}
+
+void TimeSeries::decimate_lttb(size_t start, const PlotRequest &request, double x0, double x_scale, double y_top, double y_scale) {
+    // Laid out in pixels first, areas are then compared as they are drawn
+    window_points.clear();
+    window_points.reserve(count - start);
+    for_each(start, [&](double time, double value) {
+        window_points.push_back({ float((time - x0) * x_scale), float((y_top - value) * y_scale) });
+    });
+
+    size_t window = window_points.size();
+    size_t threshold = std::max<size_t>(size_t(request.width), 3);
+    if (window <= threshold) {
+        points = window_points;
+        return;
+    }
+
+    // First and last are kept, the rest is split into threshold - 2 buckets. Each bucket
+    // keeps the point forming the largest triangle with the previous pick and the
+    // average of the next bucket.
+    const SeriesPoint *samples = window_points.data();
+    points.reserve(threshold);
+    points.push_back(samples[0]);
+    double bucket = double(window - 2) / double(threshold - 2);
+    SeriesPoint previous = samples[0];
+    for (size_t b = 0; b < threshold - 2; b++) {
+        size_t range_begin = 1 + size_t(b * bucket);
+        size_t range_end = std::min(1 + size_t((b + 1) * bucket), window - 1);
+        size_t next_begin = range_end;
+        size_t next_end = std::min(1 + size_t((b + 2) * bucket), window);
+        if (next_begin >= next_end) {
+            next_begin = window - 1;
+            next_end = window;
+        }
+        double average_x = 0.0;
+        double average_y = 0.0;
+        for (size_t i = next_begin; i < next_end; i++) {
+            average_x += samples[i].x;
+            average_y += samples[i].y;
+        }
+        average_x /= double(next_end - next_begin);
+        average_y /= double(next_end - next_begin);
+
+        double best_area = -1.0;
+        size_t best = range_begin;
+        for (size_t i = range_begin; i < range_end; i++) {
+            double area = std::fabs((previous.x - average_x) * (samples[i].y - previous.y) - (previous.x - samples[i].x) * (average_y - previous.y));
+            if (area > best_area) {
+                best_area = area;
+                best = i;
+            }
+        }
+        points.push_back(samples[best]);
+        previous = samples[best];
+    }
+    points.push_back(samples[window - 1]);
+}
+
+} // namespace godot
@@ -0,0 +1,155 @@
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Point in graph pixels, laid out like a float Vector2
+struct SeriesPoint {
+    float x;
+    float y;
+};
+
+// Fixed-capacity ring of timestamped samples for overlay graphs. Pushing overwrites the
+// oldest sample and does nothing else; summaries, percentiles and plots are computed when
+// asked for and cached until the next push, so a graph redrawn every frame from a series
+// sampled less often costs nothing. Times must not go backwards, earlier ones are clamped.
+// Windows are the last span seconds up to the newest sample, 0 means everything buffered.
+class TimeSeries {
+public:
+    enum Decimation : uint8_t {
+        DECIMATION_MIN_MAX, // Lowest and highest sample per pixel column, keeps every spike
+        DECIMATION_LTTB, // Largest triangle three buckets, one point per column, keeps the shape
+    };
+
+    struct Summary {
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        double last = 0.0;
+    };
+
+    // Area the points are laid out in. x runs from the window start at 0 to the newest
+    // sample at width, y from max at 0 to min at height. A range with y_min >= y_max
+    // follows the window's own min and max.
+    struct PlotRequest {
+        Decimation mode = DECIMATION_MIN_MAX;
+        double span = 0.0;
+        int32_t width = 0;
+        float height = 0.0f;
+        double y_min = 0.0;
+        double y_max = 0.0;
+
+        bool operator==(const PlotRequest &other) const {
+            return mode == other.mode && span == other.span && width == other.width &&
+                    height == other.height && y_min == other.y_min && y_max == other.y_max;
+        }
+    };
+
+    explicit TimeSeries(size_t capacity = 1024);
+
+    void push(double time, double value) {
+        if (count > 0 && time < newest_time) {
+            time = newest_time;
+        }
+        times[head] = time;
+        values[head] = value;
+        head = head + 1 == times.size() ? 0 : head + 1;
+        count += count < times.size();
+        newest_time = time;
+        serial++;
+    }
+    void clear();
+
+    size_t get_capacity() const {
+        return times.size();
+    }
+    size_t get_count() const {
+        return count;
+    }
+    // Pushes so far, cached results are keyed on it
+    uint64_t get_serial() const {
+        return serial;
+    }
+
+    // Oldest buffered sample first
+    double get_time(size_t index) const {
+        return times[physical(index)];
+    }
+    double get_value(size_t index) const {
+        return values[physical(index)];
+    }
+
+    // Index of the first sample within the window
+    size_t find_window_start(double span) const;
+
+    const Summary &summarize(double span);
+
+    // Nearest-rank percentile (0-100) of the window, 0 when it is empty
+    double get_percentile(double span, double percentile);
+
+    // Points ready to draw as a polyline: at most two per column for min-max, at most
+    // width for LTTB. Recomputed only after a push or for a different request.
+    const std::vector<SeriesPoint> &plot(const PlotRequest &request);
+
+    // Bumped whenever plot() recomputed its points, for callers converting them
+    uint64_t get_plot_version() const {
+        return plot_version;
+    }
+
+private:
+    size_t physical(size_t index) const {
+        size_t start = head + times.size() - count;
+        size_t position = start + index;
+        return position >= times.size() ? position - times.size() : position;
+    }
+
+    // Calls f(time, value) for every sample from start on, oldest first, walking the
+    // ring as its two contiguous runs
+    template <typename F>
+    void for_each(size_t start, F &&f) const {
+        size_t remaining = count - start;
+        size_t position = physical(start);
+        size_t first = std::min(remaining, times.size() - position);
+        for (size_t i = position; i < position + first; i++) {
+            f(times[i], values[i]);
+        }
+        for (size_t i = 0; i < remaining - first; i++) {
+            f(times[i], values[i]);
+        }
+    }
+
+    void decimate_min_max(size_t start, const PlotRequest &request, double x0, double x_scale, double y_top, double y_scale);
+    void decimate_lttb(size_t start, const PlotRequest &request, double x0, double x_scale, double y_top, double y_scale);
+
+    std::vector<double> times;
+    std::vector<double> values;
+    size_t head = 0; // Next slot written
+    size_t count = 0;
+    double newest_time = 0.0;
+    uint64_t serial = 0;
+
+    // Single-entry caches, valid while the serial matches
+    Summary summary;
+    double summary_span = -1.0;
+    uint64_t summary_serial = ~uint64_t(0);
+    double percentile_span = -1.0;
+    double percentile_rank = -1.0;
+    double percentile_value = 0.0;
+    uint64_t percentile_serial = ~uint64_t(0);
+    std::vector<double> scratch;
+    std::vector<SeriesPoint> window_points; // Every window sample in pixels, for LTTB
+    PlotRequest plot_request;
+    uint64_t plot_serial = ~uint64_t(0);
+    uint64_t plot_version = 0;
+    std::vector<SeriesPoint> points;
+};
+
+} // namespace godot
+
+#endif // TIME_SERIES_H
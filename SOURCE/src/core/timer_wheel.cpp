@@ -0,0 +1,132 @@
+#include "timer_wheel.h"
+
+namespace godot {
+
+TimerWheel::TimerWheel(uint64_t p_tick_usec) :
+        tick_usec(p_tick_usec ? p_tick_usec : 1) {
+    clear();
+}
+
+void TimerWheel::clear() {
+    for (uint32_t &head : slots) {
+        head = NIL;
+    }
+    // Handles stay unique across a clear, generations carry on
+    free_list = NIL;
+    for (size_t i = timers.size(); i > 0; i--) {
+        Timer &timer = timers[i - 1];
+        timer.armed = false;
+        timer.generation = uint16_t((timer.generation + 1) & ((1u << (32 - INDEX_BITS)) - 1));
+        timer.next = free_list;
+        free_list = static_cast<uint32_t>(i - 1);
+    }
+    current_tick = 0;
+    pending = 0;
+}
+
+uint32_t TimerWheel::schedule(uint64_t deadline_usec, uint32_t cookie) {
+    uint32_t index = free_list;
+    if (index != NIL) {
+        free_list = timers[index].next;
+    } else {
+        if (timers.size() >= INDEX_MASK) {
+            return INVALID_TIMER;
+        }
+        index = static_cast<uint32_t>(timers.size());
+        timers.emplace_back();
+    }
+
+    // Rounded up so a timer never fires early, the current tick has already fired
+    Timer &timer = timers[index];
+    timer.deadline_usec = deadline_usec;
+    timer.deadline_tick = (deadline_usec + tick_usec - 1) / tick_usec;
+    if (timer.deadline_tick <= current_tick) {
+        timer.deadline_tick = current_tick + 1;
+    }
+    timer.cookie = cookie;
+    timer.armed = true;
+    pending++;
+    insert(index);
+    return index | (uint32_t(timer.generation) << INDEX_BITS);
+}
+
+bool TimerWheel::cancel(uint32_t handle) {
+    const uint32_t index = handle & INDEX_MASK;
+    if (handle == INVALID_TIMER || index >= timers.size()) {
+        return false;
+    }
+    Timer &timer = timers[index];
+    if (!timer.armed || timer.generation != (handle >> INDEX_BITS)) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::insert(uint32_t index) {
+    Timer &timer = timers[index];
+
+    // Lowest level whose span reaches the deadline
+    uint64_t delta = timer.deadline_tick > current_tick ? timer.deadline_tick - current_tick : 0;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    const uint64_t top_span = uint64_t(1) << (SLOT_BITS * LEVELS);
+    timer.slot_tick = delta < top_span ? timer.deadline_tick : current_tick + top_span - 1;
+
+    const uint16_t slot = uint16_t(level * SLOTS + ((timer.slot_tick >> (SLOT_BITS * level)) & SLOT_MASK));
+    uint32_t &head = slots[slot];
+    timer.slot = slot;
+    timer.prev = NIL;
+    timer.next = head;
+    if (head != NIL) {
+        timers[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer &timer = timers[index];
+    if (timer.prev != NIL) {
+        timers[timer.prev].next = timer.next;
+    } else {
+        slots[timer.slot] = timer.next;
+    }
+    if (timer.next != NIL) {
+        timers[timer.next].prev = timer.prev;
+    }
+    timer.next = NIL;
+    timer.prev = NIL;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Timer &timer = timers[index];
+    timer.armed = false;
+    timer.generation = uint16_t((timer.generation + 1) & ((1u << (32 - INDEX_BITS)) - 1));
+    timer.next = free_list;
+    free_list = index;
+    pending--;
+}
+
+void TimerWheel::cascade() {
+    // Called when the tick crosses a level 1 boundary. Higher levels whose boundary is
+    // crossed as well go first, so their timers can land in the slots emptied below.
+    int top = 1;
+    while (top < LEVELS - 1 && ((current_tick >> (SLOT_BITS * top)) & SLOT_MASK) == 0) {
+        top++;
+    }
+    for (int level = top; level >= 1; level--) {
+        uint32_t &head = slots[level * SLOTS + ((current_tick >> (SLOT_BITS * level)) & SLOT_MASK)];
+        uint32_t index = head;
+        head = NIL;
+        while (index != NIL) {
+            const uint32_t next = timers[index].next;
+            insert(index);
+            index = next;
+        }
+    }
+}
+
+} // namespace godot
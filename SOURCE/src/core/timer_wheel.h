@@ -0,0 +1,108 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Hierarchical timing wheel: four levels of 64 slots at 1 ms resolution cover about
+// 4.6 hours. Scheduling and cancelling are O(1) and only touch an intrusive list, so
+// many short timeouts cost no more than one. Advancing visits one slot per elapsed
+// tick and moves a slot down a level every 64 ticks. Timers never fire before their
+// deadline. Single thread.
+class TimerWheel {
+public:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t INVALID_TIMER = 0xFFFFFFFF;
+
+    explicit TimerWheel(uint64_t p_tick_usec = 1000);
+
+    // Arm a timer, the handle stays valid until it fires or is cancelled.
+    // Advance to the current time first, the wheel only moves when advanced.
+    uint32_t schedule(uint64_t deadline_usec, uint32_t cookie);
+
+    // False when the timer already fired or was cancelled
+    bool cancel(uint32_t timer);
+
+    // Drop every timer and restart the clock
+    void clear();
+
+    // Fire every timer due at or before now as fire(cookie, deadline_usec), in tick order.
+    // Timers may be scheduled and cancelled from the callback.
+    template <typename F>
+    void advance(uint64_t now_usec, F &&fire) {
+        const uint64_t target = now_usec / tick_usec;
+        while (current_tick < target) {
+            // Nothing armed, jump straight to the target
+            if (pending == 0) {
+                current_tick = target;
+                break;
+            }
+            current_tick++;
+            if ((current_tick & SLOT_MASK) == 0) {
+                cascade();
+            }
+
+            uint32_t *head = &slots[current_tick & SLOT_MASK];
+            while (*head != NIL) {
+                const uint32_t index = *head;
+                unlink(index);
+                Timer &timer = timers[index];
+                if (timer.deadline_tick > current_tick) {
+                    // Beyond the top level when scheduled, it goes around again
+                    insert(index);
+                    continue;
+                }
+                const uint32_t cookie = timer.cookie;
+                const uint64_t deadline_usec = timer.deadline_usec;
+                release(index);
+                fire(cookie, deadline_usec);
+            }
+        }
+    }
+
+    size_t get_pending_count() const {
+        return pending;
+    }
+    uint64_t get_tick_usec() const {
+        return tick_usec;
+    }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr int INDEX_BITS = 20; // Handle is the index and a reuse generation
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    struct Timer {
+        uint64_t deadline_usec = 0;
+        uint64_t deadline_tick = 0;
+        uint64_t slot_tick = 0; // Deadline tick, capped to what the top level reaches
+        uint32_t cookie = 0;
+        uint32_t next = NIL;
+        uint32_t prev = NIL;
+        uint16_t generation = 0;
+        uint16_t slot = 0; // Level * SLOTS + slot while armed
+        bool armed = false;
+    };
+
+    uint64_t tick_usec;
+    uint64_t current_tick = 0;
+    size_t pending = 0;
+    uint32_t slots[LEVELS * SLOTS]; // Heads of the intrusive lists, level major
+    std::vector<Timer> timers;
+    uint32_t free_list = NIL;
+
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade();
+};
+
+} // namespace godot
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,48 @@
+#include "x11_keymap.h"
+
+#include "keycode_tables.h"
+
+namespace godot {
+
+X11Keymap::X11Keymap() {
+    for (int keycode = 0; keycode < KEYCODE_SLOTS; keycode++) {
+        keycodes[keycode] = uint16_t(keycode);
+        keysyms[keycode] = 0;
+    }
+}
+
+void X11Keymap::rebuild(const unsigned long *keysyms_in, int first_keycode, int keycode_count, int keysyms_per_keycode) {
+    remapped_count = 0;
+    for (int keycode = 0; keycode < KEYCODE_SLOTS; keycode++) {
+        keycodes[keycode] = uint16_t(keycode);
+        keysyms[keycode] = 0;
+    }
+    if (!keysyms_in || keysyms_per_keycode <= 0) {
+        rebuild_count++;
+        return;
+    }
+
+    for (int i = 0; i < keycode_count; i++) {
+        int keycode = first_keycode + i;
+        if (keycode < 0 || keycode >= KEYCODE_SLOTS) {
+            continue;
+        }
+
+        // Keys only filled in at a later level still have a keysym to go by
+        uint32_t keysym = 0;
+        for (int level = 0; level < keysyms_per_keycode && level < 2 && !keysym; level++) {
+            keysym = uint32_t(keysyms_in[size_t(i) * keysyms_per_keycode + level]);
+        }
+        keysyms[keycode] = keysym;
+
+        // Keys without a Godot key, like right Ctrl, keep their own keycode
+        uint32_t evdev_code = keysym ? keycodes::godot_to_evdev(keycodes::x11_keysym_to_godot(keysym)) : 0;
+        if (evdev_code) {
+            keycodes[keycode] = uint16_t(evdev_code + keycodes::X11_EVDEV_KEYCODE_OFFSET);
+            remapped_count += keycodes[keycode] != keycode;
+        }
+    }
+    rebuild_count++;
+}
+
+} // namespace godot
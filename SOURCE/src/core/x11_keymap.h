@@ -0,0 +1,49 @@
+#ifndef X11_KEYMAP_H
+#define X11_KEYMAP_H
+
+#include <cstdint>
+
+namespace godot {
+
+// Keycode translation for the X11 global key listener. Raw XInput2 key events carry
+// the physical X keycode only; bindings are compiled against the keycode each Godot
+// key has on a standard evdev keyboard. This table sends every physical keycode to
+// the standard keycode of the keysym it produces in the active layout, so a binding
+// on A fires on whichever key types an a. Built from the server's keyboard mapping
+// once and again after each MappingNotify; the listener then does one load per key.
+class X11Keymap {
+public:
+    static constexpr int KEYCODE_SLOTS = 256; // X keycodes are 8-255
+
+    // Every keycode maps to itself until the first rebuild
+    X11Keymap();
+
+    // keysyms is the XGetKeyboardMapping result: keysyms_per_keycode entries for each
+    // keycode from first_keycode on. Only the unshifted keysym of the first group is used.
+    void rebuild(const unsigned long *keysyms, int first_keycode, int keycode_count, int keysyms_per_keycode);
+
+    inline uint16_t get_keycode(uint32_t x11_keycode) const {
+        return x11_keycode < KEYCODE_SLOTS ? keycodes[x11_keycode] : uint16_t(x11_keycode);
+    }
+    uint32_t get_keysym(uint32_t x11_keycode) const {
+        return x11_keycode < KEYCODE_SLOTS ? keysyms[x11_keycode] : 0;
+    }
+
+    // Keycodes whose standard keycode differs from their own, and rebuilds so far
+    int get_remapped_count() const {
+        return remapped_count;
+    }
+    uint64_t get_rebuild_count() const {
+        return rebuild_count;
+    }
+
+private:
+    uint16_t keycodes[KEYCODE_SLOTS];
+    uint32_t keysyms[KEYCODE_SLOTS];
+    int remapped_count = 0;
+    uint64_t rebuild_count = 0;
+};
+
+} // namespace godot
+
+#endif // X11_KEYMAP_H
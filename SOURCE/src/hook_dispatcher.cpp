@@ -0,0 +1,650 @@
+#include "hook_dispatcher.h"
+
+#include "core/keycode_tables.h"
+#include "core/overlay_log.h"
+
+#if defined(__linux__) || defined(__FreeBSD__)
+#include "x11_display.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XInput2.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace godot {
+
+namespace {
+
+std::mutex dispatcher_mutex;
+std::weak_ptr<HookDispatcher> shared_dispatcher;
+
+#ifdef _WIN32
+// The dispatcher whose hook runs on this thread, the hook callback has no user pointer
+thread_local HookDispatcher *hook_owner = nullptr;
+
+// Posted to the hook thread when the mouse hook should be installed or removed
+constexpr UINT WM_UPDATE_MOUSE_HOOK = WM_APP + 1;
+
+std::string wide_to_utf8(const wchar_t *text, int length) {
+    if (length <= 0) {
+        return std::string();
+    }
+    int size = WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0, nullptr, nullptr);
+    std::string result(size > 0 ? size : 0, '\0');
+    if (size > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, text, length, &result[0], size, nullptr, nullptr);
+    }
+    return result;
+}
+#elif defined(__linux__) || defined(__FreeBSD__)
+// Reads a window property, the caller frees r_data with XFree
+bool read_property(Display *display, ::Window window, Atom property, Atom type, long length,
+        unsigned char **r_data, unsigned long *r_count) {
+    Atom actual_type = None;
+    int actual_format = 0;
+    unsigned long bytes_after = 0;
+    *r_data = nullptr;
+    *r_count = 0;
+    if (XGetWindowProperty(display, window, property, 0, length, False, type, &actual_type,
+                &actual_format, r_count, &bytes_after, r_data) != Success) {
+        return false;
+    }
+    if (actual_type != type || !*r_data || *r_count == 0) {
+        if (*r_data) {
+            XFree(*r_data);
+            *r_data = nullptr;
+        }
+        return false;
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+std::shared_ptr<HookDispatcher> HookDispatcher::acquire() {
+    std::lock_guard<std::mutex> lock(dispatcher_mutex);
+    std::shared_ptr<HookDispatcher> dispatcher = shared_dispatcher.lock();
+    if (!dispatcher) {
+        dispatcher.reset(new HookDispatcher());
+        shared_dispatcher = dispatcher;
+    }
+    return dispatcher;
+}
+
+HookDispatcher::HookDispatcher() {
+#ifdef _WIN32
+    // Modifiers are tracked from the key stream instead of GetAsyncKeyState
+    modifier_tracker.set_windows_keycodes();
+
+    // Run the low-level keyboard hook on its own thread so a long Godot frame
+    // never stalls desktop input or gets the hook dropped by the OS
+    std::promise<bool> ready;
+    std::future<bool> hook_installed = ready.get_future();
+    hook_thread = std::thread(&HookDispatcher::hook_thread_main, this, std::move(ready));
+    hook_thread_id = GetThreadId(hook_thread.native_handle());
+    if (!hook_installed.get()) {
+        OVERLAY_LOG_ERROR("Failed to set up keyboard hook.\n");
+    } else {
+        OVERLAY_LOG_INFO("Keyboard hook set up successfully.\n");
+    }
+#elif defined(__linux__) || defined(__FreeBSD__)
+    // A connection of our own, so the listener thread never touches Godot's. The active
+    // window may be destroyed before its properties are read, that read fails instead
+    // of exiting.
+    display = open_background_display();
+    if (!display) {
+        OVERLAY_LOG_WARNING("Cannot open X display, foreground tracking is disabled.\n");
+        return;
+    }
+    root = DefaultRootWindow(display);
+    atom_net_active_window = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
+    atom_net_wm_pid = XInternAtom(display, "_NET_WM_PID", False);
+    atom_net_wm_name = XInternAtom(display, "_NET_WM_NAME", False);
+    atom_utf8_string = XInternAtom(display, "UTF8_STRING", False);
+    XSelectInput(display, root, PropertyChangeMask);
+    update_foreground();
+
+    // Raw key and button events reach every client since XInput 2.1, even while the game
+    // grabs the keyboard or pointer, and nothing is grabbed to get them
+    int event_base = 0;
+    int error_base = 0;
+    int major = 2;
+    int minor = 2;
+    if (XQueryExtension(display, "XInputExtension", &xi_opcode, &event_base, &error_base) &&
+            XIQueryVersion(display, &major, &minor) == Success && (major > 2 || (major == 2 && minor >= 1))) {
+        OVERLAY_LOG_VERBOSE("XInput %d.%d available for global keybinds.\n", major, minor);
+    } else {
+        xi_opcode = -1;
+        OVERLAY_LOG_WARNING("XInput 2.1 is not available, global keybinds are disabled.\n");
+    }
+
+    if (xi_opcode >= 0) {
+        // Keys sent through XTest (xdotool and friends) come from this slave device
+        int device_count = 0;
+        XIDeviceInfo *devices = XIQueryDevice(display, XIAllDevices, &device_count);
+        for (int i = 0; i < device_count; i++) {
+            if (devices[i].use == XISlaveKeyboard && strstr(devices[i].name, "XTEST")) {
+                xtest_keyboard = devices[i].deviceid;
+            }
+        }
+        if (devices) {
+            XIFreeDeviceInfo(devices);
+        }
+
+        // Modifiers are tracked from the key stream, raw events carry no modifier state
+        modifier_tracker.set_x11_keycodes();
+        update_keymap();
+    }
+
+    if (pipe(wake_pipe) != 0) {
+        OVERLAY_LOG_ERROR("Failed to create the X listener wake pipe.\n");
+        tracking_foreground.store(false, std::memory_order_relaxed);
+        close_background_display(display);
+        display = nullptr;
+        return;
+    }
+    listener_thread = std::thread(&HookDispatcher::listener_thread_main, this);
+#endif
+}
+
+HookDispatcher::~HookDispatcher() {
+#ifdef _WIN32
+    // Stop the hook thread, it unhooks before exiting
+    if (hook_thread.joinable()) {
+        PostThreadMessage(hook_thread_id, WM_QUIT, 0, 0);
+        hook_thread.join();
+        OVERLAY_LOG_INFO("Keyboard hook unset.\n");
+    }
+#elif defined(__linux__) || defined(__FreeBSD__)
+    // Wake the listener out of poll and wait for it before closing its connection
+    if (listener_thread.joinable()) {
+        char quit = 'q';
+        while (write(wake_pipe[1], &quit, 1) < 0 && errno == EINTR) {
+        }
+        listener_thread.join();
+    }
+    for (int fd : wake_pipe) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    if (display) {
+        close_background_display(display);
+    }
+#endif
+}
+
+bool HookDispatcher::subscribe(KeyEventQueue *queue) {
+    return fanout.subscribe(queue);
+}
+
+void HookDispatcher::unsubscribe(KeyEventQueue *queue) {
+    fanout.unsubscribe(queue);
+}
+
+int HookDispatcher::get_subscriber_count() const {
+    return fanout.get_subscriber_count();
+}
+
+bool HookDispatcher::is_hooked() const {
+#ifdef _WIN32
+    return hook_thread.joinable() && keyboard_hook != nullptr;
+#elif defined(__linux__) || defined(__FreeBSD__)
+    return listener_thread.joinable() && xi_opcode >= 0;
+#else
+    return false;
+#endif
+}
+
+bool HookDispatcher::is_tracking_foreground() const {
+    return tracking_foreground.load(std::memory_order_acquire);
+}
+
+uint64_t HookDispatcher::get_foreground_serial() const {
+    return foreground_serial.load(std::memory_order_acquire);
+}
+
+uint64_t HookDispatcher::get_foreground_window() const {
+    return foreground_window.load(std::memory_order_relaxed);
+}
+
+uint32_t HookDispatcher::get_foreground_process_id() const {
+    return foreground_process_id.load(std::memory_order_relaxed);
+}
+
+ForegroundApp HookDispatcher::get_foreground_app() const {
+    std::lock_guard<std::mutex> lock(foreground_mutex);
+    return foreground_app;
+}
+
+void HookDispatcher::acquire_mouse() {
+    if (mouse_users++ == 0) {
+        mouse_wanted.store(true, std::memory_order_release);
+        request_mouse_update();
+    }
+}
+
+void HookDispatcher::release_mouse() {
+    if (mouse_users > 0 && --mouse_users == 0) {
+        mouse_wanted.store(false, std::memory_order_release);
+        request_mouse_update();
+    }
+}
+
+bool HookDispatcher::is_mouse_hooked() const {
+    return mouse_hooked.load(std::memory_order_acquire);
+}
+
+void HookDispatcher::request_mouse_update() {
+    // Hooks belong to the input thread, it installs or removes them itself
+#ifdef _WIN32
+    if (hook_thread.joinable()) {
+        PostThreadMessage(hook_thread_id, WM_UPDATE_MOUSE_HOOK, 0, 0);
+    }
+#elif defined(__linux__) || defined(__FreeBSD__)
+    if (listener_thread.joinable()) {
+        char update = 'm';
+        while (write(wake_pipe[1], &update, 1) < 0 && errno == EINTR) {
+        }
+    }
+#endif
+}
+
+void HookDispatcher::set_foreground(ForegroundApp &&app) {
+    // Activation of the same window again is not a change
+    if (foreground_serial.load(std::memory_order_relaxed) != 0 && app.window == foreground_window.load(std::memory_order_relaxed)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(foreground_mutex);
+        foreground_window.store(app.window, std::memory_order_relaxed);
+        foreground_process_id.store(app.process_id, std::memory_order_relaxed);
+        foreground_app = std::move(app);
+    }
+    stats.foreground_changes.fetch_add(1, std::memory_order_relaxed);
+    foreground_serial.fetch_add(1, std::memory_order_release);
+}
+
+const HookStats &HookDispatcher::get_stats() const {
+    return stats;
+}
+
+void HookDispatcher::reset_stats() {
+    stats.reset();
+}
+
+#ifdef _WIN32
+void HookDispatcher::hook_thread_main(std::promise<bool> ready) {
+    // Force creation of the thread message queue before anyone can post WM_QUIT
+    MSG msg;
+    PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+    // The hook callback only copies a record, keep it ahead of busy game threads
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+
+    // Set up a low-level keyboard hook, it is called on this thread
+    hook_owner = this;
+    keyboard_hook = SetWindowsHookEx(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(nullptr), 0);
+    if (!keyboard_hook) {
+        ready.set_value(false);
+        return;
+    }
+
+    // Foreground changes are delivered to this message loop too, no polling
+    foreground_hook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr,
+            ForegroundEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    if (foreground_hook) {
+        update_foreground(GetForegroundWindow());
+        tracking_foreground.store(true, std::memory_order_release);
+    } else {
+        OVERLAY_LOG_WARNING("Failed to set up foreground event hook. Error: %lu\n", GetLastError());
+    }
+    ready.set_value(true);
+
+    // Message loop, low-level hooks are delivered while the thread waits here
+    while (GetMessage(&msg, nullptr, 0, 0) > 0) {
+        if (msg.hwnd == nullptr && msg.message == WM_UPDATE_MOUSE_HOOK) {
+            update_mouse_hook();
+            continue;
+        }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+
+    if (mouse_hook) {
+        UnhookWindowsHookEx(mouse_hook);
+        mouse_hook = nullptr;
+        mouse_hooked.store(false, std::memory_order_release);
+    }
+    if (foreground_hook) {
+        UnhookWinEvent(foreground_hook);
+        foreground_hook = nullptr;
+    }
+    UnhookWindowsHookEx(keyboard_hook);
+    keyboard_hook = nullptr;
+    hook_owner = nullptr;
+}
+
+LRESULT CALLBACK HookDispatcher::LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    HookDispatcher *dispatcher = hook_owner;
+    if (nCode >= 0 && dispatcher) {
+        KBDLLHOOKSTRUCT* pKeyInfo = (KBDLLHOOKSTRUCT*)lParam;
+        uint64_t start_nsec = get_monotonic_nsec();
+
+        // Only record the key here, matching happens in Overlay::process of each subscriber
+        // Modifiers are tracked per side, the record carries the generic key bindings compile to
+        const uint16_t vk = static_cast<uint16_t>(pKeyInfo->vkCode);
+        KeyEvent event;
+        event.timestamp_usec = start_nsec / 1000;
+        event.keycode = static_cast<uint16_t>(keycodes::windows_generic_vk(vk));
+        event.scancode = static_cast<uint16_t>(pKeyInfo->scanCode & 0xFF);
+        if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
+            event.flags |= KEY_EVENT_PRESSED;
+        }
+        if (pKeyInfo->flags & LLKHF_INJECTED) {
+            event.flags |= KEY_EVENT_INJECTED;
+        }
+        if (pKeyInfo->flags & LLKHF_EXTENDED) {
+            event.flags |= KEY_EVENT_EXTENDED;
+            event.scancode |= keycodes::WINDOWS_SCANCODE_EXTENDED;
+        }
+        event.modifiers = dispatcher->modifier_tracker.update(vk, event.flags & KEY_EVENT_PRESSED);
+        dispatcher->fanout.publish(event);
+
+        dispatcher->stats.hook_invocations.fetch_add(1, std::memory_order_relaxed);
+        dispatcher->stats.hook_nsec.record(get_monotonic_nsec() - start_nsec);
+    }
+
+    // Pass the event to the next hook in the chain
+    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+}
+
+void HookDispatcher::update_mouse_hook() {
+    bool wanted = mouse_wanted.load(std::memory_order_acquire);
+    if (wanted && !mouse_hook) {
+        mouse_hook = SetWindowsHookEx(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandle(nullptr), 0);
+        if (mouse_hook) {
+            OVERLAY_LOG_INFO("Mouse hook set up successfully.\n");
+        } else {
+            OVERLAY_LOG_ERROR("Failed to set up mouse hook. Error: %lu\n", GetLastError());
+        }
+    } else if (!wanted && mouse_hook) {
+        UnhookWindowsHookEx(mouse_hook);
+        mouse_hook = nullptr;
+        OVERLAY_LOG_INFO("Mouse hook unset.\n");
+    }
+    mouse_hooked.store(mouse_hook != nullptr, std::memory_order_release);
+}
+
+LRESULT CALLBACK HookDispatcher::LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    HookDispatcher *dispatcher = hook_owner;
+    if (nCode >= 0 && dispatcher) {
+        MSLLHOOKSTRUCT *info = (MSLLHOOKSTRUCT *)lParam;
+        uint64_t start_nsec = get_monotonic_nsec();
+        uint64_t timestamp_usec = start_nsec / 1000;
+
+        // Added into the running totals and nothing else, most of these are motion.
+        // Modifiers come from the keyboard hook on this same thread.
+        MouseAccumulator &mouse = dispatcher->mouse;
+        uint8_t modifiers = dispatcher->modifier_tracker.get_modifiers();
+        switch (wParam) {
+            case WM_MOUSEMOVE:
+                mouse.add_position(info->pt.x, info->pt.y, timestamp_usec);
+                break;
+            case WM_LBUTTONDOWN:
+                mouse.add_press(MouseAccumulator::BUTTON_LEFT, modifiers, timestamp_usec);
+                break;
+            case WM_RBUTTONDOWN:
+                mouse.add_press(MouseAccumulator::BUTTON_RIGHT, modifiers, timestamp_usec);
+                break;
+            case WM_MBUTTONDOWN:
+                mouse.add_press(MouseAccumulator::BUTTON_MIDDLE, modifiers, timestamp_usec);
+                break;
+            case WM_XBUTTONDOWN:
+                mouse.add_press(HIWORD(info->mouseData) == XBUTTON1 ? MouseAccumulator::BUTTON_X1 : MouseAccumulator::BUTTON_X2,
+                        modifiers, timestamp_usec);
+                break;
+            case WM_MOUSEWHEEL:
+                mouse.add_wheel(MouseAccumulator::WHEEL_VERTICAL, (short)HIWORD(info->mouseData), modifiers, timestamp_usec);
+                break;
+            case WM_MOUSEHWHEEL:
+                mouse.add_wheel(MouseAccumulator::WHEEL_HORIZONTAL, (short)HIWORD(info->mouseData), modifiers, timestamp_usec);
+                break;
+            default:
+                break;
+        }
+
+        dispatcher->stats.mouse_invocations.fetch_add(1, std::memory_order_relaxed);
+        dispatcher->stats.mouse_nsec.record(get_monotonic_nsec() - start_nsec);
+    }
+    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+}
+
+void CALLBACK HookDispatcher::ForegroundEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG object_id,
+        LONG child_id, DWORD event_thread, DWORD event_time) {
+    (void)hook;
+    (void)object_id;
+    (void)child_id;
+    (void)event_thread;
+    (void)event_time;
+    HookDispatcher *dispatcher = hook_owner;
+    if (dispatcher && event == EVENT_SYSTEM_FOREGROUND) {
+        dispatcher->update_foreground(hwnd);
+    }
+}
+
+void HookDispatcher::update_foreground(HWND hwnd) {
+    ForegroundApp app;
+    app.window = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(hwnd));
+    if (hwnd) {
+        DWORD process_id = 0;
+        GetWindowThreadProcessId(hwnd, &process_id);
+        app.process_id = process_id;
+
+        // Text of a window in another process is read without sending it a message
+        wchar_t title[256];
+        app.title = wide_to_utf8(title, GetWindowTextW(hwnd, title, 256));
+
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process_id);
+        if (process) {
+            wchar_t path[MAX_PATH];
+            DWORD length = MAX_PATH;
+            if (QueryFullProcessImageNameW(process, 0, path, &length)) {
+                app.executable = wide_to_utf8(path, static_cast<int>(length));
+            }
+            CloseHandle(process);
+        }
+    }
+    set_foreground(std::move(app));
+}
+#elif defined(__linux__) || defined(__FreeBSD__)
+void HookDispatcher::listener_thread_main() {
+    // Xlib needs XInitThreads for connections on several threads, Godot's X11 display server calls it
+    pollfd fds[2] = {
+        { ConnectionNumber(display), POLLIN, 0 },
+        { wake_pipe[0], POLLIN, 0 },
+    };
+    update_selection();
+    for (;;) {
+        bool active_changed = false;
+        while (XPending(display) > 0) {
+            XEvent event;
+            XNextEvent(display, &event);
+            if (event.type == PropertyNotify && event.xproperty.atom == atom_net_active_window) {
+                active_changed = true;
+                continue;
+            }
+            if (event.type == MappingNotify) {
+                // Xlib reports XKB map changes as MappingNotify too
+                if (event.xmapping.request == MappingKeyboard) {
+                    XRefreshKeyboardMapping(&event.xmapping);
+                    update_keymap();
+                }
+                continue;
+            }
+            if (event.type != GenericEvent || event.xcookie.extension != xi_opcode || !XGetEventData(display, &event.xcookie)) {
+                continue;
+            }
+
+            uint64_t start_nsec = get_monotonic_nsec();
+            const XIRawEvent *raw = static_cast<const XIRawEvent *>(event.xcookie.data);
+            if (event.xcookie.evtype == XI_RawKeyPress || event.xcookie.evtype == XI_RawKeyRelease) {
+                // Only record the key here, matching happens in Overlay::process of each subscriber.
+                // The keycode is the layout's, the scancode the physical evdev code.
+                KeyEvent key;
+                key.timestamp_usec = start_nsec / 1000;
+                key.keycode = keymap.get_keycode(static_cast<uint32_t>(raw->detail));
+                key.scancode = static_cast<uint16_t>(raw->detail >= int(keycodes::X11_EVDEV_KEYCODE_OFFSET) ? raw->detail - keycodes::X11_EVDEV_KEYCODE_OFFSET : 0);
+                if (event.xcookie.evtype == XI_RawKeyPress) {
+                    key.flags |= KEY_EVENT_PRESSED;
+                }
+                if (raw->sourceid == xtest_keyboard) {
+                    key.flags |= KEY_EVENT_INJECTED;
+                }
+                key.modifiers = modifier_tracker.update(key.keycode, key.flags & KEY_EVENT_PRESSED);
+                fanout.publish(key);
+
+                stats.hook_invocations.fetch_add(1, std::memory_order_relaxed);
+                stats.hook_nsec.record(get_monotonic_nsec() - start_nsec);
+            } else if (event.xcookie.evtype == XI_RawButtonPress) {
+                // Modifiers come from the raw key events on this same thread
+                uint8_t modifiers = modifier_tracker.get_modifiers();
+                uint64_t timestamp_usec = start_nsec / 1000;
+                switch (raw->detail) {
+                    case Button1:
+                        mouse.add_press(MouseAccumulator::BUTTON_LEFT, modifiers, timestamp_usec);
+                        break;
+                    case Button2:
+                        mouse.add_press(MouseAccumulator::BUTTON_MIDDLE, modifiers, timestamp_usec);
+                        break;
+                    case Button3:
+                        mouse.add_press(MouseAccumulator::BUTTON_RIGHT, modifiers, timestamp_usec);
+                        break;
+                    case Button4:
+                        mouse.add_wheel(MouseAccumulator::WHEEL_VERTICAL, MouseAccumulator::WHEEL_NOTCH, modifiers, timestamp_usec);
+                        break;
+                    case Button5:
+                        mouse.add_wheel(MouseAccumulator::WHEEL_VERTICAL, -MouseAccumulator::WHEEL_NOTCH, modifiers, timestamp_usec);
+                        break;
+                    case 6:
+                        mouse.add_wheel(MouseAccumulator::WHEEL_HORIZONTAL, -MouseAccumulator::WHEEL_NOTCH, modifiers, timestamp_usec);
+                        break;
+                    case 7:
+                        mouse.add_wheel(MouseAccumulator::WHEEL_HORIZONTAL, MouseAccumulator::WHEEL_NOTCH, modifiers, timestamp_usec);
+                        break;
+                    case 8:
+                        mouse.add_press(MouseAccumulator::BUTTON_X1, modifiers, timestamp_usec);
+                        break;
+                    case 9:
+                        mouse.add_press(MouseAccumulator::BUTTON_X2, modifiers, timestamp_usec);
+                        break;
+                    default:
+                        break;
+                }
+                stats.mouse_invocations.fetch_add(1, std::memory_order_relaxed);
+                stats.mouse_nsec.record(get_monotonic_nsec() - start_nsec);
+            }
+            XFreeEventData(display, &event.xcookie);
+        }
+        if (active_changed) {
+            update_foreground();
+        }
+        // Its round trips can read events into Xlib's queue, poll only sees the socket
+        if (XEventsQueued(display, QueuedAlready) > 0) {
+            continue;
+        }
+
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents) {
+            // A quit byte from the destructor ends the thread, anything else updates the selection
+            char commands[16];
+            ssize_t count = read(wake_pipe[0], commands, sizeof(commands));
+            if (count <= 0 || memchr(commands, 'q', static_cast<size_t>(count))) {
+                break;
+            }
+            update_selection();
+        }
+    }
+}
+
+void HookDispatcher::update_selection() {
+    if (xi_opcode < 0) {
+        return;
+    }
+    bool wanted = mouse_wanted.load(std::memory_order_acquire);
+    unsigned char bits[XIMaskLen(XI_LASTEVENT)] = {};
+    XISetMask(bits, XI_RawKeyPress);
+    XISetMask(bits, XI_RawKeyRelease);
+    if (wanted) {
+        XISetMask(bits, XI_RawButtonPress);
+    }
+    XIEventMask mask;
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(bits);
+    mask.mask = bits;
+    XISelectEvents(display, root, &mask, 1);
+    XFlush(display);
+    mouse_hooked.store(wanted, std::memory_order_release);
+    OVERLAY_LOG_VERBOSE("Raw keys selected, raw mouse buttons %s.\n", wanted ? "selected" : "deselected");
+}
+
+void HookDispatcher::update_keymap() {
+    int first_keycode = 0;
+    int last_keycode = 0;
+    XDisplayKeycodes(display, &first_keycode, &last_keycode);
+    int keysyms_per_keycode = 0;
+    KeySym *keysyms = XGetKeyboardMapping(display, static_cast<KeyCode>(first_keycode), last_keycode - first_keycode + 1, &keysyms_per_keycode);
+    keymap.rebuild(keysyms, first_keycode, last_keycode - first_keycode + 1, keysyms_per_keycode);
+    if (keysyms) {
+        XFree(keysyms);
+    }
+    OVERLAY_LOG_VERBOSE("Keyboard mapping loaded, %d keys differ from the standard layout.\n", keymap.get_remapped_count());
+}
+
+void HookDispatcher::update_foreground() {
+    unsigned char *data = nullptr;
+    unsigned long count = 0;
+    if (!read_property(display, root, atom_net_active_window, XA_WINDOW, 1, &data, &count)) {
+        return; // The window manager does not publish the active window
+    }
+    ForegroundApp app;
+    app.window = *reinterpret_cast<::Window *>(data);
+    XFree(data);
+
+    if (app.window) {
+        if (read_property(display, app.window, atom_net_wm_pid, XA_CARDINAL, 1, &data, &count)) {
+            app.process_id = static_cast<uint32_t>(*reinterpret_cast<unsigned long *>(data));
+            XFree(data);
+        }
+        if (read_property(display, app.window, atom_net_wm_name, atom_utf8_string, 256, &data, &count)) {
+            app.title.assign(reinterpret_cast<const char *>(data), count);
+            XFree(data);
+        } else if (read_property(display, app.window, XA_WM_NAME, XA_STRING, 256, &data, &count)) {
+            app.title.assign(reinterpret_cast<const char *>(data), count);
+            XFree(data);
+        }
+        if (app.process_id) {
+            char link[32];
+            char path[4096];
+            snprintf(link, sizeof(link), "/proc/%u/exe", app.process_id);
+            ssize_t length = readlink(link, path, sizeof(path));
+            if (length > 0) {
+                app.executable.assign(path, static_cast<size_t>(length));
+            }
+        }
+    }
+    tracking_foreground.store(true, std::memory_order_release);
+    set_foreground(std::move(app));
+}
+#endif
+
+} // namespace godot
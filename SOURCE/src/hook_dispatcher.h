@@ -0,0 +1,155 @@
+#ifndef HOOK_DISPATCHER_H
+#define HOOK_DISPATCHER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/key_event_fanout.h"
+#include "core/key_event_queue.h"
+#include "core/keybind_table.h"
+#include "core/mouse_accumulator.h"
+#include "core/overlay_stats.h"
+#include "core/x11_keymap.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <future>
+#include <thread>
+#elif defined(__linux__) || defined(__FreeBSD__)
+#include <thread>
+
+// Xlib is kept out of this header, its macros clash with Godot names
+struct _XDisplay;
+#endif
+
+namespace godot {
+
+// Application owning the foreground window
+struct ForegroundApp {
+    uint64_t window = 0; // HWND or X11 window id
+    uint32_t process_id = 0; // 0 when the window does not say
+    std::string executable; // Full path, empty when it cannot be read
+    std::string title; // UTF-8
+};
+
+// The process-wide global key hook. Every Overlay holds a reference and
+// subscribes its own queue; the hook is installed with the first reference
+// and removed with the last, so overlays can come and go independently.
+// On X11 it is a listener for raw XInput2 key events on the root window, which
+// every client receives without a grab and whichever window has focus.
+// The same input thread follows the foreground window from OS notifications,
+// so checking focus is an atomic load instead of a syscall.
+// Mouse input goes into one MouseAccumulator that every overlay reads once a frame;
+// the mouse hook is only installed while some overlay has mouse bindings.
+class HookDispatcher {
+public:
+    // Main thread
+    static std::shared_ptr<HookDispatcher> acquire();
+
+    ~HookDispatcher();
+
+    // The queue receives every key record until unsubscribed, false when all slots are taken
+    bool subscribe(KeyEventQueue *queue);
+    void unsubscribe(KeyEventQueue *queue);
+    int get_subscriber_count() const;
+
+    // False when the OS refused the hook or the platform has none
+    bool is_hooked() const;
+
+    // Foreground window, kept current by the input thread. The serial changes
+    // with every foreground change; readers compare it to notice one.
+    bool is_tracking_foreground() const;
+    uint64_t get_foreground_serial() const;
+    uint64_t get_foreground_window() const;
+    uint32_t get_foreground_process_id() const;
+    ForegroundApp get_foreground_app() const;
+
+    // Main thread, counted: the first acquire installs the mouse hook, the last release removes it
+    void acquire_mouse();
+    void release_mouse();
+    bool is_mouse_hooked() const;
+    const MouseAccumulator &get_mouse() const {
+        return mouse;
+    }
+
+    const HookStats &get_stats() const;
+    void reset_stats();
+
+private:
+    HookDispatcher();
+    HookDispatcher(const HookDispatcher &) = delete;
+    HookDispatcher &operator=(const HookDispatcher &) = delete;
+
+    KeyEventFanout fanout;
+    HookStats stats;
+
+    // Modifier state rebuilt from the hook stream, owned by the hook thread
+    ModifierTracker modifier_tracker;
+
+    // Written by the input thread only
+    std::atomic<bool> tracking_foreground{ false };
+    std::atomic<uint64_t> foreground_serial{ 0 };
+    std::atomic<uint64_t> foreground_window{ 0 };
+    std::atomic<uint32_t> foreground_process_id{ 0 };
+    mutable std::mutex foreground_mutex;
+    ForegroundApp foreground_app;
+    void set_foreground(ForegroundApp &&app);
+
+    // Written by the input thread only, read by every overlay
+    MouseAccumulator mouse;
+    int mouse_users = 0; // Main thread
+    std::atomic<bool> mouse_wanted{ false };
+    std::atomic<bool> mouse_hooked{ false };
+    void request_mouse_update();
+
+#ifdef _WIN32
+    // Windows API hook for global input, installed on its own thread
+    static LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
+    HHOOK keyboard_hook = nullptr;
+
+    // Installed and removed on the hook thread when mouse_wanted changes
+    static LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam);
+    HHOOK mouse_hook = nullptr;
+    void update_mouse_hook();
+
+    // Foreground changes, delivered to the hook thread's message loop
+    static void CALLBACK ForegroundEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG object_id,
+            LONG child_id, DWORD event_thread, DWORD event_time);
+    HWINEVENTHOOK foreground_hook = nullptr;
+    void update_foreground(HWND hwnd);
+
+    // Hook thread with its own message loop
+    std::thread hook_thread;
+    DWORD hook_thread_id = 0;
+    void hook_thread_main(std::promise<bool> ready);
+#elif defined(__linux__) || defined(__FreeBSD__)
+    // Own X connection listening for _NET_ACTIVE_WINDOW changes on the root window,
+    // Godot's connection and event loop are left alone
+    _XDisplay *display = nullptr;
+    unsigned long root = 0;
+    unsigned long atom_net_active_window = 0;
+    unsigned long atom_net_wm_pid = 0;
+    unsigned long atom_net_wm_name = 0;
+    unsigned long atom_utf8_string = 0;
+    std::thread listener_thread;
+    int wake_pipe[2] = { -1, -1 };
+    void listener_thread_main();
+    void update_foreground();
+
+    // Raw XInput2 key events on the root window, always selected, and raw button presses,
+    // selected while mouse_wanted is set. Motion is never selected, nothing binds to it on X11.
+    int xi_opcode = -1; // -1 without XInput 2.1, which delivers raw events during grabs
+    int xtest_keyboard = -1; // Source device of synthetic keys, they are flagged injected
+    void update_selection();
+
+    // Keysym table of the active layout, rebuilt on MappingNotify
+    X11Keymap keymap;
+    void update_keymap();
+#endif
+};
+
+} // namespace godot
+
+#endif // HOOK_DISPATCHER_H
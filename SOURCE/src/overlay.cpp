@@ -1,497 +1,2632 @@
 #include "overlay.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/container.hpp>
+#include <godot_cpp/classes/display_server.hpp>
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/scene_tree.hpp>
 #include <godot_cpp/classes/window.hpp>
 #include <godot_cpp/classes/input.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/panel_container.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/core/object_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
 
+#include "core/key_replay.h"
+#include "core/keycode_tables.h"
+#include "overlay_bootstrap.h"
+#include "core/pixel_convert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace godot {
+
+namespace {
+
+// Custom monitors shown in the debugger, indexed by Overlay::StatsMonitor
+const char *const MONITOR_IDS[] = {
+    "GodoverIt/hook_invocations",
+    "GodoverIt/hook_time_p99_ns",
+    "GodoverIt/keys_matched",
+    "GodoverIt/keys_unmatched",
+    "GodoverIt/toggle_latency_p99_us",
+    "GodoverIt/native_calls",
+    "GodoverIt/native_failures",
+    "GodoverIt/enable_time_us",
+    "GodoverIt/events_dropped",
+    "GodoverIt/frames_skipped",
+};
+
+Dictionary histogram_to_dictionary(const LatencyHistogram &histogram) {
+    Dictionary result;
+    result["count"] = (int64_t)histogram.get_count();
+    result["mean"] = histogram.get_mean();
+    result["max"] = (int64_t)histogram.get_max();
+    result["last"] = (int64_t)histogram.get_last();
+    result["p50"] = (int64_t)histogram.get_percentile(50.0);
+    result["p90"] = (int64_t)histogram.get_percentile(90.0);
+    result["p99"] = (int64_t)histogram.get_percentile(99.0);
+
+    // Bucket i counts values in [2^i, 2^(i+1)), trailing empty buckets are left out
+    int used = LatencyHistogram::BUCKETS;
+    while (used > 0 && histogram.get_bucket(used - 1) == 0) {
+        used--;
+    }
+    PackedInt64Array buckets;
+    buckets.resize(used);
+    for (int i = 0; i < used; i++) {
+        buckets.set(i, (int64_t)histogram.get_bucket(i));
+    }
+    result["buckets"] = buckets;
+    return result;
+}
+
+} // namespace
+
+std::vector<Overlay *> Overlay::live_overlays;
+bool Overlay::pacing_settings_saved = false;
+bool Overlay::saved_low_processor_mode = false;
+int Overlay::saved_low_processor_sleep_usec = 0;
+
+Overlay::Overlay() {
+    OVERLAY_LOG_VERBOSE("Overlay constructor called.\n");
+
+    // Take over the main window when the project made it an overlay before the first frame,
+    // otherwise pick the native backend for the running display server
+    OverlayState bootstrap_state;
+    uint64_t bootstrap_window = 0;
+    backend = OverlayBootstrap::take_backend(bootstrap_state, bootstrap_window);
+    if (backend) {
+        bootstrap_adopted = true;
+        state_machine.enable();
+        state_machine.merge(bootstrap_state, OVERLAY_STATE_ALL);
+        window_id = DisplayServer::MAIN_WINDOW_ID;
+        native_window_handle = bootstrap_window;
+    } else {
+        backend = OverlayBackend::create();
+    }
+    if (!backend) {
+        OVERLAY_LOG_WARNING("No overlay backend for display server %s.\n",
+                DisplayServer::get_singleton()->get_name().utf8().get_data());
+    }
+
+    // The first Overlay registers the debugger monitors, they report all overlays
+    static_assert(sizeof(MONITOR_IDS) / sizeof(MONITOR_IDS[0]) == MONITOR_COUNT, "One id per monitor");
+    Performance *performance = Performance::get_singleton();
+    if (live_overlays.empty() && performance && !performance->has_custom_monitor(MONITOR_IDS[0])) {
+        for (int i = 0; i < MONITOR_COUNT; i++) {
+            Array arguments;
+            arguments.push_back(i);
+            performance->add_custom_monitor(MONITOR_IDS[i], callable_mp_static(&Overlay::get_monitor_value), arguments);
+        }
+    }
+    live_overlays.push_back(this);
+
+    // All overlays share one global hook, each gets every key record in its own queue
+    hook_dispatcher = HookDispatcher::acquire();
+    if (!hook_dispatcher->subscribe(&key_events)) {
+        OVERLAY_LOG_ERROR("Too many overlays, global keybinds are disabled for this one.\n");
+    }
+    process_id = static_cast<uint32_t>(OS::get_singleton()->get_process_id());
+    foreground_serial = hook_dispatcher->get_foreground_serial();
+
+    // Fade steps go straight to the native window from the animator's thread
+    opacity_animator.set_sink([this](uint8_t alpha) {
+        return backend && backend->set_window_alpha(alpha);
+    });
+
+    // Gestures need to know which hook keycodes only change the modifier mask
+    ModifierTracker modifier_keys;
 #ifdef _WIN32
-#include <windows.h>
+    modifier_keys.set_windows_keycodes();
+#else
+    modifier_keys.set_x11_keycodes();
 #endif
+    gesture_recognizer.set_modifier_keys(modifier_keys);
+}
 
-namespace godot {
+Overlay::~Overlay() {
+    stop_key_recording();
+    disable_auto_fit();
+    opacity_animator.stop();
+    if (mouse_acquired) {
+        hook_dispatcher->release_mouse();
+    }
+
+    // Stop receiving key records, the hook is removed with the last overlay
+    hook_dispatcher->unsubscribe(&key_events);
+    hook_dispatcher.reset();
+    return_bootstrap();
+
+    // Windows made by create_window go away with the overlay
+    Window *window = Object::cast_to<Window>(ObjectDB::get_instance(window_object_id));
+    if (window && owns_window) {
+        window->queue_free();
+    }
+
+    // Leave the engine rendering the way the remaining overlays, or the project, want it
+    live_overlays.erase(std::find(live_overlays.begin(), live_overlays.end(), this));
+    apply_engine_pacing();
+
+    if (live_overlays.empty()) {
+        Performance *performance = Performance::get_singleton();
+        for (int i = 0; i < MONITOR_COUNT; i++) {
+            if (performance->has_custom_monitor(MONITOR_IDS[i])) {
+                performance->remove_custom_monitor(MONITOR_IDS[i]);
+            }
+        }
+    }
+
+    OVERLAY_LOG_VERBOSE("Overlay destructor called.\n");
+    flush_log();
+}
+
+void Overlay::handle_keybind(const KeyEvent &event) {
+    // Only key presses can trigger a keybind
+    if (!(event.flags & KEY_EVENT_PRESSED) || !state_machine.is_enabled()) {
+        return;
+    }
+
+    // Resolve the keybind, unbound keys never touch a Godot object
+    uint16_t key = use_physical_keycodes ? event.scancode : event.keycode;
+    uint16_t action = keybind_table.match(key, event.modifiers);
+    if (action == KeybindTable::NO_ACTION) {
+        stats.keys_unmatched.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    stats.keys_matched.fetch_add(1, std::memory_order_relaxed);
+
+    // Opacity steps are faded by the animator, nothing new has to be rendered for them.
+    // They have no InputMap action either, so they apply whichever window is focused.
+    bool is_opacity_step = action == ACTION_OPACITY_UP || action == ACTION_OPACITY_DOWN;
+    if (!is_opacity_step) {
+        frame_pacer.wake(event.timestamp_usec);
+
+        // Check if the Godot window is focused
+        if (is_godot_window_focused()) {
+            return; // Godot handles the key itself through the InputMap
+        }
+    }
+
+    // Toggle latency is measured from the first key press of the frame
+    if (action <= ACTION_TOGGLE_VISIBILITY && pending_toggle_usec == 0) {
+        pending_toggle_usec = event.timestamp_usec;
+    }
+    trigger_keybind_action(action);
+}
+
+void Overlay::trigger_keybind_action(uint16_t action) {
+    switch (action) {
+        case ACTION_TOGGLE_INPUT:
+            OVERLAY_LOG_VERBOSE("Input keybind pressed globally.\n");
+            if (state_machine.is_passthrough()) {
+                disable_input_passthrough();
+            } else {
+                enable_input_passthrough();
+            }
+            emit_signal("keybind_pressed", StringName("overlay_toggle_input"));
+            break;
+        case ACTION_TOGGLE_VISIBILITY:
+            OVERLAY_LOG_VERBOSE("Visibility keybind pressed globally.\n");
+            if (state_machine.is_visible()) {
+                disable_visibility();
+            } else {
+                enable_visibility();
+            }
+            emit_signal("keybind_pressed", StringName("overlay_toggle_visibility"));
+            break;
+        case ACTION_OPACITY_UP:
+            step_opacity(opacity_step);
+            emit_signal("keybind_pressed", StringName("overlay_opacity_up"));
+            break;
+        case ACTION_OPACITY_DOWN:
+            step_opacity(-opacity_step);
+            emit_signal("keybind_pressed", StringName("overlay_opacity_down"));
+            break;
+        default:
+            if (action - ACTION_CUSTOM_BASE < (int)keybinds.size()) {
+                emit_signal("keybind_pressed", keybinds[action - ACTION_CUSTOM_BASE].action);
+            }
+            break;
+    }
+}
+
+bool Overlay::make_table_binding(const Ref<InputEventKey> &event, uint16_t action, KeybindTable::Binding &r_binding) const {
+    if (event.is_null()) {
+        return false;
+    }
+
+    // Each mode falls back to the other key for events recorded without one
+    int os_keycode = 0;
+    if (use_physical_keycodes) {
+        int physical_keycode = event->get_physical_keycode();
+        if (physical_keycode == KEY_NONE) {
+            physical_keycode = event->get_keycode();
+        }
+        os_keycode = godot_to_os_scancode(physical_keycode);
+    } else {
+        int godot_keycode = event->get_keycode();
+        if (godot_keycode == KEY_NONE) {
+            godot_keycode = event->get_physical_keycode();
+        }
+        os_keycode = godot_to_os_keycode(godot_keycode);
+    }
+    if (os_keycode <= 0 || os_keycode >= KeybindTable::KEY_SLOTS) {
+        return false;
+    }
+
+    r_binding.keycode = static_cast<uint16_t>(os_keycode);
+    r_binding.modifiers = 0;
+    if (event->is_ctrl_pressed()) {
+        r_binding.modifiers |= MODIFIER_CTRL;
+    }
+    if (event->is_shift_pressed()) {
+        r_binding.modifiers |= MODIFIER_SHIFT;
+    }
+    if (event->is_alt_pressed()) {
+        r_binding.modifiers |= MODIFIER_ALT;
+    }
+    if (event->is_meta_pressed()) {
+        r_binding.modifiers |= MODIFIER_META;
+    }
+    r_binding.action = action;
+    return true;
+}
+
+void Overlay::compile_keybinds() {
+    std::vector<KeybindTable::Binding> bindings;
+    bindings.reserve(keybinds.size() + ACTION_CUSTOM_BASE);
+
+    int unmapped = 0;
+    KeybindTable::Binding binding;
+    if (input_keybind.is_valid()) {
+        if (make_table_binding(input_keybind, ACTION_TOGGLE_INPUT, binding)) {
+            bindings.push_back(binding);
+        } else {
+            unmapped++;
+        }
+    }
+    if (visibility_keybind.is_valid()) {
+        if (make_table_binding(visibility_keybind, ACTION_TOGGLE_VISIBILITY, binding)) {
+            bindings.push_back(binding);
+        } else {
+            unmapped++;
+        }
+    }
+    if (opacity_increase_keybind.is_valid()) {
+        if (make_table_binding(opacity_increase_keybind, ACTION_OPACITY_UP, binding)) {
+            bindings.push_back(binding);
+        } else {
+            unmapped++;
+        }
+    }
+    if (opacity_decrease_keybind.is_valid()) {
+        if (make_table_binding(opacity_decrease_keybind, ACTION_OPACITY_DOWN, binding)) {
+            bindings.push_back(binding);
+        } else {
+            unmapped++;
+        }
+    }
+    for (size_t i = 0; i < keybinds.size(); i++) {
+        if (make_table_binding(keybinds[i].event, static_cast<uint16_t>(ACTION_CUSTOM_BASE + i), binding)) {
+            bindings.push_back(binding);
+        } else {
+            unmapped++;
+        }
+    }
+
+    unmapped += keybind_table.compile(bindings.data(), bindings.size());
+    if (unmapped > 0) {
+        OVERLAY_LOG_WARNING("%d keybinds could not be mapped to an OS key.\n", unmapped);
+    }
+}
+
+bool Overlay::make_gesture(const std::vector<Ref<InputEventKey>> &events, GestureRecognizer::Kind kind, uint16_t action, double duration, GestureRecognizer::Gesture &r_gesture) const {
+    r_gesture.kind = kind;
+    r_gesture.action = action;
+    r_gesture.duration_usec = static_cast<uint64_t>(MAX(duration, 0.0) * 1000000.0);
+    r_gesture.steps.clear();
+
+    KeybindTable::Binding binding;
+    for (const Ref<InputEventKey> &event : events) {
+        if (!make_table_binding(event, action, binding)) {
+            return false;
+        }
+        // A modifier key is matched against the modifiers held before it, its own bit
+        // is set on events recorded from the key itself
+        switch (event->get_keycode()) {
+            case KEY_CTRL:
+                binding.modifiers &= ~MODIFIER_CTRL;
+                break;
+            case KEY_SHIFT:
+                binding.modifiers &= ~MODIFIER_SHIFT;
+                break;
+            case KEY_ALT:
+                binding.modifiers &= ~MODIFIER_ALT;
+                break;
+            case KEY_META:
+                binding.modifiers &= ~MODIFIER_META;
+                break;
+            default:
+                break;
+        }
+        r_gesture.steps.push_back({ binding.keycode, binding.modifiers });
+    }
+    return !r_gesture.steps.empty();
+}
+
+void Overlay::compile_gestures() {
+    std::vector<GestureRecognizer::Gesture> compiled;
+    compiled.reserve(gestures.size() + GESTURE_CUSTOM_BASE);
+
+    int unmapped = 0;
+    GestureRecognizer::Gesture gesture;
+    if (peek_keybind.is_valid()) {
+        if (make_gesture({ peek_keybind }, GestureRecognizer::KIND_HOLD, GESTURE_PEEK, peek_hold_time, gesture)) {
+            compiled.push_back(gesture);
+        } else {
+            unmapped++;
+        }
+    }
+    for (size_t i = 0; i < gestures.size(); i++) {
+        const RegisteredGesture &registered = gestures[i];
+        if (make_gesture(registered.events, registered.kind, static_cast<uint16_t>(GESTURE_CUSTOM_BASE + i), registered.duration, gesture)) {
+            compiled.push_back(gesture);
+        } else {
+            unmapped++;
+        }
+    }
+
+    // Recompiling drops gestures in flight, a peek in progress ends with them
+    if (peeking) {
+        peeking = false;
+        enable_input_passthrough();
+    }
+    gesture_recognizer.set_use_scancodes(use_physical_keycodes);
+    unmapped += gesture_recognizer.compile(compiled.data(), compiled.size());
+    if (unmapped > 0) {
+        OVERLAY_LOG_WARNING("%d gestures could not be mapped to OS keys.\n", unmapped);
+    }
+}
+
+void Overlay::emit_gestures() {
+    uint64_t now_usec = get_monotonic_usec();
+    for (const GestureRecognizer::Result &result : gesture_results) {
+        frame_pacer.wake(now_usec);
+        bool recognized = result.phase == GestureRecognizer::PHASE_RECOGNIZED;
+        if (recognized) {
+            stats.gestures_recognized.fetch_add(1, std::memory_order_relaxed);
+            stats.gesture_usec.record(now_usec > result.timestamp_usec ? now_usec - result.timestamp_usec : 0);
+        }
+        const char *signal = recognized ? "gesture_recognized" : "gesture_released";
+
+        if (result.action == GESTURE_PEEK) {
+            // Interactive only while held, a peek started in full passthrough gives it back
+            if (recognized && state_machine.is_enabled() && state_machine.is_passthrough()) {
+                OVERLAY_LOG_VERBOSE("Peek keybind held.\n");
+                peeking = true;
+                disable_input_passthrough();
+            } else if (!recognized && peeking) {
+                peeking = false;
+                enable_input_passthrough();
+            }
+            emit_signal(signal, StringName("overlay_peek"));
+        } else if (result.action - GESTURE_CUSTOM_BASE < (int)gestures.size() && state_machine.is_enabled()) {
+            emit_signal(signal, gestures[result.action - GESTURE_CUSTOM_BASE].action);
+        }
+    }
+    gesture_results.clear();
+}
+
+// Convert a Godot keycode to the keycode the global hook reports
+int Overlay::godot_to_os_keycode(int godot_keycode) {
+#ifdef _WIN32
+    return keycodes::godot_to_windows_vk(godot_keycode);
+#else
+    uint32_t evdev_code = keycodes::godot_to_evdev(godot_keycode);
+    return evdev_code ? evdev_code + keycodes::X11_EVDEV_KEYCODE_OFFSET : 0;
+#endif
+}
 
+// Convert a Godot physical keycode to the layout independent scancode the hook reports
+int Overlay::godot_to_os_scancode(int godot_physical_keycode) {
 #ifdef _WIN32
-HHOOK Overlay::keyboard_hook = nullptr;
-Overlay* Overlay::instance = nullptr; // Initialize static instance pointer
+    return keycodes::godot_to_windows_scancode(godot_physical_keycode);
+#else
+    return keycodes::godot_to_evdev(godot_physical_keycode);
 #endif
+}
+
+void Overlay::flush_log() {
+    OverlayLog::flush([](const OverlayLogRecord &record) {
+        String message = String("[Overlay] ") + String::utf8(record.text);
+        switch (record.level) {
+            case OVERLAY_LOG_ERROR:
+                UtilityFunctions::push_error(message);
+                break;
+            case OVERLAY_LOG_WARNING:
+                UtilityFunctions::push_warning(message);
+                break;
+            default:
+                UtilityFunctions::print(message);
+                break;
+        }
+    });
+}
+
+bool Overlay::is_godot_window_focused() const {
+    // Any window of this process counts, Godot then sees the key through the InputMap itself
+    if (hook_dispatcher->is_tracking_foreground()) {
+        uint32_t foreground_process = hook_dispatcher->get_foreground_process_id();
+        if (foreground_process != 0) {
+            return foreground_process == process_id;
+        }
+        return native_window_handle != 0 && hook_dispatcher->get_foreground_window() == native_window_handle;
+    }
+
+    if (!backend) {
+        return false; // No native window, assume not focused
+    }
+    return backend->is_window_focused();
+}
+
+bool Overlay::get_is_godot_focused() const {
+    return is_godot_window_focused();
+}
+
+Dictionary Overlay::get_foreground_app() const {
+    ForegroundApp app = hook_dispatcher->get_foreground_app();
+    Dictionary result;
+    result["window"] = (int64_t)app.window;
+    result["process_id"] = (int64_t)app.process_id;
+    result["executable"] = String::utf8(app.executable.c_str());
+    result["title"] = String::utf8(app.title.c_str());
+    return result;
+}
+
+void Overlay::enable_overlay_with_title(const String &title) {
+    window_title = title; // Set the window title
+    enable_overlay(); // Call the original method
+}
+
+void Overlay::enable_overlay() {
+    Window *window = get_target_window();
+    if (window) {
+        OVERLAY_LOG_VERBOSE("Godot window is valid.\n");
+
+        if (!backend) {
+            OVERLAY_LOG_ERROR("Overlay is not supported on this platform.\n");
+            flush_log();
+            return;
+        }
+        uint64_t start_usec = get_monotonic_usec();
+
+        // Embedded subwindows are drawn inside their parent and have no native window
+        window_id = window->get_window_id();
+        OVERLAY_LOG_VERBOSE("Window ID: %d\n", window_id);
+        if (window_id == DisplayServer::INVALID_WINDOW_ID) {
+            OVERLAY_LOG_ERROR("Window has no native window, disable display/window/subwindows/embed_subwindows.\n");
+            flush_log();
+            return;
+        }
+
+        // Ask the display server for the native handles of the window
+        DisplayServer *display_server = DisplayServer::get_singleton();
+        int64_t native_window = display_server->window_get_native_handle(DisplayServer::WINDOW_HANDLE, window_id);
+        int64_t native_display = display_server->window_get_native_handle(DisplayServer::DISPLAY_HANDLE, window_id);
+        CharString title = (window_object_id ? window->get_title() : window_title).utf8();
+        bool attached = backend->attach(native_window, native_display, title.get_data());
+        native_window_handle = static_cast<uint64_t>(native_window);
+        stats.attach_usec.record(get_monotonic_usec() - start_usec);
+        if (!attached) {
+            flush_log();
+            return; // Exit if the window is still invalid
+        }
+
+        // Borderless, always on top, transparent and ignoring input, applied as one batch
+        state_machine.enable();
+        cursor_over_region = false;
+        commit_state();
+
+        uint64_t elapsed_usec = get_monotonic_usec() - start_usec;
+        stats.enable_usec.record(elapsed_usec);
+        OVERLAY_LOG_VERBOSE("%s overlay enabled in %llu us.\n", backend->get_name(), (unsigned long long)elapsed_usec);
+    } else {
+        OVERLAY_LOG_ERROR("Failed to retrieve Godot window.\n");
+    }
+    flush_log();
+}
+
+Window *Overlay::get_target_window() const {
+    if (window_object_id != 0) {
+        return Object::cast_to<Window>(ObjectDB::get_instance(window_object_id));
+    }
+    SceneTree *scene_tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!scene_tree) {
+        OVERLAY_LOG_ERROR("Failed to retrieve SceneTree.\n");
+        return nullptr;
+    }
+    return scene_tree->get_root();
+}
+
+void Overlay::set_window(Window *window) {
+    uint64_t new_id = window ? (uint64_t)window->get_instance_id() : 0;
+    if (new_id == window_object_id) {
+        return;
+    }
+
+    // Leave the previous window as a normal window, handles and applied state start over.
+    // A bootstrapped main window stays an overlay for the next Overlay driving it.
+    stop_fades();
+    disable_auto_fit();
+    if (bootstrap_adopted) {
+        return_bootstrap();
+        state_machine = OverlayStateMachine();
+    } else if (state_machine.is_enabled()) {
+        disable_overlay();
+    }
+    Window *previous = Object::cast_to<Window>(ObjectDB::get_instance(window_object_id));
+    if (previous) {
+        previous->disconnect("tree_exiting", callable_mp(this, &Overlay::_on_window_exiting));
+        if (owns_window) {
+            previous->queue_free();
+        }
+    }
+    backend = OverlayBackend::create();
+
+    window_object_id = new_id;
+    owns_window = false;
+    window_id = 0;
+    native_window_handle = 0;
+    if (window) {
+        window->connect("tree_exiting", callable_mp(this, &Overlay::_on_window_exiting));
+    }
+}
+
+void Overlay::return_bootstrap() {
+    if (!bootstrap_adopted) {
+        return;
+    }
+    bootstrap_adopted = false;
+
+    // Once disabled it is a normal window, nothing is left to hand on
+    if (state_machine.is_enabled()) {
+        OverlayBootstrap::return_backend(std::move(backend), state_machine.get_desired(), native_window_handle);
+    }
+}
+
+Window *Overlay::get_window() const {
+    return get_target_window();
+}
+
+Window *Overlay::create_window(const Rect2i &rect) {
+    SceneTree *scene_tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!scene_tree || !scene_tree->get_root()) {
+        OVERLAY_LOG_ERROR("Failed to retrieve SceneTree.\n");
+        flush_log();
+        return nullptr;
+    }
+    Window *root = scene_tree->get_root();
+    if (root->is_embedding_subwindows()) {
+        OVERLAY_LOG_ERROR("Subwindows are embedded, disable display/window/subwindows/embed_subwindows.\n");
+        flush_log();
+        return nullptr;
+    }
+
+    // Only the area the content needs is composited, not a desktop sized surface
+    Window *window = memnew(Window);
+    window->set_title(window_title + " Overlay");
+    window->set_flag(Window::FLAG_BORDERLESS, true);
+    window->set_flag(Window::FLAG_TRANSPARENT, true);
+    window->set_flag(Window::FLAG_ALWAYS_ON_TOP, true);
+    window->set_transparent_background(true);
+    window->set_position(rect.position);
+    window->set_size(rect.size);
+    root->add_child(window);
+
+    set_window(window);
+    owns_window = true;
+    return window;
+}
+
+Overlay *Overlay::create_for_screen(int screen) {
+    DisplayServer *display_server = DisplayServer::get_singleton();
+    if (screen < 0 || screen >= display_server->get_screen_count()) {
+        OVERLAY_LOG_ERROR("Screen %d does not exist.\n", screen);
+        flush_log();
+        return nullptr;
+    }
+
+    // A window covering the usable area of the screen, taskbars and docks stay clickable
+    Overlay *overlay = memnew(Overlay);
+    if (!overlay->create_window(display_server->screen_get_usable_rect(screen))) {
+        memdelete(overlay);
+        return nullptr;
+    }
+    return overlay;
+}
+
+void Overlay::_on_window_exiting() {
+    // The native window goes away with the Window, the handles are stale after this
+    if (state_machine.is_enabled()) {
+        OVERLAY_LOG_INFO("Overlay window left the tree, overlay disabled.\n");
+    }
+    stop_fades();
+    state_machine.disable();
+    cursor_over_region = false;
+    if (backend) {
+        backend = OverlayBackend::create();
+    }
+    window_id = 0;
+    native_window_handle = 0;
+    update_frame_pacing();
+}
+
+void Overlay::disable_overlay() {
+    if (backend && backend->is_attached()) {
+        uint64_t start_usec = get_monotonic_usec();
+
+        cancel_fade();
+        state_machine.disable();
+        commit_state();
+        update_frame_pacing();
+
+        uint64_t elapsed_usec = get_monotonic_usec() - start_usec;
+        stats.disable_usec.record(elapsed_usec);
+        OVERLAY_LOG_VERBOSE("%s overlay disabled in %llu us.\n", backend->get_name(), (unsigned long long)elapsed_usec);
+    }
+    flush_log();
+}
+
+void Overlay::enable_input_passthrough() {
+    if (backend && backend->is_attached()) {
+        // Make the window transparent to input
+        if (state_machine.set_passthrough(true)) {
+            cursor_over_region = false;
+            request_commit();
+        }
+    } else {
+        OVERLAY_LOG_WARNING("Native window is invalid. Cannot enable passthrough.\n");
+    }
+}
+
+void Overlay::disable_input_passthrough() {
+    if (backend && backend->is_attached()) {
+        // Remove the input transparency, the window is focused once committed
+        if (state_machine.set_passthrough(false)) {
+            request_commit();
+        }
+    } else {
+        OVERLAY_LOG_WARNING("Native window is invalid. Cannot disable passthrough.\n");
+    }
+}
+
+void Overlay::enable_visibility() {
+    if (backend && backend->is_attached()) {
+        // Make the window fully opaque
+        if (state_machine.set_visible(true)) {
+            request_commit();
+        }
+    } else {
+        OVERLAY_LOG_WARNING("Native window is invalid. Cannot enable visibility.\n");
+    }
+}
+
+void Overlay::disable_visibility() {
+    if (backend && backend->is_attached()) {
+        // Make the window fully transparent, a fade would show it again
+        cancel_fade();
+        if (state_machine.set_visible(false)) {
+            request_commit();
+        }
+    } else {
+        OVERLAY_LOG_WARNING("Native window is invalid. Cannot disable visibility.\n");
+    }
+}
+
+void Overlay::set_opacity(double opacity) {
+    cancel_fade();
+    OverlayState values;
+    values.alpha = static_cast<uint8_t>(std::lround(CLAMP(opacity, 0.0, 1.0) * 255.0));
+    state_machine.merge(values, OVERLAY_STATE_ALPHA);
+    if (backend && backend->is_attached()) {
+        request_commit();
+    }
+}
+
+double Overlay::get_opacity() const {
+    uint8_t alpha = fade_running ? opacity_animator.get_alpha() : state_machine.get_desired().alpha;
+    return alpha / 255.0;
+}
+
+void Overlay::fade_to(double opacity, double duration, FadeCurve curve) {
+    // Without a window to fade the opacity is only stored
+    if (!backend || !backend->is_attached() || !state_machine.is_enabled() || duration <= 0.0) {
+        set_opacity(opacity);
+        return;
+    }
+
+    // A hidden overlay is shown at alpha 0 right away, so the first step starts from there
+    if (!state_machine.is_visible()) {
+        cancel_fade();
+        OverlayState values;
+        values.alpha = 0;
+        state_machine.merge(values, OVERLAY_STATE_ALPHA);
+        state_machine.set_visible(true);
+        commit_state();
+    }
+
+    // Without a fade running the window shows the committed alpha, a new fade replaces
+    // the running one from wherever it got to and counts as the same fade
+    if (!fade_running) {
+        opacity_animator.set_alpha(state_machine.get_desired().alpha);
+        // The animator writes alpha behind the backend's cached state from here on
+        backend->invalidate_state(OVERLAY_STATE_ALPHA);
+        fade_running = true;
+        fade_start_usec = get_monotonic_usec();
+        fade_start_frames = Engine::get_singleton()->get_frames_drawn();
+    }
+    fade_target = static_cast<uint8_t>(std::lround(CLAMP(opacity, 0.0, 1.0) * 255.0));
+    opacity_animator.fade_to(fade_target, static_cast<uint64_t>(duration * 1000000.0), static_cast<OpacityAnimator::Curve>(curve));
+    fade_serial = opacity_animator.get_finished_serial();
+}
+
+void Overlay::cancel_fade() {
+    if (fade_running) {
+        opacity_animator.cancel();
+        end_fade(false);
+    }
+}
+
+bool Overlay::is_fading() const {
+    return fade_running;
+}
+
+void Overlay::set_fade_step_rate(int steps_per_second) {
+    opacity_animator.set_step_rate(steps_per_second);
+}
+
+int Overlay::get_fade_step_rate() const {
+    return opacity_animator.get_step_rate();
+}
+
+void Overlay::end_fade(bool reached) {
+    fade_running = false;
+    uint8_t alpha = opacity_animator.get_alpha();
+    stats.fades.fetch_add(1, std::memory_order_relaxed);
+    stats.fade_usec.record(get_monotonic_usec() - fade_start_usec);
+    stats.fade_frames_drawn.fetch_add(Engine::get_singleton()->get_frames_drawn() - fade_start_frames, std::memory_order_relaxed);
+
+    // The backend's cached alpha is whatever it last set itself, not what the fade left.
+    // The alpha is sent again, cancel has waited for the last step so it lands after it.
+    OverlayState values;
+    values.alpha = alpha;
+    state_machine.merge(values, OVERLAY_STATE_ALPHA);
+    if (backend) {
+        backend->invalidate_state(OVERLAY_STATE_ALPHA);
+    }
+    if (backend && backend->is_attached()) {
+        request_commit();
+    }
+    if (reached) {
+        emit_signal("fade_finished", alpha / 255.0);
+    }
+}
+
+void Overlay::stop_fades() {
+    // Joins the animator's thread, after this nothing calls into the backend
+    opacity_animator.stop();
+    if (fade_running) {
+        end_fade(false);
+    }
+}
+
+void Overlay::step_opacity(double step) {
+    // Presses during a fade add up from its target
+    if (!state_machine.is_visible()) {
+        return;
+    }
+    uint8_t base = fade_running ? fade_target : state_machine.get_desired().alpha;
+    fade_to(base / 255.0 + step, opacity_step_time, FADE_CURVE_EASE_OUT);
+}
+
+void Overlay::set_opacity_step_keybinds(const Ref<InputEvent> &increase, const Ref<InputEvent> &decrease, double step, double fade_time) {
+    opacity_increase_keybind = increase;
+    opacity_decrease_keybind = decrease;
+    opacity_step = CLAMP(step, 0.0, 1.0);
+    opacity_step_time = MAX(fade_time, 0.0);
+    compile_keybinds();
+    OVERLAY_LOG_VERBOSE("Opacity step keybinds set.\n");
+}
+
+Ref<InputEvent> Overlay::get_opacity_increase_keybind() const {
+    return opacity_increase_keybind;
+}
+
+Ref<InputEvent> Overlay::get_opacity_decrease_keybind() const {
+    return opacity_decrease_keybind;
+}
+
+bool Overlay::attach_to_window(const String &process_name, const String &title, const String &window_class) {
+    WindowMatch match;
+    match.process_name = process_name.utf8().get_data();
+    match.title = title.utf8().get_data();
+    match.window_class = window_class.utf8().get_data();
+    if (match.is_empty()) {
+        OVERLAY_LOG_ERROR("attach_to_window needs a process name, title or window class.\n");
+        return false;
+    }
+
+    // Tracking positions the overlay window, only where a backend knows the native one
+    detach_from_window();
+    if (backend) {
+        window_tracker = WindowTracker::create();
+    }
+    if (!window_tracker || !window_tracker->start(match)) {
+        window_tracker.reset();
+        OVERLAY_LOG_WARNING("Window tracking is not supported here, attach_to_window ignored.\n");
+        return false;
+    }
+
+    // Hidden until the window is found, the first state is taken on the next frame
+    window_tracker_serial = 0;
+    tracked_window = TrackedWindow();
+    tracked_hidden = true;
+    if (backend->is_attached()) {
+        request_commit();
+    }
+    OVERLAY_LOG_VERBOSE("Following windows matching process \"%s\", title \"%s\", class \"%s\" (%s).\n",
+            match.process_name.c_str(), match.title.c_str(), match.window_class.c_str(), window_tracker->get_name());
+    return true;
+}
+
+void Overlay::detach_from_window() {
+    if (!window_tracker) {
+        return;
+    }
+    window_tracker.reset();
+    bool had_window = tracked_window.window != 0;
+    tracked_window = TrackedWindow();
+    if (tracked_hidden) {
+        tracked_hidden = false;
+        frame_pacer.wake(get_monotonic_usec());
+        if (backend && backend->is_attached()) {
+            request_commit();
+        }
+    }
+    if (had_window) {
+        emit_signal("target_lost");
+    }
+}
+
+bool Overlay::is_attached_to_window() const {
+    return window_tracker != nullptr;
+}
+
+Dictionary Overlay::get_attached_window_state() const {
+    return tracked_window_to_dictionary(tracked_window);
+}
+
+Dictionary Overlay::tracked_window_to_dictionary(const TrackedWindow &state) const {
+    Dictionary result;
+    result["window"] = (int64_t)state.window;
+    result["process_id"] = (int64_t)state.process_id;
+    result["rect"] = Rect2i(state.rect.x, state.rect.y, state.rect.width, state.rect.height);
+    result["minimized"] = state.minimized;
+    result["occluded"] = state.occluded;
+    return result;
+}
+
+void Overlay::update_tracked_window() {
+    TrackedWindow previous = tracked_window;
+    tracked_window = window_tracker->get_state();
+    const TrackedWindow &current = tracked_window;
+    stats.target_updates.fetch_add(1, std::memory_order_relaxed);
+
+    // The tracker only publishes changes, geometry is still compared field by field
+    bool found = current.window != 0 && current.window != previous.window;
+    bool lost = previous.window != 0 && current.window != previous.window;
+    bool moved = current.window != 0 && !current.minimized && !current.rect.is_empty() &&
+            (found || current.rect != previous.rect);
+    if (moved) {
+        move_to_tracked_window();
+    }
+
+    // Hidden and suspended while there is nothing to draw over
+    bool hidden = current.window == 0 || current.minimized || current.occluded;
+    if (hidden != tracked_hidden) {
+        tracked_hidden = hidden;
+        if (!hidden) {
+            frame_pacer.wake(get_monotonic_usec());
+        }
+        if (backend && backend->is_attached()) {
+            request_commit();
+        }
+    }
+
+    // Signals last, a handler may detach
+    if (lost) {
+        emit_signal("target_lost");
+    }
+    if (found) {
+        emit_signal("target_found", tracked_window_to_dictionary(current));
+    }
+    if (moved) {
+        emit_signal("target_rect_changed", Rect2i(current.rect.x, current.rect.y, current.rect.width, current.rect.height));
+    }
+    if (current.window != 0 && !found && (current.minimized != previous.minimized || current.occluded != previous.occluded)) {
+        emit_signal("target_visibility_changed", current.minimized, current.occluded);
+    }
+}
+
+void Overlay::move_to_tracked_window() {
+    Window *window = get_target_window();
+    if (!window) {
+        return;
+    }
+    uint64_t start_usec = get_monotonic_usec();
+
+    // The tracker reports native screen pixels, Godot may place its screens elsewhere
+    Vector2i offset;
+    int32_t native_x = 0;
+    int32_t native_y = 0;
+    if (backend && backend->is_attached() && backend->get_client_origin(native_x, native_y)) {
+        offset = window->get_position() - Vector2i(native_x, native_y);
+    }
+    const RegionRect &rect = tracked_window.rect;
+    Vector2i position = Vector2i(rect.x, rect.y) + offset;
+    Vector2i size(rect.width, rect.height);
+    if (fit_root_id != 0) {
+        set_fit_frame(Rect2i(position, size)); // The fit stays inside the followed window
+    } else {
+        if (window->get_position() != position) {
+            window->set_position(position);
+        }
+        if (window->get_size() != size) {
+            window->set_size(size);
+        }
+    }
+
+    stats.target_moves.fetch_add(1, std::memory_order_relaxed);
+    stats.target_move_usec.record(get_monotonic_usec() - start_usec);
+}
+
+bool Overlay::enable_auto_fit(Control *content_root, int margin, int snap, double shrink_delay) {
+    disable_auto_fit();
+    Window *window = get_target_window();
+    if (!content_root || !content_root->is_inside_tree() || !window) {
+        OVERLAY_LOG_ERROR("enable_auto_fit needs a content root inside the tree.\n");
+        flush_log();
+        return false;
+    }
+
+    // A stretched viewport would rescale content with every resize instead of cropping it
+    if (window->get_content_scale_mode() != Window::CONTENT_SCALE_MODE_DISABLED) {
+        OVERLAY_LOG_ERROR("Auto-fit needs display/window/stretch/mode disabled.\n");
+        flush_log();
+        return false;
+    }
+
+    window_fit = WindowFit();
+    window_fit.set_margin(margin);
+    window_fit.set_snap(snap);
+    window_fit.set_shrink_delay_usec(static_cast<uint64_t>(MAX(shrink_delay, 0.0) * 1000000.0));
+    fit_root_id = content_root->get_instance_id();
+    fit_start_usec = get_monotonic_usec();
+    set_fit_frame(Rect2i(window->get_position(), window->get_size()));
+
+    // Controls added under the root later are found from the tree, nothing is polled
+    SceneTree *scene_tree = content_root->get_tree();
+    scene_tree->connect("node_added", callable_mp(this, &Overlay::_on_fit_node_added));
+    scene_tree->connect("node_removed", callable_mp(this, &Overlay::_on_fit_node_removed));
+    std::vector<Node *> pending(1, content_root);
+    while (!pending.empty()) {
+        Node *node = pending.back();
+        pending.pop_back();
+        for (int i = 0; i < node->get_child_count(); i++) {
+            Node *child = node->get_child(i);
+            Control *control = Object::cast_to<Control>(child);
+            if (control) {
+                track_fit_control(control);
+            }
+            pending.push_back(child);
+        }
+    }
+    OVERLAY_LOG_VERBOSE("Auto-fit enabled with %d controls.\n", (int)fit_controls.size());
+    return true;
+}
+
+void Overlay::disable_auto_fit() {
+    if (fit_root_id == 0) {
+        return;
+    }
+    SceneTree *scene_tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (scene_tree) {
+        scene_tree->disconnect("node_added", callable_mp(this, &Overlay::_on_fit_node_added));
+        scene_tree->disconnect("node_removed", callable_mp(this, &Overlay::_on_fit_node_removed));
+    }
+    std::vector<uint64_t> control_ids(fit_controls.begin(), fit_controls.end());
+    for (uint64_t control_id : control_ids) {
+        Control *control = Object::cast_to<Control>(ObjectDB::get_instance(control_id));
+        if (control) {
+            untrack_fit_control(control);
+        }
+    }
+    fit_root_id = 0;
+    fit_controls.clear();
+    fit_dirty.clear();
+    fit_bounds.clear();
+
+    // Back to the whole frame with the canvas where it was
+    Window *window = get_target_window();
+    if (window) {
+        window->set_canvas_transform(Transform2D());
+        window->set_position(fit_frame.position);
+        window->set_size(fit_frame.size);
+    }
+    dirty_controls.assign(interactive_controls.begin(), interactive_controls.end());
+}
+
+bool Overlay::is_auto_fit_enabled() const {
+    return fit_root_id != 0;
+}
+
+Rect2i Overlay::get_auto_fit_rect() const {
+    if (fit_root_id == 0) {
+        return Rect2i();
+    }
+    const RegionRect &rect = window_fit.get_rect();
+    return Rect2i(fit_frame.position + Vector2i(rect.x, rect.y), Vector2i(rect.width, rect.height));
+}
+
+Dictionary Overlay::get_auto_fit_stats() const {
+    const WindowFit::Stats &fit_stats = window_fit.get_stats();
+    const RegionRect &rect = window_fit.get_rect();
+    uint64_t resizes = fit_stats.grows + fit_stats.shrinks;
+    double minutes = fit_root_id ? (get_monotonic_usec() - fit_start_usec) / 60000000.0 : 0.0;
+
+    // Area is the share of the frame not composited, now and averaged since enabling
+    Dictionary result;
+    result["enabled"] = fit_root_id != 0;
+    result["rect"] = get_auto_fit_rect();
+    result["frame"] = fit_frame;
+    result["controls"] = (int64_t)fit_controls.size();
+    result["content_rects"] = (int64_t)fit_bounds.get_rect_count();
+    result["area_saved"] = fit_root_id ? window_fit.get_area_saved() : 0.0;
+    result["mean_area_saved"] = fit_root_id ? window_fit.get_mean_area_saved() : 0.0;
+    result["pixels_saved"] = fit_root_id ? (int64_t)fit_frame.get_area() - (int64_t)rect.width * rect.height : (int64_t)0;
+    result["resizes"] = (int64_t)resizes;
+    result["grows"] = (int64_t)fit_stats.grows;
+    result["shrinks"] = (int64_t)fit_stats.shrinks;
+    result["shrinks_abandoned"] = (int64_t)fit_stats.shrinks_abandoned;
+    result["resizes_per_minute"] = minutes > 0.0 ? resizes / minutes : 0.0;
+    result["measures"] = (int64_t)stats.fit_measures.load(std::memory_order_relaxed);
+    result["bounds_recomputes"] = (int64_t)fit_bounds.get_recompute_count();
+    result["resize_usec"] = histogram_to_dictionary(stats.fit_resize_usec);
+    return result;
+}
+
+void Overlay::track_fit_control(Control *control) {
+    uint64_t control_id = control->get_instance_id();
+    if (!fit_controls.insert(control_id).second) {
+        return;
+    }
+
+    // Layout and visibility notify us, removal comes from the tree
+    Callable changed = callable_mp(this, &Overlay::_on_fit_control_changed).bind(control_id);
+    control->connect("item_rect_changed", changed);
+    control->connect("visibility_changed", changed);
+    fit_dirty.push_back(control_id);
+}
+
+void Overlay::untrack_fit_control(Control *control) {
+    uint64_t control_id = control->get_instance_id();
+    if (fit_controls.erase(control_id) == 0) {
+        return;
+    }
+    Callable changed = callable_mp(this, &Overlay::_on_fit_control_changed).bind(control_id);
+    control->disconnect("item_rect_changed", changed);
+    control->disconnect("visibility_changed", changed);
+    fit_bounds.remove(control_id);
+}
+
+void Overlay::_on_fit_node_added(Node *node) {
+    Control *control = Object::cast_to<Control>(node);
+    Node *content_root = Object::cast_to<Node>(ObjectDB::get_instance(fit_root_id));
+    if (control && content_root && content_root->is_ancestor_of(control)) {
+        track_fit_control(control);
+    }
+}
+
+void Overlay::_on_fit_node_removed(Node *node) {
+    if ((uint64_t)node->get_instance_id() == fit_root_id) {
+        OVERLAY_LOG_INFO("Auto-fit content root left the tree, auto-fit disabled.\n");
+        disable_auto_fit();
+        return;
+    }
+    Control *control = Object::cast_to<Control>(node);
+    if (control) {
+        untrack_fit_control(control);
+    }
+}
+
+void Overlay::_on_fit_control_changed(uint64_t control_id) {
+    fit_dirty.push_back(control_id);
+}
+
+void Overlay::refresh_fit_controls() {
+    Window *window = get_target_window();
+    if (!window) {
+        return;
+    }
+
+    // Descendants move and hide with a control without reporting it, so a changed control
+    // is measured with its whole subtree
+    Transform2D to_window = window->get_final_transform();
+    std::vector<Node *> pending;
+    fit_measured.clear();
+    for (uint64_t control_id : fit_dirty) {
+        Control *changed = Object::cast_to<Control>(ObjectDB::get_instance(control_id));
+        if (!changed || fit_controls.count(control_id) == 0 || fit_measured.count(control_id) != 0) {
+            continue;
+        }
+        pending.push_back(changed);
+        while (!pending.empty()) {
+            Node *node = pending.back();
+            pending.pop_back();
+            Control *control = Object::cast_to<Control>(node);
+            if (control) {
+                uint64_t id = control->get_instance_id();
+                if (fit_controls.count(id) == 0 || !fit_measured.insert(id).second) {
+                    continue;
+                }
+                stats.fit_measures.fetch_add(1, std::memory_order_relaxed);
+
+                // Layout containers draw nothing themselves, their children are the content
+                bool layout_only = Object::cast_to<Container>(control) && !Object::cast_to<PanelContainer>(control);
+                if (layout_only || !control->is_visible_in_tree()) {
+                    fit_bounds.remove(id);
+                } else {
+                    Rect2 rect = to_window.xform(control->get_global_transform().xform(Rect2(Vector2(), control->get_size())));
+                    int32_t left = static_cast<int32_t>(std::floor(rect.position.x));
+                    int32_t top = static_cast<int32_t>(std::floor(rect.position.y));
+                    int32_t right = static_cast<int32_t>(std::ceil(rect.position.x + rect.size.x));
+                    int32_t bottom = static_cast<int32_t>(std::ceil(rect.position.y + rect.size.y));
+                    fit_bounds.set_rect(id, { left, top, right - left, bottom - top });
+                }
+            }
+            for (int i = 0; i < node->get_child_count(); i++) {
+                pending.push_back(node->get_child(i));
+            }
+        }
+    }
+    fit_dirty.clear();
+}
+
+void Overlay::update_auto_fit(uint64_t now_usec) {
+    if (fit_root_id == 0) {
+        return;
+    }
+    if (!fit_dirty.empty()) {
+        refresh_fit_controls();
+    }
+
+    // Runs every frame, a waiting shrink is due by time alone
+    if (window_fit.update(fit_bounds.get_bounds(), now_usec)) {
+        apply_auto_fit();
+    }
+}
+
+void Overlay::apply_auto_fit() {
+    Window *window = get_target_window();
+    if (!window) {
+        return;
+    }
+    uint64_t start_usec = get_monotonic_usec();
+
+    const RegionRect &rect = window_fit.get_rect();
+    Vector2i position = fit_frame.position + Vector2i(rect.x, rect.y);
+    Vector2i size(rect.width, rect.height);
+    if (window->get_size() != size) {
+        window->set_size(size);
+    }
+    if (window->get_position() != position) {
+        window->set_position(position);
+    }
+
+    // Content keeps its place on screen: the canvas moves back by what the window moved
+    Vector2 offset = window->get_final_transform().affine_inverse().basis_xform(Vector2(rect.x, rect.y));
+    window->set_canvas_transform(Transform2D(0.0, -offset));
+
+    // Input regions are in window pixels, every one of them moved
+    dirty_controls.assign(interactive_controls.begin(), interactive_controls.end());
+    stats.fit_resize_usec.record(get_monotonic_usec() - start_usec);
+}
+
+void Overlay::set_fit_frame(const Rect2i &frame) {
+    fit_frame = frame;
+    window_fit.set_frame(frame.size.x, frame.size.y);
+
+    // Layout is that of the whole frame, whatever size the window has
+    Control *content_root = Object::cast_to<Control>(ObjectDB::get_instance(fit_root_id));
+    Window *window = get_target_window();
+    if (content_root && window) {
+        content_root->set_anchors_preset(Control::PRESET_TOP_LEFT);
+        content_root->set_position(Vector2());
+        content_root->set_size(window->get_final_transform().affine_inverse().basis_xform(Vector2(frame.size)));
+    }
+    apply_auto_fit();
+}
+
+void Overlay::apply_state(const Dictionary &state) {
+    // Unknown keys are ignored, missing keys keep their current value
+    OverlayState values;
+    uint32_t fields = 0;
+    if (state.has("borderless")) {
+        values.borderless = state["borderless"];
+        fields |= OVERLAY_STATE_BORDERLESS;
+    }
+    if (state.has("topmost")) {
+        values.topmost = state["topmost"];
+        fields |= OVERLAY_STATE_TOPMOST;
+    }
+    if (state.has("layered")) {
+        values.layered = state["layered"];
+        fields |= OVERLAY_STATE_LAYERED;
+    }
+    if (state.has("use_color_key") || state.has("color_key")) {
+        values.use_color_key = state.get("use_color_key", state_machine.get_desired().use_color_key);
+        values.color_key = state_machine.get_desired().color_key;
+        if (state.has("color_key")) {
+            Color color = state["color_key"];
+            values.color_key = color.to_argb32() & 0xFFFFFF;
+        }
+        fields |= OVERLAY_STATE_COLOR_KEY;
+    }
+    if (state.has("alpha")) {
+        double alpha = state["alpha"];
+        values.alpha = static_cast<uint8_t>(std::lround(CLAMP(alpha, 0.0, 1.0) * 255.0));
+        fields |= OVERLAY_STATE_ALPHA;
+    }
+    if (state.has("passthrough")) {
+        values.passthrough = state["passthrough"];
+        cursor_over_region = false;
+        fields |= OVERLAY_STATE_PASSTHROUGH;
+    }
+    if (state.has("visible")) {
+        values.visible = state["visible"];
+        fields |= OVERLAY_STATE_VISIBLE;
+    }
+    if (state.has("per_pixel_alpha")) {
+        values.per_pixel_alpha = state["per_pixel_alpha"];
+        fields |= OVERLAY_STATE_PER_PIXEL_ALPHA;
+    }
+
+    // An explicit alpha or hiding ends a running fade where it got to
+    if ((fields & OVERLAY_STATE_ALPHA) || ((fields & OVERLAY_STATE_VISIBLE) && !values.visible)) {
+        cancel_fade();
+    }
+    state_machine.merge(values, fields);
+
+    // Stored until the overlay is attached, applied with everything else this frame otherwise
+    if (backend && backend->is_attached()) {
+        request_commit();
+    }
+}
+
+Dictionary Overlay::get_state() const {
+    const OverlayState &desired = state_machine.get_desired();
+    Dictionary state;
+    state["borderless"] = desired.borderless;
+    state["topmost"] = desired.topmost;
+    state["layered"] = desired.layered;
+    state["use_color_key"] = desired.use_color_key;
+    state["color_key"] = Color::hex((desired.color_key << 8) | 0xFF);
+    state["alpha"] = desired.alpha / 255.0;
+    state["passthrough"] = desired.passthrough;
+    state["visible"] = desired.visible;
+    state["per_pixel_alpha"] = desired.per_pixel_alpha;
+    return state;
+}
+
+uint64_t Overlay::get_native_call_count() const {
+    return backend ? backend->get_native_call_count() : 0;
+}
+
+void Overlay::request_commit() {
+    // Every change made during a frame is applied together once the frame ends
+    if (commit_pending) {
+        return;
+    }
+    commit_pending = true;
+    callable_mp(this, &Overlay::commit_state).call_deferred();
+}
+
+void Overlay::commit_state() {
+    commit_pending = false;
+    if (!backend || !backend->is_attached()) {
+        return;
+    }
+
+    // Without native input shaping the window only captures input while the cursor is over a region
+    OverlayState target = state_machine.get_desired();
+    bool use_regions = target.passthrough && passthrough_mode == PASSTHROUGH_MODE_REGIONS;
+    if (use_regions && !input_region_native && cursor_over_region) {
+        target.passthrough = false;
+    }
+
+    // Mid-fade the window shows the animator's alpha, other changes must not reset it
+    if (fade_running) {
+        target.alpha = opacity_animator.get_alpha();
+    }
+
+    // Nothing to draw over while the followed window is missing, minimized or occluded
+    if (tracked_hidden) {
+        target.visible = false;
+    }
+
+    uint32_t changed = backend->apply_state(target);
+    uint32_t failed = diff_overlay_state(backend->get_applied_state(), target);
+
+    // A new layered style or key starts over with a fully converted frame
+    if (changed & (OVERLAY_STATE_LAYERED | OVERLAY_STATE_PER_PIXEL_ALPHA | OVERLAY_STATE_COLOR_KEY)) {
+        layered_tiles.invalidate();
+    }
+    if (failed) {
+        OVERLAY_LOG_WARNING("Some window state could not be applied (0x%x), retrying next change.\n", failed);
+    }
+
+    // Applying passthrough replaces the input shape, put the region back on top
+    if (use_regions && (changed & OVERLAY_STATE_PASSTHROUGH) && target.passthrough) {
+        refresh_dirty_controls();
+        input_region.update_region();
+        input_region_native = backend->set_input_region(input_region.get_region());
+        if (!input_region_native) {
+            update_input_region();
+        }
+    }
+
+    if (pending_toggle_usec != 0) {
+        stats.toggles.fetch_add(1, std::memory_order_relaxed);
+        stats.toggle_usec.record(get_monotonic_usec() - pending_toggle_usec);
+        pending_toggle_usec = 0;
+    }
+
+    // Only focus when the frame ended with input captured
+    if (state_machine.take_focus_request()) {
+        backend->focus_window();
+    }
+}
+
+void Overlay::refresh_dirty_controls() {
+    for (uint64_t control_id : dirty_controls) {
+        if (interactive_controls.count(control_id) == 0) {
+            continue; // Removed after it was marked
+        }
+        Control *control = Object::cast_to<Control>(ObjectDB::get_instance(control_id));
+        if (!control || !control->is_inside_tree() || !control->is_visible_in_tree()) {
+            input_region.remove(control_id);
+            continue;
+        }
+
+        // Viewport to window pixels, covers content scaling and stretch. A fitted window
+        // starts where the fit does, the canvas is shifted by as much.
+        Rect2 rect = control->get_viewport()->get_final_transform().xform(control->get_global_rect());
+        if (fit_root_id != 0) {
+            rect.position -= Vector2(window_fit.get_rect().x, window_fit.get_rect().y);
+        }
+        int32_t left = static_cast<int32_t>(std::floor(rect.position.x));
+        int32_t top = static_cast<int32_t>(std::floor(rect.position.y));
+        int32_t right = static_cast<int32_t>(std::ceil(rect.position.x + rect.size.x));
+        int32_t bottom = static_cast<int32_t>(std::ceil(rect.position.y + rect.size.y));
+        input_region.set_rect(control_id, { left, top, right - left, bottom - top });
+    }
+    dirty_controls.clear();
+}
+
+void Overlay::update_input_region() {
+    if (passthrough_mode != PASSTHROUGH_MODE_REGIONS || !state_machine.is_enabled() || !state_machine.is_passthrough() || !backend) {
+        return;
+    }
+
+    // Only controls that reported a change are re-inserted, and the OS region
+    // is only replaced when the coalesced union actually differs
+    if (!dirty_controls.empty()) {
+        refresh_dirty_controls();
+    }
+    if (input_region.update_region() && input_region_native) {
+        backend->set_input_region(input_region.get_region());
+    }
+
+    if (!input_region_native) {
+        // Backend cannot shape input: capture input only while the cursor is over a region
+        DisplayServer *display_server = DisplayServer::get_singleton();
+        Vector2i cursor = display_server->mouse_get_position() - display_server->window_get_position(window_id);
+        bool over_region = input_region.hit_test(cursor.x, cursor.y);
+        if (over_region != cursor_over_region) {
+            cursor_over_region = over_region;
+            frame_pacer.wake(get_monotonic_usec());
+            request_commit();
+        }
+    }
+}
+
+void Overlay::set_passthrough_mode(PassthroughMode mode) {
+    if (passthrough_mode == mode) {
+        return;
+    }
+    passthrough_mode = mode;
+    cursor_over_region = false;
+    input_region_native = false;
+
+    // Re-apply passthrough so the window switches between full and per-region right away
+    if (backend && backend->is_attached()) {
+        backend->invalidate_state(OVERLAY_STATE_PASSTHROUGH);
+        request_commit();
+    }
+}
+
+Overlay::PassthroughMode Overlay::get_passthrough_mode() const {
+    return passthrough_mode;
+}
+
+void Overlay::add_interactive_control(Control *control) {
+    if (!control) {
+        return;
+    }
+    uint64_t control_id = control->get_instance_id();
+    if (!interactive_controls.insert(control_id).second) {
+        return;
+    }
+
+    // Layout, visibility and removal notify us, nothing is polled per frame
+    Callable changed = callable_mp(this, &Overlay::_on_interactive_control_changed).bind(control_id);
+    control->connect("item_rect_changed", changed);
+    control->connect("visibility_changed", changed);
+    control->connect("tree_entered", changed);
+    control->connect("tree_exiting", callable_mp(this, &Overlay::_on_interactive_control_exiting).bind(control_id));
+    dirty_controls.push_back(control_id);
+}
+
+void Overlay::remove_interactive_control(Control *control) {
+    if (!control) {
+        return;
+    }
+    uint64_t control_id = control->get_instance_id();
+    if (interactive_controls.erase(control_id) == 0) {
+        return;
+    }
+    Callable changed = callable_mp(this, &Overlay::_on_interactive_control_changed).bind(control_id);
+    control->disconnect("item_rect_changed", changed);
+    control->disconnect("visibility_changed", changed);
+    control->disconnect("tree_entered", changed);
+    control->disconnect("tree_exiting", callable_mp(this, &Overlay::_on_interactive_control_exiting).bind(control_id));
+    input_region.remove(control_id);
+}
+
+void Overlay::clear_interactive_controls() {
+    std::vector<uint64_t> control_ids(interactive_controls.begin(), interactive_controls.end());
+    for (uint64_t control_id : control_ids) {
+        Control *control = Object::cast_to<Control>(ObjectDB::get_instance(control_id));
+        if (control) {
+            remove_interactive_control(control);
+        }
+    }
+    interactive_controls.clear();
+    input_region.clear();
+    dirty_controls.clear();
+}
+
+TypedArray<Rect2i> Overlay::get_input_region() const {
+    TypedArray<Rect2i> rects;
+    for (const RegionRect &rect : input_region.get_region()) {
+        rects.push_back(Rect2i(rect.x, rect.y, rect.width, rect.height));
+    }
+    return rects;
+}
+
+void Overlay::_on_interactive_control_changed(uint64_t control_id) {
+    dirty_controls.push_back(control_id);
+}
+
+void Overlay::_on_interactive_control_exiting(uint64_t control_id) {
+    // Still inside the tree at this point, drop the rectangle directly
+    input_region.remove(control_id);
+}
+
+Overlay::CaptureRegion *Overlay::find_capture_region(int id) {
+    for (CaptureRegion &region : capture_regions) {
+        if (region.id == id) {
+            return &region;
+        }
+    }
+    return nullptr;
+}
+
+int Overlay::add_capture_region(const Rect2i &rect) {
+    if (rect.size.x <= 0 || rect.size.y <= 0) {
+        OVERLAY_LOG_ERROR("Capture region must not be empty.\n");
+        flush_log();
+        return -1;
+    }
+
+    // The platform capture opens its own connection on first use
+    if (!screen_capture) {
+        screen_capture = ScreenCapture::create();
+        if (!screen_capture || !screen_capture->open()) {
+            screen_capture.reset();
+            OVERLAY_LOG_ERROR("Screen capture is not supported on this platform.\n");
+            flush_log();
+            return -1;
+        }
+    }
+
+    CaptureRegion region;
+    region.id = next_capture_id++;
+    region.rect = rect;
+    region.image = Image::create_empty(rect.size.x, rect.size.y, false, Image::FORMAT_RGBA8);
+    region.texture = ImageTexture::create_from_image(region.image);
+    capture_regions.push_back(std::move(region));
+    return capture_regions.back().id;
+}
+
+void Overlay::set_capture_region_rect(int id, const Rect2i &rect) {
+    CaptureRegion *region = find_capture_region(id);
+    if (!region || rect.size.x <= 0 || rect.size.y <= 0) {
+        return;
+    }
+
+    // Moving keeps the texture, resizing needs a texture of the new size
+    if (rect.size != region->rect.size) {
+        region->image = Image::create_empty(rect.size.x, rect.size.y, false, Image::FORMAT_RGBA8);
+        region->texture->set_image(region->image);
+    }
+    region->rect = rect;
+}
+
+void Overlay::remove_capture_region(int id) {
+    for (size_t i = 0; i < capture_regions.size(); i++) {
+        if (capture_regions[i].id == id) {
+            screen_capture->release(std::move(capture_regions[i].surface));
+            capture_regions.erase(capture_regions.begin() + i);
+            return;
+        }
+    }
+}
+
+void Overlay::clear_capture_regions() {
+    for (CaptureRegion &region : capture_regions) {
+        screen_capture->release(std::move(region.surface));
+    }
+    capture_regions.clear();
+}
+
+Ref<ImageTexture> Overlay::get_capture_texture(int id) const {
+    for (const CaptureRegion &region : capture_regions) {
+        if (region.id == id) {
+            return region.texture;
+        }
+    }
+    return Ref<ImageTexture>();
+}
+
+void Overlay::set_capture_rate(double fps) {
+    capture_rate = MAX(fps, 0.0);
+}
+
+double Overlay::get_capture_rate() const {
+    return capture_rate;
+}
+
+void Overlay::update_captures() {
+    if (capture_regions.empty() || capture_rate <= 0.0 || !state_machine.is_enabled() || !state_machine.is_visible()) {
+        return;
+    }
+    uint64_t now_usec = get_monotonic_usec();
+    if (last_capture_usec != 0 && now_usec - last_capture_usec < static_cast<uint64_t>(1000000.0 / capture_rate)) {
+        return;
+    }
+
+    // Regions follow the window, in the native screen coordinates the OS grabs from
+    int32_t origin_x = 0;
+    int32_t origin_y = 0;
+    if (!backend || !backend->get_client_origin(origin_x, origin_y)) {
+        return;
+    }
+    last_capture_usec = now_usec;
+    if (stats.capture_start_usec == 0) {
+        stats.capture_start_usec = now_usec;
+    }
+
+    for (CaptureRegion &region : capture_regions) {
+        uint64_t start_usec = get_monotonic_usec();
+        RegionRect screen_rect = { origin_x + region.rect.position.x, origin_y + region.rect.position.y, region.rect.size.x, region.rect.size.y };
+        CaptureFrame frame;
+        if (!screen_capture->capture(screen_rect, region.surface, frame)) {
+            continue; // Off screen or refused, the texture keeps the last grab
+        }
+        uint64_t grabbed_usec = get_monotonic_usec();
+        stats.capture_grab_usec.record(grabbed_usec - start_usec);
+
+        // One pass from the OS surface into the image the texture is updated from,
+        // clipped grabs land at their offset inside the region
+        size_t row_bytes = static_cast<size_t>(region.rect.size.x) * 4;
+        uint8_t *pixels = region.image->ptrw();
+        uint8_t *destination = pixels + (frame.y - screen_rect.y) * row_bytes + (frame.x - screen_rect.x) * 4;
+        convert_bgrx_to_rgba(frame.pixels, frame.stride, destination, row_bytes, frame.width, frame.height);
+        region.texture->update(region.image);
+
+        stats.capture_upload_usec.record(get_monotonic_usec() - grabbed_usec);
+        stats.capture_frames.fetch_add(1, std::memory_order_relaxed);
+        stats.capture_bytes.fetch_add(static_cast<uint64_t>(frame.width) * frame.height * 4, std::memory_order_relaxed);
+    }
+}
+
+void Overlay::present_layered() {
+    if (!backend || !backend->supports_layered_present() || !state_machine.is_enabled()) {
+        return;
+    }
+    Window *window = get_target_window();
+    if (!window) {
+        return;
+    }
+
+    // The viewport texture holds the last drawn frame, reading it back waits for the GPU
+    uint64_t start_usec = get_monotonic_usec();
+    Ref<Image> image = window->get_texture()->get_image();
+    if (image.is_null() || image->is_empty()) {
+        return;
+    }
+    if (image->get_format() != Image::FORMAT_RGBA8) {
+        image->convert(Image::FORMAT_RGBA8);
+    }
+    int32_t width = image->get_width();
+    int32_t height = image->get_height();
+    uint64_t readback_usec = get_monotonic_usec();
+    stats.layered_readback_usec.record(readback_usec - start_usec);
+
+    size_t stride = 0;
+    uint8_t *buffer = backend->get_layered_buffer(width, height, stride);
+    if (!buffer) {
+        return;
+    }
+    if (width != layered_tiles.get_width() || height != layered_tiles.get_height()) {
+        layered_tiles.reset(width, height);
+    }
+
+    // Unchanged tiles are already in the buffer from an earlier frame
+    const uint8_t *pixels = image->ptr();
+    size_t row_bytes = static_cast<size_t>(width) * 4;
+    layered_tiles.diff(pixels, row_bytes, layered_rects);
+    if (layered_rects.empty()) {
+        stats.layered_frames_unchanged.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const OverlayState &desired = state_machine.get_desired();
+    RegionRect bounds = layered_rects[0];
+    uint64_t converted = 0;
+    for (const RegionRect &rect : layered_rects) {
+        size_t offset = rect.y * row_bytes + static_cast<size_t>(rect.x) * 4;
+        size_t buffer_offset = rect.y * stride + static_cast<size_t>(rect.x) * 4;
+        if (desired.use_color_key) {
+            convert_rgba_keyed_to_bgra(pixels + offset, row_bytes, buffer + buffer_offset, stride, rect.width, rect.height, desired.color_key);
+        } else {
+            convert_rgba_to_premultiplied_bgra(pixels + offset, row_bytes, buffer + buffer_offset, stride, rect.width, rect.height);
+        }
+        converted += static_cast<uint64_t>(rect.width) * rect.height;
+
+        int32_t right = MAX(bounds.x + bounds.width, rect.x + rect.width);
+        int32_t bottom = MAX(bounds.y + bounds.height, rect.y + rect.height);
+        bounds.x = MIN(bounds.x, rect.x);
+        bounds.y = MIN(bounds.y, rect.y);
+        bounds.width = right - bounds.x;
+        bounds.height = bottom - bounds.y;
+    }
+    uint64_t converted_usec = get_monotonic_usec();
+    stats.layered_convert_usec.record(converted_usec - readback_usec);
+
+    // One dirty rectangle per present, the bounds of every changed tile
+    if (!backend->present_layered(bounds)) {
+        layered_tiles.invalidate();
+        return;
+    }
+    stats.layered_present_usec.record(get_monotonic_usec() - converted_usec);
+    stats.layered_frames.fetch_add(1, std::memory_order_relaxed);
+    stats.layered_pixels.fetch_add(converted, std::memory_order_relaxed);
+}
+
+Dictionary Overlay::get_capture_stats() const {
+    uint64_t frames = stats.capture_frames.load(std::memory_order_relaxed);
+    uint64_t bytes = stats.capture_bytes.load(std::memory_order_relaxed);
+    double seconds = stats.capture_start_usec ? (get_monotonic_usec() - stats.capture_start_usec) / 1000000.0 : 0.0;
+
+    Dictionary result;
+    result["backend"] = screen_capture ? String(screen_capture->get_name()) : String();
+    result["zero_copy"] = screen_capture && screen_capture->is_zero_copy();
+    result["regions"] = (int64_t)capture_regions.size();
+    result["frames"] = (int64_t)frames;
+    result["bytes"] = (int64_t)bytes;
+    result["frames_per_sec"] = seconds > 0.0 ? frames / seconds : 0.0;
+    result["mb_per_sec"] = seconds > 0.0 ? bytes / seconds / 1000000.0 : 0.0;
+    result["grab_usec"] = histogram_to_dictionary(stats.capture_grab_usec);
+    result["upload_usec"] = histogram_to_dictionary(stats.capture_upload_usec);
+    result["pool_hits"] = (int64_t)(screen_capture ? screen_capture->get_pool().get_hits() : 0);
+    result["pool_misses"] = (int64_t)(screen_capture ? screen_capture->get_pool().get_misses() : 0);
+    return result;
+}
+
+bool Overlay::open_telemetry(const String &name, int snapshot_values, int ring_records, int record_size) {
+    close_telemetry();
+    if (snapshot_values < 0 || ring_records <= 0 || (ring_records & (ring_records - 1)) != 0 || record_size <= 0 || (record_size & 7) != 0) {
+        OVERLAY_LOG_ERROR("Telemetry ring_records must be a power of two and record_size a multiple of 8.\n");
+        flush_log();
+        return false;
+    }
+    telemetry_name = name.utf8();
+    telemetry_snapshot_values = static_cast<uint32_t>(snapshot_values);
+    telemetry_ring_records = static_cast<uint32_t>(ring_records);
+    telemetry_record_size = static_cast<uint32_t>(record_size);
+    telemetry_snapshot.resize(0);
+    telemetry_records_drained = 0;
+    telemetry_retry_usec = get_monotonic_usec();
+    bool opened = try_open_telemetry();
+    flush_log();
+    return opened || telemetry_retry_usec != 0;
+}
+
+bool Overlay::try_open_telemetry() {
+    int result = telemetry.open(telemetry_name.get_data(), telemetry_snapshot_values, telemetry_ring_records, telemetry_record_size);
+    if (result == 0) {
+        telemetry_retry_usec = 0;
+        OVERLAY_LOG_INFO("Telemetry channel %s %s.\n", telemetry_name.get_data(), telemetry.is_creator() ? "created" : "opened");
+        return true;
+    }
+    if (result == -2) {
+        OVERLAY_LOG_VERBOSE("Telemetry channel %s is still being created, retrying.\n", telemetry_name.get_data());
+        return false;
+    }
+    telemetry_retry_usec = 0;
+    OVERLAY_LOG_ERROR("Failed to open telemetry channel %s, check the name and that both sides use the same sizes.\n",
+            telemetry_name.get_data());
+    return false;
+}
+
+void Overlay::close_telemetry() {
+    telemetry.close();
+    telemetry_retry_usec = 0;
+}
+
+bool Overlay::is_telemetry_open() const {
+    return telemetry.is_open();
+}
+
+PackedFloat64Array Overlay::get_telemetry_snapshot() {
+    // The last consistent snapshot is kept when the producer is mid-write: a failed read
+    // leaves the values untouched and the array goes back to the previous count
+    if (telemetry.is_open()) {
+        int64_t previous = telemetry_snapshot.size();
+        if (previous < (int64_t)telemetry.get_snapshot_capacity()) {
+            telemetry_snapshot.resize(telemetry.get_snapshot_capacity());
+        }
+        uint32_t count = static_cast<uint32_t>(previous);
+        telemetry.read_snapshot(telemetry_snapshot.ptrw(), count);
+        if (count != telemetry_snapshot.size()) {
+            telemetry_snapshot.resize(count);
+        }
+    }
+    return telemetry_snapshot;
+}
+
+PackedByteArray Overlay::drain_telemetry(int max_records) {
+    // Records are concatenated, record_size bytes each, e.g. decode with to_float64_array()
+    size_t pending = telemetry.get_pending_count();
+    if (max_records >= 0 && pending > (size_t)max_records) {
+        pending = max_records;
+    }
+    telemetry_records.resize(pending * telemetry.get_record_size());
+    if (pending > 0) {
+        size_t drained = telemetry.drain(telemetry_records.ptrw(), pending);
+        telemetry_records_drained += drained;
+    }
+    return telemetry_records;
+}
+
+Dictionary Overlay::get_telemetry_stats() const {
+    Dictionary result;
+    result["open"] = telemetry.is_open();
+    result["creator"] = telemetry.is_open() && telemetry.is_creator();
+    result["snapshot_sequence"] = (int64_t)telemetry.get_snapshot_sequence();
+    result["snapshot_retries"] = (int64_t)telemetry.get_snapshot_retries();
+    result["records_pending"] = (int64_t)telemetry.get_pending_count();
+    result["records_drained"] = (int64_t)telemetry_records_drained;
+    result["records_dropped"] = (int64_t)telemetry.get_dropped_count();
+    return result;
+}
+
+// Keybind methods
+void Overlay::set_input_keybind(const Ref<InputEvent> &event) {
+    input_keybind = event;
+    compile_keybinds();
+    OVERLAY_LOG_VERBOSE("Input keybind set.\n");
+}
+
+Ref<InputEvent> Overlay::get_input_keybind() const {
+    return input_keybind;
+}
+
+void Overlay::set_visibility_keybind(const Ref<InputEvent> &event) {
+    visibility_keybind = event;
+    compile_keybinds();
+    OVERLAY_LOG_VERBOSE("Visibility keybind set.\n");
+}
+
+Ref<InputEvent> Overlay::get_visibility_keybind() const {
+    return visibility_keybind;
+}
 
-Overlay::Overlay() {
-    printf("Overlay constructor called.\n");
+void Overlay::add_keybind(const StringName &action, const Ref<InputEvent> &event) {
+    Ref<InputEventKey> key_event = event;
+    if (key_event.is_null()) {
+        OVERLAY_LOG_WARNING("Keybind must be an InputEventKey.\n");
+        return;
+    }
 
-#ifdef _WIN32
-    // Set the static instance pointer
-    instance = this;
+    // Rebinding an existing action replaces its event
+    for (RegisteredKeybind &keybind : keybinds) {
+        if (keybind.action == action) {
+            keybind.event = key_event;
+            compile_keybinds();
+            return;
+        }
+    }
 
-    // Set up a low-level keyboard hook
-    keyboard_hook = SetWindowsHookEx(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(nullptr), 0);
-    if (!keyboard_hook) {
-        printf("Failed to set up keyboard hook.\n");
-    } else {
-        printf("Keyboard hook set up successfully.\n");
+    if (keybinds.size() >= KeybindTable::NO_ACTION - ACTION_CUSTOM_BASE) {
+        OVERLAY_LOG_WARNING("Too many keybinds registered.\n");
+        return;
     }
-#endif
+    keybinds.push_back({ action, key_event });
+    compile_keybinds();
 }
 
-Overlay::~Overlay() {
-#ifdef _WIN32
-    // Unhook the keyboard hook
-    if (keyboard_hook) {
-        UnhookWindowsHookEx(keyboard_hook);
-        keyboard_hook = nullptr;
-        printf("Keyboard hook unset.\n");
+void Overlay::remove_keybind(const StringName &action) {
+    for (size_t i = 0; i < keybinds.size(); i++) {
+        if (keybinds[i].action == action) {
+            keybinds.erase(keybinds.begin() + i);
+            compile_keybinds();
+            return;
+        }
     }
+}
 
-    // Clear the static instance pointer
-    instance = nullptr;
-#endif
-
-    printf("Overlay destructor called.\n");
+void Overlay::clear_keybinds() {
+    keybinds.clear();
+    compile_keybinds();
 }
 
-#ifdef _WIN32
-LRESULT CALLBACK Overlay::LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
-    if (nCode >= 0) {
-        KBDLLHOOKSTRUCT* pKeyInfo = (KBDLLHOOKSTRUCT*)lParam;
+void Overlay::add_mouse_binding(const StringName &action, const Ref<InputEvent> &event) {
+    Ref<InputEventMouseButton> mouse_event = event;
+    if (mouse_event.is_null()) {
+        OVERLAY_LOG_WARNING("Mouse binding must be an InputEventMouseButton.\n");
+        return;
+    }
 
-        // Use the static instance pointer to access the Overlay instance
-        if (instance) {
-            instance->handle_keybind(wParam, pKeyInfo);
-        }
+    MouseBinding binding;
+    binding.action = action;
+    binding.event = mouse_event;
+    switch (mouse_event->get_button_index()) {
+        case MOUSE_BUTTON_LEFT:
+            binding.button = MouseAccumulator::BUTTON_LEFT;
+            break;
+        case MOUSE_BUTTON_RIGHT:
+            binding.button = MouseAccumulator::BUTTON_RIGHT;
+            break;
+        case MOUSE_BUTTON_MIDDLE:
+            binding.button = MouseAccumulator::BUTTON_MIDDLE;
+            break;
+        case MOUSE_BUTTON_XBUTTON1:
+            binding.button = MouseAccumulator::BUTTON_X1;
+            break;
+        case MOUSE_BUTTON_XBUTTON2:
+            binding.button = MouseAccumulator::BUTTON_X2;
+            break;
+        case MOUSE_BUTTON_WHEEL_UP:
+            binding.button = MouseAccumulator::BUTTON_WHEEL_UP;
+            break;
+        case MOUSE_BUTTON_WHEEL_DOWN:
+            binding.button = MouseAccumulator::BUTTON_WHEEL_DOWN;
+            break;
+        case MOUSE_BUTTON_WHEEL_LEFT:
+            binding.button = MouseAccumulator::BUTTON_WHEEL_LEFT;
+            break;
+        case MOUSE_BUTTON_WHEEL_RIGHT:
+            binding.button = MouseAccumulator::BUTTON_WHEEL_RIGHT;
+            break;
+        default:
+            OVERLAY_LOG_WARNING("Mouse button %d cannot be bound globally.\n", (int)mouse_event->get_button_index());
+            return;
+    }
+    if (mouse_event->is_ctrl_pressed()) {
+        binding.modifiers |= MODIFIER_CTRL;
+    }
+    if (mouse_event->is_shift_pressed()) {
+        binding.modifiers |= MODIFIER_SHIFT;
+    }
+    if (mouse_event->is_alt_pressed()) {
+        binding.modifiers |= MODIFIER_ALT;
+    }
+    if (mouse_event->is_meta_pressed()) {
+        binding.modifiers |= MODIFIER_META;
+    }
+    if (action == StringName("overlay_toggle_input")) {
+        binding.builtin = ACTION_TOGGLE_INPUT;
+    } else if (action == StringName("overlay_toggle_visibility")) {
+        binding.builtin = ACTION_TOGGLE_VISIBILITY;
+    } else if (action == StringName("overlay_opacity_up")) {
+        binding.builtin = ACTION_OPACITY_UP;
+    } else if (action == StringName("overlay_opacity_down")) {
+        binding.builtin = ACTION_OPACITY_DOWN;
     }
 
-    // Pass the event to the next hook in the chain
-    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+    // Rebinding an existing action replaces its event
+    for (MouseBinding &existing : mouse_bindings) {
+        if (existing.action == action) {
+            existing = binding;
+            return;
+        }
+    }
+    mouse_bindings.push_back(binding);
+    update_mouse_subscription();
 }
 
-void Overlay::handle_keybind(WPARAM wParam, KBDLLHOOKSTRUCT* pKeyInfo) {
-    // Check if the Godot window is focused
-    if (is_godot_window_focused() || !is_overlay_enabled) {
-        printf("Godot window is focused or overlay disabled, ignoring input.\n");
-        return; // Ignore input if the Godot window is focused
+void Overlay::remove_mouse_binding(const StringName &action) {
+    for (size_t i = 0; i < mouse_bindings.size(); i++) {
+        if (mouse_bindings[i].action == action) {
+            mouse_bindings.erase(mouse_bindings.begin() + i);
+            update_mouse_subscription();
+            return;
+        }
     }
+}
+
+void Overlay::clear_mouse_bindings() {
+    mouse_bindings.clear();
+    update_mouse_subscription();
+}
 
-    if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
-        // Get the current state of modifier keys
-        bool ctrl_pressed = (GetAsyncKeyState(VK_CONTROL) & 0x8000);
-        bool shift_pressed = (GetAsyncKeyState(VK_SHIFT) & 0x8000);
-        bool alt_pressed = (GetAsyncKeyState(VK_MENU) & 0x8000);
+PackedStringArray Overlay::get_mouse_binding_actions() const {
+    PackedStringArray actions;
+    for (const MouseBinding &binding : mouse_bindings) {
+        actions.push_back(binding.action);
+    }
+    return actions;
+}
 
-        printf("Key pressed: %d, Ctrl: %d, Shift: %d, Alt: %d\n",
-               pKeyInfo->vkCode, ctrl_pressed, shift_pressed, alt_pressed);
+void Overlay::update_mouse_subscription() {
+    // Input before the first binding is not reported, the totals are taken as they are
+    bool wanted = !mouse_bindings.empty();
+    if (wanted && !mouse_acquired) {
+        hook_dispatcher->acquire_mouse();
+        mouse_reader.sync(hook_dispatcher->get_mouse());
+    } else if (!wanted && mouse_acquired) {
+        hook_dispatcher->release_mouse();
+    }
+    mouse_acquired = wanted;
+}
 
-        // Check if the pressed key matches the input keybind
-        if (input_keybind.is_valid()) {
-            int godot_keycode = input_keybind->get_keycode();
-            int os_keycode = godot_to_os_keycode(godot_keycode);
+void Overlay::handle_mouse_frame() {
+    stats.mouse_frames.fetch_add(1, std::memory_order_relaxed);
+    stats.mouse_records.fetch_add(mouse_frame.events, std::memory_order_relaxed);
+    if (!state_machine.is_enabled()) {
+        return;
+    }
 
-            bool key_match = (pKeyInfo->vkCode == os_keycode);
-            bool ctrl_match = (ctrl_pressed == input_keybind->is_ctrl_pressed());
-            bool shift_match = (shift_pressed == input_keybind->is_shift_pressed());
-            bool alt_match = (alt_pressed == input_keybind->is_alt_pressed());
+    // Indexed, a signal handler may change the bindings
+    for (size_t i = 0; i < mouse_bindings.size(); i++) {
+        const MouseBinding binding = mouse_bindings[i];
+        bool wheel = MouseAccumulator::is_wheel(binding.button);
+        double amount = wheel ? mouse_frame.get_notches(binding.button, binding.modifiers)
+                              : mouse_frame.get_presses(binding.button, binding.modifiers);
+        if (amount <= 0.0) {
+            continue;
+        }
+        stats.mouse_matched.fetch_add(1, std::memory_order_relaxed);
 
-            printf("Input keybind: Godot Key: %d, OS Key: %d, Ctrl: %d, Shift: %d, Alt: %d\n",
-                   godot_keycode, os_keycode,
-                   input_keybind->is_ctrl_pressed(),
-                   input_keybind->is_shift_pressed(),
-                   input_keybind->is_alt_pressed());
+        // Same rule as keys: opacity steps always apply, the rest is Godot's while it is focused
+        bool is_opacity_step = binding.builtin == ACTION_OPACITY_UP || binding.builtin == ACTION_OPACITY_DOWN;
+        if (!is_opacity_step) {
+            frame_pacer.wake(mouse_frame.last_usec);
+            if (is_godot_window_focused()) {
+                continue;
+            }
+        }
 
-            if (key_match && ctrl_match && shift_match && alt_match) {
-                printf("Input keybind pressed globally.\n");
-                if (is_input_passthrough_enabled) {
-                    disable_input_passthrough();
-                } else {
-                    enable_input_passthrough();
-                }
-            } else {
-                printf("Input keybind mismatch.\n");
+        if (binding.builtin <= ACTION_TOGGLE_VISIBILITY && pending_toggle_usec == 0) {
+            pending_toggle_usec = mouse_frame.last_usec;
+        }
+        if (is_opacity_step && wheel) {
+            // Notches of a frame make one fade, the size of all of them
+            step_opacity((binding.builtin == ACTION_OPACITY_UP ? opacity_step : -opacity_step) * amount);
+            emit_signal("keybind_scrolled", binding.action, amount);
+        } else if (binding.builtin != KeybindTable::NO_ACTION) {
+            // Toggles flip once a frame for the wheel, once per press for buttons
+            int count = wheel ? 1 : static_cast<int>(amount);
+            for (int press = 0; press < count; press++) {
+                trigger_keybind_action(binding.builtin);
+            }
+        } else if (wheel) {
+            emit_signal("keybind_scrolled", binding.action, amount);
+        } else {
+            for (int press = 0; press < static_cast<int>(amount); press++) {
+                emit_signal("keybind_pressed", binding.action);
             }
         }
+    }
+}
 
-        // Check if the pressed key matches the visibility keybind
-        if (visibility_keybind.is_valid()) {
-            int godot_keycode = visibility_keybind->get_keycode();
-            int os_keycode = godot_to_os_keycode(godot_keycode);
+void Overlay::set_use_physical_keycodes(bool enabled) {
+    use_physical_keycodes = enabled;
+    compile_keybinds();
+    compile_gestures();
+}
 
-            bool key_match = (pKeyInfo->vkCode == os_keycode);
-            bool ctrl_match = (ctrl_pressed == visibility_keybind->is_ctrl_pressed());
-            bool shift_match = (shift_pressed == visibility_keybind->is_shift_pressed());
-            bool alt_match = (alt_pressed == visibility_keybind->is_alt_pressed());
+bool Overlay::get_use_physical_keycodes() const {
+    return use_physical_keycodes;
+}
 
-            printf("Visibility keybind: Godot Key: %d, OS Key: %d, Ctrl: %d, Shift: %d, Alt: %d\n",
-                   godot_keycode, os_keycode,
-                   visibility_keybind->is_ctrl_pressed(),
-                   visibility_keybind->is_shift_pressed(),
-                   visibility_keybind->is_alt_pressed());
+PackedStringArray Overlay::get_keybind_actions() const {
+    PackedStringArray actions;
+    for (const RegisteredKeybind &keybind : keybinds) {
+        actions.push_back(keybind.action);
+    }
+    return actions;
+}
 
-            if (key_match && ctrl_match && shift_match && alt_match) {
-                printf("Visibility keybind pressed globally.\n");
-                if (is_visibility_enabled) {
-                    disable_visibility();
-                } else {
-                    enable_visibility();
-                }
-            } else {
-                printf("Visibility keybind mismatch.\n");
-            }
+void Overlay::add_gesture(const StringName &action, GestureRecognizer::Kind kind, const std::vector<Ref<InputEventKey>> &events, double duration) {
+    if (events.empty()) {
+        OVERLAY_LOG_WARNING("Gesture needs at least one key.\n");
+        return;
+    }
+
+    // Registering an existing action replaces its gesture
+    for (RegisteredGesture &gesture : gestures) {
+        if (gesture.action == action) {
+            gesture.kind = kind;
+            gesture.events = events;
+            gesture.duration = duration;
+            compile_gestures();
+            return;
         }
     }
+
+    if (gestures.size() >= KeybindTable::NO_ACTION - GESTURE_CUSTOM_BASE) {
+        OVERLAY_LOG_WARNING("Too many gestures registered.\n");
+        return;
+    }
+    gestures.push_back({ action, kind, events, duration });
+    compile_gestures();
 }
 
-// Define the static unordered_map
-std::unordered_map<int, int> Overlay::keycode_map = {
-    {KEY_ESCAPE, 0x1B},
-    {KEY_TAB, 0x09},
-    {KEY_ENTER, 0x0D},
-    {KEY_BACKSPACE, 0x08},
-    {KEY_SPACE, 0x20},
-    {KEY_F1, 0x70},
-    {KEY_F2, 0x71},
-    {KEY_F3, 0x72},
-    {KEY_F4, 0x73},
-    {KEY_F5, 0x74},
-    {KEY_F6, 0x75},
-    {KEY_F7, 0x76},
-    {KEY_F8, 0x77},
-    {KEY_F9, 0x78},
-    {KEY_F10, 0x79},
-    {KEY_F11, 0x7A},
-    {KEY_F12, 0x7B},
-    {KEY_A, 0x41},
-    {KEY_B, 0x42},
-    {KEY_C, 0x43},
-    {KEY_D, 0x44},
-    {KEY_E, 0x45},
-    {KEY_F, 0x46},
-    {KEY_G, 0x47},
-    {KEY_H, 0x48},
-    {KEY_I, 0x49},
-    {KEY_J, 0x4A},
-    {KEY_K, 0x4B},
-    {KEY_L, 0x4C},
-    {KEY_M, 0x4D},
-    {KEY_N, 0x4E},
-    {KEY_O, 0x4F},
-    {KEY_P, 0x50},
-    {KEY_Q, 0x51},
-    {KEY_R, 0x52},
-    {KEY_S, 0x53},
-    {KEY_T, 0x54},
-    {KEY_U, 0x55},
-    {KEY_V, 0x56},
-    {KEY_W, 0x57},
-    {KEY_X, 0x58},
-    {KEY_Y, 0x59},
-    {KEY_Z, 0x5A},
-    {KEY_0, 0x30},
-    {KEY_1, 0x31},
-    {KEY_2, 0x32},
-    {KEY_3, 0x33},
-    {KEY_4, 0x34},
-    {KEY_5, 0x35},
-    {KEY_6, 0x36},
-    {KEY_7, 0x37},
-    {KEY_8, 0x38},
-    {KEY_9, 0x39},
-    // Add more mappings as needed
-};
+void Overlay::add_hold_gesture(const StringName &action, const Ref<InputEvent> &event, double hold_time) {
+    Ref<InputEventKey> key_event = event;
+    if (key_event.is_null()) {
+        OVERLAY_LOG_WARNING("Gesture key must be an InputEventKey.\n");
+        return;
+    }
+    add_gesture(action, GestureRecognizer::KIND_HOLD, { key_event }, hold_time);
+}
 
-// Define the static function to convert Godot keycode to OS keycode
-int Overlay::godot_to_os_keycode(int godot_keycode) {
-    auto it = keycode_map.find(godot_keycode);
-    if (it != keycode_map.end()) {
-        return it->second; // Return the mapped OS keycode
+void Overlay::add_double_tap_gesture(const StringName &action, const Ref<InputEvent> &event, double interval) {
+    Ref<InputEventKey> key_event = event;
+    if (key_event.is_null()) {
+        OVERLAY_LOG_WARNING("Gesture key must be an InputEventKey.\n");
+        return;
     }
-    return godot_keycode; // Fallback to the same keycode if not found
+    add_gesture(action, GestureRecognizer::KIND_DOUBLE_TAP, { key_event }, interval);
 }
 
-bool Overlay::is_godot_window_focused() {
-    if (!hwnd) {
-        return false; // No window handle, assume not focused
+void Overlay::add_sequence_gesture(const StringName &action, const TypedArray<InputEvent> &events, double step_timeout) {
+    std::vector<Ref<InputEventKey>> key_events;
+    for (int i = 0; i < events.size(); i++) {
+        Ref<InputEventKey> key_event = events[i];
+        if (key_event.is_null()) {
+            OVERLAY_LOG_WARNING("Gesture keys must be InputEventKeys.\n");
+            return;
+        }
+        key_events.push_back(key_event);
     }
+    add_gesture(action, GestureRecognizer::KIND_SEQUENCE, key_events, step_timeout);
+}
 
-    HWND focused_window = GetForegroundWindow();
-    return (focused_window == hwnd);
+void Overlay::remove_gesture(const StringName &action) {
+    for (size_t i = 0; i < gestures.size(); i++) {
+        if (gestures[i].action == action) {
+            gestures.erase(gestures.begin() + i);
+            compile_gestures();
+            return;
+        }
+    }
 }
-#endif
 
-void Overlay::enable_overlay_with_title(const String &title) {
-    window_title = title; // Set the window title
-    enable_overlay(); // Call the original method
+void Overlay::clear_gestures() {
+    gestures.clear();
+    compile_gestures();
 }
 
-void Overlay::enable_overlay() {
-    SceneTree *scene_tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
-    if (scene_tree) {
-        Window *window = scene_tree->get_root();
-        if (window) {
-            printf("Godot window is valid.\n");
+PackedStringArray Overlay::get_gesture_actions() const {
+    PackedStringArray actions;
+    for (const RegisteredGesture &gesture : gestures) {
+        actions.push_back(gesture.action);
+    }
+    return actions;
+}
 
-#ifdef _WIN32
-            // Try to get the window ID
-            int64_t window_id = window->get_window_id();
-            printf("Window ID: %lld\n", window_id);
-
-            // Cast the window ID to HWND
-            hwnd = reinterpret_cast<HWND>(static_cast<intptr_t>(window_id));
-            if (!hwnd) {
-                printf("Failed to cast window ID to HWND. Trying FindWindow...\n");
-
-                // Convert Godot String to C-style string
-                CharString title_utf8 = window_title.utf8();
-                const char *title_cstr = title_utf8.get_data();
-
-                // Use FindWindowA to get the HWND
-                hwnd = FindWindowA(nullptr, title_cstr);
-                if (!hwnd) {
-                    printf("Failed to find window using FindWindow. Trying GetActiveWindow...\n");
-
-                    // Fallback: Use GetActiveWindow to get the HWND
-                    hwnd = GetActiveWindow();
-                    if (hwnd) {
-                        printf("Window handle (hwnd) found using GetActiveWindow: %p\n", hwnd);
-                    } else {
-                        printf("Failed to find window using GetActiveWindow. Error: %lu\n", GetLastError());
-                        return; // Exit if hwnd is still invalid
-                    }
-                } else {
-                    printf("Window handle (hwnd) found using FindWindow: %p\n", hwnd);
-                }
-            } else {
-                printf("Window handle (hwnd): %p\n", hwnd);
-            }
+void Overlay::set_peek_keybind(const Ref<InputEvent> &event, double hold_time) {
+    peek_keybind = event;
+    peek_hold_time = hold_time;
+    compile_gestures();
+    OVERLAY_LOG_VERBOSE("Peek keybind set.\n");
+}
 
-            // Remove title bar and borders
-            LONG style = GetWindowLong(hwnd, GWL_STYLE);
-            if (SetWindowLong(hwnd, GWL_STYLE, style & ~(WS_CAPTION | WS_THICKFRAME | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU))) {
-                printf("Window style updated successfully.\n");
-            } else {
-                printf("Failed to update window style. Error: %lu\n", GetLastError());
-            }
+Ref<InputEvent> Overlay::get_peek_keybind() const {
+    return peek_keybind;
+}
 
-            // Make the window always on top
-            if (SetWindowPos(hwnd, HWND_TOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE)) {
-                printf("Window set to always on top.\n");
-            } else {
-                printf("Failed to set window always on top. Error: %lu\n", GetLastError());
-            }
+// Process method to check for keybind
+void Overlay::process(double delta) {
+    // Taken first, a record stamped after it is left for the next frame's timeouts
+    uint64_t now_usec = get_monotonic_usec();
 
-            // Enable transparency
-            if (SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) | WS_EX_LAYERED)) {
-                printf("Transparency enabled.\n");
-            } else {
-                printf("Failed to enable transparency. Error: %lu\n", GetLastError());
-            }
+    // Apply global key records collected by the hook thread since the last frame
+    bool has_gestures = gesture_recognizer.get_gesture_count() > 0;
+    bool recording = key_recorder.is_open();
+    key_events.drain([this, has_gestures, recording](const KeyEvent &event) {
+        if (recording) {
+            key_recorder.append(event);
+        }
+        handle_keybind(event);
+        if (has_gestures) {
+            gesture_recognizer.process(event, gesture_results);
+        }
+    });
 
-            // Set the background color to pure black (RGB 0, 0, 0)
-            hBrush = CreateSolidBrush(RGB(0, 0, 0));
-            if (hBrush) {
-                SetClassLongPtr(hwnd, GCLP_HBRBACKGROUND, (LONG_PTR)hBrush);
-                printf("Background brush created and set.\n");
-            } else {
-                printf("Failed to create background brush. Error: %lu\n", GetLastError());
-            }
+    // Gesture timeouts come from the timer wheel, no key is polled
+    if (gesture_recognizer.get_pending_timer_count() > 0) {
+        gesture_recognizer.advance(now_usec, gesture_results);
+    }
+    emit_gestures();
 
-            // Make the black color transparent
-            if (SetLayeredWindowAttributes(hwnd, RGB(0, 0, 0), 0, LWA_COLORKEY)) {
-                printf("Background color set to transparent.\n");
-            } else {
-                printf("Failed to set background transparency. Error: %lu\n", GetLastError());
-            }
+    // Mouse input arrives as one coalesced record a frame, however fast the mouse reports
+    if (mouse_acquired && mouse_reader.take(hook_dispatcher->get_mouse(), mouse_frame)) {
+        handle_mouse_frame();
+    }
 
-            // Make the window ignore input
-            if (SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) | WS_EX_TRANSPARENT)) {
-                is_input_passthrough_enabled = true;
-                printf("Input passthrough enabled.\n");
-            } else {
-                printf("Failed to enable input passthrough. Error: %lu\n", GetLastError());
-            }
+    // A fade ended on the animator's thread, the alpha it left becomes window state
+    if (fade_running && opacity_animator.get_finished_serial() != fade_serial) {
+        end_fade(opacity_animator.get_alpha() == fade_target);
+    }
 
-            is_overlay_enabled = true;
-#endif
+    // The tracker thread bumps its serial when the followed window changes
+    if (window_tracker && window_tracker->get_serial() != window_tracker_serial) {
+        window_tracker_serial = window_tracker->get_serial();
+        update_tracked_window();
+    }
+
+    // The input thread bumps the serial on every foreground change, nothing is queried here
+    uint64_t serial = hook_dispatcher->get_foreground_serial();
+    if (serial != foreground_serial) {
+        foreground_serial = serial;
+        frame_pacer.wake(get_monotonic_usec());
+        emit_signal("focus_changed", is_godot_window_focused(), get_foreground_app());
+    }
+
+    // While the Godot window is focused the hook leaves toggles to the InputMap
+    if (input_keybind.is_valid() && Input::get_singleton()->is_action_just_pressed("overlay_toggle_input")) {
+        OVERLAY_LOG_VERBOSE("Input keybind pressed.\n");
+        if (pending_toggle_usec == 0) {
+            pending_toggle_usec = get_monotonic_usec();
+        }
+        if (state_machine.is_passthrough()) {
+            disable_input_passthrough();
         } else {
-            printf("Failed to retrieve Godot window.\n");
+            enable_input_passthrough();
         }
-    } else {
-        printf("Failed to retrieve SceneTree.\n");
     }
+    if (visibility_keybind.is_valid() && Input::get_singleton()->is_action_just_pressed("overlay_toggle_visibility")) {
+        OVERLAY_LOG_VERBOSE("Visibility keybind pressed.\n");
+        if (pending_toggle_usec == 0) {
+            pending_toggle_usec = get_monotonic_usec();
+        }
+        if (state_machine.is_visible()) {
+            disable_visibility();
+        } else {
+            enable_visibility();
+        }
+    }
+
+    // Shrink-wrap the window before input regions are taken from it
+    update_auto_fit(now_usec);
+
+    // Keep the per-region passthrough in sync with changed controls
+    update_input_region();
+
+    // Grab what is beneath the overlay for backdrop effects
+    update_captures();
+
+    // Push the rendered alpha where the OS cannot take it from the swap chain
+    present_layered();
+
+    // A telemetry producer that was still creating its segment, checked once a second
+    if (telemetry_retry_usec != 0 && get_monotonic_usec() - telemetry_retry_usec >= 1000000) {
+        telemetry_retry_usec = get_monotonic_usec();
+        try_open_telemetry();
+    }
+
+    // Render rate for the next frame
+    update_frame_pacing();
+
+    // Print whatever was logged since the last frame
+    flush_log();
 }
 
-void Overlay::disable_overlay() {
-#ifdef _WIN32
-        if (hwnd) {
-            // Remove the always-on-top flag
-            if (SetWindowPos(hwnd, HWND_NOTOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE)) {
-                printf("Window no longer always on top.\n");
-            } else {
-                printf("Failed to remove always-on-top flag. Error: %lu\n", GetLastError());
-            }
-    
-            // Restore the original window style
-            LONG original_style = GetWindowLong(hwnd, GWL_STYLE);
-            if (SetWindowLong(hwnd, GWL_STYLE, original_style | WS_OVERLAPPEDWINDOW)) {
-                printf("Window style restored.\n");
-            } else {
-                printf("Failed to restore window style. Error: %lu\n", GetLastError());
-            }
-    
-            // Disable transparency
-            if (SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) & ~WS_EX_LAYERED)) {
-                printf("Transparency disabled.\n");
-            } else {
-                printf("Failed to disable transparency. Error: %lu\n", GetLastError());
-            }
-    
-            // Restore input handling
-            if (SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) & ~WS_EX_TRANSPARENT)) {
-                printf("Input passthrough disabled.\n");
-            } else {
-                printf("Failed to disable input passthrough. Error: %lu\n", GetLastError());
-            }
+void Overlay::update_frame_pacing() {
+    uint64_t now_usec = get_monotonic_usec();
+    DisplayServer *display_server = DisplayServer::get_singleton();
+    int screen = backend && backend->is_attached() ? display_server->window_get_current_screen(window_id) : DisplayServer::SCREEN_OF_MAIN_WINDOW;
+    double refresh_rate = display_server->screen_get_refresh_rate(screen);
+    frame_pacer.record_frame(now_usec, Engine::get_singleton()->get_frames_drawn(), refresh_rate);
 
-             // Delete the brush to avoid memory leaks
-            if (hBrush) {
-                DeleteObject(hBrush);
-                hBrush = nullptr;
-                printf("Background brush deleted.\n");
-            }
+    // Passthrough only idles in full mode, a region under the cursor takes input
+    bool passive = state_machine.is_passthrough() && !cursor_over_region;
+    bool visible = state_machine.is_visible() && !tracked_hidden;
+    if (frame_pacer.update(now_usec, state_machine.is_enabled(), visible, passive)) {
+        apply_engine_pacing();
+        OVERLAY_LOG_VERBOSE("Frame pacing: %s.\n", FramePacer::get_mode_name(frame_pacer.get_mode()));
+        emit_signal("pacing_mode_changed", get_pacing_mode());
+    }
+}
 
-    
-            // Redraw the window to apply changes
-            SetWindowPos(hwnd, nullptr, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
-    
-            is_overlay_enabled = false;
+void Overlay::apply_engine_pacing() {
+    OS *os = OS::get_singleton();
+    RenderingServer *rendering_server = RenderingServer::get_singleton();
+
+    // The engine renders for every window, so it only slows down as far as the busiest overlay allows
+    FramePacer::Mode mode = live_overlays.empty() ? FramePacer::MODE_FULL : FramePacer::MODE_SUSPENDED;
+    for (const Overlay *overlay : live_overlays) {
+        mode = MIN(mode, overlay->frame_pacer.get_mode());
+    }
+
+    if (mode == FramePacer::MODE_FULL) {
+        if (pacing_settings_saved) {
+            rendering_server->set_render_loop_enabled(true);
+            os->set_low_processor_usage_mode(saved_low_processor_mode);
+            os->set_low_processor_usage_mode_sleep_usec(saved_low_processor_sleep_usec);
+            pacing_settings_saved = false;
         }
-#endif
-}
+        return;
+    }
 
-void Overlay::enable_input_passthrough() {
-#ifdef _WIN32
-    if (hwnd) {
-        if (is_overlay_enabled) {
-            // Make the window transparent to input
-            if (SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) | WS_EX_TRANSPARENT)) {
-                printf("Input passthrough enabled.\n");
-                is_input_passthrough_enabled = true;
-            } else {
-                printf("Failed to enable input passthrough. Error: %lu\n", GetLastError());
-            }
+    if (!pacing_settings_saved) {
+        saved_low_processor_mode = os->is_in_low_processor_usage_mode();
+        saved_low_processor_sleep_usec = os->get_low_processor_usage_mode_sleep_usec();
+        pacing_settings_saved = true;
+    }
+
+    // Low processor mode only redraws on content changes and sleeps between iterations,
+    // the sleep also bounds how late a hotkey is noticed
+    int rate = 1;
+    for (const Overlay *overlay : live_overlays) {
+        if (overlay->frame_pacer.get_mode() == mode) {
+            rate = MAX(rate, mode == FramePacer::MODE_SUSPENDED ? overlay->suspended_poll_rate : overlay->idle_frame_rate);
         }
-    } else {
-        printf("Window handle (hwnd) is invalid. Cannot enable passthrough.\n");
     }
-#endif
+    os->set_low_processor_usage_mode(true);
+    os->set_low_processor_usage_mode_sleep_usec(1000000 / rate);
+    rendering_server->set_render_loop_enabled(mode != FramePacer::MODE_SUSPENDED);
 }
 
-void Overlay::disable_input_passthrough() {
-#ifdef _WIN32
-    if (hwnd) {
-        if (is_overlay_enabled) {
-            // Remove the input transparency
-            if (SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) & ~WS_EX_TRANSPARENT)) {
-                printf("Input passthrough disabled.\n");
-                is_input_passthrough_enabled = false;
-                // Focus the window
-                if (SetForegroundWindow(hwnd)) {
-                    printf("Window focused.\n");
-                } else {
-                    printf("Failed to focus window. Error: %lu\n", GetLastError());
-                }
-            } else {
-                printf("Failed to disable input passthrough. Error: %lu\n", GetLastError());
-            }
-        }
-    } else {
-        printf("Window handle (hwnd) is invalid. Cannot disable passthrough.\n");
+void Overlay::set_frame_pacing_enabled(bool enabled) {
+    frame_pacer.set_enabled(enabled);
+    update_frame_pacing();
+}
+
+bool Overlay::get_frame_pacing_enabled() const {
+    return frame_pacer.is_enabled();
+}
+
+void Overlay::set_idle_frame_rate(int fps) {
+    idle_frame_rate = MAX(fps, 1);
+    if (frame_pacer.get_mode() == FramePacer::MODE_IDLE) {
+        apply_engine_pacing();
     }
-#endif
 }
 
-void Overlay::enable_visibility() {
-#ifdef _WIN32
-    if (hwnd) {
-        if (is_overlay_enabled) {
-            // Make the window fully opaque
-            (SetLayeredWindowAttributes(hwnd, RGB(0, 0, 0), 0, LWA_COLORKEY));
-            is_visibility_enabled = true;
-            printf("Window shown.\n");
-        }
-    } else {
-        printf("Window handle (hwnd) is invalid. Cannot enable visibility.\n");
+int Overlay::get_idle_frame_rate() const {
+    return idle_frame_rate;
+}
+
+void Overlay::set_suspended_poll_rate(int rate) {
+    suspended_poll_rate = MAX(rate, 1);
+    if (frame_pacer.get_mode() == FramePacer::MODE_SUSPENDED) {
+        apply_engine_pacing();
     }
-#endif
 }
 
-void Overlay::disable_visibility() {
-#ifdef _WIN32
-    if (hwnd) {
-        if (is_overlay_enabled) {
-            // Make the window fully transparent
-            SetLayeredWindowAttributes(hwnd, 0, 0, LWA_ALPHA);
-            is_visibility_enabled = false;
-            printf("Window hidden.\n");
+int Overlay::get_suspended_poll_rate() const {
+    return suspended_poll_rate;
+}
+
+void Overlay::set_wake_duration(double seconds) {
+    frame_pacer.set_wake_duration_usec(static_cast<uint64_t>(MAX(seconds, 0.0) * 1000000.0));
+}
+
+double Overlay::get_wake_duration() const {
+    return frame_pacer.get_wake_duration_usec() / 1000000.0;
+}
+
+void Overlay::wake_frame_pacing() {
+    frame_pacer.wake(get_monotonic_usec());
+    update_frame_pacing();
+}
+
+Overlay::PacingMode Overlay::get_pacing_mode() const {
+    return static_cast<PacingMode>(frame_pacer.get_mode());
+}
+
+Dictionary Overlay::get_pacing_stats() const {
+    const FramePacer::Stats &stats = frame_pacer.get_stats();
+    Dictionary result;
+    result["mode"] = get_pacing_mode();
+    result["frames_drawn"] = (int64_t)stats.frames_drawn;
+    result["frames_skipped"] = (int64_t)stats.frames_skipped;
+    result["wakeups"] = (int64_t)stats.wakeups;
+    result["mode_changes"] = (int64_t)stats.mode_changes;
+    result["full_usec"] = (int64_t)stats.mode_usec[FramePacer::MODE_FULL];
+    result["idle_usec"] = (int64_t)stats.mode_usec[FramePacer::MODE_IDLE];
+    result["suspended_usec"] = (int64_t)stats.mode_usec[FramePacer::MODE_SUSPENDED];
+    return result;
+}
+
+void Overlay::reset_pacing_stats() {
+    frame_pacer.reset_stats();
+}
+
+Variant Overlay::get_monitor_value(int monitor) {
+    // Counters add up over all overlays, latencies report the worst one
+    int64_t value = 0;
+    for (const Overlay *overlay : live_overlays) {
+        const OverlayStats &stats = overlay->stats;
+        const OverlayBackend *backend = overlay->backend.get();
+        switch (monitor) {
+            case MONITOR_HOOK_INVOCATIONS:
+                return (int64_t)overlay->hook_dispatcher->get_stats().hook_invocations.load(std::memory_order_relaxed);
+            case MONITOR_HOOK_TIME_P99:
+                return (int64_t)overlay->hook_dispatcher->get_stats().hook_nsec.get_percentile(99.0);
+            case MONITOR_KEYS_MATCHED:
+                value += stats.keys_matched.load(std::memory_order_relaxed);
+                break;
+            case MONITOR_KEYS_UNMATCHED:
+                value += stats.keys_unmatched.load(std::memory_order_relaxed);
+                break;
+            case MONITOR_TOGGLE_LATENCY_P99:
+                value = MAX(value, (int64_t)stats.toggle_usec.get_percentile(99.0));
+                break;
+            case MONITOR_NATIVE_CALLS:
+                value += backend ? backend->get_native_call_count() : 0;
+                break;
+            case MONITOR_NATIVE_FAILURES:
+                value += backend ? backend->get_native_failure_count() : 0;
+                break;
+            case MONITOR_ENABLE_TIME:
+                value = MAX(value, (int64_t)stats.enable_usec.get_last());
+                break;
+            case MONITOR_EVENTS_DROPPED:
+                value += overlay->key_events.get_dropped_count();
+                break;
+            case MONITOR_FRAMES_SKIPPED:
+                value = MAX(value, (int64_t)overlay->frame_pacer.get_stats().frames_skipped);
+                break;
+            default:
+                break;
         }
-    } else {
-        printf("Window handle (hwnd) is invalid. Cannot disable visibility.\n");
     }
-#endif
+    return value;
 }
 
-// Keybind methods
-void Overlay::set_input_keybind(const Ref<InputEvent> &event) {
-    input_keybind = event;
-    printf("Input keybind set.\n");
+Dictionary Overlay::get_stats() const {
+    const HookStats &hook_stats = hook_dispatcher->get_stats();
+    Dictionary result;
+    result["hook_invocations"] = (int64_t)hook_stats.hook_invocations.load(std::memory_order_relaxed);
+    result["hook_nsec"] = histogram_to_dictionary(hook_stats.hook_nsec);
+    result["hook_subscribers"] = hook_dispatcher->get_subscriber_count();
+    result["foreground_changes"] = (int64_t)hook_stats.foreground_changes.load(std::memory_order_relaxed);
+    result["keys_matched"] = (int64_t)stats.keys_matched.load(std::memory_order_relaxed);
+    result["keys_unmatched"] = (int64_t)stats.keys_unmatched.load(std::memory_order_relaxed);
+    result["events_dropped"] = (int64_t)key_events.get_dropped_count();
+    result["toggles"] = (int64_t)stats.toggles.load(std::memory_order_relaxed);
+    result["toggle_usec"] = histogram_to_dictionary(stats.toggle_usec);
+    result["attach_usec"] = histogram_to_dictionary(stats.attach_usec);
+    result["enable_usec"] = histogram_to_dictionary(stats.enable_usec);
+    result["disable_usec"] = histogram_to_dictionary(stats.disable_usec);
+
+    // Records per frame shows how much the hook coalesced
+    Dictionary mouse;
+    mouse["hooked"] = hook_dispatcher->is_mouse_hooked();
+    mouse["hook_invocations"] = (int64_t)hook_stats.mouse_invocations.load(std::memory_order_relaxed);
+    mouse["hook_nsec"] = histogram_to_dictionary(hook_stats.mouse_nsec);
+    mouse["frames"] = (int64_t)stats.mouse_frames.load(std::memory_order_relaxed);
+    mouse["records"] = (int64_t)stats.mouse_records.load(std::memory_order_relaxed);
+    mouse["matched"] = (int64_t)stats.mouse_matched.load(std::memory_order_relaxed);
+    result["mouse"] = mouse;
+    result["gestures_recognized"] = (int64_t)stats.gestures_recognized.load(std::memory_order_relaxed);
+    result["gesture_usec"] = histogram_to_dictionary(stats.gesture_usec);
+
+    // With the renderer idle or suspended frames_drawn stays 0, a fade draws nothing itself
+    const OpacityAnimator::Stats &fade_stats = opacity_animator.get_stats();
+    Dictionary fade;
+    fade["fades"] = (int64_t)stats.fades.load(std::memory_order_relaxed);
+    fade["frames_drawn"] = (int64_t)stats.fade_frames_drawn.load(std::memory_order_relaxed);
+    fade["steps"] = (int64_t)fade_stats.steps.load(std::memory_order_relaxed);
+    fade["step_failures"] = (int64_t)fade_stats.step_failures.load(std::memory_order_relaxed);
+    fade["interrupted"] = (int64_t)fade_stats.fades_interrupted.load(std::memory_order_relaxed);
+    fade["fade_usec"] = histogram_to_dictionary(stats.fade_usec);
+    fade["step_lag_usec"] = histogram_to_dictionary(fade_stats.step_lag_usec);
+    result["fade"] = fade;
+
+    Dictionary target;
+    target["attached"] = window_tracker != nullptr;
+    target["updates"] = (int64_t)stats.target_updates.load(std::memory_order_relaxed);
+    target["moves"] = (int64_t)stats.target_moves.load(std::memory_order_relaxed);
+    target["move_usec"] = histogram_to_dictionary(stats.target_move_usec);
+    if (window_tracker) {
+        const WindowTracker::Stats &tracker_stats = window_tracker->get_stats();
+        target["events"] = (int64_t)tracker_stats.events.load(std::memory_order_relaxed);
+        target["searches"] = (int64_t)tracker_stats.searches.load(std::memory_order_relaxed);
+        target["changes"] = (int64_t)tracker_stats.changes.load(std::memory_order_relaxed);
+    }
+    result["target"] = target;
+    result["auto_fit"] = get_auto_fit_stats();
+    result["native_calls"] = (int64_t)(backend ? backend->get_native_call_count() : 0);
+    result["native_failures"] = (int64_t)(backend ? backend->get_native_failure_count() : 0);
+    result["log_dropped"] = (int64_t)OverlayLog::get_dropped_count();
+    result["pacing"] = get_pacing_stats();
+    result["capture"] = get_capture_stats();
+    result["telemetry"] = get_telemetry_stats();
+
+    Dictionary layered;
+    layered["frames"] = (int64_t)stats.layered_frames.load(std::memory_order_relaxed);
+    layered["frames_unchanged"] = (int64_t)stats.layered_frames_unchanged.load(std::memory_order_relaxed);
+    layered["pixels"] = (int64_t)stats.layered_pixels.load(std::memory_order_relaxed);
+    layered["readback_usec"] = histogram_to_dictionary(stats.layered_readback_usec);
+    layered["convert_usec"] = histogram_to_dictionary(stats.layered_convert_usec);
+    layered["present_usec"] = histogram_to_dictionary(stats.layered_present_usec);
+    layered["pixel_isa"] = String(get_pixel_isa_name(get_pixel_isa()));
+    result["layered"] = layered;
+    return result;
 }
 
-Ref<InputEvent> Overlay::get_input_keybind() const {
-    return input_keybind;
+bool Overlay::start_key_recording(const String &path) {
+    stop_key_recording();
+
+    // Accept res:// and user:// paths as well as OS paths
+    CharString path_utf8 = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+#ifdef _WIN32
+    KeyRecordingPlatform platform = KEY_RECORDING_WINDOWS;
+#else
+    KeyRecordingPlatform platform = KEY_RECORDING_X11;
+#endif
+    if (!key_recorder.open(path_utf8.get_data(), platform)) {
+        OVERLAY_LOG_ERROR("Failed to open key recording: %s\n", path_utf8.get_data());
+        return false;
+    }
+    key_recording_dropped = key_events.get_dropped_count();
+    OVERLAY_LOG_INFO("Recording global keys to %s.\n", path_utf8.get_data());
+    return true;
 }
 
-void Overlay::set_visibility_keybind(const Ref<InputEvent> &event) {
-    visibility_keybind = event;
-    printf("Visibility keybind set.\n");
+void Overlay::stop_key_recording() {
+    if (key_recorder.is_open()) {
+        uint64_t records = key_recorder.get_record_count();
+        key_recorder.close(key_events.get_dropped_count() - key_recording_dropped);
+        OVERLAY_LOG_INFO("Key recording stopped after %llu records.\n", (unsigned long long)records);
+    }
 }
 
-Ref<InputEvent> Overlay::get_visibility_keybind() const {
-    return visibility_keybind;
+bool Overlay::is_key_recording() const {
+    return key_recorder.is_open();
 }
 
-// Process method to check for keybind
-void Overlay::process(double delta) {
-    if (input_keybind.is_valid() && Input::get_singleton()->is_action_just_pressed("overlay_toggle_input")) {
-        printf("Input keybind pressed.\n");
-        if (is_input_passthrough_enabled) {
-            disable_input_passthrough();
-        } else {
-            enable_input_passthrough();
-        }
+Dictionary Overlay::replay_key_recording(const String &path, bool at_recorded_speed) {
+    Dictionary result;
+    CharString path_utf8 = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+    KeyRecordingInfo info;
+    std::vector<KeyEvent> events;
+    if (!read_key_recording(path_utf8.get_data(), info, events)) {
+        OVERLAY_LOG_ERROR("Failed to read key recording: %s\n", path_utf8.get_data());
+        return result;
     }
-    if (visibility_keybind.is_valid() && Input::get_singleton()->is_action_just_pressed("overlay_toggle_visibility")) {
-        printf("Visibility keybind pressed.\n");
-        if (is_visibility_enabled) {
-            disable_visibility();
-        } else {
-            enable_visibility();
-        }
+
+    // This overlay's compiled bindings, with the recording's modifier keys
+    std::unique_ptr<KeyReplayer> replayer(new KeyReplayer());
+    replayer->get_keybind_table() = keybind_table;
+    replayer->get_gesture_recognizer() = gesture_recognizer;
+    replayer->set_platform(info.platform);
+    replayer->set_use_scancodes(use_physical_keycodes);
+    KeyReplayer::Report report = replayer->run(events, at_recorded_speed ? KeyReplayer::PACING_RECORDED : KeyReplayer::PACING_FAST);
+
+    result["events"] = (int64_t)report.events;
+    result["matched"] = (int64_t)report.matched;
+    result["toggles"] = (int64_t)report.toggles;
+    result["gestures"] = (int64_t)report.gestures;
+    result["recorded_dropped"] = (int64_t)info.dropped;
+    result["replay_dropped"] = (int64_t)report.dropped;
+    result["wall_usec"] = (int64_t)report.wall_usec;
+    result["latency_p50_nsec"] = (int64_t)report.latency_p50_nsec;
+    result["latency_p90_nsec"] = (int64_t)report.latency_p90_nsec;
+    result["latency_p99_nsec"] = (int64_t)report.latency_p99_nsec;
+    result["latency_p999_nsec"] = (int64_t)report.latency_p999_nsec;
+    result["latency_max_nsec"] = (int64_t)report.latency_max_nsec;
+    if (at_recorded_speed) {
+        result["lag_p99_usec"] = (int64_t)report.lag_p99_usec;
+        result["lag_max_usec"] = (int64_t)report.lag_max_usec;
+    }
+    return result;
+}
+
+Dictionary Overlay::get_startup_timeline() {
+    return OverlayBootstrap::get_timeline_dictionary();
+}
+
+void Overlay::reset_stats() {
+    // Hook counters are shared by all overlays and reset for all of them
+    stats.reset();
+    hook_dispatcher->reset_stats();
+    frame_pacer.reset_stats();
+    opacity_animator.reset_stats();
+    window_fit.reset_stats();
+    fit_start_usec = get_monotonic_usec();
+}
+
+void Overlay::set_log_level(LogLevel level) {
+    OverlayLog::set_level(level);
+}
+
+Overlay::LogLevel Overlay::get_log_level() const {
+    return static_cast<LogLevel>(OverlayLog::get_level());
+}
+
+bool Overlay::set_log_file(const String &path) {
+    // Accept res:// and user:// paths as well as OS paths
+    String os_path = path.is_empty() ? path : ProjectSettings::get_singleton()->globalize_path(path);
+    CharString path_utf8 = os_path.utf8();
+    if (!OverlayLog::set_file(path_utf8.get_data())) {
+        OVERLAY_LOG_ERROR("Failed to open log file: %s\n", path_utf8.get_data());
+        flush_log();
+        return false;
     }
+    return true;
 }
 
 // Implement the getter methods
 bool Overlay::get_is_overlay_enabled() const {
-    return is_overlay_enabled;
+    return state_machine.is_enabled();
 }
 
 bool Overlay::get_is_input_passthrough_enabled() const {
-    return is_input_passthrough_enabled;
+    return state_machine.is_passthrough();
 }
 
 bool Overlay::get_is_visibility_enabled() const {
-    return is_visibility_enabled;
+    return state_machine.is_visible();
 }
 
 // Getter methods for the properties
 void Overlay::_bind_methods() {
-    printf("Binding methods for Overlay class.\n");
+    OVERLAY_LOG_VERBOSE("Binding methods for Overlay class.\n");
 
     // Bind methods
     ClassDB::bind_method(D_METHOD("enable_overlay"), &Overlay::enable_overlay);
@@ -499,23 +2634,181 @@ void Overlay::_bind_methods() {
     ClassDB::bind_method(D_METHOD("enable_input_passthrough"), &Overlay::enable_input_passthrough);
     ClassDB::bind_method(D_METHOD("disable_input_passthrough"), &Overlay::disable_input_passthrough);
 
+    // Bind window methods
+    ClassDB::bind_method(D_METHOD("set_window", "window"), &Overlay::set_window);
+    ClassDB::bind_method(D_METHOD("get_window"), &Overlay::get_window);
+    ClassDB::bind_method(D_METHOD("create_window", "rect"), &Overlay::create_window);
+    ClassDB::bind_static_method("Overlay", D_METHOD("create_for_screen", "screen"), &Overlay::create_for_screen);
+
+    // Bind per-region passthrough methods
+    ClassDB::bind_method(D_METHOD("set_passthrough_mode", "mode"), &Overlay::set_passthrough_mode);
+    ClassDB::bind_method(D_METHOD("get_passthrough_mode"), &Overlay::get_passthrough_mode);
+    ClassDB::bind_method(D_METHOD("add_interactive_control", "control"), &Overlay::add_interactive_control);
+    ClassDB::bind_method(D_METHOD("remove_interactive_control", "control"), &Overlay::remove_interactive_control);
+    ClassDB::bind_method(D_METHOD("clear_interactive_controls"), &Overlay::clear_interactive_controls);
+    ClassDB::bind_method(D_METHOD("get_input_region"), &Overlay::get_input_region);
+
+    BIND_ENUM_CONSTANT(PASSTHROUGH_MODE_FULL);
+    BIND_ENUM_CONSTANT(PASSTHROUGH_MODE_REGIONS);
+
     // Bind keybind methods
     ClassDB::bind_method(D_METHOD("set_input_keybind", "event"), &Overlay::set_input_keybind);
     ClassDB::bind_method(D_METHOD("get_input_keybind"), &Overlay::get_input_keybind);
     ClassDB::bind_method(D_METHOD("set_visibility_keybind", "event"), &Overlay::set_visibility_keybind);
     ClassDB::bind_method(D_METHOD("get_visibility_keybind"), &Overlay::get_visibility_keybind);
+    ClassDB::bind_method(D_METHOD("add_keybind", "action", "event"), &Overlay::add_keybind);
+    ClassDB::bind_method(D_METHOD("add_mouse_binding", "action", "event"), &Overlay::add_mouse_binding);
+    ClassDB::bind_method(D_METHOD("remove_mouse_binding", "action"), &Overlay::remove_mouse_binding);
+    ClassDB::bind_method(D_METHOD("clear_mouse_bindings"), &Overlay::clear_mouse_bindings);
+    ClassDB::bind_method(D_METHOD("get_mouse_binding_actions"), &Overlay::get_mouse_binding_actions);
+    ClassDB::bind_method(D_METHOD("remove_keybind", "action"), &Overlay::remove_keybind);
+    ClassDB::bind_method(D_METHOD("clear_keybinds"), &Overlay::clear_keybinds);
+    ClassDB::bind_method(D_METHOD("get_keybind_actions"), &Overlay::get_keybind_actions);
+    ClassDB::bind_method(D_METHOD("add_hold_gesture", "action", "event", "hold_time"), &Overlay::add_hold_gesture, DEFVAL(0.3));
+    ClassDB::bind_method(D_METHOD("add_double_tap_gesture", "action", "event", "interval"), &Overlay::add_double_tap_gesture, DEFVAL(0.3));
+    ClassDB::bind_method(D_METHOD("add_sequence_gesture", "action", "events", "step_timeout"), &Overlay::add_sequence_gesture, DEFVAL(1.0));
+    ClassDB::bind_method(D_METHOD("remove_gesture", "action"), &Overlay::remove_gesture);
+    ClassDB::bind_method(D_METHOD("clear_gestures"), &Overlay::clear_gestures);
+    ClassDB::bind_method(D_METHOD("get_gesture_actions"), &Overlay::get_gesture_actions);
+    ClassDB::bind_method(D_METHOD("set_peek_keybind", "event", "hold_time"), &Overlay::set_peek_keybind, DEFVAL(0.2));
+    ClassDB::bind_method(D_METHOD("get_peek_keybind"), &Overlay::get_peek_keybind);
+    ClassDB::bind_method(D_METHOD("set_use_physical_keycodes", "enabled"), &Overlay::set_use_physical_keycodes);
+    ClassDB::bind_method(D_METHOD("get_use_physical_keycodes"), &Overlay::get_use_physical_keycodes);
 
     // Bind visibility methods
     ClassDB::bind_method(D_METHOD("enable_visibility"), &Overlay::enable_visibility);
     ClassDB::bind_method(D_METHOD("disable_visibility"), &Overlay::disable_visibility);
 
+    // Bind opacity methods
+    ClassDB::bind_method(D_METHOD("set_opacity", "opacity"), &Overlay::set_opacity);
+    ClassDB::bind_method(D_METHOD("get_opacity"), &Overlay::get_opacity);
+    ClassDB::bind_method(D_METHOD("fade_to", "opacity", "duration", "curve"), &Overlay::fade_to, DEFVAL(FADE_CURVE_EASE_IN_OUT));
+    ClassDB::bind_method(D_METHOD("cancel_fade"), &Overlay::cancel_fade);
+    ClassDB::bind_method(D_METHOD("is_fading"), &Overlay::is_fading);
+    ClassDB::bind_method(D_METHOD("set_fade_step_rate", "steps_per_second"), &Overlay::set_fade_step_rate);
+    ClassDB::bind_method(D_METHOD("get_fade_step_rate"), &Overlay::get_fade_step_rate);
+    ClassDB::bind_method(D_METHOD("set_opacity_step_keybinds", "increase", "decrease", "step", "fade_time"), &Overlay::set_opacity_step_keybinds, DEFVAL(0.1), DEFVAL(0.1));
+    ClassDB::bind_method(D_METHOD("get_opacity_increase_keybind"), &Overlay::get_opacity_increase_keybind);
+    ClassDB::bind_method(D_METHOD("get_opacity_decrease_keybind"), &Overlay::get_opacity_decrease_keybind);
+
+    BIND_ENUM_CONSTANT(FADE_CURVE_LINEAR);
+    BIND_ENUM_CONSTANT(FADE_CURVE_EASE_IN);
+    BIND_ENUM_CONSTANT(FADE_CURVE_EASE_OUT);
+    BIND_ENUM_CONSTANT(FADE_CURVE_EASE_IN_OUT);
+
+    // Bind window following methods
+    ClassDB::bind_method(D_METHOD("attach_to_window", "process_name", "title", "window_class"), &Overlay::attach_to_window, DEFVAL(""), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("detach_from_window"), &Overlay::detach_from_window);
+    ClassDB::bind_method(D_METHOD("is_attached_to_window"), &Overlay::is_attached_to_window);
+    ClassDB::bind_method(D_METHOD("get_attached_window_state"), &Overlay::get_attached_window_state);
+
+    // Bind auto-fit methods
+    ClassDB::bind_method(D_METHOD("enable_auto_fit", "content_root", "margin", "snap", "shrink_delay"), &Overlay::enable_auto_fit, DEFVAL(16), DEFVAL(32), DEFVAL(0.5));
+    ClassDB::bind_method(D_METHOD("disable_auto_fit"), &Overlay::disable_auto_fit);
+    ClassDB::bind_method(D_METHOD("is_auto_fit_enabled"), &Overlay::is_auto_fit_enabled);
+    ClassDB::bind_method(D_METHOD("get_auto_fit_rect"), &Overlay::get_auto_fit_rect);
+    ClassDB::bind_method(D_METHOD("get_auto_fit_stats"), &Overlay::get_auto_fit_stats);
+
+    // Bind bulk window state methods
+    ClassDB::bind_method(D_METHOD("apply_state", "state"), &Overlay::apply_state);
+    ClassDB::bind_method(D_METHOD("get_state"), &Overlay::get_state);
+    ClassDB::bind_method(D_METHOD("get_native_call_count"), &Overlay::get_native_call_count);
+
     // Bind getter methods
     ClassDB::bind_method(D_METHOD("get_is_overlay_enabled"), &Overlay::get_is_overlay_enabled);
     ClassDB::bind_method(D_METHOD("get_is_input_passthrough_enabled"), &Overlay::get_is_input_passthrough_enabled);
     ClassDB::bind_method(D_METHOD("get_is_visibility_enabled"), &Overlay::get_is_visibility_enabled);
 
+    // Bind foreground tracking methods
+    ClassDB::bind_method(D_METHOD("get_is_godot_focused"), &Overlay::get_is_godot_focused);
+    ClassDB::bind_method(D_METHOD("get_foreground_app"), &Overlay::get_foreground_app);
+
+    // Bind frame pacing methods
+    ClassDB::bind_method(D_METHOD("set_frame_pacing_enabled", "enabled"), &Overlay::set_frame_pacing_enabled);
+    ClassDB::bind_method(D_METHOD("get_frame_pacing_enabled"), &Overlay::get_frame_pacing_enabled);
+    ClassDB::bind_method(D_METHOD("set_idle_frame_rate", "fps"), &Overlay::set_idle_frame_rate);
+    ClassDB::bind_method(D_METHOD("get_idle_frame_rate"), &Overlay::get_idle_frame_rate);
+    ClassDB::bind_method(D_METHOD("set_suspended_poll_rate", "rate"), &Overlay::set_suspended_poll_rate);
+    ClassDB::bind_method(D_METHOD("get_suspended_poll_rate"), &Overlay::get_suspended_poll_rate);
+    ClassDB::bind_method(D_METHOD("set_wake_duration", "seconds"), &Overlay::set_wake_duration);
+    ClassDB::bind_method(D_METHOD("get_wake_duration"), &Overlay::get_wake_duration);
+    ClassDB::bind_method(D_METHOD("wake_frame_pacing"), &Overlay::wake_frame_pacing);
+    ClassDB::bind_method(D_METHOD("get_pacing_mode"), &Overlay::get_pacing_mode);
+    ClassDB::bind_method(D_METHOD("get_pacing_stats"), &Overlay::get_pacing_stats);
+    ClassDB::bind_method(D_METHOD("reset_pacing_stats"), &Overlay::reset_pacing_stats);
+
+    BIND_ENUM_CONSTANT(PACING_MODE_FULL);
+    BIND_ENUM_CONSTANT(PACING_MODE_IDLE);
+    BIND_ENUM_CONSTANT(PACING_MODE_SUSPENDED);
+
+    // Bind capture methods
+    ClassDB::bind_method(D_METHOD("add_capture_region", "rect"), &Overlay::add_capture_region);
+    ClassDB::bind_method(D_METHOD("set_capture_region_rect", "id", "rect"), &Overlay::set_capture_region_rect);
+    ClassDB::bind_method(D_METHOD("remove_capture_region", "id"), &Overlay::remove_capture_region);
+    ClassDB::bind_method(D_METHOD("clear_capture_regions"), &Overlay::clear_capture_regions);
+    ClassDB::bind_method(D_METHOD("get_capture_texture", "id"), &Overlay::get_capture_texture);
+    ClassDB::bind_method(D_METHOD("set_capture_rate", "fps"), &Overlay::set_capture_rate);
+    ClassDB::bind_method(D_METHOD("get_capture_rate"), &Overlay::get_capture_rate);
+    ClassDB::bind_method(D_METHOD("get_capture_stats"), &Overlay::get_capture_stats);
+
+    // Bind telemetry methods
+    ClassDB::bind_method(D_METHOD("open_telemetry", "name", "snapshot_values", "ring_records", "record_size"), &Overlay::open_telemetry, DEFVAL(64), DEFVAL(1024), DEFVAL(32));
+    ClassDB::bind_method(D_METHOD("close_telemetry"), &Overlay::close_telemetry);
+    ClassDB::bind_method(D_METHOD("is_telemetry_open"), &Overlay::is_telemetry_open);
+    ClassDB::bind_method(D_METHOD("get_telemetry_snapshot"), &Overlay::get_telemetry_snapshot);
+    ClassDB::bind_method(D_METHOD("drain_telemetry", "max_records"), &Overlay::drain_telemetry, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("get_telemetry_stats"), &Overlay::get_telemetry_stats);
+
+    // Bind key recording methods
+    ClassDB::bind_method(D_METHOD("start_key_recording", "path"), &Overlay::start_key_recording);
+    ClassDB::bind_method(D_METHOD("stop_key_recording"), &Overlay::stop_key_recording);
+    ClassDB::bind_method(D_METHOD("is_key_recording"), &Overlay::is_key_recording);
+    ClassDB::bind_method(D_METHOD("replay_key_recording", "path", "at_recorded_speed"), &Overlay::replay_key_recording, DEFVAL(false));
+
+    // Bind statistics methods
+    ClassDB::bind_method(D_METHOD("get_stats"), &Overlay::get_stats);
+    ClassDB::bind_static_method("Overlay", D_METHOD("get_startup_timeline"), &Overlay::get_startup_timeline);
+    ClassDB::bind_method(D_METHOD("reset_stats"), &Overlay::reset_stats);
+
+    // Bind logging methods
+    ClassDB::bind_method(D_METHOD("set_log_level", "level"), &Overlay::set_log_level);
+    ClassDB::bind_method(D_METHOD("get_log_level"), &Overlay::get_log_level);
+    ClassDB::bind_method(D_METHOD("set_log_file", "path"), &Overlay::set_log_file);
+
+    BIND_ENUM_CONSTANT(LOG_LEVEL_NONE);
+    BIND_ENUM_CONSTANT(LOG_LEVEL_ERROR);
+    BIND_ENUM_CONSTANT(LOG_LEVEL_WARNING);
+    BIND_ENUM_CONSTANT(LOG_LEVEL_INFO);
+    BIND_ENUM_CONSTANT(LOG_LEVEL_VERBOSE);
+
     // Bind process method
     ClassDB::bind_method(D_METHOD("process", "delta"), &Overlay::process);
+
+    // Emitted for every global keybind match, built-in toggles included
+    ADD_SIGNAL(MethodInfo("keybind_pressed", PropertyInfo(Variant::STRING_NAME, "action")));
+
+    // Emitted at most once a frame per wheel binding, notches summed over the frame
+    ADD_SIGNAL(MethodInfo("keybind_scrolled", PropertyInfo(Variant::STRING_NAME, "action"), PropertyInfo(Variant::FLOAT, "notches")));
+
+    // Emitted for timed gestures: holds reaching their time, double taps and completed
+    // sequences, then on key-up for holds. The peek hold reports as overlay_peek.
+    ADD_SIGNAL(MethodInfo("gesture_recognized", PropertyInfo(Variant::STRING_NAME, "action")));
+    ADD_SIGNAL(MethodInfo("gesture_released", PropertyInfo(Variant::STRING_NAME, "action")));
+
+    // Emitted when a fade reaches its target, not when it is cancelled or replaced
+    ADD_SIGNAL(MethodInfo("fade_finished", PropertyInfo(Variant::FLOAT, "opacity")));
+
+    // Followed window events, state holds window, process_id, rect, minimized and occluded
+    ADD_SIGNAL(MethodInfo("target_found", PropertyInfo(Variant::DICTIONARY, "state")));
+    ADD_SIGNAL(MethodInfo("target_lost"));
+    ADD_SIGNAL(MethodInfo("target_rect_changed", PropertyInfo(Variant::RECT2I, "rect")));
+    ADD_SIGNAL(MethodInfo("target_visibility_changed", PropertyInfo(Variant::BOOL, "minimized"), PropertyInfo(Variant::BOOL, "occluded")));
+
+    // Emitted when another window comes to the foreground, app holds window, process_id, executable and title
+    ADD_SIGNAL(MethodInfo("focus_changed", PropertyInfo(Variant::BOOL, "godot_focused"), PropertyInfo(Variant::DICTIONARY, "app")));
+
+    // Emitted when frame pacing switches between full, idle and suspended rendering
+    ADD_SIGNAL(MethodInfo("pacing_mode_changed", PropertyInfo(Variant::INT, "mode")));
 }
 
 } // namespace godot
\ No newline at end of file
@@ -5,14 +5,39 @@
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/classes/input_event.hpp>
 #include <godot_cpp/classes/input_event_key.hpp>
-#include <unordered_map> // Include the unordered_map header
+#include <godot_cpp/classes/input_event_mouse_button.hpp>
+#include <godot_cpp/classes/control.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <atomic>
+#include <memory>
+#include <unordered_set>
+#include <vector>
 
-#ifdef _WIN32
-#include <windows.h>
-#endif
+#include "core/content_fit.h"
+#include "core/dirty_tiles.h"
+#include "core/frame_pacer.h"
+#include "core/gesture_recognizer.h"
+#include "core/key_event_queue.h"
+#include "core/key_recording.h"
+#include "core/keybind_table.h"
+#include "core/mouse_accumulator.h"
+#include "core/opacity_animator.h"
+#include "core/overlay_log.h"
+#include "core/overlay_state_machine.h"
+#include "core/overlay_stats.h"
+#include "core/telemetry_reader.h"
+#include "hook_dispatcher.h"
+#include "overlay_backend.h"
+#include "screen_capture.h"
+#include "window_tracker.h"
 
 namespace godot {
 
+class Window;
+
 class Overlay : public Object {
     GDCLASS(Overlay, Object);
 
@@ -20,6 +45,32 @@ protected:
     static void _bind_methods();
 
 public:
+    enum PassthroughMode {
+        PASSTHROUGH_MODE_FULL, // The whole window lets input through
+        PASSTHROUGH_MODE_REGIONS, // Only interactive controls capture input
+    };
+
+    enum LogLevel {
+        LOG_LEVEL_NONE = OVERLAY_LOG_NONE,
+        LOG_LEVEL_ERROR = OVERLAY_LOG_ERROR,
+        LOG_LEVEL_WARNING = OVERLAY_LOG_WARNING,
+        LOG_LEVEL_INFO = OVERLAY_LOG_INFO,
+        LOG_LEVEL_VERBOSE = OVERLAY_LOG_VERBOSE,
+    };
+
+    enum PacingMode {
+        PACING_MODE_FULL = FramePacer::MODE_FULL,
+        PACING_MODE_IDLE = FramePacer::MODE_IDLE,
+        PACING_MODE_SUSPENDED = FramePacer::MODE_SUSPENDED,
+    };
+
+    enum FadeCurve {
+        FADE_CURVE_LINEAR = OpacityAnimator::CURVE_LINEAR,
+        FADE_CURVE_EASE_IN = OpacityAnimator::CURVE_EASE_IN,
+        FADE_CURVE_EASE_OUT = OpacityAnimator::CURVE_EASE_OUT,
+        FADE_CURVE_EASE_IN_OUT = OpacityAnimator::CURVE_EASE_IN_OUT,
+    };
+
     Overlay();
     ~Overlay();
 
@@ -29,57 +80,428 @@ public:
     void enable_input_passthrough();
     void disable_input_passthrough();
 
+    // Window this overlay drives, the root window when none is set.
+    // Each overlay has its own window, state, keybinds and input region.
+    void set_window(Window *window);
+    Window *get_window() const;
+    Window *create_window(const Rect2i &rect);
+    static Overlay *create_for_screen(int screen);
+
+    // Per-region passthrough, interactive controls keep capturing input
+    void set_passthrough_mode(PassthroughMode mode);
+    PassthroughMode get_passthrough_mode() const;
+    void add_interactive_control(Control *control);
+    void remove_interactive_control(Control *control);
+    void clear_interactive_controls();
+    TypedArray<Rect2i> get_input_region() const;
+
     // Keybind methods
     void set_input_keybind(const Ref<InputEvent> &event);
     Ref<InputEvent> get_input_keybind() const;
     void set_visibility_keybind(const Ref<InputEvent> &event);
     Ref<InputEvent> get_visibility_keybind() const;
 
+    // Global keybind registry, each match emits keybind_pressed(action)
+    void add_keybind(const StringName &action, const Ref<InputEvent> &event);
+    void remove_keybind(const StringName &action);
+    void clear_keybinds();
+    PackedStringArray get_keybind_actions() const;
+
+    // Global mouse bindings from an InputEventMouseButton: a button or wheel direction with
+    // modifiers. Presses emit keybind_pressed(action); wheel bindings emit
+    // keybind_scrolled(action, notches) at most once a frame with the notches summed.
+    // The built-in overlay_toggle_input, overlay_toggle_visibility, overlay_opacity_up
+    // and overlay_opacity_down actions can be bound too, wheel opacity steps scale with notches.
+    void add_mouse_binding(const StringName &action, const Ref<InputEvent> &event);
+    void remove_mouse_binding(const StringName &action);
+    void clear_mouse_bindings();
+    PackedStringArray get_mouse_binding_actions() const;
+
+    // Timed gestures on global keys, recognized from the hook's key timestamps.
+    // gesture_recognized(action) fires when a hold reaches its time, on the second tap
+    // and on the last key of a sequence; gesture_released(action) when a hold ends.
+    void add_hold_gesture(const StringName &action, const Ref<InputEvent> &event, double hold_time);
+    void add_double_tap_gesture(const StringName &action, const Ref<InputEvent> &event, double interval);
+    void add_sequence_gesture(const StringName &action, const TypedArray<InputEvent> &events, double step_timeout);
+    void remove_gesture(const StringName &action);
+    void clear_gestures();
+    PackedStringArray get_gesture_actions() const;
+
+    // Hold-to-peek: input passthrough is off while the key is held for hold_time
+    void set_peek_keybind(const Ref<InputEvent> &event, double hold_time);
+    Ref<InputEvent> get_peek_keybind() const;
+
+    // Match keybinds by physical key position instead of the layout's keycode
+    void set_use_physical_keycodes(bool enabled);
+    bool get_use_physical_keycodes() const;
+
     // Visibility methods
     void enable_visibility();
     void disable_visibility();
 
+    // Window-level opacity (0-1), composited by the OS without rendering a frame.
+    // fade_to animates it from a timer thread, fading a hidden overlay shows it from 0.
+    // fade_finished(opacity) is emitted once a fade reaches its target.
+    void set_opacity(double opacity);
+    double get_opacity() const;
+    void fade_to(double opacity, double duration, FadeCurve curve);
+    void cancel_fade();
+    bool is_fading() const;
+    void set_fade_step_rate(int steps_per_second);
+    int get_fade_step_rate() const;
+
+    // Global keys stepping the opacity up and down, each press fades by step over fade_time
+    void set_opacity_step_keybinds(const Ref<InputEvent> &increase, const Ref<InputEvent> &decrease, double step, double fade_time);
+    Ref<InputEvent> get_opacity_increase_keybind() const;
+    Ref<InputEvent> get_opacity_decrease_keybind() const;
+
+    // Follow a window of another application, matched by executable name, part of the
+    // title or window class; empty fields match anything. The overlay window is moved
+    // onto its client area when that changes, and hidden without rendering while the
+    // window is missing, minimized or occluded. A closed window is searched for again.
+    // Emits target_found(state), target_lost(), target_rect_changed(rect) and
+    // target_visibility_changed(minimized, occluded).
+    bool attach_to_window(const String &process_name, const String &title, const String &window_class);
+    void detach_from_window();
+    bool is_attached_to_window() const;
+    Dictionary get_attached_window_state() const;
+
+    // Shrink-wrap the window around the visible controls under content_root instead of
+    // compositing the whole window. content_root is pinned to the window's current rect,
+    // the frame, so layout does not follow the window, and the canvas is shifted so content
+    // keeps its place on screen. The window grows as soon as content leaves it and shrinks
+    // once it stayed smaller for shrink_delay; margin and snap absorb jitter. Layout
+    // containers count through their children. Needs content scale mode disabled.
+    bool enable_auto_fit(Control *content_root, int margin, int snap, double shrink_delay);
+    void disable_auto_fit();
+    bool is_auto_fit_enabled() const;
+    Rect2i get_auto_fit_rect() const;
+    Dictionary get_auto_fit_stats() const;
+
+    // Bulk window state, keys match OverlayState: borderless, topmost, layered,
+    // use_color_key, color_key (Color), alpha (0-1), passthrough, visible, per_pixel_alpha.
+    // per_pixel_alpha takes transparency from the rendered alpha instead of the color key,
+    // where the OS needs it the changed tiles of every frame are converted and pushed.
+    // With use_color_key also set, key colored pixels become transparent and the rest opaque.
+    void apply_state(const Dictionary &state);
+    Dictionary get_state() const;
+    uint64_t get_native_call_count() const;
+
     // Getter methods for the properties
     bool get_is_overlay_enabled() const;
     bool get_is_input_passthrough_enabled() const;
     bool get_is_visibility_enabled() const;
 
+    // Foreground tracking, kept current from OS notifications instead of polled
+    bool get_is_godot_focused() const;
+    Dictionary get_foreground_app() const;
+
+    // Frame pacing: stop rendering while hidden, idle while passive in passthrough
+    void set_frame_pacing_enabled(bool enabled);
+    bool get_frame_pacing_enabled() const;
+    void set_idle_frame_rate(int fps);
+    int get_idle_frame_rate() const;
+    void set_suspended_poll_rate(int rate);
+    int get_suspended_poll_rate() const;
+    void set_wake_duration(double seconds);
+    double get_wake_duration() const;
+    void wake_frame_pacing();
+    PacingMode get_pacing_mode() const;
+    Dictionary get_pacing_stats() const;
+    void reset_pacing_stats();
+
+    // Desktop capture beneath the overlay. Regions are in window pixels and are
+    // grabbed while the overlay is enabled and visible, at most capture_rate times a second.
+    int add_capture_region(const Rect2i &rect);
+    void set_capture_region_rect(int id, const Rect2i &rect);
+    void remove_capture_region(int id);
+    void clear_capture_regions();
+    Ref<ImageTexture> get_capture_texture(int id) const;
+    void set_capture_rate(double fps);
+    double get_capture_rate() const;
+    Dictionary get_capture_stats() const;
+
+    // Shared memory telemetry from another process, see include/godoverit_telemetry.h.
+    // Reading only touches mapped memory, no system call per frame.
+    bool open_telemetry(const String &name, int snapshot_values, int ring_records, int record_size);
+    void close_telemetry();
+    bool is_telemetry_open() const;
+    PackedFloat64Array get_telemetry_snapshot();
+    PackedByteArray drain_telemetry(int max_records);
+    Dictionary get_telemetry_stats() const;
+
+    // Record the global key stream this overlay receives to a binary file, to replay
+    // field reports of dropped or late toggles. The stream is written from process().
+    bool start_key_recording(const String &path);
+    void stop_key_recording();
+    bool is_key_recording() const;
+
+    // Feed a recording through the keybind matching, gestures and state transitions
+    // of this overlay without touching the window. Blocks until done; at recorded
+    // speed that is the length of the recording. Returns counts and latency percentiles.
+    Dictionary replay_key_recording(const String &path, bool at_recorded_speed);
+
+    // Library load, main window resolve, style apply and first frame in microseconds
+    // since the library was loaded, -1 for stages not reached. Style apply is only
+    // reached when the project bootstraps the overlay before the first frame.
+    static Dictionary get_startup_timeline();
+
+    // Counters and latency histograms, also shown as GodoverIt/* debugger monitors
+    Dictionary get_stats() const;
+    void reset_stats();
+
+    // Logging methods, levels above the compiled level are ignored
+    void set_log_level(LogLevel level);
+    LogLevel get_log_level() const;
+    bool set_log_file(const String &path);
+
     // Process method
     void process(double delta);
 
 private:
-    bool is_overlay_enabled = false;
-    bool is_input_passthrough_enabled = false;
-    bool is_visibility_enabled = true;
     String window_title = "Godot";
     Ref<InputEventKey> input_keybind;
     Ref<InputEventKey> visibility_keybind;
 
-#ifdef _WIN32
-    HWND hwnd = nullptr;
-    HBRUSH hBrush = nullptr;
+    // Key records pushed by the shared hook thread, drained in process()
+    KeyEventQueue key_events;
+    std::shared_ptr<HookDispatcher> hook_dispatcher;
+
+    // Built-in actions come first in the table, registered keybinds follow
+    enum KeybindAction : uint16_t {
+        ACTION_TOGGLE_INPUT,
+        ACTION_TOGGLE_VISIBILITY,
+        ACTION_OPACITY_UP,
+        ACTION_OPACITY_DOWN,
+        ACTION_CUSTOM_BASE,
+    };
+
+    struct RegisteredKeybind {
+        StringName action;
+        Ref<InputEventKey> event;
+    };
+    std::vector<RegisteredKeybind> keybinds;
+
+    // Compiled from the keybinds above whenever they change, read on the main thread
+    KeybindTable keybind_table;
+    void compile_keybinds();
+    bool make_table_binding(const Ref<InputEventKey> &event, uint16_t action, KeybindTable::Binding &r_binding) const;
+    void trigger_keybind_action(uint16_t action);
 
-    // Windows API hook for global input
-    static LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
-    static HHOOK keyboard_hook;
+    // Mouse bindings are matched against the hook's coalesced record once a frame.
+    // The mouse hook is held while there is at least one binding.
+    struct MouseBinding {
+        StringName action;
+        Ref<InputEventMouseButton> event;
+        MouseAccumulator::Button button = MouseAccumulator::BUTTON_LEFT;
+        uint8_t modifiers = 0;
+        uint16_t builtin = KeybindTable::NO_ACTION; // Built-in action driven instead of a signal
+    };
+    std::vector<MouseBinding> mouse_bindings;
+    MouseAccumulator::Reader mouse_reader;
+    MouseAccumulator::Frame mouse_frame;
+    bool mouse_acquired = false;
+    void update_mouse_subscription();
+    void handle_mouse_frame();
 
-    // Static unordered_map for keycode mapping
-    static std::unordered_map<int, int> keycode_map;
+    // Gestures are compiled into the recognizer whenever they change, the built-in
+    // peek hold comes first. Results are collected while draining and emitted after.
+    enum GestureAction : uint16_t {
+        GESTURE_PEEK,
+        GESTURE_CUSTOM_BASE,
+    };
 
-    // Static function to convert Godot keycode to OS keycode
+    struct RegisteredGesture {
+        StringName action;
+        GestureRecognizer::Kind kind = GestureRecognizer::KIND_HOLD;
+        std::vector<Ref<InputEventKey>> events;
+        double duration = 0.0;
+    };
+    std::vector<RegisteredGesture> gestures;
+    Ref<InputEventKey> peek_keybind;
+    double peek_hold_time = 0.2;
+    bool peeking = false; // Passthrough was turned off by the peek hold
+    GestureRecognizer gesture_recognizer;
+    std::vector<GestureRecognizer::Result> gesture_results;
+    void add_gesture(const StringName &action, GestureRecognizer::Kind kind, const std::vector<Ref<InputEventKey>> &events, double duration);
+    bool make_gesture(const std::vector<Ref<InputEventKey>> &events, GestureRecognizer::Kind kind, uint16_t action, double duration, GestureRecognizer::Gesture &r_gesture) const;
+    void compile_gestures();
+    void emit_gestures();
+
+    // Static functions to convert Godot keycodes to OS keycodes and scancodes
     static int godot_to_os_keycode(int godot_keycode);
+    static int godot_to_os_scancode(int godot_physical_keycode);
+    bool use_physical_keycodes = false;
+
+    // Keybind handling, runs on the main thread for each drained record
+    void handle_keybind(const KeyEvent &event);
+
+    // Check if a window of this Godot process is focused, a cached flag when the OS notifies us
+    bool is_godot_window_focused() const;
+    uint64_t native_window_handle = 0;
+    uint32_t process_id = 0;
+    uint64_t foreground_serial = 0; // Last foreground change reported through focus_changed
+
+    // Print queued log records, only called from the main thread
+    static void flush_log();
+
+    // Always-on counters, written from the hook thread and the main thread
+    OverlayStats stats;
+    uint64_t pending_toggle_usec = 0; // Key press that started the toggle being committed
+
+    enum StatsMonitor {
+        MONITOR_HOOK_INVOCATIONS,
+        MONITOR_HOOK_TIME_P99,
+        MONITOR_KEYS_MATCHED,
+        MONITOR_KEYS_UNMATCHED,
+        MONITOR_TOGGLE_LATENCY_P99,
+        MONITOR_NATIVE_CALLS,
+        MONITOR_NATIVE_FAILURES,
+        MONITOR_ENABLE_TIME,
+        MONITOR_EVENTS_DROPPED,
+        MONITOR_FRAMES_SKIPPED,
+        MONITOR_COUNT,
+    };
+    static Variant get_monitor_value(int monitor);
 
-    // Static pointer to the Overlay instance
-    static Overlay* instance;
+    // Every constructed Overlay, main thread only. Monitors and engine pacing are shared.
+    static std::vector<Overlay *> live_overlays;
 
-    // Keybind handling
-    void handle_keybind(WPARAM wParam, KBDLLHOOKSTRUCT* pKeyInfo);
+    // Native window operations for the current platform, null when unsupported
+    std::unique_ptr<OverlayBackend> backend;
+    int32_t window_id = 0;
 
-    // Check if the Godot window is focused
-    bool is_godot_window_focused();
-#endif
+    // Bound window by ObjectID so a freed window is noticed, 0 for the root window
+    uint64_t window_object_id = 0;
+    bool owns_window = false; // Made by create_window, freed with the overlay
+    bool bootstrap_adopted = false; // Backend taken over from OverlayBootstrap, given back when done
+    void return_bootstrap();
+    Window *get_target_window() const;
+    void _on_window_exiting();
+
+    // Capture regions own their native surface and the texture it is uploaded to.
+    // Declared after screen_capture so surfaces are freed before its connection.
+    struct CaptureRegion {
+        int id = 0;
+        Rect2i rect;
+        Ref<Image> image; // RGBA8, converted into in place
+        Ref<ImageTexture> texture;
+        std::unique_ptr<CaptureSurface> surface;
+    };
+    std::unique_ptr<ScreenCapture> screen_capture;
+    std::vector<CaptureRegion> capture_regions;
+    int next_capture_id = 1;
+    double capture_rate = 30.0;
+    uint64_t last_capture_usec = 0;
+    CaptureRegion *find_capture_region(int id);
+    void update_captures();
+
+    // Telemetry channel, arrays are kept and refilled so reading does not allocate.
+    // A channel the producer has not finished creating is retried once a second.
+    TelemetryReader telemetry;
+    CharString telemetry_name;
+    uint32_t telemetry_snapshot_values = 0;
+    uint32_t telemetry_ring_records = 0;
+    uint32_t telemetry_record_size = 0;
+    uint64_t telemetry_retry_usec = 0;
+    PackedFloat64Array telemetry_snapshot;
+    PackedByteArray telemetry_records;
+    uint64_t telemetry_records_drained = 0;
+    bool try_open_telemetry();
+
+    // Key recording, records are appended while draining. Drops in the queue since
+    // the recording started are written into its header when it stops.
+    KeyRecordingWriter key_recorder;
+    uint64_t key_recording_dropped = 0;
+
+    // Opacity fades run on the animator's thread and only touch window alpha. The alpha
+    // a fade ends on is committed into the state, frames drawn meanwhile are counted.
+    // Stopped before the backend is replaced, the sink calls into it.
+    OpacityAnimator opacity_animator;
+    bool fade_running = false;
+    uint8_t fade_target = 255;
+    uint64_t fade_serial = 0; // Animator serial when the running fade started
+    uint64_t fade_start_usec = 0;
+    uint64_t fade_start_frames = 0;
+    Ref<InputEventKey> opacity_increase_keybind;
+    Ref<InputEventKey> opacity_decrease_keybind;
+    double opacity_step = 0.1;
+    double opacity_step_time = 0.1;
+    void end_fade(bool reached);
+    void stop_fades();
+    void step_opacity(double step);
+
+    // Window of another application followed by the tracker's thread, its state is
+    // taken when the serial changes. tracked_hidden keeps the overlay hidden and suspended.
+    std::unique_ptr<WindowTracker> window_tracker;
+    uint64_t window_tracker_serial = 0;
+    TrackedWindow tracked_window;
+    bool tracked_hidden = false;
+    void update_tracked_window();
+    void move_to_tracked_window();
+    Dictionary tracked_window_to_dictionary(const TrackedWindow &state) const;
+
+    // Auto-fit. Controls under the root are measured in frame pixels when they or an
+    // ancestor report a change, the window follows the fit of their union bounds.
+    uint64_t fit_root_id = 0;
+    Rect2i fit_frame; // Screen rect the window had before fitting
+    WindowFit window_fit;
+    ContentBounds fit_bounds;
+    std::unordered_set<uint64_t> fit_controls;
+    std::vector<uint64_t> fit_dirty;
+    std::unordered_set<uint64_t> fit_measured; // Per refresh, a subtree is measured once
+    uint64_t fit_start_usec = 0;
+    void track_fit_control(Control *control);
+    void untrack_fit_control(Control *control);
+    void _on_fit_node_added(Node *node);
+    void _on_fit_node_removed(Node *node);
+    void _on_fit_control_changed(uint64_t control_id);
+    void refresh_fit_controls();
+    void update_auto_fit(uint64_t now_usec);
+    void apply_auto_fit();
+    void set_fit_frame(const Rect2i &frame);
+
+    // Per-pixel alpha presentation, the rendered frame is diffed against the last one
+    // and only changed tiles are converted into the backend's buffer
+    DirtyTiles layered_tiles;
+    std::vector<RegionRect> layered_rects;
+    void present_layered();
+
+    // State the window should be in, changes during a frame are committed together
+    OverlayStateMachine state_machine;
+    bool commit_pending = false;
+    void request_commit();
+    void commit_state();
+
+    // Each overlay paces itself, the engine runs at the least reduced mode of all of them.
+    // Engine pacing settings are saved on leaving full rate and restored on return.
+    FramePacer frame_pacer;
+    int idle_frame_rate = 10;
+    int suspended_poll_rate = 20;
+    static bool pacing_settings_saved;
+    static bool saved_low_processor_mode;
+    static int saved_low_processor_sleep_usec;
+    void update_frame_pacing();
+    static void apply_engine_pacing();
+
+    // Interactive controls by ObjectID, only changed ones are re-inserted in the index
+    PassthroughMode passthrough_mode = PASSTHROUGH_MODE_FULL;
+    InputRegionIndex input_region;
+    std::unordered_set<uint64_t> interactive_controls;
+    std::vector<uint64_t> dirty_controls;
+    bool input_region_native = false; // Backend shapes input itself
+    bool cursor_over_region = false; // Fallback state when it cannot
+    void _on_interactive_control_changed(uint64_t control_id);
+    void _on_interactive_control_exiting(uint64_t control_id);
+    void refresh_dirty_controls();
+    void update_input_region();
 };
 
 } // namespace godot
 
+VARIANT_ENUM_CAST(Overlay::PassthroughMode);
+VARIANT_ENUM_CAST(Overlay::LogLevel);
+VARIANT_ENUM_CAST(Overlay::PacingMode);
+VARIANT_ENUM_CAST(Overlay::FadeCurve);
+
 #endif // OVERLAY_H
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "overlay_backend.h"
+
+#include <godot_cpp/classes/display_server.hpp>
+
+#if defined(_WIN32)
+#include "overlay_backend_windows.h"
+#elif defined(__linux__) || defined(__FreeBSD__)
+#include "overlay_backend_x11.h"
+#endif
+
+namespace godot {
+
+std::unique_ptr<OverlayBackend> OverlayBackend::create() {
+#if defined(_WIN32)
+    return std::unique_ptr<OverlayBackend>(new OverlayBackendWindows());
+#elif defined(__linux__) || defined(__FreeBSD__)
+    // Godot on Linux may also run on Wayland, which has no backend yet
+    if (DisplayServer::get_singleton()->get_name() != "X11") {
+        return nullptr;
+    }
+    return std::unique_ptr<OverlayBackend>(new OverlayBackendX11());
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace godot
@@ -0,0 +1,102 @@
+#ifndef OVERLAY_BACKEND_H
+#define OVERLAY_BACKEND_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/input_region.h"
+#include "core/overlay_state_applier.h"
+
+namespace godot {
+
+// Native window operations Overlay dispatches to, one implementation per windowing system.
+// Every call but set_window_alpha is made from the Godot main thread and returns false
+// when the OS refused it.
+// Calls that may block on another process are moved to a worker by the implementation.
+// State changes go through OverlayStateApplier::apply_state, which batches them into
+// apply_changes.
+class OverlayBackend : public OverlayStateApplier {
+public:
+    // Bind to a native window. Handles come from DisplayServer::window_get_native_handle,
+    // the UTF-8 title is only used by backends that can search for a window when the
+    // handle is null. Nothing here depends on Godot, the headless bench attaches too.
+    virtual bool attach(int64_t native_window, int64_t native_display, const char *title) = 0;
+
+    // Let input through everywhere except the given window rectangles.
+    // Returns false when the windowing system cannot shape input, callers
+    // then toggle OverlayState::passthrough themselves as the cursor moves.
+    // Applying a state that changes passthrough replaces the region.
+    virtual bool set_input_region(const std::vector<RegionRect> &rects) {
+        (void)rects;
+        return false;
+    }
+
+    // Native screen position of the window's top-left client pixel, what screen capture uses
+    virtual bool get_client_origin(int32_t &r_x, int32_t &r_y) const {
+        (void)r_x;
+        (void)r_y;
+        return false;
+    }
+
+    // Per-pixel alpha for windowing systems that cannot take the rendered alpha directly.
+    // The caller converts the frame into the premultiplied BGRA buffer, which keeps its
+    // contents between frames, and presents it with the bounds of what changed.
+    // The buffer is null when unsupported, a new size starts from an undefined buffer.
+    virtual bool supports_layered_present() const {
+        return false;
+    }
+    virtual uint8_t *get_layered_buffer(int32_t width, int32_t height, size_t &r_stride) {
+        (void)width;
+        (void)height;
+        (void)r_stride;
+        return nullptr;
+    }
+    virtual bool present_layered(const RegionRect &dirty) {
+        (void)dirty;
+        return false;
+    }
+
+    // Window-level opacity on its own, for fades. Unlike everything else here this is
+    // called from the fade thread, while the main thread keeps applying state. The
+    // cached state is left alone, Overlay marks alpha stale around a fade and commits
+    // the final one through apply_state. Returns once the window system has the alpha.
+    virtual bool set_window_alpha(uint8_t alpha) {
+        (void)alpha;
+        return false;
+    }
+
+    // Give the overlay window keyboard focus
+    virtual bool focus_window() = 0;
+    virtual bool is_window_focused() const = 0;
+
+    virtual const char *get_name() const = 0;
+
+    // Number of native window calls made so far, and how many the OS refused
+    uint64_t get_native_call_count() const {
+        return native_calls.load(std::memory_order_relaxed);
+    }
+    uint64_t get_native_failure_count() const {
+        return native_failures.load(std::memory_order_relaxed);
+    }
+
+    // Backend for the platform this library was built for, null when there is none
+    static std::unique_ptr<OverlayBackend> create();
+
+protected:
+    void count_native_calls(uint64_t count = 1) {
+        native_calls.fetch_add(count, std::memory_order_relaxed);
+    }
+    void count_native_failure(uint64_t count = 1) {
+        native_failures.fetch_add(count, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> native_calls{ 0 };
+    std::atomic<uint64_t> native_failures{ 0 };
+};
+
+} // namespace godot
+
+#endif // OVERLAY_BACKEND_H
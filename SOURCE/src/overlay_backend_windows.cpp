@@ -0,0 +1,368 @@
+#ifdef _WIN32
+
+#include "overlay_backend_windows.h"
+#include "core/overlay_log.h"
+
+namespace godot {
+
+OverlayBackendWindows::~OverlayBackendWindows() {
+    // Does not wait for a focus call stuck behind a hung window, the job holds no reference here
+    worker.stop();
+    release_layered_buffer();
+
+    // Delete the brush to avoid memory leaks
+    if (hBrush) {
+        DeleteObject(hBrush);
+        hBrush = nullptr;
+    }
+}
+
+bool OverlayBackendWindows::attach(int64_t native_window, int64_t native_display, const char *title) {
+    (void)native_display;
+
+    // Use the handle Godot reports for the window
+    hwnd = reinterpret_cast<HWND>(static_cast<intptr_t>(native_window));
+    if (!hwnd) {
+        OVERLAY_LOG_WARNING("Failed to get native window handle. Trying FindWindow...\n");
+
+        // Use FindWindowA to get the HWND
+        hwnd = FindWindowA(nullptr, title);
+        if (!hwnd) {
+            OVERLAY_LOG_WARNING("Failed to find window using FindWindow. Trying GetActiveWindow...\n");
+
+            // Fallback: Use GetActiveWindow to get the HWND
+            hwnd = GetActiveWindow();
+            if (hwnd) {
+                OVERLAY_LOG_INFO("Window handle (hwnd) found using GetActiveWindow: %p\n", hwnd);
+            } else {
+                count_native_failure();
+                OVERLAY_LOG_ERROR("Failed to find window using GetActiveWindow. Error: %lu\n", GetLastError());
+                return false;
+            }
+        } else {
+            OVERLAY_LOG_INFO("Window handle (hwnd) found using FindWindow: %p\n", hwnd);
+        }
+    } else {
+        OVERLAY_LOG_INFO("Window handle (hwnd): %p\n", hwnd);
+    }
+    return true;
+}
+
+bool OverlayBackendWindows::is_attached() const {
+    return hwnd != nullptr;
+}
+
+bool OverlayBackendWindows::set_window_long(int index, LONG value) {
+    // SetWindowLong returns the previous value, which may legitimately be 0
+    SetLastError(0);
+    count_native_calls();
+    return SetWindowLong(hwnd, index, value) != 0 || GetLastError() == 0;
+}
+
+uint32_t OverlayBackendWindows::apply_changes(const OverlayState &state, uint32_t changed) {
+    uint32_t applied = 0;
+    bool frame_changed = false;
+
+    // Title bar and borders
+    if (changed & OVERLAY_STATE_BORDERLESS) {
+        const LONG border_styles = WS_CAPTION | WS_THICKFRAME | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU;
+        count_native_calls();
+        LONG style = GetWindowLong(hwnd, GWL_STYLE);
+        LONG new_style = state.borderless ? (style & ~border_styles) : (style | WS_OVERLAPPEDWINDOW);
+        if (new_style == style || set_window_long(GWL_STYLE, new_style)) {
+            applied |= OVERLAY_STATE_BORDERLESS;
+            frame_changed = true;
+        } else {
+            count_native_failure();
+            OVERLAY_LOG_ERROR("Failed to update window style. Error: %lu\n", GetLastError());
+        }
+    }
+
+    // Transparency and input passthrough share the extended style
+    const uint32_t restyle_fields = OVERLAY_STATE_LAYERED | OVERLAY_STATE_PER_PIXEL_ALPHA;
+    if (changed & (restyle_fields | OVERLAY_STATE_PASSTHROUGH)) {
+        count_native_calls();
+        LONG ex_style = GetWindowLong(hwnd, GWL_EXSTYLE);
+
+        // A window that had SetLayeredWindowAttributes only takes UpdateLayeredWindow
+        // once WS_EX_LAYERED was cleared, and the other way round
+        if ((changed & OVERLAY_STATE_PER_PIXEL_ALPHA) && state.layered && (ex_style & WS_EX_LAYERED)) {
+            if (set_window_long(GWL_EXSTYLE, ex_style & ~WS_EX_LAYERED)) {
+                ex_style &= ~WS_EX_LAYERED;
+            }
+        }
+        LONG new_ex_style = ex_style;
+        if (changed & restyle_fields) {
+            new_ex_style = state.layered ? (new_ex_style | WS_EX_LAYERED) : (new_ex_style & ~WS_EX_LAYERED);
+        }
+        if (changed & OVERLAY_STATE_PASSTHROUGH) {
+            new_ex_style = state.passthrough ? (new_ex_style | WS_EX_TRANSPARENT) : (new_ex_style & ~WS_EX_TRANSPARENT);
+        }
+        if (new_ex_style == ex_style || set_window_long(GWL_EXSTYLE, new_ex_style)) {
+            applied |= changed & (restyle_fields | OVERLAY_STATE_PASSTHROUGH);
+            frame_changed = frame_changed || (changed & OVERLAY_STATE_LAYERED);
+            if (changed & restyle_fields) {
+                layered_presented = false;
+            }
+        } else {
+            count_native_failure();
+            OVERLAY_LOG_ERROR("Failed to update extended window style. Error: %lu\n", GetLastError());
+        }
+    }
+
+    // Color key and opacity only mean something on a layered window,
+    // while not layered they are recorded and applied when it becomes one
+    const uint32_t attribute_fields = OVERLAY_STATE_COLOR_KEY | OVERLAY_STATE_ALPHA | OVERLAY_STATE_VISIBLE;
+    if (changed & (attribute_fields | restyle_fields)) {
+        // Hidden is alpha 0, the color key stays so showing again is one call
+        BYTE alpha = state.visible ? state.alpha : 0;
+        window_alpha.store(alpha, std::memory_order_relaxed);
+        if (!state.layered) {
+            applied |= changed & attribute_fields;
+            if (hBrush) {
+                count_native_calls();
+                DeleteObject(hBrush);
+                hBrush = nullptr;
+            }
+        } else if ((changed & restyle_fields) && !(applied & restyle_fields)) {
+            // The extended style failed, the attributes are retried with it
+        } else if (state.per_pixel_alpha) {
+            // Opacity is passed with every present, the color key is applied while converting
+            if (!layered_presented || update_layered_blend(alpha)) {
+                applied |= changed & attribute_fields;
+            }
+        } else {
+            COLORREF key = RGB((state.color_key >> 16) & 0xFF, (state.color_key >> 8) & 0xFF, state.color_key & 0xFF);
+
+            // Background brush matching the color key, so uncovered areas are transparent
+            if (state.use_color_key && (!hBrush || brush_color != key)) {
+                count_native_calls(3);
+                HBRUSH brush = CreateSolidBrush(key);
+                if (brush) {
+                    SetClassLongPtr(hwnd, GCLP_HBRBACKGROUND, (LONG_PTR)brush);
+                    if (hBrush) {
+                        DeleteObject(hBrush);
+                    }
+                    hBrush = brush;
+                    brush_color = key;
+                } else {
+                    count_native_failure();
+                    OVERLAY_LOG_ERROR("Failed to create background brush. Error: %lu\n", GetLastError());
+                }
+            }
+
+            DWORD flags = LWA_ALPHA | (state.use_color_key ? LWA_COLORKEY : 0);
+            count_native_calls();
+            if (SetLayeredWindowAttributes(hwnd, key, alpha, flags)) {
+                applied |= changed & attribute_fields;
+            } else {
+                count_native_failure();
+                OVERLAY_LOG_ERROR("Failed to set layered window attributes. Error: %lu\n", GetLastError());
+            }
+        }
+    }
+
+    // Z order and the frame recalculation share a single SetWindowPos
+    bool topmost_changed = (changed & OVERLAY_STATE_TOPMOST) != 0;
+    if (topmost_changed || frame_changed) {
+        UINT flags = SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE;
+        if (!topmost_changed) {
+            flags |= SWP_NOZORDER;
+        }
+        if (frame_changed) {
+            flags |= SWP_FRAMECHANGED;
+        }
+        HWND insert_after = state.topmost ? HWND_TOPMOST : HWND_NOTOPMOST;
+        count_native_calls();
+        if (SetWindowPos(hwnd, insert_after, 0, 0, 0, 0, flags)) {
+            if (topmost_changed) {
+                applied |= OVERLAY_STATE_TOPMOST;
+            }
+        } else {
+            count_native_failure();
+            OVERLAY_LOG_ERROR("Failed to update window position. Error: %lu\n", GetLastError());
+        }
+    }
+
+    OVERLAY_LOG_VERBOSE("Window state applied: changed 0x%x, failed 0x%x.\n", changed, changed & ~applied);
+    return applied;
+}
+
+bool OverlayBackendWindows::get_client_origin(int32_t &r_x, int32_t &r_y) const {
+    POINT origin = { 0, 0 };
+    if (!hwnd || !ClientToScreen(hwnd, &origin)) {
+        return false;
+    }
+    r_x = origin.x;
+    r_y = origin.y;
+    return true;
+}
+
+bool OverlayBackendWindows::supports_layered_present() const {
+    const OverlayState &state = get_applied_state();
+    return hwnd && state.layered && state.per_pixel_alpha;
+}
+
+uint8_t *OverlayBackendWindows::get_layered_buffer(int32_t width, int32_t height, size_t &r_stride) {
+    if (!supports_layered_present() || width <= 0 || height <= 0) {
+        return nullptr;
+    }
+    if (!layered_bits || width != layered_width || height != layered_height) {
+        release_layered_buffer();
+
+        // Top-down 32 bit DIB, the bytes are premultiplied BGRA as UpdateLayeredWindow wants them
+        BITMAPINFO info = {};
+        info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        info.bmiHeader.biWidth = width;
+        info.bmiHeader.biHeight = -height;
+        info.bmiHeader.biPlanes = 1;
+        info.bmiHeader.biBitCount = 32;
+        info.bmiHeader.biCompression = BI_RGB;
+        void *bits = nullptr;
+        count_native_calls(3);
+        layered_dc = CreateCompatibleDC(nullptr);
+        layered_bitmap = layered_dc ? CreateDIBSection(layered_dc, &info, DIB_RGB_COLORS, &bits, nullptr, 0) : nullptr;
+        if (!layered_bitmap) {
+            count_native_failure();
+            OVERLAY_LOG_ERROR("Failed to create the layered window surface. Error: %lu\n", GetLastError());
+            release_layered_buffer();
+            return nullptr;
+        }
+        layered_previous = SelectObject(layered_dc, layered_bitmap);
+        layered_bits = static_cast<uint8_t *>(bits);
+        layered_width = width;
+        layered_height = height;
+        layered_presented = false;
+    }
+    r_stride = static_cast<size_t>(layered_width) * 4;
+    return layered_bits;
+}
+
+bool OverlayBackendWindows::present_layered(const RegionRect &dirty) {
+    if (!supports_layered_present() || !layered_bits) {
+        return false;
+    }
+    // A fade may be changing the opacity between frames, the last one set is kept
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, window_alpha.load(std::memory_order_relaxed), AC_SRC_ALPHA };
+    POINT source = { 0, 0 };
+    SIZE size = { layered_width, layered_height };
+    RECT rect = { dirty.x, dirty.y, dirty.x + dirty.width, dirty.y + dirty.height };
+
+    // The first present after a new surface or style has to cover the whole window
+    UPDATELAYEREDWINDOWINFO info = {};
+    info.cbSize = sizeof(info);
+    info.hdcSrc = layered_dc;
+    info.pptSrc = &source;
+    info.psize = &size;
+    info.pblend = &blend;
+    info.dwFlags = ULW_ALPHA;
+    info.prcDirty = layered_presented ? &rect : nullptr;
+    count_native_calls();
+    if (!UpdateLayeredWindowIndirect(hwnd, &info)) {
+        count_native_failure();
+        OVERLAY_LOG_ERROR("Failed to update the layered window. Error: %lu\n", GetLastError());
+        return false;
+    }
+    layered_presented = true;
+    return true;
+}
+
+bool OverlayBackendWindows::update_layered_blend(BYTE alpha) {
+    // Without a source DC only the opacity changes, the last surface stays
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, alpha, AC_SRC_ALPHA };
+    count_native_calls();
+    if (!UpdateLayeredWindow(hwnd, nullptr, nullptr, nullptr, nullptr, nullptr, 0, &blend, ULW_ALPHA)) {
+        count_native_failure();
+        OVERLAY_LOG_ERROR("Failed to update layered window opacity. Error: %lu\n", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool OverlayBackendWindows::set_window_alpha(uint8_t alpha) {
+    if (!hwnd) {
+        return false;
+    }
+    window_alpha.store(alpha, std::memory_order_relaxed);
+
+    // The color key and flags are read back from the window rather than the main
+    // thread's state. A window showing an UpdateLayeredWindow surface has no
+    // attributes to read and takes a new blend instead.
+    COLORREF key = 0;
+    DWORD flags = 0;
+    count_native_calls();
+    if (GetLayeredWindowAttributes(hwnd, &key, nullptr, &flags)) {
+        count_native_calls();
+        if (SetLayeredWindowAttributes(hwnd, key, alpha, flags | LWA_ALPHA)) {
+            return true;
+        }
+        count_native_failure();
+        return false;
+    }
+
+    // Not layered at all, there is no window-level opacity to animate
+    count_native_calls();
+    if (!(GetWindowLong(hwnd, GWL_EXSTYLE) & WS_EX_LAYERED)) {
+        return false;
+    }
+    return update_layered_blend(alpha);
+}
+
+void OverlayBackendWindows::release_layered_buffer() {
+    if (layered_dc) {
+        if (layered_previous) {
+            SelectObject(layered_dc, layered_previous);
+        }
+        DeleteDC(layered_dc);
+    }
+    if (layered_bitmap) {
+        DeleteObject(layered_bitmap);
+    }
+    layered_dc = nullptr;
+    layered_bitmap = nullptr;
+    layered_previous = nullptr;
+    layered_bits = nullptr;
+    layered_width = 0;
+    layered_height = 0;
+    layered_presented = false;
+}
+
+bool OverlayBackendWindows::focus_window() {
+    if (!hwnd) {
+        return false;
+    }
+
+    // Failed focus calls are counted by the worker, the job cannot reach this backend
+    uint64_t failures = worker.get_failure_count();
+    if (failures > worker_failures) {
+        count_native_failure(failures - worker_failures);
+        worker_failures = failures;
+    }
+
+    // Queued, a newer request replaces one still waiting. The job only gets the handle,
+    // it may outlive this backend.
+    HWND target = hwnd;
+    count_native_calls();
+    worker.post(1, [target]() {
+        if (!SetForegroundWindow(target)) {
+            OVERLAY_LOG_ERROR("Failed to focus window. Error: %lu\n", GetLastError());
+            return false;
+        }
+        OVERLAY_LOG_INFO("Window focused.\n");
+        return true;
+    });
+    return true;
+}
+
+bool OverlayBackendWindows::is_window_focused() const {
+    if (!hwnd) {
+        return false; // No window handle, assume not focused
+    }
+
+    HWND focused_window = GetForegroundWindow();
+    return (focused_window == hwnd);
+}
+
+} // namespace godot
+
+#endif // _WIN32
@@ -0,0 +1,73 @@
+#ifndef OVERLAY_BACKEND_WINDOWS_H
+#define OVERLAY_BACKEND_WINDOWS_H
+
+#ifdef _WIN32
+
+#include "core/native_worker.h"
+#include "overlay_backend.h"
+
+#include <windows.h>
+
+namespace godot {
+
+// Win32 backend: layered window with a color key, WS_EX_TRANSPARENT for passthrough.
+// A state change costs at most one read and one write per style word, one
+// SetLayeredWindowAttributes and one SetWindowPos carrying the frame change.
+// With per-pixel alpha the window shows a premultiplied DIB section through
+// UpdateLayeredWindowIndirect instead, which only redraws the dirty rectangle.
+class OverlayBackendWindows : public OverlayBackend {
+public:
+    ~OverlayBackendWindows() override;
+
+    bool attach(int64_t native_window, int64_t native_display, const char *title) override;
+    bool is_attached() const override;
+
+    bool get_client_origin(int32_t &r_x, int32_t &r_y) const override;
+
+    bool supports_layered_present() const override;
+    uint8_t *get_layered_buffer(int32_t width, int32_t height, size_t &r_stride) override;
+    bool present_layered(const RegionRect &dirty) override;
+
+    bool set_window_alpha(uint8_t alpha) override;
+
+    bool focus_window() override;
+    bool is_window_focused() const override;
+
+    const char *get_name() const override {
+        return "Windows";
+    }
+
+protected:
+    uint32_t apply_changes(const OverlayState &state, uint32_t changed) override;
+
+private:
+    HWND hwnd = nullptr;
+    HBRUSH hBrush = nullptr;
+    COLORREF brush_color = 0;
+
+    // SetForegroundWindow can stall behind a hung foreground window
+    NativeWorker worker;
+    uint64_t worker_failures = 0; // Already added to the native failure count
+
+    // Surface UpdateLayeredWindow reads from, recreated when the size changes
+    HDC layered_dc = nullptr;
+    HBITMAP layered_bitmap = nullptr;
+    HGDIOBJ layered_previous = nullptr;
+    uint8_t *layered_bits = nullptr;
+    int32_t layered_width = 0;
+    int32_t layered_height = 0;
+    bool layered_presented = false; // The window has a surface, partial updates are allowed
+
+    // Opacity last given to the window, by a state change or by the fade thread
+    std::atomic<BYTE> window_alpha{ 255 };
+
+    bool set_window_long(int index, LONG value);
+    bool update_layered_blend(BYTE alpha);
+    void release_layered_buffer();
+};
+
+} // namespace godot
+
+#endif // _WIN32
+
+#endif // OVERLAY_BACKEND_WINDOWS_H
@@ -0,0 +1,308 @@
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "overlay_backend_x11.h"
+#include "core/overlay_log.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/Xfixes.h>
+#include <X11/extensions/shape.h>
+
+namespace godot {
+
+namespace {
+
+// _MOTIF_WM_HINTS layout understood by every common window manager
+struct MotifWmHints {
+    unsigned long flags;
+    unsigned long functions;
+    unsigned long decorations;
+    long input_mode;
+    unsigned long status;
+};
+
+constexpr unsigned long MWM_HINTS_DECORATIONS = 1L << 1;
+constexpr long NET_WM_STATE_REMOVE = 0;
+constexpr long NET_WM_STATE_ADD = 1;
+
+} // namespace
+
+OverlayBackendX11::~OverlayBackendX11() {
+    // The fade thread is stopped by now, its connection can go
+    if (fade_display) {
+        XCloseDisplay(fade_display);
+    }
+}
+
+bool OverlayBackendX11::attach(int64_t native_window, int64_t native_display, const char *title) {
+    (void)title; // Godot always reports its X11 handles, no title search needed
+
+    display = reinterpret_cast<Display *>(static_cast<intptr_t>(native_display));
+    window = static_cast<::Window>(native_window);
+    if (!display || !window) {
+        count_native_failure();
+        OVERLAY_LOG_ERROR("Failed to get X11 display or window handle.\n");
+        display = nullptr;
+        window = 0;
+        return false;
+    }
+
+    XWindowAttributes attributes;
+    if (!XGetWindowAttributes(display, window, &attributes)) {
+        count_native_failure();
+        OVERLAY_LOG_ERROR("Failed to query X11 window attributes.\n");
+        return false;
+    }
+    root = attributes.root;
+    display_name = DisplayString(display);
+
+    // A 32 bit visual is needed for the transparent background
+    has_argb_visual = attributes.depth == 32;
+    if (!has_argb_visual) {
+        OVERLAY_LOG_WARNING("Window has no ARGB visual, enable display/window/per_pixel_transparency/allowed.\n");
+    }
+
+    int event_base = 0;
+    int error_base = 0;
+    has_xfixes = XFixesQueryExtension(display, &event_base, &error_base);
+    if (!has_xfixes) {
+        OVERLAY_LOG_WARNING("XFixes is not available, input passthrough is disabled.\n");
+    }
+
+    // One round trip for every atom the backend uses
+    const char *names[] = {
+        "_NET_WM_STATE",
+        "_NET_WM_STATE_ABOVE",
+        "_NET_ACTIVE_WINDOW",
+        "_NET_WM_WINDOW_OPACITY",
+        "_MOTIF_WM_HINTS",
+    };
+    Atom atoms[5];
+    XInternAtoms(display, const_cast<char **>(names), 5, False, atoms);
+    atom_net_wm_state = atoms[0];
+    atom_net_wm_state_above = atoms[1];
+    atom_net_active_window = atoms[2];
+    atom_net_wm_window_opacity = atoms[3];
+    atom_motif_wm_hints = atoms[4];
+
+    OVERLAY_LOG_INFO("X11 window: 0x%lx\n", window);
+    return true;
+}
+
+bool OverlayBackendX11::is_attached() const {
+    return display != nullptr && window != 0;
+}
+
+void OverlayBackendX11::send_wm_state(bool add, unsigned long state) {
+    // EWMH: the window manager owns _NET_WM_STATE on mapped windows, ask it through the root
+    XEvent event = {};
+    event.xclient.type = ClientMessage;
+    event.xclient.window = window;
+    event.xclient.message_type = atom_net_wm_state;
+    event.xclient.format = 32;
+    event.xclient.data.l[0] = add ? NET_WM_STATE_ADD : NET_WM_STATE_REMOVE;
+    event.xclient.data.l[1] = static_cast<long>(state);
+    event.xclient.data.l[2] = 0;
+    event.xclient.data.l[3] = 1; // Normal application
+    XSendEvent(display, root, False, SubstructureRedirectMask | SubstructureNotifyMask, &event);
+}
+
+void OverlayBackendX11::set_decorations(bool decorated) {
+    if (decorated) {
+        XDeleteProperty(display, window, atom_motif_wm_hints);
+        return;
+    }
+    MotifWmHints hints = {};
+    hints.flags = MWM_HINTS_DECORATIONS;
+    hints.decorations = 0;
+    XChangeProperty(display, window, atom_motif_wm_hints, atom_motif_wm_hints, 32, PropModeReplace,
+            reinterpret_cast<unsigned char *>(&hints), 5);
+}
+
+void OverlayBackendX11::set_opacity(bool visible, uint8_t alpha) {
+    // The compositor applies _NET_WM_WINDOW_OPACITY, no need to unmap
+    if (visible && alpha == 255) {
+        XDeleteProperty(display, window, atom_net_wm_window_opacity);
+        return;
+    }
+    unsigned long opacity = visible ? static_cast<unsigned long>(alpha) * 0x01010101UL : 0;
+    XChangeProperty(display, window, atom_net_wm_window_opacity, XA_CARDINAL, 32, PropModeReplace,
+            reinterpret_cast<unsigned char *>(&opacity), 1);
+}
+
+bool OverlayBackendX11::set_window_alpha(uint8_t alpha) {
+    if (!fade_display) {
+        if (!is_attached()) {
+            return false;
+        }
+        count_native_calls();
+        fade_display = XOpenDisplay(display_name.c_str());
+        if (!fade_display) {
+            count_native_failure();
+            OVERLAY_LOG_ERROR("Failed to open an X11 connection for fading.\n");
+            return false;
+        }
+    }
+
+    // Atoms are the same on every connection. Fades only run while visible.
+    unsigned long opacity = static_cast<unsigned long>(alpha) * 0x01010101UL;
+    XChangeProperty(fade_display, window, atom_net_wm_window_opacity, XA_CARDINAL, 32, PropModeReplace,
+            reinterpret_cast<unsigned char *>(&opacity), 1);
+    // Processed before returning, so an alpha or unmap the main connection sends after a
+    // cancelled fade is never overtaken by the fade's last step
+    XSync(fade_display, False);
+    count_native_calls(2);
+    return true;
+}
+
+uint32_t OverlayBackendX11::apply_changes(const OverlayState &state, uint32_t changed) {
+    uint32_t applied = 0;
+    uint64_t requests = 0;
+
+    // Remove borders and keep above other windows.
+    // override_redirect is not used: it only takes effect after an unmap/map cycle.
+    if (changed & OVERLAY_STATE_BORDERLESS) {
+        set_decorations(!state.borderless);
+        applied |= OVERLAY_STATE_BORDERLESS;
+        requests++;
+    }
+    if (changed & OVERLAY_STATE_TOPMOST) {
+        send_wm_state(state.topmost, atom_net_wm_state_above);
+        applied |= OVERLAY_STATE_TOPMOST;
+        requests++;
+    }
+
+    // The background is transparent through the ARGB visual, there is no color key.
+    // The compositor already blends the rendered alpha, per-pixel alpha needs no conversion.
+    const uint32_t transparency_fields = OVERLAY_STATE_LAYERED | OVERLAY_STATE_COLOR_KEY | OVERLAY_STATE_PER_PIXEL_ALPHA;
+    if (changed & transparency_fields) {
+        if (state.layered && !has_argb_visual) {
+            OVERLAY_LOG_WARNING("Transparent background needs an ARGB visual.\n");
+        }
+        applied |= changed & transparency_fields;
+    }
+
+    // An empty input region lets every pointer event fall through to the window below.
+    // Without XFixes this was reported on attach, the field is recorded as applied.
+    if (changed & OVERLAY_STATE_PASSTHROUGH) {
+        applied |= OVERLAY_STATE_PASSTHROUGH;
+        if (has_xfixes) {
+            if (state.passthrough) {
+                XserverRegion region = XFixesCreateRegion(display, nullptr, 0);
+                XFixesSetWindowShapeRegion(display, window, ShapeInput, 0, 0, region);
+                XFixesDestroyRegion(display, region);
+                requests += 3;
+            } else {
+                // None restores the default input shape (the whole window)
+                XFixesSetWindowShapeRegion(display, window, ShapeInput, 0, 0, None);
+                requests++;
+            }
+        }
+    }
+
+    if (changed & (OVERLAY_STATE_ALPHA | OVERLAY_STATE_VISIBLE)) {
+        set_opacity(state.visible, state.alpha);
+        applied |= changed & (OVERLAY_STATE_ALPHA | OVERLAY_STATE_VISIBLE);
+        requests++;
+    }
+
+    if (requests > 0) {
+        XFlush(display);
+        count_native_calls(requests + 1);
+    }
+
+    OVERLAY_LOG_VERBOSE("Window state applied: changed 0x%x, failed 0x%x.\n", changed, changed & ~applied);
+    return applied;
+}
+
+bool OverlayBackendX11::set_input_region(const std::vector<RegionRect> &rects) {
+    if (!is_attached() || !has_xfixes) {
+        return false;
+    }
+
+    // The rectangles are already coalesced, hand them to the server as one region
+    std::vector<XRectangle> xrects;
+    xrects.reserve(rects.size());
+    for (const RegionRect &rect : rects) {
+        XRectangle xrect;
+        xrect.x = static_cast<short>(rect.x);
+        xrect.y = static_cast<short>(rect.y);
+        xrect.width = static_cast<unsigned short>(rect.width);
+        xrect.height = static_cast<unsigned short>(rect.height);
+        xrects.push_back(xrect);
+    }
+    XserverRegion region = XFixesCreateRegion(display, xrects.data(), static_cast<int>(xrects.size()));
+    XFixesSetWindowShapeRegion(display, window, ShapeInput, 0, 0, region);
+    XFixesDestroyRegion(display, region);
+    XFlush(display);
+    count_native_calls(4);
+
+    OVERLAY_LOG_VERBOSE("Input region set to %d rectangles.\n", static_cast<int>(xrects.size()));
+    return true;
+}
+
+bool OverlayBackendX11::get_client_origin(int32_t &r_x, int32_t &r_y) const {
+    if (!is_attached()) {
+        return false;
+    }
+
+    // Reparenting window managers move the window inside a frame, ask the server
+    int x = 0;
+    int y = 0;
+    ::Window child = 0;
+    if (!XTranslateCoordinates(display, window, root, 0, 0, &x, &y, &child)) {
+        return false;
+    }
+    r_x = x;
+    r_y = y;
+    return true;
+}
+
+bool OverlayBackendX11::focus_window() {
+    if (!is_attached()) {
+        return false;
+    }
+
+    // Ask the window manager to activate the window (source indication 2: pager)
+    XEvent event = {};
+    event.xclient.type = ClientMessage;
+    event.xclient.window = window;
+    event.xclient.message_type = atom_net_active_window;
+    event.xclient.format = 32;
+    event.xclient.data.l[0] = 2;
+    event.xclient.data.l[1] = CurrentTime;
+    XSendEvent(display, root, False, SubstructureRedirectMask | SubstructureNotifyMask, &event);
+    XFlush(display);
+    count_native_calls(2);
+
+    OVERLAY_LOG_INFO("Window focused.\n");
+    return true;
+}
+
+bool OverlayBackendX11::is_window_focused() const {
+    if (!is_attached()) {
+        return false;
+    }
+
+    Atom actual_type = None;
+    int actual_format = 0;
+    unsigned long item_count = 0;
+    unsigned long bytes_after = 0;
+    unsigned char *data = nullptr;
+    bool focused = false;
+    if (XGetWindowProperty(display, root, atom_net_active_window, 0, 1, False, XA_WINDOW, &actual_type,
+                &actual_format, &item_count, &bytes_after, &data) == Success) {
+        if (data && item_count == 1) {
+            focused = *reinterpret_cast<::Window *>(data) == window;
+        }
+    }
+    if (data) {
+        XFree(data);
+    }
+    return focused;
+}
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
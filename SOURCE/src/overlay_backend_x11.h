@@ -0,0 +1,72 @@
+#ifndef OVERLAY_BACKEND_X11_H
+#define OVERLAY_BACKEND_X11_H
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "overlay_backend.h"
+
+#include <string>
+
+// Xlib is kept out of this header, its macros clash with Godot names
+struct _XDisplay;
+
+namespace godot {
+
+// X11 backend: EWMH state for always-on-top, Motif hints for borderless,
+// an empty XFixes input region for passthrough. Transparency needs the ARGB
+// visual Godot picks when per-pixel transparency is allowed. Every state
+// change is queued on the connection and sent with a single XFlush.
+class OverlayBackendX11 : public OverlayBackend {
+public:
+    ~OverlayBackendX11() override;
+
+    bool attach(int64_t native_window, int64_t native_display, const char *title) override;
+    bool is_attached() const override;
+
+    bool set_input_region(const std::vector<RegionRect> &rects) override;
+
+    bool get_client_origin(int32_t &r_x, int32_t &r_y) const override;
+
+    bool set_window_alpha(uint8_t alpha) override;
+
+    bool focus_window() override;
+    bool is_window_focused() const override;
+
+    const char *get_name() const override {
+        return "X11";
+    }
+
+protected:
+    uint32_t apply_changes(const OverlayState &state, uint32_t changed) override;
+
+private:
+    // Godot's own connection, only used from the main thread
+    _XDisplay *display = nullptr;
+    unsigned long window = 0;
+    unsigned long root = 0;
+
+    // Connection of the fade thread, opened on its first step. Xlib connections are
+    // not shared between threads, the opacity property is set through this one.
+    std::string display_name;
+    _XDisplay *fade_display = nullptr;
+
+    bool has_argb_visual = false;
+    bool has_xfixes = false;
+
+    // Atoms interned once on attach
+    unsigned long atom_net_wm_state = 0;
+    unsigned long atom_net_wm_state_above = 0;
+    unsigned long atom_net_active_window = 0;
+    unsigned long atom_net_wm_window_opacity = 0;
+    unsigned long atom_motif_wm_hints = 0;
+
+    void send_wm_state(bool add, unsigned long state);
+    void set_decorations(bool decorated);
+    void set_opacity(bool visible, uint8_t alpha);
+};
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
+
+#endif // OVERLAY_BACKEND_X11_H
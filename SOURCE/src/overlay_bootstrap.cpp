@@ -0,0 +1,145 @@
+#include "overlay_bootstrap.h"
+
+#include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include "core/overlay_log.h"
+#include "core/overlay_state_machine.h"
+
+namespace godot {
+
+namespace {
+
+const char *const SETTING_ENABLED = "godoverit/bootstrap/enabled";
+const char *const SETTING_PASSTHROUGH = "godoverit/bootstrap/passthrough";
+const char *const SETTING_VISIBLE = "godoverit/bootstrap/visible";
+const char *const SETTING_PER_PIXEL_ALPHA = "godoverit/bootstrap/per_pixel_alpha";
+
+void add_setting(ProjectSettings *settings, const String &name, const Variant &default_value) {
+    if (!settings->has_setting(name)) {
+        settings->set_setting(name, default_value);
+    }
+    settings->set_initial_value(name, default_value);
+    Dictionary info;
+    info["name"] = name;
+    info["type"] = default_value.get_type();
+    settings->add_property_info(info);
+}
+
+} // namespace
+
+StartupTimeline OverlayBootstrap::timeline;
+std::unique_ptr<OverlayBackend> OverlayBootstrap::backend;
+OverlayState OverlayBootstrap::state;
+uint64_t OverlayBootstrap::native_window = 0;
+bool OverlayBootstrap::bootstrapped = false;
+uint64_t OverlayBootstrap::native_calls = 0;
+
+void OverlayBootstrap::initialize() {
+    timeline.mark(StartupTimeline::STAGE_SCENE_INIT);
+    register_settings();
+
+    // The first drawn frame closes the timeline, whether or not the bootstrap ran
+    RenderingServer *rendering_server = RenderingServer::get_singleton();
+    if (rendering_server) {
+        rendering_server->connect("frame_post_draw", callable_mp_static(&OverlayBootstrap::_on_frame_post_draw), Object::CONNECT_ONE_SHOT);
+    }
+
+    // The editor is never turned into an overlay
+    if (!Engine::get_singleton()->is_editor_hint() && (bool)ProjectSettings::get_singleton()->get_setting(SETTING_ENABLED, false)) {
+        apply_from_settings();
+    }
+}
+
+void OverlayBootstrap::uninitialize() {
+    RenderingServer *rendering_server = RenderingServer::get_singleton();
+    Callable callable = callable_mp_static(&OverlayBootstrap::_on_frame_post_draw);
+    if (rendering_server && rendering_server->is_connected("frame_post_draw", callable)) {
+        rendering_server->disconnect("frame_post_draw", callable);
+    }
+    backend.reset();
+}
+
+void OverlayBootstrap::register_settings() {
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    add_setting(settings, SETTING_ENABLED, false);
+    add_setting(settings, SETTING_PASSTHROUGH, true);
+    add_setting(settings, SETTING_VISIBLE, true);
+    add_setting(settings, SETTING_PER_PIXEL_ALPHA, false);
+}
+
+void OverlayBootstrap::apply_from_settings() {
+    // Headless and unsupported display servers have no native window to shape
+    DisplayServer *display_server = DisplayServer::get_singleton();
+    std::unique_ptr<OverlayBackend> created = OverlayBackend::create();
+    if (!display_server || !created) {
+        OVERLAY_LOG_WARNING("Overlay bootstrap skipped, no backend for this display server.\n");
+        return;
+    }
+
+    // The main window already exists at this level, its handle is asked for directly
+    int64_t window = display_server->window_get_native_handle(DisplayServer::WINDOW_HANDLE, DisplayServer::MAIN_WINDOW_ID);
+    int64_t display = display_server->window_get_native_handle(DisplayServer::DISPLAY_HANDLE, DisplayServer::MAIN_WINDOW_ID);
+    if (window == 0 || !created->attach(window, display, "")) {
+        OVERLAY_LOG_ERROR("Overlay bootstrap could not attach to the main window.\n");
+        return;
+    }
+    timeline.mark(StartupTimeline::STAGE_WINDOW_RESOLVE);
+
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    OverlayStateMachine machine;
+    machine.enable();
+    machine.set_passthrough(settings->get_setting(SETTING_PASSTHROUGH, true));
+    machine.set_visible(settings->get_setting(SETTING_VISIBLE, true));
+    OverlayState values;
+    values.per_pixel_alpha = settings->get_setting(SETTING_PER_PIXEL_ALPHA, false);
+    machine.merge(values, OVERLAY_STATE_PER_PIXEL_ALPHA);
+
+    created->apply_state(machine.get_desired());
+    timeline.mark(StartupTimeline::STAGE_STYLE_APPLY);
+    uint32_t failed = diff_overlay_state(created->get_applied_state(), machine.get_desired());
+    if (failed) {
+        OVERLAY_LOG_WARNING("Overlay bootstrap could not apply some window state (0x%x).\n", failed);
+    }
+
+    state = machine.get_desired();
+    native_window = static_cast<uint64_t>(window);
+    native_calls = created->get_native_call_count();
+    backend = std::move(created);
+    bootstrapped = true;
+    OVERLAY_LOG_VERBOSE("Overlay bootstrapped before the first frame with %llu native calls.\n", (unsigned long long)native_calls);
+}
+
+std::unique_ptr<OverlayBackend> OverlayBootstrap::take_backend(OverlayState &r_state, uint64_t &r_native_window) {
+    if (backend) {
+        r_state = state;
+        r_native_window = native_window;
+    }
+    return std::move(backend);
+}
+
+void OverlayBootstrap::return_backend(std::unique_ptr<OverlayBackend> p_backend, const OverlayState &p_state, uint64_t p_native_window) {
+    backend = std::move(p_backend);
+    state = p_state;
+    native_window = p_native_window;
+}
+
+void OverlayBootstrap::_on_frame_post_draw() {
+    timeline.mark(StartupTimeline::STAGE_FIRST_FRAME);
+}
+
+Dictionary OverlayBootstrap::get_timeline_dictionary() {
+    Dictionary result;
+    for (int i = 0; i < StartupTimeline::STAGE_COUNT; i++) {
+        StartupTimeline::Stage stage = static_cast<StartupTimeline::Stage>(i);
+        result[String(StartupTimeline::get_stage_name(stage)) + "_usec"] = timeline.get_offset_usec(stage);
+    }
+    result["bootstrapped"] = bootstrapped;
+    result["bootstrap_native_calls"] = (int64_t)native_calls;
+    return result;
+}
+
+} // namespace godot
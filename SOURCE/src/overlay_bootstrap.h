@@ -0,0 +1,53 @@
+#ifndef OVERLAY_BOOTSTRAP_H
+#define OVERLAY_BOOTSTRAP_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <memory>
+
+#include "core/overlay_state.h"
+#include "core/startup_timeline.h"
+#include "overlay_backend.h"
+
+namespace godot {
+
+// Makes the main window an overlay during scene level module initialization, before
+// the first frame is drawn, when godoverit/bootstrap/enabled is set. The window Godot
+// just created is attached through its native handle and the state from the project
+// settings is applied in one batch. The first Overlay driving the main window adopts
+// the attached backend, so nothing is applied twice and the window never flashes.
+class OverlayBootstrap {
+public:
+    // Called from the module initializer and terminator
+    static void initialize();
+    static void uninitialize();
+
+    // Backend attached to the main window with the state it is in, null when there is none.
+    // Ownership moves to the caller, later calls return null.
+    static std::unique_ptr<OverlayBackend> take_backend(OverlayState &r_state, uint64_t &r_native_window);
+
+    // Hand the backend back when its Overlay stops driving the main window, the
+    // window stays as it is for the next Overlay
+    static void return_backend(std::unique_ptr<OverlayBackend> p_backend, const OverlayState &p_state, uint64_t p_native_window);
+
+    static StartupTimeline &get_timeline() {
+        return timeline;
+    }
+    static Dictionary get_timeline_dictionary();
+
+private:
+    static StartupTimeline timeline;
+    static std::unique_ptr<OverlayBackend> backend;
+    static OverlayState state;
+    static uint64_t native_window;
+    static bool bootstrapped;
+    static uint64_t native_calls; // Spent by the bootstrap, for the timeline
+
+    static void register_settings();
+    static void apply_from_settings();
+    static void _on_frame_post_draw();
+};
+
+} // namespace godot
+
+#endif // OVERLAY_BOOTSTRAP_H
@@ -0,0 +1,404 @@
+#include "overlay_node.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/input_map.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+
+namespace godot {
+
+namespace {
+
+const char *const ACTION_TOGGLE_INPUT = "overlay_toggle_input";
+const char *const ACTION_TOGGLE_VISIBILITY = "overlay_toggle_visibility";
+
+// Overlay signals the node re-emits, with their argument counts
+struct ForwardedSignal {
+    const char *name;
+    int arguments;
+};
+
+const ForwardedSignal FORWARDED_SIGNALS[] = {
+    { "keybind_pressed", 1 },
+    { "keybind_scrolled", 2 },
+    { "gesture_recognized", 1 },
+    { "gesture_released", 1 },
+    { "fade_finished", 1 },
+    { "target_found", 1 },
+    { "target_lost", 0 },
+    { "target_rect_changed", 1 },
+    { "target_visibility_changed", 2 },
+    { "focus_changed", 2 },
+    { "pacing_mode_changed", 1 },
+};
+
+Ref<InputEventKey> make_key_event(Key keycode) {
+    Ref<InputEventKey> event;
+    event.instantiate();
+    event->set_keycode(keycode);
+    event->set_ctrl_pressed(true);
+    event->set_pressed(true);
+    return event;
+}
+
+Ref<InputEventKey> find_key_event(const Array &events) {
+    for (int64_t i = 0; i < events.size(); i++) {
+        Ref<InputEventKey> key = events[i];
+        if (key.is_valid()) {
+            return key;
+        }
+    }
+    return Ref<InputEventKey>();
+}
+
+Ref<InputEventKey> find_action_key(const StringName &action) {
+    InputMap *input_map = InputMap::get_singleton();
+    if (!input_map->has_action(action)) {
+        return Ref<InputEventKey>();
+    }
+    return find_key_event(input_map->action_get_events(action));
+}
+
+// Same key as far as the keybind table is concerned
+bool is_same_key(const Ref<InputEventKey> &a, const Ref<InputEventKey> &b) {
+    if (a.is_null() || b.is_null()) {
+        return a.is_null() == b.is_null();
+    }
+    return a->get_keycode() == b->get_keycode() && a->get_physical_keycode() == b->get_physical_keycode() &&
+            a->is_ctrl_pressed() == b->is_ctrl_pressed() && a->is_shift_pressed() == b->is_shift_pressed() &&
+            a->is_alt_pressed() == b->is_alt_pressed() && a->is_meta_pressed() == b->is_meta_pressed();
+}
+
+} // namespace
+
+OverlayNode::OverlayNode() {
+}
+
+OverlayNode::~OverlayNode() {
+    destroy_overlay();
+}
+
+void OverlayNode::_notification(int p_what) {
+    switch (p_what) {
+        case NOTIFICATION_ENTER_TREE:
+            // The editor shows the node, only the running project gets an overlay
+            if (!Engine::get_singleton()->is_editor_hint()) {
+                create_overlay();
+            }
+            break;
+        case NOTIFICATION_INTERNAL_PROCESS:
+            // Nothing to do in a quiet frame is a few atomic loads in Overlay::process
+            overlay->process(get_process_delta_time());
+            break;
+        case NOTIFICATION_EXIT_TREE:
+            destroy_overlay();
+            break;
+        default:
+            break;
+    }
+}
+
+void OverlayNode::create_overlay() {
+    if (overlay) {
+        return;
+    }
+
+    // Keybinds are compiled once here, afterwards only when the project settings change one
+    reload_keybinds();
+    overlay = memnew(Overlay);
+    for (const ForwardedSignal &forwarded : FORWARDED_SIGNALS) {
+        StringName name = forwarded.name;
+        switch (forwarded.arguments) {
+            case 0:
+                overlay->connect(name, callable_mp(this, &OverlayNode::_forward_signal_0).bind(name));
+                break;
+            case 1:
+                overlay->connect(name, callable_mp(this, &OverlayNode::_forward_signal_1).bind(name));
+                break;
+            default:
+                overlay->connect(name, callable_mp(this, &OverlayNode::_forward_signal_2).bind(name));
+                break;
+        }
+    }
+
+    overlay->set_passthrough_mode(passthrough_mode);
+    overlay->set_use_physical_keycodes(use_physical_keycodes);
+    overlay->set_frame_pacing_enabled(frame_pacing_enabled);
+    overlay->set_idle_frame_rate(idle_frame_rate);
+    if (opacity < 1.0) {
+        overlay->set_opacity(opacity);
+    }
+    overlay->set_input_keybind(input_keybind);
+    overlay->set_visibility_keybind(visibility_keybind);
+    ProjectSettings::get_singleton()->connect("settings_changed", callable_mp(this, &OverlayNode::_on_settings_changed));
+
+    if (enable_on_ready) {
+        overlay->enable_overlay();
+    }
+    set_process_internal(true);
+}
+
+void OverlayNode::destroy_overlay() {
+    if (!overlay) {
+        return;
+    }
+    set_process_internal(false);
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    Callable on_settings_changed = callable_mp(this, &OverlayNode::_on_settings_changed);
+    if (settings && settings->is_connected("settings_changed", on_settings_changed)) {
+        settings->disconnect("settings_changed", on_settings_changed);
+    }
+
+    // The window goes back to a normal one when the node leaves, the overlay is freed
+    // right away since nothing queued can still call into it
+    overlay->disable_overlay();
+    memdelete(overlay);
+    overlay = nullptr;
+}
+
+Overlay *OverlayNode::get_overlay() const {
+    return overlay;
+}
+
+void OverlayNode::set_enable_on_ready(bool enabled) {
+    enable_on_ready = enabled;
+}
+
+bool OverlayNode::get_enable_on_ready() const {
+    return enable_on_ready;
+}
+
+void OverlayNode::set_passthrough_mode(Overlay::PassthroughMode mode) {
+    passthrough_mode = mode;
+    if (overlay) {
+        overlay->set_passthrough_mode(mode);
+    }
+}
+
+Overlay::PassthroughMode OverlayNode::get_passthrough_mode() const {
+    return overlay ? overlay->get_passthrough_mode() : passthrough_mode;
+}
+
+void OverlayNode::set_use_physical_keycodes(bool enabled) {
+    use_physical_keycodes = enabled;
+    if (overlay) {
+        overlay->set_use_physical_keycodes(enabled);
+    }
+}
+
+bool OverlayNode::get_use_physical_keycodes() const {
+    return use_physical_keycodes;
+}
+
+void OverlayNode::set_frame_pacing_enabled(bool enabled) {
+    frame_pacing_enabled = enabled;
+    if (overlay) {
+        overlay->set_frame_pacing_enabled(enabled);
+    }
+}
+
+bool OverlayNode::get_frame_pacing_enabled() const {
+    return frame_pacing_enabled;
+}
+
+void OverlayNode::set_idle_frame_rate(int fps) {
+    idle_frame_rate = MAX(fps, 1);
+    if (overlay) {
+        overlay->set_idle_frame_rate(idle_frame_rate);
+    }
+}
+
+int OverlayNode::get_idle_frame_rate() const {
+    return idle_frame_rate;
+}
+
+void OverlayNode::set_opacity(double p_opacity) {
+    opacity = CLAMP(p_opacity, 0.0, 1.0);
+    if (overlay) {
+        overlay->set_opacity(opacity);
+    }
+}
+
+double OverlayNode::get_opacity() const {
+    return overlay ? overlay->get_opacity() : opacity;
+}
+
+void OverlayNode::enable_overlay() {
+    if (overlay) {
+        overlay->enable_overlay();
+    }
+}
+
+void OverlayNode::disable_overlay() {
+    if (overlay) {
+        overlay->disable_overlay();
+    }
+}
+
+void OverlayNode::enable_input_passthrough() {
+    if (overlay) {
+        overlay->enable_input_passthrough();
+    }
+}
+
+void OverlayNode::disable_input_passthrough() {
+    if (overlay) {
+        overlay->disable_input_passthrough();
+    }
+}
+
+void OverlayNode::enable_visibility() {
+    if (overlay) {
+        overlay->enable_visibility();
+    }
+}
+
+void OverlayNode::disable_visibility() {
+    if (overlay) {
+        overlay->disable_visibility();
+    }
+}
+
+bool OverlayNode::is_overlay_enabled() const {
+    return overlay && overlay->get_is_overlay_enabled();
+}
+
+bool OverlayNode::is_input_enabled() const {
+    return overlay && overlay->get_is_input_passthrough_enabled();
+}
+
+bool OverlayNode::is_visibility_enabled() const {
+    return overlay && overlay->get_is_visibility_enabled();
+}
+
+bool OverlayNode::reload_keybinds() {
+    Ref<InputEventKey> input = find_action_key(ACTION_TOGGLE_INPUT);
+    if (input.is_null()) {
+        input = make_key_event(KEY_F1);
+    }
+    Ref<InputEventKey> visibility = find_action_key(ACTION_TOGGLE_VISIBILITY);
+    if (visibility.is_null()) {
+        visibility = make_key_event(KEY_F2);
+    }
+
+    // Each setter recompiles the overlay's table, an unchanged key is not passed on
+    bool changed = false;
+    if (!is_same_key(input, input_keybind)) {
+        input_keybind = input;
+        if (overlay) {
+            overlay->set_input_keybind(input_keybind);
+        }
+        changed = true;
+    }
+    if (!is_same_key(visibility, visibility_keybind)) {
+        visibility_keybind = visibility;
+        if (overlay) {
+            overlay->set_visibility_keybind(visibility_keybind);
+        }
+        changed = true;
+    }
+    keybind_updates += changed;
+    return changed;
+}
+
+int OverlayNode::get_keybind_update_count() const {
+    return keybind_updates;
+}
+
+void OverlayNode::sync_action_from_settings(const StringName &action) {
+    // input/<action> is what the editor and the plugin persist; the running InputMap only
+    // loads it at startup, so a changed entry is carried over for the focused path too
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    String path = String("input/") + String(action);
+    if (!settings->has_setting(path)) {
+        return;
+    }
+    Dictionary entry = settings->get_setting(path);
+    Array events = entry.get("events", Array());
+    Ref<InputEventKey> key = find_key_event(events);
+    if (key.is_null() || is_same_key(key, find_action_key(action))) {
+        return;
+    }
+    InputMap *input_map = InputMap::get_singleton();
+    if (!input_map->has_action(action)) {
+        input_map->add_action(action, entry.get("deadzone", 0.5));
+    }
+    input_map->action_erase_events(action);
+    for (int64_t i = 0; i < events.size(); i++) {
+        Ref<InputEvent> event = events[i];
+        if (event.is_valid()) {
+            input_map->action_add_event(action, event);
+        }
+    }
+}
+
+void OverlayNode::_on_settings_changed() {
+    // Emitted at most once a frame for any setting, most are not keybinds
+    sync_action_from_settings(ACTION_TOGGLE_INPUT);
+    sync_action_from_settings(ACTION_TOGGLE_VISIBILITY);
+    if (reload_keybinds()) {
+        OVERLAY_LOG_VERBOSE("Overlay keybinds changed in the project settings.\n");
+    }
+}
+
+void OverlayNode::_forward_signal_0(const StringName &signal) {
+    emit_signal(signal);
+}
+
+void OverlayNode::_forward_signal_1(const Variant &arg1, const StringName &signal) {
+    emit_signal(signal, arg1);
+}
+
+void OverlayNode::_forward_signal_2(const Variant &arg1, const Variant &arg2, const StringName &signal) {
+    emit_signal(signal, arg1, arg2);
+}
+
+void OverlayNode::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_overlay"), &OverlayNode::get_overlay);
+    ClassDB::bind_method(D_METHOD("set_enable_on_ready", "enabled"), &OverlayNode::set_enable_on_ready);
+    ClassDB::bind_method(D_METHOD("get_enable_on_ready"), &OverlayNode::get_enable_on_ready);
+    ClassDB::bind_method(D_METHOD("set_passthrough_mode", "mode"), &OverlayNode::set_passthrough_mode);
+    ClassDB::bind_method(D_METHOD("get_passthrough_mode"), &OverlayNode::get_passthrough_mode);
+    ClassDB::bind_method(D_METHOD("set_use_physical_keycodes", "enabled"), &OverlayNode::set_use_physical_keycodes);
+    ClassDB::bind_method(D_METHOD("get_use_physical_keycodes"), &OverlayNode::get_use_physical_keycodes);
+    ClassDB::bind_method(D_METHOD("set_frame_pacing_enabled", "enabled"), &OverlayNode::set_frame_pacing_enabled);
+    ClassDB::bind_method(D_METHOD("get_frame_pacing_enabled"), &OverlayNode::get_frame_pacing_enabled);
+    ClassDB::bind_method(D_METHOD("set_idle_frame_rate", "fps"), &OverlayNode::set_idle_frame_rate);
+    ClassDB::bind_method(D_METHOD("get_idle_frame_rate"), &OverlayNode::get_idle_frame_rate);
+    ClassDB::bind_method(D_METHOD("set_opacity", "opacity"), &OverlayNode::set_opacity);
+    ClassDB::bind_method(D_METHOD("get_opacity"), &OverlayNode::get_opacity);
+
+    ClassDB::bind_method(D_METHOD("enable_overlay"), &OverlayNode::enable_overlay);
+    ClassDB::bind_method(D_METHOD("disable_overlay"), &OverlayNode::disable_overlay);
+    ClassDB::bind_method(D_METHOD("enable_input_passthrough"), &OverlayNode::enable_input_passthrough);
+    ClassDB::bind_method(D_METHOD("disable_input_passthrough"), &OverlayNode::disable_input_passthrough);
+    ClassDB::bind_method(D_METHOD("enable_visibility"), &OverlayNode::enable_visibility);
+    ClassDB::bind_method(D_METHOD("disable_visibility"), &OverlayNode::disable_visibility);
+    ClassDB::bind_method(D_METHOD("is_overlay_enabled"), &OverlayNode::is_overlay_enabled);
+    ClassDB::bind_method(D_METHOD("is_input_enabled"), &OverlayNode::is_input_enabled);
+    ClassDB::bind_method(D_METHOD("is_visibility_enabled"), &OverlayNode::is_visibility_enabled);
+    ClassDB::bind_method(D_METHOD("reload_keybinds"), &OverlayNode::reload_keybinds);
+    ClassDB::bind_method(D_METHOD("get_keybind_update_count"), &OverlayNode::get_keybind_update_count);
+
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "overlay", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE, "Overlay"), "", "get_overlay");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "enable_on_ready"), "set_enable_on_ready", "get_enable_on_ready");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "passthrough_mode", PROPERTY_HINT_ENUM, "Full,Regions"), "set_passthrough_mode", "get_passthrough_mode");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_physical_keycodes"), "set_use_physical_keycodes", "get_use_physical_keycodes");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "frame_pacing_enabled"), "set_frame_pacing_enabled", "get_frame_pacing_enabled");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "idle_frame_rate", PROPERTY_HINT_RANGE, "1,240,1"), "set_idle_frame_rate", "get_idle_frame_rate");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "opacity", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_opacity", "get_opacity");
+
+    // Same signals as Overlay, emitted by the node
+    ADD_SIGNAL(MethodInfo("keybind_pressed", PropertyInfo(Variant::STRING_NAME, "action")));
+    ADD_SIGNAL(MethodInfo("keybind_scrolled", PropertyInfo(Variant::STRING_NAME, "action"), PropertyInfo(Variant::FLOAT, "notches")));
+    ADD_SIGNAL(MethodInfo("gesture_recognized", PropertyInfo(Variant::STRING_NAME, "action")));
+    ADD_SIGNAL(MethodInfo("gesture_released", PropertyInfo(Variant::STRING_NAME, "action")));
+    ADD_SIGNAL(MethodInfo("fade_finished", PropertyInfo(Variant::FLOAT, "opacity")));
+    ADD_SIGNAL(MethodInfo("target_found", PropertyInfo(Variant::DICTIONARY, "state")));
+    ADD_SIGNAL(MethodInfo("target_lost"));
+    ADD_SIGNAL(MethodInfo("target_rect_changed", PropertyInfo(Variant::RECT2I, "rect")));
+    ADD_SIGNAL(MethodInfo("target_visibility_changed", PropertyInfo(Variant::BOOL, "minimized"), PropertyInfo(Variant::BOOL, "occluded")));
+    ADD_SIGNAL(MethodInfo("focus_changed", PropertyInfo(Variant::BOOL, "godot_focused"), PropertyInfo(Variant::DICTIONARY, "app")));
+    ADD_SIGNAL(MethodInfo("pacing_mode_changed", PropertyInfo(Variant::INT, "mode")));
+}
+
+} // namespace godot
@@ -0,0 +1,88 @@
+#ifndef OVERLAY_NODE_H
+#define OVERLAY_NODE_H
+
+#include <godot_cpp/classes/input_event_key.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+
+#include "overlay.h"
+
+namespace godot {
+
+// Scene node owning an Overlay for the time it is in the tree. The overlay is processed
+// from the node's internal process notification, so no script runs per frame, and its
+// signals are re-emitted by the node. The toggle keybinds come from the
+// overlay_toggle_input and overlay_toggle_visibility InputMap actions, Ctrl+F1 and
+// Ctrl+F2 when missing. They are read again when ProjectSettings reports a change and
+// recompiled only if a key actually differs; call reload_keybinds after remapping the
+// InputMap from code. Everything else is reached through the overlay property.
+class OverlayNode : public Node {
+    GDCLASS(OverlayNode, Node);
+
+protected:
+    static void _bind_methods();
+    void _notification(int p_what);
+
+public:
+    OverlayNode();
+    ~OverlayNode();
+
+    // Null outside the tree and in the editor
+    Overlay *get_overlay() const;
+
+    // Applied when the overlay is created and forwarded while it exists
+    void set_enable_on_ready(bool enabled);
+    bool get_enable_on_ready() const;
+    void set_passthrough_mode(Overlay::PassthroughMode mode);
+    Overlay::PassthroughMode get_passthrough_mode() const;
+    void set_use_physical_keycodes(bool enabled);
+    bool get_use_physical_keycodes() const;
+    void set_frame_pacing_enabled(bool enabled);
+    bool get_frame_pacing_enabled() const;
+    void set_idle_frame_rate(int fps);
+    int get_idle_frame_rate() const;
+    void set_opacity(double opacity);
+    double get_opacity() const;
+
+    void enable_overlay();
+    void disable_overlay();
+    void enable_input_passthrough();
+    void disable_input_passthrough();
+    void enable_visibility();
+    void disable_visibility();
+    bool is_overlay_enabled() const;
+    bool is_input_enabled() const;
+    bool is_visibility_enabled() const;
+
+    // Read the toggle actions from the InputMap, returns whether a keybind changed
+    bool reload_keybinds();
+    // Keybind changes applied to the overlay so far, unchanged reloads are not counted
+    int get_keybind_update_count() const;
+
+private:
+    Overlay *overlay = nullptr;
+    Ref<InputEventKey> input_keybind;
+    Ref<InputEventKey> visibility_keybind;
+    int keybind_updates = 0;
+
+    bool enable_on_ready = false;
+    Overlay::PassthroughMode passthrough_mode = Overlay::PASSTHROUGH_MODE_FULL;
+    bool use_physical_keycodes = false;
+    bool frame_pacing_enabled = true;
+    int idle_frame_rate = 10;
+    double opacity = 1.0;
+
+    void create_overlay();
+    void destroy_overlay();
+    void sync_action_from_settings(const StringName &action);
+    void _on_settings_changed();
+
+    // Overlay signals re-emitted by the node, the signal name is bound last
+    void _forward_signal_0(const StringName &signal);
+    void _forward_signal_1(const Variant &arg1, const StringName &signal);
+    void _forward_signal_2(const Variant &arg1, const Variant &arg2, const StringName &signal);
+};
+
+} // namespace godot
+
+#endif // OVERLAY_NODE_H
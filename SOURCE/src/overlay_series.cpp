@@ -0,0 +1,177 @@
+#include "overlay_series.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+#include "core/overlay_log.h"
+
+namespace godot {
+
+OverlaySeries::Series *OverlaySeries::get_series(int id) const {
+    if (id < 0 || id >= (int)series.size()) {
+        return nullptr;
+    }
+    return series[id].get();
+}
+
+int OverlaySeries::add_series(const StringName &name, int capacity) {
+    int existing = find_series(name);
+    if (existing >= 0) {
+        return existing;
+    }
+    if (capacity <= 0) {
+        OVERLAY_LOG_ERROR("Series capacity must be positive.\n");
+        return -1;
+    }
+
+    // Removed slots are reused so ids stay small
+    std::unique_ptr<Series> entry(new Series(name, static_cast<size_t>(capacity)));
+    for (size_t i = 0; i < series.size(); i++) {
+        if (!series[i]) {
+            series[i] = std::move(entry);
+            return (int)i;
+        }
+    }
+    series.push_back(std::move(entry));
+    return (int)series.size() - 1;
+}
+
+void OverlaySeries::remove_series(int id) {
+    if (get_series(id)) {
+        series[id].reset();
+    }
+}
+
+int OverlaySeries::find_series(const StringName &name) const {
+    for (size_t i = 0; i < series.size(); i++) {
+        if (series[i] && series[i]->name == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+PackedStringArray OverlaySeries::get_series_names() const {
+    PackedStringArray names;
+    for (const std::unique_ptr<Series> &entry : series) {
+        if (entry) {
+            names.push_back(entry->name);
+        }
+    }
+    return names;
+}
+
+void OverlaySeries::push(int id, double value) {
+    Series *entry = get_series(id);
+    if (entry) {
+        entry->samples.push(Time::get_singleton()->get_ticks_usec() / 1000000.0, value);
+    }
+}
+
+void OverlaySeries::push_at(int id, double time, double value) {
+    Series *entry = get_series(id);
+    if (entry) {
+        entry->samples.push(time, value);
+    }
+}
+
+void OverlaySeries::push_batch(int id, const PackedFloat64Array &times, const PackedFloat64Array &values) {
+    Series *entry = get_series(id);
+    if (!entry) {
+        return;
+    }
+    if (times.size() != values.size()) {
+        OVERLAY_LOG_ERROR("push_batch needs as many times as values.\n");
+        return;
+    }
+
+    // One call for a whole batch, samples collected at 1 kHz are pushed once a frame
+    const double *time = times.ptr();
+    const double *value = values.ptr();
+    for (int64_t i = 0; i < values.size(); i++) {
+        entry->samples.push(time[i], value[i]);
+    }
+}
+
+void OverlaySeries::clear(int id) {
+    Series *entry = get_series(id);
+    if (entry) {
+        entry->samples.clear();
+    }
+}
+
+int OverlaySeries::get_count(int id) const {
+    Series *entry = get_series(id);
+    return entry ? (int)entry->samples.get_count() : 0;
+}
+
+int OverlaySeries::get_capacity(int id) const {
+    Series *entry = get_series(id);
+    return entry ? (int)entry->samples.get_capacity() : 0;
+}
+
+Dictionary OverlaySeries::get_summary(int id, double window) {
+    Dictionary result;
+    Series *entry = get_series(id);
+    if (!entry) {
+        return result;
+    }
+    const TimeSeries::Summary &summary = entry->samples.summarize(window);
+    result["count"] = (int64_t)summary.count;
+    result["min"] = summary.min;
+    result["max"] = summary.max;
+    result["avg"] = summary.mean;
+    result["last"] = summary.last;
+    return result;
+}
+
+double OverlaySeries::get_percentile(int id, double percentile, double window) {
+    Series *entry = get_series(id);
+    return entry ? entry->samples.get_percentile(window, percentile) : 0.0;
+}
+
+PackedVector2Array OverlaySeries::get_points(int id, const Vector2 &size, Decimation mode, double window, double y_min, double y_max) {
+    Series *entry = get_series(id);
+    if (!entry) {
+        return PackedVector2Array();
+    }
+    TimeSeries::PlotRequest request;
+    request.mode = static_cast<TimeSeries::Decimation>(mode);
+    request.span = window;
+    request.width = static_cast<int32_t>(size.x);
+    request.height = static_cast<float>(size.y);
+    request.y_min = y_min;
+    request.y_max = y_max;
+
+    // The array is only rebuilt when the plot was, otherwise the cached one is shared
+    const std::vector<SeriesPoint> &points = entry->samples.plot(request);
+    if (entry->plot_version != entry->samples.get_plot_version()) {
+        entry->plot_version = entry->samples.get_plot_version();
+        entry->points.resize(points.size());
+        Vector2 *out = entry->points.ptrw();
+        for (size_t i = 0; i < points.size(); i++) {
+            out[i] = Vector2(points[i].x, points[i].y);
+        }
+    }
+    return entry->points;
+}
+
+void OverlaySeries::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("add_series", "name", "capacity"), &OverlaySeries::add_series, DEFVAL(4096));
+    ClassDB::bind_method(D_METHOD("remove_series", "id"), &OverlaySeries::remove_series);
+    ClassDB::bind_method(D_METHOD("find_series", "name"), &OverlaySeries::find_series);
+    ClassDB::bind_method(D_METHOD("get_series_names"), &OverlaySeries::get_series_names);
+    ClassDB::bind_method(D_METHOD("push", "id", "value"), &OverlaySeries::push);
+    ClassDB::bind_method(D_METHOD("push_at", "id", "time", "value"), &OverlaySeries::push_at);
+    ClassDB::bind_method(D_METHOD("push_batch", "id", "times", "values"), &OverlaySeries::push_batch);
+    ClassDB::bind_method(D_METHOD("clear", "id"), &OverlaySeries::clear);
+    ClassDB::bind_method(D_METHOD("get_count", "id"), &OverlaySeries::get_count);
+    ClassDB::bind_method(D_METHOD("get_capacity", "id"), &OverlaySeries::get_capacity);
+    ClassDB::bind_method(D_METHOD("get_summary", "id", "window"), &OverlaySeries::get_summary, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_percentile", "id", "percentile", "window"), &OverlaySeries::get_percentile, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_points", "id", "size", "mode", "window", "y_min", "y_max"), &OverlaySeries::get_points, DEFVAL(DECIMATION_MIN_MAX), DEFVAL(0.0), DEFVAL(0.0), DEFVAL(0.0));
+
+    BIND_ENUM_CONSTANT(DECIMATION_MIN_MAX);
+    BIND_ENUM_CONSTANT(DECIMATION_LTTB);
+}
+
+} // namespace godot
@@ -0,0 +1,78 @@
+#ifndef OVERLAY_SERIES_H
+#define OVERLAY_SERIES_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <memory>
+#include <vector>
+
+#include "core/time_series.h"
+
+namespace godot {
+
+// Time series for overlay graphs (frame times, ping, CPU), kept natively so a HUD does
+// not append to Arrays and redraw thousands of points from GDScript. Each series is a
+// fixed-capacity ring, pushing is O(1). Summaries, percentiles and points are computed
+// when asked for and cached until the next push, so reading them every frame is free
+// while nothing new arrived. Windows are the last window seconds, 0 for all buffered.
+class OverlaySeries : public RefCounted {
+    GDCLASS(OverlaySeries, RefCounted);
+
+protected:
+    static void _bind_methods();
+
+public:
+    enum Decimation {
+        DECIMATION_MIN_MAX = TimeSeries::DECIMATION_MIN_MAX,
+        DECIMATION_LTTB = TimeSeries::DECIMATION_LTTB,
+    };
+
+    // Returns the series id, the existing one when the name is already used
+    int add_series(const StringName &name, int capacity);
+    void remove_series(int id);
+    int find_series(const StringName &name) const;
+    PackedStringArray get_series_names() const;
+
+    // push stamps samples with Time.get_ticks_usec in seconds, push_at and push_batch take
+    // any times that do not go backwards. Unknown ids are ignored.
+    void push(int id, double value);
+    void push_at(int id, double time, double value);
+    void push_batch(int id, const PackedFloat64Array &times, const PackedFloat64Array &values);
+    void clear(int id);
+    int get_count(int id) const;
+    int get_capacity(int id) const;
+
+    // count, min, max, avg and last of the window
+    Dictionary get_summary(int id, double window);
+    double get_percentile(int id, double percentile, double window);
+
+    // Points laid out in size for draw_polyline, the newest sample at the right edge and
+    // larger values higher up. Min-max keeps every spike with up to two points per pixel
+    // column, LTTB keeps the shape with one. y_min >= y_max scales to the window.
+    PackedVector2Array get_points(int id, const Vector2 &size, Decimation mode, double window, double y_min, double y_max);
+
+private:
+    struct Series {
+        StringName name;
+        TimeSeries samples;
+        PackedVector2Array points; // Converted from the plot of plot_version
+        uint64_t plot_version = 0;
+
+        Series(const StringName &p_name, size_t capacity) :
+                name(p_name), samples(capacity) {}
+    };
+
+    // Indexed by id, removed series leave a null slot that is reused
+    std::vector<std::unique_ptr<Series>> series;
+    Series *get_series(int id) const;
+};
+
+} // namespace godot
+
+VARIANT_ENUM_CAST(OverlaySeries::Decimation);
+
+#endif // OVERLAY_SERIES_H
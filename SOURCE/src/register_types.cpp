@@ -1,5 +1,8 @@
 #include "register_types.h"
 #include "overlay.h"
+#include "overlay_bootstrap.h"
+#include "overlay_node.h"
+#include "overlay_series.h"
 #include <godot_cpp/core/class_db.hpp>
 
 using namespace godot;
@@ -7,15 +10,23 @@ using namespace godot;
 void initialize_overlay_module(ModuleInitializationLevel p_level) {
     if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
         ClassDB::register_class<Overlay>();
+        ClassDB::register_class<OverlayNode>();
+        ClassDB::register_class<OverlaySeries>();
+
+        // Shape the main window before it draws its first frame
+        OverlayBootstrap::initialize();
     }
 }
 
 void uninitialize_overlay_module(ModuleInitializationLevel p_level) {
-    // Cleanup if needed
+    if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
+        OverlayBootstrap::uninitialize();
+    }
 }
 
 extern "C" {
 GDExtensionBool GDE_EXPORT overlay_init(GDExtensionInterfaceGetProcAddress p_get_proc_address, GDExtensionClassLibraryPtr p_library, GDExtensionInitialization *r_initialization) {
+    OverlayBootstrap::get_timeline().mark(StartupTimeline::STAGE_LIBRARY_LOAD);
     godot::GDExtensionBinding::InitObject init_obj(p_get_proc_address, p_library, r_initialization);
 
     init_obj.register_initializer(initialize_overlay_module);
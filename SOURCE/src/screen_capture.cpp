@@ -0,0 +1,43 @@
+#include "screen_capture.h"
+
+#if defined(_WIN32)
+#include "screen_capture_windows.h"
+#elif defined(__linux__) || defined(__FreeBSD__)
+#include "screen_capture_x11.h"
+#endif
+
+namespace godot {
+
+bool ScreenCapture::capture(const RegionRect &rect, std::unique_ptr<CaptureSurface> &surface, CaptureFrame &r_frame) {
+    RegionRect clipped = rect;
+    if (!clip(clipped)) {
+        return false;
+    }
+
+    // Allocation only happens when a region grows past every surface we have
+    if (!surface || !surface->fits(clipped.width, clipped.height)) {
+        std::unique_ptr<CaptureSurface> replacement = pool.acquire(clipped.width, clipped.height);
+        if (!replacement) {
+            // Round up so a region resized a few pixels at a time keeps its surface
+            replacement = create_surface((clipped.width + 63) & ~63, (clipped.height + 63) & ~63);
+            if (!replacement) {
+                return false;
+            }
+        }
+        pool.release(std::move(surface));
+        surface = std::move(replacement);
+    }
+    return grab(clipped, *surface, r_frame);
+}
+
+std::unique_ptr<ScreenCapture> ScreenCapture::create() {
+#if defined(_WIN32)
+    return std::unique_ptr<ScreenCapture>(new ScreenCaptureWindows());
+#elif defined(__linux__) || defined(__FreeBSD__)
+    return std::unique_ptr<ScreenCapture>(new ScreenCaptureX11());
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace godot
@@ -0,0 +1,61 @@
+#ifndef SCREEN_CAPTURE_H
+#define SCREEN_CAPTURE_H
+
+#include <cstdint>
+#include <memory>
+
+#include "core/capture_surface.h"
+#include "core/input_region.h"
+
+namespace godot {
+
+// Grabs rectangles of the desktop into reusable native surfaces, one
+// implementation per windowing system. Pixels are written by the OS
+// straight into memory this process can read; no intermediate copy is made.
+// Not thread safe, every call comes from the thread that created it.
+class ScreenCapture {
+public:
+    virtual ~ScreenCapture() {}
+
+    // False when the windowing system cannot be reached
+    virtual bool open() = 0;
+
+    // Grab rect (screen pixels, clipped to the screen) into surface. The surface is
+    // swapped for a pooled or new one when it is too small. False on failure.
+    bool capture(const RegionRect &rect, std::unique_ptr<CaptureSurface> &surface, CaptureFrame &r_frame);
+
+    // Surfaces belong to this capture's connection: callers release theirs
+    // before destroying it. Give a surface back once its region is gone.
+    void release(std::unique_ptr<CaptureSurface> surface) {
+        pool.release(std::move(surface));
+    }
+
+    const CaptureSurfacePool &get_pool() const {
+        return pool;
+    }
+
+    // True when grabs go through shared memory, false for the copying fallback
+    virtual bool is_zero_copy() const = 0;
+    virtual const char *get_name() const = 0;
+
+    // Capture for the platform this was built for, null when there is none
+    static std::unique_ptr<ScreenCapture> create();
+
+protected:
+    // Implementations call this first in their destructor
+    void clear_surfaces() {
+        pool.clear();
+    }
+
+    // Clip rect to the screen, false when nothing is left
+    virtual bool clip(RegionRect &rect) const = 0;
+    virtual std::unique_ptr<CaptureSurface> create_surface(int32_t width, int32_t height) = 0;
+    virtual bool grab(const RegionRect &rect, CaptureSurface &surface, CaptureFrame &r_frame) = 0;
+
+private:
+    CaptureSurfacePool pool;
+};
+
+} // namespace godot
+
+#endif // SCREEN_CAPTURE_H
@@ -0,0 +1,132 @@
+#ifdef _WIN32
+
+#include "screen_capture_windows.h"
+#include "core/overlay_log.h"
+
+namespace godot {
+
+namespace {
+
+// Memory DC with a DIB section selected, bits are written by BitBlt in place
+class DibSurface : public CaptureSurface {
+public:
+    DibSurface(int32_t p_width, int32_t p_height) :
+            width(p_width), height(p_height) {}
+
+    ~DibSurface() override {
+        if (memory_dc) {
+            if (previous) {
+                SelectObject(memory_dc, previous);
+            }
+            DeleteDC(memory_dc);
+        }
+        if (bitmap) {
+            DeleteObject(bitmap);
+        }
+    }
+
+    bool create(HDC screen_dc) {
+        BITMAPINFO info = {};
+        info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        info.bmiHeader.biWidth = width;
+        info.bmiHeader.biHeight = -height; // Top-down rows
+        info.bmiHeader.biPlanes = 1;
+        info.bmiHeader.biBitCount = 32;
+        info.bmiHeader.biCompression = BI_RGB;
+        bitmap = CreateDIBSection(screen_dc, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+        if (!bitmap) {
+            return false;
+        }
+        memory_dc = CreateCompatibleDC(screen_dc);
+        if (!memory_dc) {
+            return false;
+        }
+        previous = SelectObject(memory_dc, bitmap);
+        return true;
+    }
+
+    bool fits(int32_t p_width, int32_t p_height) const override {
+        return p_width <= width && p_height <= height;
+    }
+    size_t get_bytes() const override {
+        return static_cast<size_t>(width) * height * 4;
+    }
+
+    int32_t width;
+    int32_t height;
+    HDC memory_dc = nullptr;
+    HBITMAP bitmap = nullptr;
+    HGDIOBJ previous = nullptr;
+    void *bits = nullptr;
+};
+
+} // namespace
+
+ScreenCaptureWindows::~ScreenCaptureWindows() {
+    clear_surfaces();
+    if (screen_dc) {
+        ReleaseDC(nullptr, screen_dc);
+    }
+}
+
+bool ScreenCaptureWindows::open() {
+    if (screen_dc) {
+        return true;
+    }
+    screen_dc = GetDC(nullptr);
+    if (!screen_dc) {
+        OVERLAY_LOG_ERROR("Failed to get the screen DC for capture. Error: %lu\n", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool ScreenCaptureWindows::clip(RegionRect &rect) const {
+    // The virtual screen spans every monitor and may start at negative coordinates
+    int32_t screen_left = GetSystemMetrics(SM_XVIRTUALSCREEN);
+    int32_t screen_top = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    int32_t screen_right = screen_left + GetSystemMetrics(SM_CXVIRTUALSCREEN);
+    int32_t screen_bottom = screen_top + GetSystemMetrics(SM_CYVIRTUALSCREEN);
+
+    int32_t left = rect.x > screen_left ? rect.x : screen_left;
+    int32_t top = rect.y > screen_top ? rect.y : screen_top;
+    int32_t right = rect.x + rect.width < screen_right ? rect.x + rect.width : screen_right;
+    int32_t bottom = rect.y + rect.height < screen_bottom ? rect.y + rect.height : screen_bottom;
+    rect = { left, top, right - left, bottom - top };
+    return !rect.is_empty();
+}
+
+std::unique_ptr<CaptureSurface> ScreenCaptureWindows::create_surface(int32_t width, int32_t height) {
+    if (!screen_dc) {
+        return nullptr;
+    }
+    std::unique_ptr<DibSurface> surface(new DibSurface(width, height));
+    if (!surface->create(screen_dc)) {
+        OVERLAY_LOG_ERROR("Failed to create a %dx%d capture DIB. Error: %lu\n", width, height, GetLastError());
+        return nullptr;
+    }
+    return surface;
+}
+
+bool ScreenCaptureWindows::grab(const RegionRect &rect, CaptureSurface &surface, CaptureFrame &r_frame) {
+    DibSurface &dib = static_cast<DibSurface &>(surface);
+    if (!BitBlt(dib.memory_dc, 0, 0, rect.width, rect.height, screen_dc, rect.x, rect.y, SRCCOPY)) {
+        OVERLAY_LOG_ERROR("BitBlt capture failed. Error: %lu\n", GetLastError());
+        return false;
+    }
+
+    // GDI batches drawing, make sure the bits are written before they are read
+    GdiFlush();
+
+    r_frame.pixels = static_cast<const uint8_t *>(dib.bits);
+    r_frame.x = rect.x;
+    r_frame.y = rect.y;
+    r_frame.width = rect.width;
+    r_frame.height = rect.height;
+    r_frame.stride = dib.width * 4;
+    return true;
+}
+
+} // namespace godot
+
+#endif // _WIN32
@@ -0,0 +1,41 @@
+#ifndef SCREEN_CAPTURE_WINDOWS_H
+#define SCREEN_CAPTURE_WINDOWS_H
+
+#ifdef _WIN32
+
+#include "screen_capture.h"
+
+#include <windows.h>
+
+namespace godot {
+
+// Win32 capture: BitBlt from the screen DC into a top-down 32-bit DIB section,
+// whose bits live in our address space. Layered windows, the overlay included,
+// are left out because CAPTUREBLT is not set, so the grab shows what is beneath.
+class ScreenCaptureWindows : public ScreenCapture {
+public:
+    ~ScreenCaptureWindows() override;
+
+    bool open() override;
+
+    bool is_zero_copy() const override {
+        return true;
+    }
+    const char *get_name() const override {
+        return "Windows";
+    }
+
+protected:
+    bool clip(RegionRect &rect) const override;
+    std::unique_ptr<CaptureSurface> create_surface(int32_t width, int32_t height) override;
+    bool grab(const RegionRect &rect, CaptureSurface &surface, CaptureFrame &r_frame) override;
+
+private:
+    HDC screen_dc = nullptr;
+};
+
+} // namespace godot
+
+#endif // _WIN32
+
+#endif // SCREEN_CAPTURE_WINDOWS_H
@@ -0,0 +1,198 @@
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "screen_capture_x11.h"
+#include "core/overlay_log.h"
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+namespace godot {
+
+namespace {
+
+// Shared memory segment attached on both sides, with an image header for the last grab size
+class ShmSurface : public CaptureSurface {
+public:
+    ShmSurface(Display *p_display, int32_t p_width, int32_t p_height) :
+            display(p_display), width(p_width), height(p_height) {}
+
+    ~ShmSurface() override {
+        if (image) {
+            image->data = nullptr; // The segment is not the header's to free
+            XDestroyImage(image);
+        }
+        if (attached) {
+            XShmDetach(display, &segment);
+            XSync(display, False);
+        }
+        if (segment.shmaddr && segment.shmaddr != reinterpret_cast<char *>(-1)) {
+            shmdt(segment.shmaddr);
+        }
+    }
+
+    bool create() {
+        segment.shmid = shmget(IPC_PRIVATE, get_bytes(), IPC_CREAT | 0600);
+        if (segment.shmid < 0) {
+            return false;
+        }
+        segment.shmaddr = static_cast<char *>(shmat(segment.shmid, nullptr, 0));
+        segment.readOnly = False;
+        if (segment.shmaddr == reinterpret_cast<char *>(-1)) {
+            shmctl(segment.shmid, IPC_RMID, nullptr);
+            return false;
+        }
+        attached = XShmAttach(display, &segment);
+        XSync(display, False);
+
+        // Removed now so the segment goes away with the last detach, even after a crash
+        shmctl(segment.shmid, IPC_RMID, nullptr);
+        return attached;
+    }
+
+    bool fits(int32_t p_width, int32_t p_height) const override {
+        return p_width <= width && p_height <= height;
+    }
+    size_t get_bytes() const override {
+        return static_cast<size_t>(width) * height * 4;
+    }
+
+    // The header is client side only, recreating it for a new size costs no round trip
+    XImage *get_image(int32_t p_width, int32_t p_height) {
+        if (image && image->width == p_width && image->height == p_height) {
+            return image;
+        }
+        if (image) {
+            image->data = nullptr;
+            XDestroyImage(image);
+        }
+        image = XShmCreateImage(display, DefaultVisual(display, DefaultScreen(display)),
+                DefaultDepth(display, DefaultScreen(display)), ZPixmap, segment.shmaddr, &segment, p_width, p_height);
+        return image;
+    }
+
+private:
+    Display *display;
+    int32_t width;
+    int32_t height;
+    XShmSegmentInfo segment = {};
+    bool attached = false;
+    XImage *image = nullptr;
+};
+
+// Without MIT-SHM Xlib allocates every image, the surface only owns the last one
+class CopySurface : public CaptureSurface {
+public:
+    ~CopySurface() override {
+        if (image) {
+            XDestroyImage(image);
+        }
+    }
+
+    bool fits(int32_t width, int32_t height) const override {
+        (void)width;
+        (void)height;
+        return true;
+    }
+    size_t get_bytes() const override {
+        return image ? static_cast<size_t>(image->bytes_per_line) * image->height : 0;
+    }
+
+    XImage *image = nullptr;
+};
+
+} // namespace
+
+ScreenCaptureX11::~ScreenCaptureX11() {
+    // Surfaces detach from the connection, so they go first
+    clear_surfaces();
+    if (display) {
+        XCloseDisplay(display);
+    }
+}
+
+bool ScreenCaptureX11::open() {
+    if (display) {
+        return true;
+    }
+    display = XOpenDisplay(nullptr);
+    if (!display) {
+        OVERLAY_LOG_ERROR("Failed to open X display for capture.\n");
+        return false;
+    }
+    int screen = DefaultScreen(display);
+    root = RootWindow(display, screen);
+    screen_width = DisplayWidth(display, screen);
+    screen_height = DisplayHeight(display, screen);
+
+    // Only 32 bits per pixel layouts are read directly
+    has_shm = XShmQueryExtension(display) && DefaultDepth(display, screen) >= 24;
+    if (!has_shm) {
+        OVERLAY_LOG_WARNING("MIT-SHM unavailable, screen capture copies every frame.\n");
+    }
+    return true;
+}
+
+bool ScreenCaptureX11::clip(RegionRect &rect) const {
+    int32_t left = rect.x > 0 ? rect.x : 0;
+    int32_t top = rect.y > 0 ? rect.y : 0;
+    int32_t right = rect.x + rect.width < screen_width ? rect.x + rect.width : screen_width;
+    int32_t bottom = rect.y + rect.height < screen_height ? rect.y + rect.height : screen_height;
+    rect = { left, top, right - left, bottom - top };
+    return !rect.is_empty();
+}
+
+std::unique_ptr<CaptureSurface> ScreenCaptureX11::create_surface(int32_t width, int32_t height) {
+    if (!display) {
+        return nullptr;
+    }
+    if (!has_shm) {
+        return std::unique_ptr<CaptureSurface>(new CopySurface());
+    }
+    std::unique_ptr<ShmSurface> surface(new ShmSurface(display, width, height));
+    if (!surface->create()) {
+        OVERLAY_LOG_ERROR("Failed to create a %dx%d shared memory capture surface.\n", width, height);
+        return nullptr;
+    }
+    return surface;
+}
+
+bool ScreenCaptureX11::grab(const RegionRect &rect, CaptureSurface &surface, CaptureFrame &r_frame) {
+    XImage *image = nullptr;
+    if (has_shm) {
+        image = static_cast<ShmSurface &>(surface).get_image(rect.width, rect.height);
+        if (!image || !XShmGetImage(display, root, image, rect.x, rect.y, AllPlanes)) {
+            OVERLAY_LOG_ERROR("XShmGetImage failed.\n");
+            return false;
+        }
+    } else {
+        CopySurface &copy = static_cast<CopySurface &>(surface);
+        if (copy.image) {
+            XDestroyImage(copy.image);
+        }
+        copy.image = XGetImage(display, root, rect.x, rect.y, rect.width, rect.height, AllPlanes, ZPixmap);
+        image = copy.image;
+        if (!image) {
+            OVERLAY_LOG_ERROR("XGetImage failed.\n");
+            return false;
+        }
+    }
+    if (image->bits_per_pixel != 32) {
+        OVERLAY_LOG_ERROR("Unsupported capture format: %d bits per pixel.\n", image->bits_per_pixel);
+        return false;
+    }
+
+    r_frame.pixels = reinterpret_cast<const uint8_t *>(image->data);
+    r_frame.x = rect.x;
+    r_frame.y = rect.y;
+    r_frame.width = rect.width;
+    r_frame.height = rect.height;
+    r_frame.stride = image->bytes_per_line;
+    return true;
+}
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
@@ -0,0 +1,47 @@
+#ifndef SCREEN_CAPTURE_X11_H
+#define SCREEN_CAPTURE_X11_H
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "screen_capture.h"
+
+// Xlib is kept out of this header, its macros clash with Godot names
+struct _XDisplay;
+
+namespace godot {
+
+// X11 capture: XShmGetImage from the root window into SysV shared memory
+// segments, so the server writes pixels straight into our address space.
+// Falls back to plain XGetImage when MIT-SHM is missing (remote displays).
+// Uses its own connection, Godot's is never touched.
+class ScreenCaptureX11 : public ScreenCapture {
+public:
+    ~ScreenCaptureX11() override;
+
+    bool open() override;
+
+    bool is_zero_copy() const override {
+        return has_shm;
+    }
+    const char *get_name() const override {
+        return "X11";
+    }
+
+protected:
+    bool clip(RegionRect &rect) const override;
+    std::unique_ptr<CaptureSurface> create_surface(int32_t width, int32_t height) override;
+    bool grab(const RegionRect &rect, CaptureSurface &surface, CaptureFrame &r_frame) override;
+
+private:
+    _XDisplay *display = nullptr;
+    unsigned long root = 0;
+    int32_t screen_width = 0;
+    int32_t screen_height = 0;
+    bool has_shm = false;
+};
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
+
+#endif // SCREEN_CAPTURE_X11_H
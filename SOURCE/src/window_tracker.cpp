@@ -0,0 +1,67 @@
+#include "window_tracker.h"
+
+#if defined(_WIN32)
+#include "window_tracker_windows.h"
+#elif defined(__linux__) || defined(__FreeBSD__)
+#include "window_tracker_x11.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+
+namespace godot {
+
+namespace {
+
+// ASCII only, executable names and titles compare the same way on every platform
+std::string to_lower(const std::string &text) {
+    std::string result = text;
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return result;
+}
+
+} // namespace
+
+bool WindowMatch::matches(const std::string &executable, const std::string &window_title, const std::string &class_name) const {
+    if (!window_class.empty() && class_name != window_class) {
+        return false;
+    }
+    if (!title.empty() && to_lower(window_title).find(to_lower(title)) == std::string::npos) {
+        return false;
+    }
+    if (!process_name.empty()) {
+        // Only the file name counts, the path is whatever the OS reported
+        size_t separator = executable.find_last_of("/\\");
+        std::string file_name = separator == std::string::npos ? executable : executable.substr(separator + 1);
+        if (to_lower(file_name) != to_lower(process_name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WindowTracker::publish(const TrackedWindow &new_state) {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (new_state == state) {
+            return;
+        }
+        state = new_state;
+    }
+    stats.changes.fetch_add(1, std::memory_order_relaxed);
+    serial.fetch_add(1, std::memory_order_release);
+}
+
+std::unique_ptr<WindowTracker> WindowTracker::create() {
+#if defined(_WIN32)
+    return std::unique_ptr<WindowTracker>(new WindowTrackerWindows());
+#elif defined(__linux__) || defined(__FreeBSD__)
+    return std::unique_ptr<WindowTracker>(new WindowTrackerX11());
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace godot
@@ -0,0 +1,96 @@
+#ifndef WINDOW_TRACKER_H
+#define WINDOW_TRACKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/input_region.h"
+
+namespace godot {
+
+// Which window of another application to follow. Empty fields match anything.
+struct WindowMatch {
+    std::string process_name; // Executable file name, e.g. "game.exe", case-insensitive
+    std::string title; // Part of the window title
+    std::string window_class; // Window class name on Windows, WM_CLASS name or class on X11
+
+    bool is_empty() const {
+        return process_name.empty() && title.empty() && window_class.empty();
+    }
+    bool matches(const std::string &executable, const std::string &window_title, const std::string &class_name) const;
+};
+
+// Last known state of the followed window, window is 0 while none matches
+struct TrackedWindow {
+    uint64_t window = 0; // HWND or X11 window id
+    uint32_t process_id = 0;
+    RegionRect rect; // Client area in native screen pixels
+    bool minimized = false;
+    bool occluded = false; // Cloaked or fully obscured, where the OS says so
+
+    bool operator==(const TrackedWindow &other) const {
+        return window == other.window && process_id == other.process_id && rect == other.rect &&
+                minimized == other.minimized && occluded == other.occluded;
+    }
+    bool operator!=(const TrackedWindow &other) const {
+        return !(*this == other);
+    }
+};
+
+// Follows a window of another application from OS notifications on a thread of its
+// own, one implementation per windowing system. Nothing is polled: the thread sleeps
+// until the window moves, resizes, minimizes or goes away, or until a new window
+// appears while none matches. Readers compare the serial to notice a change.
+class WindowTracker {
+public:
+    struct Stats {
+        std::atomic<uint64_t> events{ 0 }; // OS notifications handled
+        std::atomic<uint64_t> searches{ 0 }; // Window list scans while nothing matched
+        std::atomic<uint64_t> changes{ 0 }; // States published
+    };
+
+    virtual ~WindowTracker() {}
+
+    // Start following the first window matching, false when the windowing system
+    // cannot be reached. A destroyed window is searched for again.
+    virtual bool start(const WindowMatch &match) = 0;
+
+    // Join the thread, the state is kept
+    virtual void stop() = 0;
+
+    virtual const char *get_name() const = 0;
+
+    // Bumped by the tracker thread on every change of the state
+    uint64_t get_serial() const {
+        return serial.load(std::memory_order_acquire);
+    }
+    TrackedWindow get_state() const {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return state;
+    }
+
+    const Stats &get_stats() const {
+        return stats;
+    }
+
+    // Tracker for the platform this was built for, null when there is none
+    static std::unique_ptr<WindowTracker> create();
+
+protected:
+    // Tracker thread, a state equal to the last one is not published
+    void publish(const TrackedWindow &new_state);
+
+    Stats stats;
+
+private:
+    mutable std::mutex state_mutex;
+    TrackedWindow state;
+    std::atomic<uint64_t> serial{ 0 };
+};
+
+} // namespace godot
+
+#endif // WINDOW_TRACKER_H
@@ -0,0 +1,288 @@
+#ifdef _WIN32
+
+#include "window_tracker_windows.h"
+#include "core/overlay_log.h"
+
+namespace godot {
+
+namespace {
+
+// The tracker whose hooks run on this thread, WinEvent callbacks have no user pointer
+thread_local WindowTrackerWindows *tracker_owner = nullptr;
+
+// Not in older SDK headers, sent when a window moves to or from another virtual desktop
+constexpr DWORD EVENT_CLOAKED = 0x8017;
+constexpr DWORD EVENT_UNCLOAKED = 0x8018;
+
+std::string wide_to_utf8(const wchar_t *text, int length) {
+    if (length <= 0) {
+        return std::string();
+    }
+    int size = WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0, nullptr, nullptr);
+    std::string result(size > 0 ? size : 0, '\0');
+    if (size > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, text, length, &result[0], size, nullptr, nullptr);
+    }
+    return result;
+}
+
+struct SearchResult {
+    WindowTrackerWindows *tracker;
+    HWND found;
+};
+
+} // namespace
+
+WindowTrackerWindows::~WindowTrackerWindows() {
+    stop();
+}
+
+bool WindowTrackerWindows::start(const WindowMatch &p_match) {
+    stop();
+    match = p_match;
+    target = nullptr;
+    current = TrackedWindow();
+
+    std::promise<bool> ready;
+    std::future<bool> started = ready.get_future();
+    thread = std::thread(&WindowTrackerWindows::thread_main, this, std::move(ready));
+    thread_id = GetThreadId(thread.native_handle());
+    if (!started.get()) {
+        thread.join();
+        OVERLAY_LOG_ERROR("Failed to set up window tracking hooks.\n");
+        return false;
+    }
+    return true;
+}
+
+void WindowTrackerWindows::stop() {
+    // The thread unhooks before exiting
+    if (thread.joinable()) {
+        PostThreadMessage(thread_id, WM_QUIT, 0, 0);
+        thread.join();
+    }
+    target = nullptr;
+}
+
+void WindowTrackerWindows::thread_main(std::promise<bool> ready) {
+    // Force creation of the thread message queue before anyone can post WM_QUIT
+    MSG msg;
+    PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+    tracker_owner = this;
+    if (!search()) {
+        set_searching(true);
+        if (!search_hooks[0]) {
+            tracker_owner = nullptr;
+            ready.set_value(false);
+            return;
+        }
+    }
+    publish(current);
+    ready.set_value(true);
+
+    // Message loop, WinEvents are delivered while the thread waits here
+    while (GetMessage(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+
+    set_searching(false);
+    lose_target();
+    tracker_owner = nullptr;
+}
+
+void CALLBACK WindowTrackerWindows::WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG object_id,
+        LONG child_id, DWORD event_thread, DWORD event_time) {
+    (void)hook;
+    (void)event_thread;
+    (void)event_time;
+    WindowTrackerWindows *tracker = tracker_owner;
+    if (tracker && hwnd && object_id == OBJID_WINDOW && child_id == CHILDID_SELF) {
+        tracker->handle_event(event, hwnd);
+    }
+}
+
+void WindowTrackerWindows::handle_event(DWORD event, HWND hwnd) {
+    stats.events.fetch_add(1, std::memory_order_relaxed);
+
+    // While nothing matches, a top-level window being shown or renamed may be the one
+    if (!target) {
+        if ((event == EVENT_OBJECT_SHOW || event == EVENT_OBJECT_NAMECHANGE) && GetAncestor(hwnd, GA_ROOT) == hwnd) {
+            stats.searches.fetch_add(1, std::memory_order_relaxed);
+            if (matches(hwnd)) {
+                follow(hwnd);
+                publish(current);
+            }
+        }
+        return;
+    }
+    if (hwnd != target) {
+        return; // Another window of the same process
+    }
+
+    switch (event) {
+        case EVENT_OBJECT_DESTROY:
+            lose_target();
+            if (!search()) {
+                set_searching(true);
+            }
+            break;
+        case EVENT_OBJECT_LOCATIONCHANGE:
+            refresh_geometry();
+            break;
+        case EVENT_SYSTEM_MINIMIZESTART:
+            current.minimized = true;
+            break;
+        case EVENT_SYSTEM_MINIMIZEEND:
+            current.minimized = false;
+            refresh_geometry();
+            break;
+        case EVENT_CLOAKED:
+            current.occluded = true;
+            break;
+        case EVENT_UNCLOAKED:
+            current.occluded = false;
+            break;
+        default:
+            break;
+    }
+    publish(current);
+}
+
+BOOL CALLBACK WindowTrackerWindows::EnumWindowsProc(HWND hwnd, LPARAM lparam) {
+    SearchResult *result = reinterpret_cast<SearchResult *>(lparam);
+    if (result->tracker->matches(hwnd)) {
+        result->found = hwnd;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+bool WindowTrackerWindows::search() {
+    stats.searches.fetch_add(1, std::memory_order_relaxed);
+    SearchResult result = { this, nullptr };
+    EnumWindows(EnumWindowsProc, reinterpret_cast<LPARAM>(&result));
+    if (result.found) {
+        follow(result.found);
+    }
+    return result.found != nullptr;
+}
+
+bool WindowTrackerWindows::matches(HWND hwnd) {
+    if (!IsWindowVisible(hwnd)) {
+        return false;
+    }
+
+    // Never our own windows: reading their title would send a message to Godot's thread
+    DWORD process_id = 0;
+    GetWindowThreadProcessId(hwnd, &process_id);
+    if (process_id == GetCurrentProcessId()) {
+        return false;
+    }
+
+    // Only what the match asks for is read
+    std::string title;
+    std::string class_name;
+    std::string executable;
+    if (!match.title.empty()) {
+        wchar_t text[256];
+        title = wide_to_utf8(text, GetWindowTextW(hwnd, text, 256));
+    }
+    if (!match.window_class.empty()) {
+        wchar_t text[256];
+        class_name = wide_to_utf8(text, GetClassNameW(hwnd, text, 256));
+    }
+    if (!match.process_name.empty()) {
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process_id);
+        if (!process) {
+            return false;
+        }
+        wchar_t path[MAX_PATH];
+        DWORD length = MAX_PATH;
+        if (QueryFullProcessImageNameW(process, 0, path, &length)) {
+            executable = wide_to_utf8(path, static_cast<int>(length));
+        }
+        CloseHandle(process);
+    }
+    return match.matches(executable, title, class_name);
+}
+
+void WindowTrackerWindows::follow(HWND hwnd) {
+    set_searching(false);
+    target = hwnd;
+    DWORD process_id = 0;
+    GetWindowThreadProcessId(hwnd, &process_id);
+    current.window = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(hwnd));
+    current.process_id = process_id;
+
+    // Only the target's process reports to these, the callback picks out the window itself
+    const DWORD ranges[4][2] = {
+        { EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY },
+        { EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE },
+        { EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND },
+        { EVENT_CLOAKED, EVENT_UNCLOAKED },
+    };
+    for (int i = 0; i < 4; i++) {
+        target_hooks[i] = SetWinEventHook(ranges[i][0], ranges[i][1], nullptr, WinEventProc, process_id, 0, WINEVENT_OUTOFCONTEXT);
+        if (!target_hooks[i]) {
+            OVERLAY_LOG_WARNING("Failed to hook window events 0x%lx. Error: %lu\n", ranges[i][0], GetLastError());
+        }
+    }
+    current.minimized = IsIconic(hwnd) != 0;
+    refresh_geometry();
+    OVERLAY_LOG_VERBOSE("Tracking window %p of process %lu.\n", hwnd, process_id);
+}
+
+void WindowTrackerWindows::lose_target() {
+    for (HWINEVENTHOOK &hook : target_hooks) {
+        if (hook) {
+            UnhookWinEvent(hook);
+            hook = nullptr;
+        }
+    }
+    if (target) {
+        OVERLAY_LOG_VERBOSE("Tracked window %p is gone.\n", target);
+    }
+    target = nullptr;
+    current = TrackedWindow();
+}
+
+void WindowTrackerWindows::set_searching(bool searching) {
+    if (searching && !search_hooks[0]) {
+        // Every process, but only two event kinds that are rare outside window creation
+        const DWORD events[2] = { EVENT_OBJECT_SHOW, EVENT_OBJECT_NAMECHANGE };
+        for (int i = 0; i < 2; i++) {
+            search_hooks[i] = SetWinEventHook(events[i], events[i], nullptr, WinEventProc, 0, 0,
+                    WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+        }
+    } else if (!searching) {
+        for (HWINEVENTHOOK &hook : search_hooks) {
+            if (hook) {
+                UnhookWinEvent(hook);
+                hook = nullptr;
+            }
+        }
+    }
+}
+
+bool WindowTrackerWindows::refresh_geometry() {
+    // A minimized window reports a placeholder rect far off screen, the last real one is kept
+    if (IsIconic(target)) {
+        return true;
+    }
+    RECT client;
+    POINT origin = { 0, 0 };
+    if (!GetClientRect(target, &client) || !ClientToScreen(target, &origin)) {
+        return false;
+    }
+    current.rect.x = origin.x;
+    current.rect.y = origin.y;
+    current.rect.width = client.right - client.left;
+    current.rect.height = client.bottom - client.top;
+    return true;
+}
+
+} // namespace godot
+
+#endif // _WIN32
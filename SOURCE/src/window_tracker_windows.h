@@ -0,0 +1,58 @@
+#ifndef WINDOW_TRACKER_WINDOWS_H
+#define WINDOW_TRACKER_WINDOWS_H
+
+#ifdef _WIN32
+
+#include "window_tracker.h"
+
+#include <windows.h>
+#include <future>
+#include <thread>
+
+namespace godot {
+
+// Win32 tracker: WinEvent hooks on a thread with its own message loop. The followed
+// window's process reports EVENT_OBJECT_LOCATIONCHANGE, minimize start and end,
+// cloaking (another virtual desktop) and EVENT_OBJECT_DESTROY. While nothing matches,
+// windows being shown or renamed anywhere are checked against the match instead.
+class WindowTrackerWindows : public WindowTracker {
+public:
+    ~WindowTrackerWindows() override;
+
+    bool start(const WindowMatch &match) override;
+    void stop() override;
+
+    const char *get_name() const override {
+        return "Windows";
+    }
+
+private:
+    // Owned by the thread once it runs
+    WindowMatch match;
+    TrackedWindow current;
+    HWND target = nullptr;
+    HWINEVENTHOOK target_hooks[4] = {};
+    HWINEVENTHOOK search_hooks[2] = {};
+
+    std::thread thread;
+    DWORD thread_id = 0;
+    void thread_main(std::promise<bool> ready);
+
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG object_id,
+            LONG child_id, DWORD event_thread, DWORD event_time);
+    void handle_event(DWORD event, HWND hwnd);
+
+    static BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lparam);
+    bool search();
+    bool matches(HWND hwnd);
+    void follow(HWND hwnd);
+    void lose_target();
+    void set_searching(bool searching);
+    bool refresh_geometry();
+};
+
+} // namespace godot
+
+#endif // _WIN32
+
+#endif // WINDOW_TRACKER_WINDOWS_H
@@ -0,0 +1,343 @@
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "window_tracker_x11.h"
+#include "core/overlay_log.h"
+#include "x11_display.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <cerrno>
+#include <cstdio>
+#include <poll.h>
+#include <unistd.h>
+
+namespace godot {
+
+namespace {
+
+// Reads a window property, the caller frees r_data with XFree
+bool read_property(Display *display, ::Window window, Atom property, Atom type, long length,
+        unsigned char **r_data, unsigned long *r_count) {
+    Atom actual_type = None;
+    int actual_format = 0;
+    unsigned long bytes_after = 0;
+    *r_data = nullptr;
+    *r_count = 0;
+    if (XGetWindowProperty(display, window, property, 0, length, False, type, &actual_type,
+                &actual_format, r_count, &bytes_after, r_data) != Success) {
+        return false;
+    }
+    if (actual_type != type || !*r_data || *r_count == 0) {
+        if (*r_data) {
+            XFree(*r_data);
+            *r_data = nullptr;
+        }
+        return false;
+    }
+    return true;
+}
+
+// New top-level windows and client list changes, only selected while searching
+constexpr long ROOT_SEARCH_MASK = SubstructureNotifyMask | PropertyChangeMask;
+constexpr long TARGET_MASK = StructureNotifyMask | PropertyChangeMask | VisibilityChangeMask;
+
+} // namespace
+
+WindowTrackerX11::~WindowTrackerX11() {
+    stop();
+}
+
+bool WindowTrackerX11::start(const WindowMatch &p_match) {
+    stop();
+
+    // A connection of our own, so the thread never touches Godot's. Windows of other
+    // clients go away at any time, reading one that did fails instead of exiting.
+    display = open_background_display();
+    if (!display) {
+        OVERLAY_LOG_WARNING("Cannot open X display, window tracking is disabled.\n");
+        return false;
+    }
+    if (pipe(wake_pipe) != 0) {
+        OVERLAY_LOG_ERROR("Failed to create the window tracker wake pipe.\n");
+        close_background_display(display);
+        display = nullptr;
+        return false;
+    }
+    root = DefaultRootWindow(display);
+
+    const char *names[] = {
+        "_NET_CLIENT_LIST",
+        "_NET_WM_PID",
+        "_NET_WM_NAME",
+        "_NET_WM_STATE",
+        "_NET_WM_STATE_HIDDEN",
+        "UTF8_STRING",
+    };
+    Atom atoms[6];
+    XInternAtoms(display, const_cast<char **>(names), 6, False, atoms);
+    atom_net_client_list = atoms[0];
+    atom_net_wm_pid = atoms[1];
+    atom_net_wm_name = atoms[2];
+    atom_net_wm_state = atoms[3];
+    atom_net_wm_state_hidden = atoms[4];
+    atom_utf8_string = atoms[5];
+
+    // Select first, so a window mapped during the first search is not missed
+    match = p_match;
+    target = 0;
+    current = TrackedWindow();
+    XSelectInput(display, root, ROOT_SEARCH_MASK);
+    search();
+    publish(current);
+
+    thread = std::thread(&WindowTrackerX11::thread_main, this);
+    return true;
+}
+
+void WindowTrackerX11::stop() {
+    // Wake the thread out of poll and wait for it before closing its connection
+    if (thread.joinable()) {
+        char quit = 'q';
+        while (write(wake_pipe[1], &quit, 1) < 0 && errno == EINTR) {
+        }
+        thread.join();
+    }
+    for (int &fd : wake_pipe) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (display) {
+        close_background_display(display);
+        display = nullptr;
+    }
+    target = 0;
+}
+
+void WindowTrackerX11::thread_main() {
+    pollfd fds[2] = {
+        { ConnectionNumber(display), POLLIN, 0 },
+        { wake_pipe[0], POLLIN, 0 },
+    };
+    for (;;) {
+        // Events are handled in batches, a drag becomes one publish per batch
+        bool rescan = false;
+        bool geometry = false;
+        bool wm_state = false;
+        while (XPending(display) > 0) {
+            XEvent event;
+            XNextEvent(display, &event);
+            stats.events.fetch_add(1, std::memory_order_relaxed);
+            if (target == 0) {
+                if (event.type == CreateNotify || event.type == MapNotify || event.type == ReparentNotify ||
+                        (event.type == PropertyNotify && event.xproperty.atom == atom_net_client_list)) {
+                    rescan = true;
+                }
+                continue;
+            }
+            if (event.xany.window != target) {
+                continue; // Left over from searching
+            }
+            switch (event.type) {
+                case ConfigureNotify:
+                    geometry = true;
+                    break;
+                case MapNotify:
+                    unmapped = false;
+                    geometry = true;
+                    break;
+                case UnmapNotify:
+                    // ICCCM iconic windows are unmapped
+                    unmapped = true;
+                    break;
+                case VisibilityNotify:
+                    current.occluded = event.xvisibility.state == VisibilityFullyObscured;
+                    break;
+                case PropertyNotify:
+                    wm_state = wm_state || event.xproperty.atom == atom_net_wm_state;
+                    break;
+                case DestroyNotify:
+                    lose_target();
+                    rescan = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (rescan && target == 0) {
+            search();
+        } else if (target != 0) {
+            if (geometry && !refresh_geometry()) {
+                lose_target();
+            } else if (wm_state) {
+                refresh_wm_state();
+            }
+        }
+        current.minimized = target != 0 && (unmapped || hidden);
+        publish(current);
+
+        // The round trips above can read events into Xlib's queue, poll only sees the socket
+        if (XEventsQueued(display, QueuedAlready) > 0) {
+            continue;
+        }
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents) {
+            break; // Woken by stop
+        }
+    }
+}
+
+bool WindowTrackerX11::search() {
+    stats.searches.fetch_add(1, std::memory_order_relaxed);
+
+    // Client windows from the window manager, the root's children without one
+    ::Window *windows = nullptr;
+    unsigned long count = 0;
+    unsigned char *data = nullptr;
+    bool from_client_list = read_property(display, root, atom_net_client_list, XA_WINDOW, 4096, &data, &count);
+    if (from_client_list) {
+        windows = reinterpret_cast<::Window *>(data);
+    } else {
+        ::Window root_return = 0;
+        ::Window parent_return = 0;
+        unsigned int children = 0;
+        if (!XQueryTree(display, root, &root_return, &parent_return, &windows, &children)) {
+            return false;
+        }
+        count = children;
+    }
+
+    ::Window found = 0;
+    for (unsigned long i = 0; i < count && !found; i++) {
+        if (matches(windows[i])) {
+            found = windows[i];
+        }
+    }
+    if (windows) {
+        XFree(windows);
+    }
+    if (found) {
+        follow(found);
+    }
+    return found != 0;
+}
+
+bool WindowTrackerX11::matches(unsigned long window) {
+    // Only what the match asks for is read, each read is a round trip
+    std::string title;
+    std::string executable;
+    std::string instance;
+    std::string class_name;
+    unsigned char *data = nullptr;
+    unsigned long count = 0;
+    if (!match.title.empty()) {
+        if (read_property(display, window, atom_net_wm_name, atom_utf8_string, 256, &data, &count) ||
+                read_property(display, window, XA_WM_NAME, XA_STRING, 256, &data, &count)) {
+            title.assign(reinterpret_cast<const char *>(data), count);
+            XFree(data);
+        }
+    }
+    if (!match.window_class.empty()) {
+        XClassHint hint = {};
+        if (XGetClassHint(display, window, &hint)) {
+            if (hint.res_name) {
+                instance = hint.res_name;
+                XFree(hint.res_name);
+            }
+            if (hint.res_class) {
+                class_name = hint.res_class;
+                XFree(hint.res_class);
+            }
+        }
+    }
+    uint32_t process_id = 0;
+    if (read_property(display, window, atom_net_wm_pid, XA_CARDINAL, 1, &data, &count)) {
+        process_id = static_cast<uint32_t>(*reinterpret_cast<unsigned long *>(data));
+        XFree(data);
+    }
+    if (!match.process_name.empty()) {
+        if (process_id == 0) {
+            return false;
+        }
+        char link[32];
+        char path[4096];
+        snprintf(link, sizeof(link), "/proc/%u/exe", process_id);
+        ssize_t length = readlink(link, path, sizeof(path));
+        if (length > 0) {
+            executable.assign(path, static_cast<size_t>(length));
+        }
+    }
+
+    // WM_CLASS holds an instance and a class name, either may match
+    if (!match.matches(executable, title, instance) && !match.matches(executable, title, class_name)) {
+        return false;
+    }
+    current.process_id = process_id;
+    return true;
+}
+
+void WindowTrackerX11::follow(unsigned long window) {
+    target = window;
+    current.window = window;
+    XSelectInput(display, root, NoEventMask);
+    XSelectInput(display, target, TARGET_MASK);
+
+    XWindowAttributes attributes;
+    unmapped = XGetWindowAttributes(display, target, &attributes) && attributes.map_state == IsUnmapped;
+    refresh_wm_state();
+    if (!refresh_geometry()) {
+        lose_target();
+    }
+    OVERLAY_LOG_VERBOSE("Tracking X11 window 0x%lx.\n", window);
+}
+
+void WindowTrackerX11::lose_target() {
+    OVERLAY_LOG_VERBOSE("Tracked X11 window 0x%lx is gone.\n", target);
+    target = 0;
+    current = TrackedWindow();
+    unmapped = false;
+    hidden = false;
+    XSelectInput(display, root, ROOT_SEARCH_MASK);
+}
+
+bool WindowTrackerX11::refresh_geometry() {
+    // ConfigureNotify from a reparenting window manager is relative to its frame,
+    // translating to the root gives the client area on screen either way
+    XWindowAttributes attributes;
+    if (!XGetWindowAttributes(display, target, &attributes)) {
+        return false;
+    }
+    int x = 0;
+    int y = 0;
+    ::Window child = 0;
+    if (!XTranslateCoordinates(display, target, root, 0, 0, &x, &y, &child)) {
+        return false;
+    }
+    current.rect.x = x;
+    current.rect.y = y;
+    current.rect.width = attributes.width;
+    current.rect.height = attributes.height;
+    return true;
+}
+
+void WindowTrackerX11::refresh_wm_state() {
+    hidden = false;
+    unsigned char *data = nullptr;
+    unsigned long count = 0;
+    if (read_property(display, target, atom_net_wm_state, XA_ATOM, 32, &data, &count)) {
+        const Atom *states = reinterpret_cast<const Atom *>(data);
+        for (unsigned long i = 0; i < count; i++) {
+            hidden = hidden || states[i] == atom_net_wm_state_hidden;
+        }
+        XFree(data);
+    }
+}
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
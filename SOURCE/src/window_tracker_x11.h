@@ -0,0 +1,66 @@
+#ifndef WINDOW_TRACKER_X11_H
+#define WINDOW_TRACKER_X11_H
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "window_tracker.h"
+
+#include <thread>
+
+// Xlib is kept out of this header, its macros clash with Godot names
+struct _XDisplay;
+
+namespace godot {
+
+// X11 tracker on a connection of its own. The followed window reports ConfigureNotify
+// for moves and resizes, Unmap/MapNotify and _NET_WM_STATE_HIDDEN for minimizing,
+// VisibilityNotify for occlusion and DestroyNotify when it goes away. While nothing
+// matches, new top-level windows are noticed from the root window's substructure
+// events and _NET_CLIENT_LIST. The thread sleeps in poll between events.
+class WindowTrackerX11 : public WindowTracker {
+public:
+    ~WindowTrackerX11() override;
+
+    bool start(const WindowMatch &match) override;
+    void stop() override;
+
+    const char *get_name() const override {
+        return "X11";
+    }
+
+private:
+    _XDisplay *display = nullptr;
+    unsigned long root = 0;
+    unsigned long target = 0;
+
+    // Atoms interned once on start
+    unsigned long atom_net_client_list = 0;
+    unsigned long atom_net_wm_pid = 0;
+    unsigned long atom_net_wm_name = 0;
+    unsigned long atom_net_wm_state = 0;
+    unsigned long atom_net_wm_state_hidden = 0;
+    unsigned long atom_utf8_string = 0;
+
+    // Owned by the thread once it runs
+    WindowMatch match;
+    TrackedWindow current;
+    bool unmapped = false;
+    bool hidden = false; // _NET_WM_STATE_HIDDEN, for window managers that keep minimized windows mapped
+
+    std::thread thread;
+    int wake_pipe[2] = { -1, -1 };
+    void thread_main();
+
+    bool search();
+    bool matches(unsigned long window);
+    void follow(unsigned long window);
+    void lose_target();
+    bool refresh_geometry();
+    void refresh_wm_state();
+};
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
+
+#endif // WINDOW_TRACKER_X11_H
@@ -0,0 +1,77 @@
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include "x11_display.h"
+#include "core/overlay_log.h"
+
+#include <X11/Xlib.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace godot {
+
+namespace {
+
+std::mutex displays_mutex;
+std::vector<Display *> background_displays;
+XErrorHandler previous_handler = nullptr;
+bool handler_installed = false;
+std::atomic<uint64_t> ignored_errors{ 0 };
+
+int handle_error(Display *display, XErrorEvent *error) {
+    bool background = false;
+    {
+        std::lock_guard<std::mutex> lock(displays_mutex);
+        background = std::find(background_displays.begin(), background_displays.end(), display) != background_displays.end();
+    }
+    if (!background) {
+        return previous_handler ? previous_handler(display, error) : 0;
+    }
+    if (error->error_code == BadWindow || error->error_code == BadDrawable) {
+        ignored_errors.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    OVERLAY_LOG_WARNING("X11 error %d on a background connection, request %d.%d.\n", error->error_code,
+            error->request_code, error->minor_code);
+    return 0;
+}
+
+} // namespace
+
+Display *open_background_display(const char *name) {
+    Display *display = XOpenDisplay(name);
+    if (!display) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(displays_mutex);
+    // The handler is process wide, installed once on top of whatever was there
+    if (!handler_installed) {
+        previous_handler = XSetErrorHandler(&handle_error);
+        handler_installed = true;
+    }
+    background_displays.push_back(display);
+    return display;
+}
+
+void close_background_display(Display *display) {
+    if (!display) {
+        return;
+    }
+    // Errors still on their way arrive while registered, a pointer reused by the next
+    // XOpenDisplay never is
+    XSync(display, False);
+    {
+        std::lock_guard<std::mutex> lock(displays_mutex);
+        background_displays.erase(std::remove(background_displays.begin(), background_displays.end(), display), background_displays.end());
+    }
+    XCloseDisplay(display);
+}
+
+uint64_t get_ignored_x11_error_count() {
+    return ignored_errors.load(std::memory_order_relaxed);
+}
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
@@ -0,0 +1,31 @@
+#ifndef X11_DISPLAY_H
+#define X11_DISPLAY_H
+
+#if defined(__linux__) || defined(__FreeBSD__)
+
+#include <cstdint>
+
+// Xlib is kept out of this header, its macros clash with Godot names
+struct _XDisplay;
+
+namespace godot {
+
+// Connections of our own for background threads that read other clients' windows.
+// Such a window can be destroyed between learning its id and reading it, and Xlib's
+// default error handler exits the process on the BadWindow that follows. Errors on
+// these connections are handled here instead: BadWindow and BadDrawable are counted
+// and ignored, the call that caused them fails as usual, anything else is logged.
+// Errors on every other connection go to the handler installed before.
+
+// XOpenDisplay for a background thread, null when the display cannot be reached
+_XDisplay *open_background_display(const char *name = nullptr);
+void close_background_display(_XDisplay *display);
+
+// BadWindow and BadDrawable ignored on background connections so far
+uint64_t get_ignored_x11_error_count();
+
+} // namespace godot
+
+#endif // __linux__ || __FreeBSD__
+
+#endif // X11_DISPLAY_H
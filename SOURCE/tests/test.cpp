@@ -0,0 +1,66 @@
+// Unit test runner for the Godot-free core.
+// Usage: overlay_tests [--filter text]
+// The exit code is the number of failed cases.
+
+#include "test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace test {
+
+namespace {
+
+struct TestCase {
+    const char *name;
+    TestFunction function;
+};
+
+std::vector<TestCase> &get_registry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+} // namespace
+
+bool TestRun::check(bool passed, const char *expression, const char *file, int line) {
+    if (!passed) {
+        failures++;
+        fprintf(stderr, "  %s:%d: CHECK(%s) failed\n", file, line, expression);
+    }
+    return passed;
+}
+
+TestRegistrar::TestRegistrar(const char *name, TestFunction function) {
+    get_registry().push_back({ name, function });
+}
+
+} // namespace test
+
+int main(int argc, char **argv) {
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--filter text]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int ran = 0;
+    int failed = 0;
+    for (const test::TestCase &test_case : test::get_registry()) {
+        if (filter && !strstr(test_case.name, filter)) {
+            continue;
+        }
+        test::TestRun run;
+        test_case.function(run);
+        ran++;
+        failed += run.get_failures() > 0;
+        fprintf(stderr, "%-48s %s\n", test_case.name, run.get_failures() ? "FAILED" : "ok");
+    }
+    fprintf(stderr, "%d of %d cases passed\n", ran - failed, ran);
+    return failed;
+}
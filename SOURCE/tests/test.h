@@ -0,0 +1,39 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstdint>
+
+namespace test {
+
+// Handed to every test case, counts the checks that failed
+class TestRun {
+public:
+    // Reports a failed check with its location, returns the result so callers can bail out
+    bool check(bool passed, const char *expression, const char *file, int line);
+
+    int get_failures() const {
+        return failures;
+    }
+
+private:
+    int failures = 0;
+};
+
+using TestFunction = void (*)(TestRun &);
+
+// Adds a case to the global registry from a static initializer
+struct TestRegistrar {
+    TestRegistrar(const char *name, TestFunction function);
+};
+
+} // namespace test
+
+#define TEST_CASE(name)                                                        \
+    static void test_##name(::test::TestRun &run);                             \
+    static ::test::TestRegistrar test_registrar_##name(#name, &test_##name); \
+    static void test_##name(::test::TestRun &run)
+
+// Failed checks are reported and counted, the case carries on
+#define CHECK(expression) run.check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif // TEST_H
@@ -0,0 +1,249 @@
+// GestureRecognizer on scripted key streams with known outcomes. Each stream is built
+// the way the Windows hook publishes records: modifiers tracked per side, sided modifier
+// keys folded onto the generic ones. Every stream is replayed once with only the key
+// records and again with 60 Hz and 20 Hz advances in between, the results including
+// their timestamps must not change.
+
+#include "test.h"
+
+#include "core/gesture_recognizer.h"
+#include "core/keybind_table.h"
+#include "core/keycode_tables.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+// Windows virtual keys as WH_KEYBOARD_LL reports them
+constexpr uint16_t VK_SPACE = 0x20;
+constexpr uint16_t VK_A = 0x41;
+constexpr uint16_t VK_C = 0x43;
+constexpr uint16_t VK_D = 0x44;
+constexpr uint16_t VK_G = 0x47;
+constexpr uint16_t VK_H = 0x48;
+constexpr uint16_t VK_X = 0x58;
+constexpr uint16_t VK_LSHIFT = 0xA0;
+constexpr uint16_t VK_RSHIFT = 0xA1;
+constexpr uint16_t VK_LCONTROL = 0xA2;
+constexpr uint16_t VK_RCONTROL = 0xA3;
+
+enum Action : uint16_t {
+    ACTION_HOLD_H,
+    ACTION_DOUBLE_D,
+    ACTION_SEQUENCE_GGX,
+    ACTION_DOUBLE_SHIFT,
+    ACTION_HOLD_CTRL_SPACE,
+    ACTION_HOLD_CTRL,
+};
+
+constexpr GestureRecognizer::Phase RECOGNIZED = GestureRecognizer::PHASE_RECOGNIZED;
+constexpr GestureRecognizer::Phase RELEASED = GestureRecognizer::PHASE_RELEASED;
+
+GestureRecognizer::Gesture make_gesture(GestureRecognizer::Kind kind, uint16_t action, uint64_t duration_msec, std::vector<GestureRecognizer::Step> steps) {
+    GestureRecognizer::Gesture gesture;
+    gesture.kind = kind;
+    gesture.action = action;
+    gesture.duration_usec = duration_msec * 1000;
+    gesture.steps = std::move(steps);
+    return gesture;
+}
+
+void build_gestures(GestureRecognizer &recognizer) {
+    // Modifier keys compile as Overlay::make_gesture does: the OS key from the Godot
+    // one, without the key's own modifier bit
+    const uint16_t shift = uint16_t(keycodes::godot_to_windows_vk(keycodes::special(0x15)));
+    const uint16_t ctrl = uint16_t(keycodes::godot_to_windows_vk(keycodes::special(0x16)));
+    const GestureRecognizer::Gesture gestures[] = {
+        make_gesture(GestureRecognizer::KIND_HOLD, ACTION_HOLD_H, 300, { { VK_H, 0 } }),
+        make_gesture(GestureRecognizer::KIND_DOUBLE_TAP, ACTION_DOUBLE_D, 250, { { VK_D, 0 } }),
+        make_gesture(GestureRecognizer::KIND_SEQUENCE, ACTION_SEQUENCE_GGX, 500, { { VK_G, 0 }, { VK_G, 0 }, { VK_X, 0 } }),
+        make_gesture(GestureRecognizer::KIND_DOUBLE_TAP, ACTION_DOUBLE_SHIFT, 300, { { shift, 0 } }),
+        make_gesture(GestureRecognizer::KIND_HOLD, ACTION_HOLD_CTRL_SPACE, 200, { { VK_SPACE, MODIFIER_CTRL } }),
+        make_gesture(GestureRecognizer::KIND_HOLD, ACTION_HOLD_CTRL, 300, { { ctrl, 0 } }),
+    };
+    ModifierTracker modifier_keys;
+    modifier_keys.set_windows_keycodes();
+    recognizer.set_modifier_keys(modifier_keys);
+    recognizer.compile(gestures, sizeof(gestures) / sizeof(gestures[0]));
+}
+
+// Key records as the hook publishes them
+struct StreamBuilder {
+    ModifierTracker tracker;
+    std::vector<KeyEvent> events;
+
+    StreamBuilder() {
+        tracker.set_windows_keycodes();
+    }
+
+    StreamBuilder &key(uint64_t msec, uint16_t vk, bool pressed) {
+        KeyEvent event;
+        event.timestamp_usec = msec * 1000;
+        event.keycode = uint16_t(keycodes::windows_generic_vk(vk));
+        event.flags = pressed ? KEY_EVENT_PRESSED : 0;
+        event.modifiers = tracker.update(vk, pressed);
+        events.push_back(event);
+        return *this;
+    }
+    StreamBuilder &down(uint64_t msec, uint16_t vk) {
+        return key(msec, vk, true);
+    }
+    StreamBuilder &up(uint64_t msec, uint16_t vk) {
+        return key(msec, vk, false);
+    }
+    // Press and release
+    StreamBuilder &tap(uint64_t msec, uint16_t vk) {
+        return down(msec, vk).up(msec + 40, vk);
+    }
+};
+
+struct Expected {
+    uint16_t action;
+    GestureRecognizer::Phase phase;
+    uint64_t msec;
+};
+
+// Replay a stream, with an advance every frame_usec in between when it is not 0
+void replay(GestureRecognizer &recognizer, const std::vector<KeyEvent> &events, uint64_t frame_usec, std::vector<GestureRecognizer::Result> &r_results) {
+    uint64_t frame = 0;
+    for (const KeyEvent &event : events) {
+        while (frame_usec && frame + frame_usec < event.timestamp_usec) {
+            frame += frame_usec;
+            recognizer.advance(frame, r_results);
+        }
+        recognizer.process(event, r_results);
+    }
+    recognizer.advance(events.empty() ? 0 : events.back().timestamp_usec + 10000000, r_results);
+}
+
+// Replays the stream at every frame rate, returns false and names it on a difference
+bool recognizes(const char *name, const StreamBuilder &stream, const std::vector<Expected> &expected) {
+    GestureRecognizer recognizer;
+    build_gestures(recognizer);
+    std::vector<GestureRecognizer::Result> results;
+    const uint64_t frame_usecs[] = { 0, 16667, 50000 };
+    bool passed = true;
+    for (uint64_t frame_usec : frame_usecs) {
+        recognizer.reset(0, results);
+        results.clear();
+        replay(recognizer, stream.events, frame_usec, results);
+        bool same = results.size() == expected.size();
+        for (size_t i = 0; same && i < results.size(); i++) {
+            same = results[i].action == expected[i].action && results[i].phase == expected[i].phase &&
+                    results[i].timestamp_usec == expected[i].msec * 1000;
+        }
+        if (!same) {
+            fprintf(stderr, "  %s: %zu results instead of %zu with frames of %llu usec\n", name, results.size(),
+                    expected.size(), (unsigned long long)frame_usec);
+        }
+        passed = passed && same;
+    }
+    return passed;
+}
+
+} // namespace
+
+TEST_CASE(gesture_hold) {
+    // Held past the threshold, auto-repeat in between
+    StreamBuilder s;
+    s.down(0, VK_H).down(30, VK_H).down(60, VK_H).down(90, VK_H).up(500, VK_H);
+    CHECK(recognizes("hold", s, { { ACTION_HOLD_H, RECOGNIZED, 300 }, { ACTION_HOLD_H, RELEASED, 500 } }));
+
+    s = StreamBuilder();
+    s.down(0, VK_H).up(299, VK_H);
+    CHECK(recognizes("hold_too_short", s, {}));
+
+    // Another key before the threshold cancels it, after the threshold it does not
+    s = StreamBuilder();
+    s.down(0, VK_H).tap(100, VK_A).up(400, VK_H);
+    CHECK(recognizes("hold_interrupted", s, {}));
+
+    s = StreamBuilder();
+    s.down(0, VK_H).tap(350, VK_A).up(420, VK_H);
+    CHECK(recognizes("hold_typing_while_active", s, { { ACTION_HOLD_H, RECOGNIZED, 300 }, { ACTION_HOLD_H, RELEASED, 420 } }));
+
+    s = StreamBuilder();
+    s.down(0, VK_LCONTROL).down(10, VK_SPACE).up(300, VK_SPACE).up(320, VK_LCONTROL);
+    CHECK(recognizes("hold_with_modifier", s, { { ACTION_HOLD_CTRL_SPACE, RECOGNIZED, 210 }, { ACTION_HOLD_CTRL_SPACE, RELEASED, 300 } }));
+
+    s = StreamBuilder();
+    s.down(10, VK_SPACE).up(300, VK_SPACE);
+    CHECK(recognizes("hold_missing_modifier", s, {}));
+}
+
+TEST_CASE(gesture_double_tap) {
+    StreamBuilder s;
+    s.tap(0, VK_D).tap(200, VK_D);
+    CHECK(recognizes("double_tap", s, { { ACTION_DOUBLE_D, RECOGNIZED, 200 } }));
+
+    // The late second press starts a new double tap that the third completes
+    s = StreamBuilder();
+    s.tap(0, VK_D).tap(250, VK_D).tap(400, VK_D);
+    CHECK(recognizes("double_tap_too_slow", s, { { ACTION_DOUBLE_D, RECOGNIZED, 400 } }));
+
+    s = StreamBuilder();
+    s.tap(0, VK_D).tap(100, VK_A).tap(160, VK_D);
+    CHECK(recognizes("double_tap_interrupted", s, {}));
+
+    // A triple tap is one double tap, the third press starts over
+    s = StreamBuilder();
+    s.tap(0, VK_D).tap(100, VK_D).tap(200, VK_D);
+    CHECK(recognizes("triple_tap", s, { { ACTION_DOUBLE_D, RECOGNIZED, 100 } }));
+}
+
+TEST_CASE(gesture_sequence) {
+    StreamBuilder s;
+    s.tap(0, VK_G).tap(200, VK_G).tap(400, VK_X);
+    CHECK(recognizes("sequence", s, { { ACTION_SEQUENCE_GGX, RECOGNIZED, 400 } }));
+
+    // Timed out after the first key, the late one counts as a fresh first key
+    s = StreamBuilder();
+    s.tap(0, VK_G).tap(600, VK_G).tap(700, VK_G).tap(800, VK_X);
+    CHECK(recognizes("sequence_restart", s, { { ACTION_SEQUENCE_GGX, RECOGNIZED, 800 } }));
+
+    s = StreamBuilder();
+    s.tap(0, VK_G).tap(100, VK_A).tap(200, VK_G).tap(300, VK_X);
+    CHECK(recognizes("sequence_interrupted", s, {}));
+
+    // G G G X: the third G is not X, it restarts at the second step
+    s = StreamBuilder();
+    s.tap(0, VK_G).tap(100, VK_G).tap(200, VK_G).tap(300, VK_G).tap(400, VK_X);
+    CHECK(recognizes("sequence_overlap", s, { { ACTION_SEQUENCE_GGX, RECOGNIZED, 400 } }));
+
+    // Gestures on different keys run side by side
+    s = StreamBuilder();
+    s.down(0, VK_H).tap(310, VK_D).tap(400, VK_D).up(600, VK_H);
+    CHECK(recognizes("hold_and_double_tap", s, { { ACTION_HOLD_H, RECOGNIZED, 300 }, { ACTION_DOUBLE_D, RECOGNIZED, 400 }, { ACTION_HOLD_H, RELEASED, 600 } }));
+}
+
+TEST_CASE(gesture_sided_modifier_keys) {
+    // The hook reports either side, a gesture on the bare modifier takes both
+    StreamBuilder s;
+    s.down(0, VK_RCONTROL).down(100, VK_RCONTROL).up(450, VK_RCONTROL);
+    CHECK(recognizes("hold_right_ctrl", s, { { ACTION_HOLD_CTRL, RECOGNIZED, 300 }, { ACTION_HOLD_CTRL, RELEASED, 450 } }));
+
+    s = StreamBuilder();
+    s.down(0, VK_LCONTROL).up(350, VK_LCONTROL);
+    CHECK(recognizes("hold_left_ctrl", s, { { ACTION_HOLD_CTRL, RECOGNIZED, 300 }, { ACTION_HOLD_CTRL, RELEASED, 350 } }));
+
+    // Ctrl used for a shortcut is not a hold of its own
+    s = StreamBuilder();
+    s.down(0, VK_RCONTROL).tap(100, VK_C).up(400, VK_RCONTROL);
+    CHECK(recognizes("hold_ctrl_shortcut", s, {}));
+
+    s = StreamBuilder();
+    s.tap(0, VK_LSHIFT).tap(150, VK_LSHIFT);
+    CHECK(recognizes("double_tap_left_shift", s, { { ACTION_DOUBLE_SHIFT, RECOGNIZED, 150 } }));
+
+    s = StreamBuilder();
+    s.tap(0, VK_RSHIFT).tap(150, VK_LSHIFT);
+    CHECK(recognizes("double_tap_either_shift", s, { { ACTION_DOUBLE_SHIFT, RECOGNIZED, 150 } }));
+
+    // Shift held for a capital does not count as a tap of its own
+    s = StreamBuilder();
+    s.tap(0, VK_RSHIFT).down(100, VK_RSHIFT).tap(120, VK_A).up(200, VK_RSHIFT).tap(260, VK_RSHIFT);
+    CHECK(recognizes("double_tap_shift_interrupted", s, { { ACTION_DOUBLE_SHIFT, RECOGNIZED, 100 } }));
+}
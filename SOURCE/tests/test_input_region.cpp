@@ -0,0 +1,251 @@
+// InputRegionIndex and coalesce_region: change tracking, and coverage checked pixel by pixel
+// against a brute-force union for overlapping, adjacent, contained, empty and edge cases.
+
+#include "test.h"
+
+#include "core/input_region.h"
+
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+// Brute-force coverage of the union, the reference every region is compared with
+bool covered(const std::vector<RegionRect> &rects, int32_t x, int32_t y) {
+    for (const RegionRect &rect : rects) {
+        if (rect.has_point(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Disjoint, non-empty, sorted by band then x, and no two touching bands with the same spans
+bool is_banded(const std::vector<RegionRect> &region) {
+    for (size_t i = 0; i < region.size(); i++) {
+        const RegionRect &rect = region[i];
+        if (rect.is_empty()) {
+            return false;
+        }
+        if (i > 0) {
+            const RegionRect &previous = region[i - 1];
+            bool same_band = previous.y == rect.y && previous.height == rect.height;
+            if (same_band ? previous.x + previous.width >= rect.x : previous.y + previous.height > rect.y) {
+                return false; // Overlapping, touching spans left unmerged, or out of order
+            }
+        }
+    }
+    // Bands are the runs of rectangles with the same y
+    size_t band_start = 0;
+    size_t previous_start = 0;
+    size_t previous_end = 0;
+    while (band_start < region.size()) {
+        size_t band_end = band_start;
+        while (band_end < region.size() && region[band_end].y == region[band_start].y) {
+            band_end++;
+        }
+        if (previous_end > previous_start && band_end - band_start == previous_end - previous_start &&
+                region[previous_start].y + region[previous_start].height == region[band_start].y) {
+            bool same_spans = true;
+            for (size_t i = 0; i < band_end - band_start; i++) {
+                same_spans = same_spans && region[previous_start + i].x == region[band_start + i].x &&
+                        region[previous_start + i].width == region[band_start + i].width;
+            }
+            if (same_spans) {
+                return false; // Should have grown the band above
+            }
+        }
+        previous_start = band_start;
+        previous_end = band_end;
+        band_start = band_end;
+    }
+    return true;
+}
+
+// Coalesces and checks the region covers exactly the union over the given area
+bool matches_union(const std::vector<RegionRect> &rects, std::vector<RegionRect> &r_region, int32_t min, int32_t max) {
+    coalesce_region(rects, r_region);
+    if (!is_banded(r_region)) {
+        return false;
+    }
+    for (int32_t y = min; y < max; y++) {
+        for (int32_t x = min; x < max; x++) {
+            if (covered(rects, x, y) != covered(r_region, x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(input_region_index_tracks_changes) {
+    InputRegionIndex index(64);
+    CHECK(!index.update_region());
+    CHECK(index.get_region().empty());
+
+    index.set_rect(1, { 10, 10, 100, 50 });
+    index.set_rect(2, { 300, 0, 20, 20 });
+    CHECK(index.get_rect_count() == 2);
+    CHECK(index.update_region());
+    CHECK(index.get_region().size() == 4); // Three bands, the middle one holds both
+    CHECK(!index.update_region()); // Nothing changed since
+
+    // Setting the same rectangle again is not a change
+    index.set_rect(1, { 10, 10, 100, 50 });
+    CHECK(!index.update_region());
+
+    // Moving across cells follows the rectangle, the old cells forget it
+    index.set_rect(1, { 500, 500, 10, 10 });
+    CHECK(index.update_region());
+    CHECK(index.hit_test(505, 505));
+    CHECK(!index.hit_test(50, 30));
+
+    // An empty rectangle removes
+    index.set_rect(2, { 300, 0, 0, 20 });
+    CHECK(index.get_rect_count() == 1);
+    CHECK(!index.hit_test(310, 10));
+    CHECK(index.update_region());
+    CHECK(index.get_region().size() == 1 && index.get_region()[0] == RegionRect({ 500, 500, 10, 10 }));
+
+    // Two halves replacing one rectangle leave the same union, not reported as a change
+    index.set_rect(1, { 500, 500, 10, 5 });
+    index.set_rect(3, { 500, 505, 10, 5 });
+    CHECK(!index.update_region());
+    CHECK(index.get_region().size() == 1);
+
+    index.remove(42); // Unknown ids are ignored
+    index.clear();
+    CHECK(index.get_rect_count() == 0);
+    CHECK(index.update_region());
+    CHECK(index.get_region().empty());
+    CHECK(!index.hit_test(505, 505));
+}
+
+TEST_CASE(input_region_index_negative_coordinates) {
+    // Windows partly off the left or top edge keep negative coordinates
+    InputRegionIndex index(32);
+    index.set_rect(1, { -40, -40, 30, 30 });
+    CHECK(index.hit_test(-40, -40));
+    CHECK(index.hit_test(-11, -11));
+    CHECK(!index.hit_test(-10, -10));
+    CHECK(!index.hit_test(-41, -20));
+    index.remove(1);
+    CHECK(!index.hit_test(-20, -20));
+}
+
+TEST_CASE(coalesce_region_overlapping_adjacent_contained) {
+    std::vector<RegionRect> region;
+
+    // Overlapping: three bands, the middle one joined
+    CHECK(matches_union({ { 0, 0, 10, 10 }, { 5, 5, 10, 10 } }, region, -2, 20));
+    CHECK(region == std::vector<RegionRect>({ { 0, 0, 10, 5 }, { 0, 5, 15, 5 }, { 5, 10, 10, 5 } }));
+
+    // Side by side and stacked: one rectangle each
+    CHECK(matches_union({ { 0, 0, 10, 10 }, { 10, 0, 10, 10 } }, region, -2, 25));
+    CHECK(region == std::vector<RegionRect>({ { 0, 0, 20, 10 } }));
+    CHECK(matches_union({ { 0, 0, 10, 10 }, { 0, 10, 10, 10 } }, region, -2, 25));
+    CHECK(region == std::vector<RegionRect>({ { 0, 0, 10, 20 } }));
+
+    // Touching only at a corner: two rectangles in two bands
+    CHECK(matches_union({ { 0, 0, 10, 10 }, { 10, 10, 10, 10 } }, region, -2, 25));
+    CHECK(region.size() == 2);
+
+    // A gap of one pixel stays a gap
+    CHECK(matches_union({ { 0, 0, 10, 10 }, { 11, 0, 10, 10 } }, region, -2, 25));
+    CHECK(region.size() == 2);
+
+    // Contained, in either order, and duplicates
+    CHECK(matches_union({ { 0, 0, 20, 20 }, { 5, 5, 5, 5 } }, region, -2, 25));
+    CHECK(region == std::vector<RegionRect>({ { 0, 0, 20, 20 } }));
+    CHECK(matches_union({ { 5, 5, 5, 5 }, { 0, 0, 20, 20 }, { 5, 5, 5, 5 } }, region, -2, 25));
+    CHECK(region == std::vector<RegionRect>({ { 0, 0, 20, 20 } }));
+
+    // A cross leaves a hole-free plus shape in three bands
+    CHECK(matches_union({ { 8, 0, 4, 20 }, { 0, 8, 20, 4 } }, region, -2, 25));
+    CHECK(region.size() == 3);
+
+    // Negative coordinates
+    CHECK(matches_union({ { -10, -10, 8, 8 }, { -4, -4, 8, 8 } }, region, -12, 8));
+}
+
+TEST_CASE(coalesce_region_empty_input) {
+    std::vector<RegionRect> region = { { 1, 2, 3, 4 } };
+    coalesce_region({}, region);
+    CHECK(region.empty()); // The output is replaced, not appended to
+
+    // Zero or negative sizes are ignored, alone or next to real rectangles
+    coalesce_region({ { 0, 0, 0, 10 }, { 5, 5, 10, 0 }, { 3, 3, -4, 5 } }, region);
+    CHECK(region.empty());
+    CHECK(matches_union({ { 0, 0, 0, 10 }, { 2, 2, 4, 4 }, { 5, 5, 10, -1 } }, region, -2, 12));
+    CHECK(region == std::vector<RegionRect>({ { 2, 2, 4, 4 } }));
+}
+
+TEST_CASE(coalesce_region_random_unions) {
+    // Small random rectangles on a small grid hit every overlap and adjacency pattern
+    uint32_t state = 12345;
+    auto next = [&state](int32_t range) {
+        state = state * 1664525u + 1013904223u;
+        return int32_t((state >> 8) % uint32_t(range));
+    };
+    int failures = 0;
+    std::vector<RegionRect> rects;
+    std::vector<RegionRect> region;
+    for (int round = 0; round < 500; round++) {
+        rects.clear();
+        int count = 1 + next(8);
+        for (int i = 0; i < count; i++) {
+            rects.push_back({ next(24) - 4, next(24) - 4, next(10), next(10) });
+        }
+        failures += !matches_union(rects, region, -6, 32);
+    }
+    CHECK(failures == 0);
+}
+
+TEST_CASE(input_region_hit_test_on_edges) {
+    // Rectangles on and across cell boundaries, each pixel against the reference
+    InputRegionIndex index(16);
+    std::vector<RegionRect> rects = {
+        { 0, 0, 16, 16 }, // Exactly one cell
+        { 16, 0, 1, 1 }, // First pixel of the next cell
+        { 31, 31, 2, 2 }, // Across four cells
+        { -16, -1, 16, 1 }, // Ends at the origin
+        { 40, 8, 10, 30 },
+        { 45, 20, 10, 5 }, // Overlapping the one before
+    };
+    for (size_t i = 0; i < rects.size(); i++) {
+        index.set_rect(i + 1, rects[i]);
+    }
+    int failures = 0;
+    for (int32_t y = -20; y < 60; y++) {
+        for (int32_t x = -20; x < 60; x++) {
+            failures += index.hit_test(x, y) != covered(rects, x, y);
+        }
+    }
+    CHECK(failures == 0);
+
+    // Right and bottom edges are outside, left and top inside
+    CHECK(index.hit_test(0, 0) && index.hit_test(15, 15));
+    CHECK(index.hit_test(16, 0) && !index.hit_test(17, 0) && !index.hit_test(16, 1));
+    CHECK(index.hit_test(32, 32) && !index.hit_test(33, 32) && !index.hit_test(32, 33) && !index.hit_test(30, 31));
+    CHECK(index.hit_test(-16, -1) && index.hit_test(-1, -1) && !index.hit_test(-17, -1) && !index.hit_test(-16, -2));
+    CHECK(index.hit_test(49, 37) && !index.hit_test(50, 37) && !index.hit_test(49, 38));
+
+    // The coalesced region agrees with the index
+    index.update_region();
+    failures = 0;
+    for (int32_t y = -20; y < 60; y++) {
+        for (int32_t x = -20; x < 60; x++) {
+            failures += index.hit_test(x, y) != covered(index.get_region(), x, y);
+        }
+    }
+    CHECK(failures == 0);
+    CHECK(is_banded(index.get_region()));
+
+    // Nothing is hit once empty
+    InputRegionIndex empty;
+    CHECK(!empty.hit_test(0, 0) && !empty.hit_test(-1, -1));
+    CHECK(!empty.update_region() && empty.get_region().empty());
+}
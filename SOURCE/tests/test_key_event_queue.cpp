@@ -0,0 +1,106 @@
+// SpscRing and KeyEventQueue: order, overflow, drain and a producer on another thread.
+
+#include "test.h"
+
+#include "core/key_event_queue.h"
+
+#include <memory>
+#include <thread>
+
+using namespace godot;
+
+TEST_CASE(spsc_ring_push_pop_in_order) {
+    SpscRing<int, 4> ring;
+    int item = 0;
+    CHECK(ring.is_empty());
+    CHECK(!ring.pop(item));
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring.push(i));
+    }
+    CHECK(!ring.is_empty());
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring.pop(item) && item == i);
+    }
+    CHECK(!ring.pop(item));
+    CHECK(ring.is_empty());
+    CHECK(ring.get_dropped_count() == 0);
+}
+
+TEST_CASE(spsc_ring_drops_when_full) {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring.push(i));
+    }
+    CHECK(!ring.push(4));
+    CHECK(!ring.push(5));
+    CHECK(ring.get_dropped_count() == 2);
+
+    // The oldest items stay, a freed slot takes the next push
+    int item = -1;
+    CHECK(ring.pop(item) && item == 0);
+    CHECK(ring.push(6));
+    int expected[] = { 1, 2, 3, 6 };
+    for (int value : expected) {
+        CHECK(ring.pop(item) && item == value);
+    }
+    CHECK(ring.is_empty());
+}
+
+TEST_CASE(spsc_ring_drain_across_the_wrap) {
+    SpscRing<int, 8> ring;
+    int next_push = 0;
+    int next_drain = 0;
+    bool in_order = true;
+    // Batches of every size up to full cross the wrap many times
+    for (int round = 0; round < 100; round++) {
+        int batch = round % 9;
+        for (int i = 0; i < batch; i++) {
+            CHECK(ring.push(next_push++));
+        }
+        size_t drained = ring.drain([&](const int &item) {
+            in_order = in_order && item == next_drain;
+            next_drain++;
+        });
+        CHECK(drained == size_t(batch));
+        CHECK(ring.is_empty());
+    }
+    CHECK(in_order);
+    CHECK(next_drain == next_push);
+    CHECK(ring.drain([](const int &) {}) == 0);
+}
+
+TEST_CASE(key_event_queue_across_threads) {
+    // The hook thread pushes while the main thread drains, nothing is lost or reordered
+    std::unique_ptr<KeyEventQueue> queue(new KeyEventQueue());
+    const uint64_t total = 200000;
+    std::thread producer([&queue, total]() {
+        for (uint64_t i = 0; i < total; i++) {
+            KeyEvent event;
+            event.timestamp_usec = i;
+            event.keycode = uint16_t(i & 0x1FF);
+            event.flags = (i & 1) ? KEY_EVENT_PRESSED : 0;
+            while (!queue->push(event)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t received = 0;
+    bool in_order = true;
+    while (received < total) {
+        size_t drained = queue->drain([&](const KeyEvent &event) {
+            in_order = in_order && event.timestamp_usec == received && event.keycode == uint16_t(received & 0x1FF) &&
+                    event.flags == ((received & 1) ? KEY_EVENT_PRESSED : 0);
+            received++;
+        });
+        if (drained == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(in_order);
+    CHECK(received == total);
+    CHECK(queue->is_empty());
+    CHECK(KeyEventQueue::capacity() == 1024);
+    CHECK(sizeof(KeyEvent) == 16);
+}
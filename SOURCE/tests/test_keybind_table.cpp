@@ -0,0 +1,90 @@
+// KeybindTable compilation and matching, ModifierTracker state.
+
+#include "test.h"
+
+#include "core/keybind_table.h"
+
+using namespace godot;
+
+TEST_CASE(keybind_table_matches_exact_modifiers) {
+    KeybindTable table;
+    const KeybindTable::Binding bindings[] = {
+        { 0x70, MODIFIER_CTRL, 0 },
+        { 0x70, MODIFIER_CTRL | MODIFIER_SHIFT, 1 },
+        { 0x41, 0, 2 },
+        { 0x1FF, MODIFIER_ALT | MODIFIER_META, 3 }, // Last slot
+    };
+    CHECK(table.compile(bindings, 4) == 0);
+    CHECK(table.get_binding_count() == 4);
+
+    CHECK(table.match(0x70, MODIFIER_CTRL) == 0);
+    CHECK(table.match(0x70, MODIFIER_CTRL | MODIFIER_SHIFT) == 1);
+    CHECK(table.match(0x70, 0) == KeybindTable::NO_ACTION);
+    CHECK(table.match(0x70, MODIFIER_CTRL | MODIFIER_ALT) == KeybindTable::NO_ACTION);
+    CHECK(table.match(0x41, 0) == 2);
+    CHECK(table.match(0x41, MODIFIER_SHIFT) == KeybindTable::NO_ACTION);
+    CHECK(table.match(0x1FF, MODIFIER_ALT | MODIFIER_META) == 3);
+    CHECK(table.match(0x42, 0) == KeybindTable::NO_ACTION);
+
+    // Keycodes past the table never match
+    CHECK(table.match(KeybindTable::KEY_SLOTS, 0) == KeybindTable::NO_ACTION);
+    CHECK(table.match(0xFFFF, MODIFIER_CTRL) == KeybindTable::NO_ACTION);
+}
+
+TEST_CASE(keybind_table_rejects_and_replaces) {
+    KeybindTable table;
+    const KeybindTable::Binding bindings[] = {
+        { 0x70, MODIFIER_CTRL, 0 },
+        { 0x70, MODIFIER_CTRL, 5 }, // Later entries win
+        { KeybindTable::KEY_SLOTS, 0, 1 },
+        { 0x41, KeybindTable::MODIFIER_COMBINATIONS, 2 },
+        { 0x42, 0, KeybindTable::NO_ACTION },
+    };
+    CHECK(table.compile(bindings, 5) == 3);
+    CHECK(table.match(0x70, MODIFIER_CTRL) == 5);
+    CHECK(table.match(0x41, 0) == KeybindTable::NO_ACTION);
+    CHECK(table.match(0x42, 0) == KeybindTable::NO_ACTION);
+
+    // Compiling again replaces every binding
+    const KeybindTable::Binding replacement = { 0x71, MODIFIER_CTRL, 1 };
+    CHECK(table.compile(&replacement, 1) == 0);
+    CHECK(table.match(0x70, MODIFIER_CTRL) == KeybindTable::NO_ACTION);
+    CHECK(table.match(0x71, MODIFIER_CTRL) == 1);
+    CHECK(table.get_binding_count() == 1);
+
+    table.clear();
+    CHECK(table.match(0x71, MODIFIER_CTRL) == KeybindTable::NO_ACTION);
+    CHECK(table.get_binding_count() == 0);
+}
+
+TEST_CASE(modifier_tracker_follows_both_sides) {
+    ModifierTracker tracker;
+    tracker.set_windows_keycodes();
+    const uint16_t left_ctrl = 0xA2;
+    const uint16_t right_ctrl = 0xA3;
+    const uint16_t left_shift = 0xA0;
+    const uint16_t key_a = 0x41;
+
+    CHECK(tracker.update(key_a, true) == 0);
+    CHECK(!tracker.is_modifier(key_a));
+    CHECK(tracker.is_modifier(left_ctrl));
+    CHECK(tracker.update(left_ctrl, true) == MODIFIER_CTRL);
+    CHECK(tracker.update(right_ctrl, true) == MODIFIER_CTRL);
+    CHECK(tracker.update(left_shift, true) == (MODIFIER_CTRL | MODIFIER_SHIFT));
+
+    // Ctrl stays held until both sides are released
+    CHECK(tracker.update(left_ctrl, false) == (MODIFIER_CTRL | MODIFIER_SHIFT));
+    CHECK(tracker.update(right_ctrl, false) == MODIFIER_SHIFT);
+    CHECK(tracker.update(key_a, false) == MODIFIER_SHIFT);
+
+    tracker.reset();
+    CHECK(tracker.get_modifiers() == 0);
+
+    // X11 keycodes are evdev + 8
+    ModifierTracker x11;
+    x11.set_x11_keycodes();
+    CHECK(x11.update(37, true) == MODIFIER_CTRL);
+    CHECK(x11.update(64, true) == (MODIFIER_CTRL | MODIFIER_ALT));
+    CHECK(x11.update(133, true) == (MODIFIER_CTRL | MODIFIER_ALT | MODIFIER_META));
+    CHECK(x11.update(KeybindTable::KEY_SLOTS + 10, true) == (MODIFIER_CTRL | MODIFIER_ALT | MODIFIER_META));
+}
@@ -0,0 +1,156 @@
+// Keycode tables checked over every KEY_ROWS entry and every OS code. keycode_tables.h
+// static_asserts the round trips as well, these name the rows that fail and also check
+// that codes no row uses translate to nothing.
+
+#include "test.h"
+
+#include "core/keycode_tables.h"
+
+#include <cstdio>
+
+using namespace godot;
+using namespace godot::keycodes;
+
+namespace {
+
+struct Column {
+    const char *name;
+    uint32_t (*code)(const KeyRow &row);
+    uint32_t (*to_os)(uint32_t godot_keycode);
+    uint32_t (*to_godot)(uint32_t code);
+    uint32_t code_limit; // Every code below this is swept
+    uint32_t page_begin; // And this range, where the table has another page
+    uint32_t page_end;
+};
+
+const Column COLUMNS[] = {
+    { "windows_vk", [](const KeyRow &row) { return uint32_t(row.windows_vk); }, godot_to_windows_vk, windows_vk_to_godot, 0x10000, 0, 0 },
+    { "windows_scancode", [](const KeyRow &row) { return uint32_t(row.windows_scancode); }, godot_to_windows_scancode, windows_scancode_to_godot, 0x10000, 0, 0 },
+    { "x11_keysym", [](const KeyRow &row) { return row.x11_keysym; }, godot_to_x11_keysym, x11_keysym_to_godot, 0x10000, 0x1008FE00, 0x10090100 },
+    { "evdev", [](const KeyRow &row) { return uint32_t(row.evdev); }, godot_to_evdev, evdev_to_godot, 0x10000, 0, 0 },
+};
+
+// Godot key of the first row using the code, 0 when no row does
+uint32_t first_godot_for(const Column &column, uint32_t code) {
+    for (const KeyRow &row : KEY_ROWS) {
+        if (column.code(row) == code) {
+            return row.godot;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+TEST_CASE(keycode_rows_have_unique_godot_keys) {
+    int duplicates = 0;
+    for (size_t i = 0; i < KEY_ROW_COUNT; i++) {
+        CHECK(godot_slot(KEY_ROWS[i].godot) != 0);
+        for (size_t j = 0; j < i; j++) {
+            if (godot_slot(KEY_ROWS[i].godot) == godot_slot(KEY_ROWS[j].godot)) {
+                fprintf(stderr, "  rows %zu and %zu share Godot key 0x%x\n", j, i, KEY_ROWS[i].godot);
+                duplicates++;
+            }
+        }
+    }
+    CHECK(duplicates == 0);
+}
+
+TEST_CASE(keycode_rows_round_trip) {
+    for (const Column &column : COLUMNS) {
+        int failures = 0;
+        for (size_t i = 0; i < KEY_ROW_COUNT; i++) {
+            const KeyRow &row = KEY_ROWS[i];
+            uint32_t code = column.code(row);
+            uint32_t forward = column.to_os(row.godot);
+            // Shared codes go back to the canonical, first listed key
+            uint32_t back = code ? column.to_godot(code) : 0;
+            uint32_t expected_back = code ? first_godot_for(column, code) : 0;
+            if (forward != code || back != expected_back) {
+                fprintf(stderr, "  %s row %zu (Godot 0x%x): code 0x%x, forward 0x%x, back 0x%x instead of 0x%x\n",
+                        column.name, i, row.godot, code, forward, back, expected_back);
+                failures++;
+            }
+        }
+        CHECK(failures == 0);
+    }
+}
+
+TEST_CASE(keycode_unused_codes_do_not_map) {
+    for (const Column &column : COLUMNS) {
+        int failures = 0;
+        auto check_code = [&](uint32_t code) {
+            uint32_t expected = first_godot_for(column, code);
+            // Upper case letter keysyms stand for the letter keys
+            if (column.to_os == godot_to_x11_keysym && code >= 'A' && code <= 'Z') {
+                expected = code;
+            }
+            if (code == 0) {
+                expected = 0;
+            }
+            if (column.to_godot(code) != expected) {
+                if (failures < 10) {
+                    fprintf(stderr, "  %s code 0x%x maps to 0x%x instead of 0x%x\n", column.name, code, column.to_godot(code), expected);
+                }
+                failures++;
+            }
+        };
+        for (uint32_t code = 0; code < column.code_limit; code++) {
+            check_code(code);
+        }
+        for (uint32_t code = column.page_begin; code < column.page_end; code++) {
+            check_code(code);
+        }
+        CHECK(failures == 0);
+    }
+
+    // Godot keys outside every row, and malformed ones, have no OS code
+    int failures = 0;
+    for (uint32_t low = 0; low < 0x200; low++) {
+        uint32_t godot_keycode = low < 0x100 ? low : special(low & 0xFF);
+        bool listed = false;
+        for (const KeyRow &row : KEY_ROWS) {
+            listed = listed || row.godot == godot_keycode;
+        }
+        for (const Column &column : COLUMNS) {
+            failures += !listed && column.to_os(godot_keycode) != 0;
+        }
+    }
+    for (const Column &column : COLUMNS) {
+        failures += column.to_os(special(0x7FFFFF)) != 0;
+        failures += column.to_os(0x10041) != 0;
+    }
+    CHECK(failures == 0);
+}
+
+TEST_CASE(keycode_hook_modifier_vks_round_trip) {
+    // What WH_KEYBOARD_LL reports for each side, and the Godot key it must match
+    struct HookVk {
+        uint32_t vk;
+        uint32_t godot;
+    };
+    const HookVk hook_vks[] = {
+        { 0xA0, special(0x15) }, { 0xA1, special(0x15) }, // Shift
+        { 0xA2, special(0x16) }, { 0xA3, special(0x16) }, // Ctrl
+        { 0xA4, special(0x18) }, { 0xA5, special(0x18) }, // Alt
+        { 0x5B, special(0x17) }, { 0x5C, special(0x17) }, // Meta
+    };
+    int failures = 0;
+    for (const HookVk &hook_vk : hook_vks) {
+        uint32_t published = windows_generic_vk(hook_vk.vk);
+        if (windows_vk_to_godot(published) != hook_vk.godot || godot_to_windows_vk(hook_vk.godot) != published) {
+            fprintf(stderr, "  VK 0x%x is published as 0x%x, Godot 0x%x compiles to 0x%x\n", hook_vk.vk, published,
+                    hook_vk.godot, godot_to_windows_vk(hook_vk.godot));
+            failures++;
+        }
+    }
+    CHECK(failures == 0);
+
+    // Every other key is published as reported
+    int changed = 0;
+    for (uint32_t vk = 0; vk < 0x100; vk++) {
+        bool sided = (vk >= 0xA0 && vk <= 0xA5) || vk == 0x5C;
+        changed += !sided && windows_generic_vk(vk) != vk;
+    }
+    CHECK(changed == 0);
+}
@@ -0,0 +1,108 @@
+// NativeWorker: keyed jobs replace queued ones, failures are counted, and stop returns
+// at once while a job is stuck, which then finishes on the detached thread.
+
+#include "test.h"
+
+#include "core/native_worker.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace godot;
+
+namespace {
+
+// Spin until the flag is set or a second has passed
+bool wait_for(const std::atomic<bool> &flag) {
+    for (int i = 0; i < 10000 && !flag.load(); i++) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return flag.load();
+}
+
+} // namespace
+
+TEST_CASE(native_worker_keyed_jobs_replace_queued_ones) {
+    NativeWorker worker;
+    std::shared_ptr<std::atomic<bool>> release = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<bool>> started = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<int>> runs = std::make_shared<std::atomic<int>>(0);
+    std::shared_ptr<std::atomic<bool>> done = std::make_shared<std::atomic<bool>>(false);
+
+    // The first job holds the thread while three more with one key queue up behind it
+    worker.post(0, [release, started]() {
+        started->store(true);
+        while (!release->load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return true;
+    });
+    if (!CHECK(wait_for(*started))) {
+        release->store(true);
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        worker.post(1, [runs]() {
+            runs->fetch_add(1);
+            return false;
+        });
+    }
+    worker.post(0, [done]() {
+        done->store(true);
+        return true;
+    });
+    release->store(true);
+    CHECK(wait_for(*done));
+    CHECK(runs->load() == 1);
+    CHECK(worker.get_failure_count() == 1);
+}
+
+TEST_CASE(native_worker_stop_does_not_wait_for_a_running_job) {
+    std::shared_ptr<std::atomic<bool>> release = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<bool>> started = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<bool>> dropped_ran = std::make_shared<std::atomic<bool>>(false);
+
+    std::chrono::steady_clock::duration stop_time;
+    {
+        // Stands in for SetForegroundWindow behind a hung window
+        NativeWorker worker;
+        worker.post(1, [release, started, finished]() {
+            started->store(true);
+            while (!release->load()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            finished->store(true);
+            return true;
+        });
+        worker.post(2, [dropped_ran]() {
+            dropped_ran->store(true);
+            return true;
+        });
+        if (!CHECK(wait_for(*started))) {
+            release->store(true);
+            return;
+        }
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        worker.stop();
+        stop_time = std::chrono::steady_clock::now() - begin;
+
+        // A stopped worker starts over with the next job
+        std::shared_ptr<std::atomic<bool>> restarted = std::make_shared<std::atomic<bool>>(false);
+        worker.post(1, [restarted]() {
+            restarted->store(true);
+            return true;
+        });
+        CHECK(wait_for(*restarted));
+    }
+    CHECK(stop_time < std::chrono::milliseconds(50));
+    CHECK(!finished->load());
+
+    // The stuck job completes after the worker is gone, the queued one never runs
+    release->store(true);
+    CHECK(wait_for(*finished));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(!dropped_ran->load());
+}
@@ -0,0 +1,83 @@
+// OpacityAnimator against a slow sink: cancel and set_alpha return only once the step
+// in the sink is done, so whatever the caller sends the window next comes after it.
+
+#include "test.h"
+
+#include "core/opacity_animator.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace godot;
+
+namespace {
+
+// Stands in for a native window that takes a while to accept each alpha
+struct SlowSink {
+    std::atomic<bool> in_sink{ false };
+    std::atomic<int> calls{ 0 };
+    std::atomic<int> calls_after_cancel{ 0 };
+    std::atomic<bool> cancelled{ false };
+
+    OpacityAnimator::Sink make() {
+        return [this](uint8_t alpha) {
+            (void)alpha;
+            calls_after_cancel += cancelled.load() ? 1 : 0;
+            in_sink = true;
+            calls++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            in_sink = false;
+            return true;
+        };
+    }
+
+    // Spin until a step is in the sink
+    bool wait_in_sink() {
+        for (int i = 0; i < 2000 && !in_sink.load(); i++) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return in_sink.load();
+    }
+};
+
+} // namespace
+
+TEST_CASE(opacity_cancel_waits_for_the_step_in_the_sink) {
+    for (int round = 0; round < 10; round++) {
+        SlowSink sink;
+        OpacityAnimator animator;
+        animator.set_sink(sink.make());
+        animator.fade_to(0, 1000000, OpacityAnimator::CURVE_LINEAR);
+        if (!CHECK(sink.wait_in_sink())) {
+            return;
+        }
+        animator.cancel();
+        CHECK(!sink.in_sink.load());
+        CHECK(!animator.is_fading());
+
+        // Nothing from the cancelled fade reaches the window later
+        sink.cancelled = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(sink.calls_after_cancel.load() == 0);
+    }
+}
+
+TEST_CASE(opacity_set_alpha_waits_for_the_step_in_the_sink) {
+    SlowSink sink;
+    OpacityAnimator animator;
+    animator.set_sink(sink.make());
+    animator.fade_to(0, 1000000, OpacityAnimator::CURVE_LINEAR);
+    if (!CHECK(sink.wait_in_sink())) {
+        return;
+    }
+    animator.set_alpha(255);
+    CHECK(!sink.in_sink.load());
+    CHECK(animator.get_alpha() == 255);
+    CHECK(animator.get_target() == 255);
+
+    sink.cancelled = true;
+    animator.stop();
+    CHECK(sink.calls_after_cancel.load() == 0);
+    CHECK(sink.calls.load() > 0);
+}
@@ -0,0 +1,137 @@
+// OverlayStateApplier through a mock backend that records every apply_changes call:
+// unchanged states cost nothing, a frame of changes is one call, refused fields are retried.
+
+#include "test.h"
+
+#include "core/overlay_state_applier.h"
+#include "core/overlay_state_machine.h"
+
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+class MockBackend : public OverlayStateApplier {
+public:
+    bool attached = true;
+    uint32_t refused = 0; // Fields the mock OS turns down
+    std::vector<uint32_t> calls; // The changed mask of every apply_changes
+
+    bool is_attached() const override {
+        return attached;
+    }
+
+protected:
+    uint32_t apply_changes(const OverlayState &state, uint32_t changed) override {
+        (void)state;
+        calls.push_back(changed);
+        return changed & ~refused;
+    }
+};
+
+} // namespace
+
+TEST_CASE(overlay_state_identical_states_cost_nothing) {
+    MockBackend backend;
+    OverlayState normal = OverlayState::normal_window();
+    CHECK(backend.apply_state(normal) == 0);
+    CHECK(backend.calls.empty());
+
+    OverlayState overlay = OverlayState::overlay_window();
+    uint32_t expected = OVERLAY_STATE_BORDERLESS | OVERLAY_STATE_TOPMOST | OVERLAY_STATE_LAYERED | OVERLAY_STATE_PASSTHROUGH;
+    CHECK(backend.apply_state(overlay) == expected);
+    CHECK(backend.calls.size() == 1 && backend.calls[0] == expected);
+
+    // The same state again, as every frame commits it, never reaches the OS
+    for (int frame = 0; frame < 100; frame++) {
+        backend.apply_state(overlay);
+    }
+    CHECK(backend.calls.size() == 1);
+
+    // Nothing is sent to a window that is not attached, the change waits for it
+    backend.attached = false;
+    overlay.visible = false;
+    CHECK(backend.apply_state(overlay) == 0);
+    CHECK(backend.calls.size() == 1);
+    backend.attached = true;
+    CHECK(backend.apply_state(overlay) == OVERLAY_STATE_VISIBLE);
+    CHECK(backend.calls.size() == 2);
+}
+
+TEST_CASE(overlay_state_frame_changes_coalesce) {
+    // Overlay commits the state machine once per frame, whatever happened during it
+    MockBackend backend;
+    OverlayStateMachine machine;
+    machine.enable();
+    backend.apply_state(machine.get_desired());
+    backend.calls.clear();
+
+    // Toggled back and forth within the frame: nothing to apply
+    machine.toggle_passthrough();
+    machine.toggle_passthrough();
+    machine.toggle_visible();
+    machine.toggle_visible();
+    CHECK(backend.apply_state(machine.get_desired()) == 0);
+    CHECK(backend.calls.empty());
+
+    // Several fields in one frame are one call with all of them
+    machine.set_passthrough(false);
+    machine.set_visible(false);
+    OverlayState faded;
+    faded.alpha = 128;
+    machine.merge(faded, OVERLAY_STATE_ALPHA);
+    faded.alpha = 64;
+    machine.merge(faded, OVERLAY_STATE_ALPHA);
+    uint32_t expected = OVERLAY_STATE_PASSTHROUGH | OVERLAY_STATE_VISIBLE | OVERLAY_STATE_ALPHA;
+    CHECK(backend.apply_state(machine.get_desired()) == expected);
+    CHECK(backend.calls.size() == 1 && backend.calls[0] == expected);
+    CHECK(backend.get_applied_state().alpha == 64);
+    CHECK(!backend.get_applied_state().passthrough && !backend.get_applied_state().visible);
+
+    // Disabling is a single batch back to a normal window
+    machine.disable();
+    CHECK(backend.apply_state(machine.get_desired()) != 0);
+    CHECK(backend.calls.size() == 2);
+    CHECK(diff_overlay_state(backend.get_applied_state(), OverlayState::normal_window()) == 0);
+}
+
+TEST_CASE(overlay_state_refused_fields_are_retried) {
+    MockBackend backend;
+    backend.refused = OVERLAY_STATE_TOPMOST;
+    OverlayState overlay = OverlayState::overlay_window();
+    uint32_t applied = backend.apply_state(overlay);
+    CHECK(!(applied & OVERLAY_STATE_TOPMOST) && (applied & OVERLAY_STATE_BORDERLESS));
+    CHECK(backend.get_stale_fields() == OVERLAY_STATE_TOPMOST);
+    CHECK(!backend.get_applied_state().topmost);
+
+    // Still refused: only the stale field is sent again, the rest stays applied
+    CHECK(backend.apply_state(overlay) == 0);
+    CHECK(backend.calls.size() == 2 && backend.calls[1] == OVERLAY_STATE_TOPMOST);
+
+    // Once the OS takes it the field is no longer stale and costs nothing after
+    backend.refused = 0;
+    CHECK(backend.apply_state(overlay) == OVERLAY_STATE_TOPMOST);
+    CHECK(backend.calls.size() == 3 && backend.calls[2] == OVERLAY_STATE_TOPMOST);
+    CHECK(backend.get_stale_fields() == 0);
+    CHECK(backend.apply_state(overlay) == 0);
+    CHECK(backend.calls.size() == 3);
+
+    // A refused field is retried even when the next state asks for the cached value,
+    // the window may have been left half changed
+    backend.refused = OVERLAY_STATE_VISIBLE;
+    overlay.visible = false;
+    backend.apply_state(overlay);
+    overlay.visible = true;
+    backend.refused = 0;
+    CHECK(backend.apply_state(overlay) == OVERLAY_STATE_VISIBLE);
+    CHECK(backend.calls.size() == 5 && backend.calls[4] == OVERLAY_STATE_VISIBLE);
+
+    // Invalidated fields go out even though nothing changed
+    backend.invalidate_state(OVERLAY_STATE_PASSTHROUGH | OVERLAY_STATE_ALPHA);
+    CHECK(backend.get_stale_fields() == (OVERLAY_STATE_PASSTHROUGH | OVERLAY_STATE_ALPHA));
+    CHECK(backend.apply_state(overlay) == (OVERLAY_STATE_PASSTHROUGH | OVERLAY_STATE_ALPHA));
+    CHECK(backend.calls.size() == 6);
+    CHECK(backend.apply_state(overlay) == 0);
+    CHECK(backend.calls.size() == 6);
+}
@@ -0,0 +1,167 @@
+// Pixel conversion kernels, every instruction set the CPU has: the output must equal a
+// per-byte reference and the scalar kernel, for every (color, alpha) pair, at widths
+// that leave a scalar tail after the vector loop, with padded rows whose padding is
+// never written.
+
+#include "test.h"
+
+#include "core/pixel_convert.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+enum Kernel {
+    KERNEL_SWAP,
+    KERNEL_PREMULTIPLY,
+    KERNEL_COLOR_KEY,
+    KERNEL_COUNT,
+};
+
+const char *const KERNEL_NAMES[KERNEL_COUNT] = { "swap", "premultiply", "color_key" };
+
+constexpr uint32_t COLOR_KEY = 0xFF00FF;
+constexpr uint8_t PADDING = 0xCD;
+
+void convert(Kernel kernel, const uint8_t *src, size_t src_stride, uint8_t *dst, size_t dst_stride, int32_t width, int32_t height) {
+    switch (kernel) {
+        case KERNEL_SWAP:
+            convert_bgrx_to_rgba(src, src_stride, dst, dst_stride, width, height);
+            break;
+        case KERNEL_PREMULTIPLY:
+            convert_rgba_to_premultiplied_bgra(src, src_stride, dst, dst_stride, width, height);
+            break;
+        default:
+            convert_rgba_keyed_to_bgra(src, src_stride, dst, dst_stride, width, height, COLOR_KEY);
+            break;
+    }
+}
+
+// What each kernel documents, one pixel at a time
+void reference(Kernel kernel, const uint8_t *in, uint8_t *out) {
+    switch (kernel) {
+        case KERNEL_SWAP:
+            out[0] = in[2];
+            out[1] = in[1];
+            out[2] = in[0];
+            out[3] = 255;
+            break;
+        case KERNEL_PREMULTIPLY:
+            out[0] = uint8_t((in[2] * in[3] + 127) / 255);
+            out[1] = uint8_t((in[1] * in[3] + 127) / 255);
+            out[2] = uint8_t((in[0] * in[3] + 127) / 255);
+            out[3] = in[3];
+            break;
+        default: {
+            bool keyed = in[0] == ((COLOR_KEY >> 16) & 0xFF) && in[1] == ((COLOR_KEY >> 8) & 0xFF) && in[2] == (COLOR_KEY & 0xFF);
+            out[0] = keyed ? 0 : in[2];
+            out[1] = keyed ? 0 : in[1];
+            out[2] = keyed ? 0 : in[0];
+            out[3] = keyed ? 0 : 255;
+            break;
+        }
+    }
+}
+
+// Every (c, a) pair once in each color channel, the key color with every alpha, and noise
+std::vector<uint8_t> make_pixels() {
+    std::vector<uint8_t> pixels;
+    for (int a = 0; a < 256; a++) {
+        for (int c = 0; c < 256; c++) {
+            const uint8_t pixel[4] = { uint8_t(c), uint8_t(255 - c), uint8_t(c ^ 0x5A), uint8_t(a) };
+            pixels.insert(pixels.end(), pixel, pixel + 4);
+        }
+        const uint8_t keyed[4] = { uint8_t(COLOR_KEY >> 16), uint8_t(COLOR_KEY >> 8), uint8_t(COLOR_KEY), uint8_t(a) };
+        pixels.insert(pixels.end(), keyed, keyed + 4);
+    }
+    std::mt19937 random(99);
+    for (int i = 0; i < 4096; i++) {
+        pixels.push_back(uint8_t(random()));
+    }
+    return pixels;
+}
+
+struct Layout {
+    int32_t width;
+    size_t src_padding; // Bytes after each row
+    size_t dst_padding;
+};
+
+// Converts the pixels laid out in rows of the given width, a partial last row is left
+// out. Returns the destination rows with their padding.
+std::vector<uint8_t> run_layout(Kernel kernel, const std::vector<uint8_t> &pixels, const Layout &layout, int32_t &r_height) {
+    const size_t row_bytes = size_t(layout.width) * 4;
+    const size_t src_stride = row_bytes + layout.src_padding;
+    const size_t dst_stride = row_bytes + layout.dst_padding;
+    r_height = int32_t(pixels.size() / row_bytes);
+    std::vector<uint8_t> src(src_stride * r_height, PADDING);
+    for (int32_t y = 0; y < r_height; y++) {
+        std::copy(pixels.begin() + y * row_bytes, pixels.begin() + (y + 1) * row_bytes, src.begin() + y * src_stride);
+    }
+    std::vector<uint8_t> dst(dst_stride * r_height, PADDING);
+    convert(kernel, src.data(), src_stride, dst.data(), dst_stride, layout.width, r_height);
+    return dst;
+}
+
+} // namespace
+
+TEST_CASE(pixel_convert_every_isa_matches_reference_and_scalar) {
+    const std::vector<uint8_t> pixels = make_pixels();
+    const Layout layouts[] = {
+        { 256, 0, 0 }, // Dense
+        { 1, 4, 12 },
+        { 3, 0, 8 },
+        { 5, 12, 0 },
+        { 7, 4, 4 },
+        { 9, 0, 0 },
+        { 13, 8, 36 },
+        { 31, 4, 0 },
+        { 33, 0, 28 },
+        { 257, 60, 4 },
+    };
+
+    for (int isa = 0; isa < PIXEL_ISA_COUNT; isa++) {
+        if (!set_pixel_isa(PixelIsa(isa))) {
+            continue; // Not on this CPU
+        }
+        for (int kernel = 0; kernel < KERNEL_COUNT; kernel++) {
+            for (const Layout &layout : layouts) {
+                int32_t height = 0;
+                set_pixel_isa(PixelIsa(isa));
+                std::vector<uint8_t> dst = run_layout(Kernel(kernel), pixels, layout, height);
+                set_pixel_isa(PIXEL_ISA_SCALAR);
+                std::vector<uint8_t> scalar = run_layout(Kernel(kernel), pixels, layout, height);
+
+                const size_t dst_stride = size_t(layout.width) * 4 + layout.dst_padding;
+                size_t wrong = 0;
+                size_t padding_written = 0;
+                for (int32_t y = 0; y < height; y++) {
+                    const uint8_t *row = dst.data() + y * dst_stride;
+                    for (int32_t x = 0; x < layout.width; x++) {
+                        uint8_t expected[4];
+                        reference(Kernel(kernel), pixels.data() + (size_t(y) * layout.width + x) * 4, expected);
+                        for (int i = 0; i < 4; i++) {
+                            wrong += row[x * 4 + i] != expected[i];
+                        }
+                    }
+                    for (size_t i = size_t(layout.width) * 4; i < dst_stride; i++) {
+                        padding_written += row[i] != PADDING;
+                    }
+                }
+                if (wrong || padding_written || dst != scalar) {
+                    fprintf(stderr, "  %s %s, width %d: %zu wrong bytes, %zu padding bytes written%s\n", get_pixel_isa_name(PixelIsa(isa)),
+                            KERNEL_NAMES[kernel], layout.width, wrong, padding_written, dst != scalar ? ", differs from scalar" : "");
+                }
+                CHECK(wrong == 0);
+                CHECK(padding_written == 0);
+                CHECK(dst == scalar);
+            }
+        }
+    }
+    set_pixel_isa(get_best_pixel_isa());
+}
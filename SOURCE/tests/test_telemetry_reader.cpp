@@ -0,0 +1,125 @@
+// TelemetryReader against a producer channel in the same process: snapshots, a write in
+// progress, and the record ring across its wrap and when full.
+
+#include "test.h"
+
+#include "core/telemetry_reader.h"
+
+#include <cstdio>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace godot;
+
+namespace {
+
+void make_name(char *name, size_t size, const char *kind) {
+#ifdef _WIN32
+    snprintf(name, size, "test_%s_%d", kind, _getpid());
+#else
+    snprintf(name, size, "test_%s_%d", kind, (int)getpid());
+#endif
+}
+
+} // namespace
+
+TEST_CASE(telemetry_snapshot_is_consistent_or_unchanged) {
+    char name[64];
+    make_name(name, sizeof(name), "snapshot");
+    TelemetryReader reader;
+    if (!CHECK(reader.open(name, 8, 16, 16) == 0)) {
+        return;
+    }
+    CHECK(reader.is_creator());
+    godoverit_telemetry producer;
+    if (!CHECK(godoverit_telemetry_open(&producer, name, 8, 16, 16) == 0)) {
+        return;
+    }
+    CHECK(!producer.created);
+
+    // Both sides must agree on the sizes
+    TelemetryReader mismatched;
+    CHECK(mismatched.open(name, 4, 16, 16) == -1);
+
+    const double written[3] = { 60.0, 16.6, 4.0 };
+    godoverit_telemetry_write_snapshot(&producer, written, 3);
+    double values[8] = {};
+    uint32_t count = 0;
+    CHECK(reader.read_snapshot(values, count));
+    CHECK(count == 3 && values[0] == 60.0 && values[1] == 16.6 && values[2] == 4.0);
+    CHECK(reader.get_snapshot_sequence() == 2);
+
+    // A producer stuck mid-write: every retry fails and the last snapshot stays as it was
+    producer.header->snapshot_sequence++;
+    producer.snapshot[0] = -1.0;
+    uint64_t retries = reader.get_snapshot_retries();
+    CHECK(!reader.read_snapshot(values, count));
+    CHECK(count == 3 && values[0] == 60.0 && values[1] == 16.6 && values[2] == 4.0);
+    CHECK(reader.get_snapshot_retries() > retries);
+    producer.header->snapshot_sequence++;
+
+    // More values than the capacity are cut
+    const double many[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    godoverit_telemetry_write_snapshot(&producer, many, 10);
+    CHECK(reader.read_snapshot(values, count));
+    CHECK(count == 8 && values[7] == 8.0);
+
+    godoverit_telemetry_close(&producer, 0);
+    reader.close();
+    CHECK(!reader.is_open());
+    CHECK(!reader.read_snapshot(values, count));
+}
+
+TEST_CASE(telemetry_ring_wraps_and_drops) {
+    char name[64];
+    make_name(name, sizeof(name), "ring");
+    TelemetryReader reader;
+    if (!CHECK(reader.open(name, 4, 8, 16) == 0)) {
+        return;
+    }
+    godoverit_telemetry producer;
+    if (!CHECK(godoverit_telemetry_open(&producer, name, 4, 8, 16) == 0)) {
+        return;
+    }
+
+    uint64_t next_push = 0;
+    uint64_t next_drain = 0;
+    bool in_order = true;
+    std::vector<uint8_t> buffer(8 * 16);
+    for (int round = 0; round < 50; round++) {
+        // Up to 5 records per round so the ring wraps at every offset
+        for (int i = 0; i < round % 6; i++) {
+            uint64_t record = next_push++;
+            CHECK(godoverit_telemetry_push(&producer, &record, sizeof(record)) == 1);
+        }
+        CHECK(reader.get_pending_count() == size_t(round % 6));
+        size_t drained = reader.drain(buffer.data(), 8);
+        for (size_t i = 0; i < drained; i++) {
+            const uint64_t *record = reinterpret_cast<const uint64_t *>(buffer.data() + i * 16);
+            // Short records come zero padded
+            in_order = in_order && record[0] == next_drain && record[1] == 0;
+            next_drain++;
+        }
+    }
+    CHECK(in_order);
+    CHECK(next_drain == next_push);
+
+    // A full ring drops and counts, the reader keeps the oldest records
+    for (uint64_t i = 0; i < 10; i++) {
+        uint64_t record = 1000 + i;
+        godoverit_telemetry_push(&producer, &record, sizeof(record));
+    }
+    CHECK(reader.get_dropped_count() == 2);
+    CHECK(reader.drain(buffer.data(), 3) == 3);
+    CHECK(*reinterpret_cast<const uint64_t *>(buffer.data()) == 1000);
+    CHECK(reader.get_pending_count() == 5);
+    CHECK(reader.drain(buffer.data(), 8) == 5);
+    CHECK(*reinterpret_cast<const uint64_t *>(buffer.data() + 4 * 16) == 1007);
+
+    godoverit_telemetry_close(&producer, 0);
+}
@@ -0,0 +1,133 @@
+// TimeSeries: ring order, windows, summaries, percentiles against a sort, and plots.
+
+#include "test.h"
+
+#include "core/time_series.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+TEST_CASE(time_series_keeps_the_newest_samples) {
+    TimeSeries series(8);
+    CHECK(series.get_capacity() == 8);
+    CHECK(series.get_count() == 0);
+    for (int i = 0; i < 20; i++) {
+        series.push(i, i * 10.0);
+    }
+    CHECK(series.get_count() == 8);
+    bool in_order = true;
+    for (size_t i = 0; i < 8; i++) {
+        in_order = in_order && series.get_time(i) == 12.0 + i && series.get_value(i) == (12.0 + i) * 10.0;
+    }
+    CHECK(in_order);
+    CHECK(series.get_serial() == 20);
+
+    // Times going backwards are clamped to the newest
+    series.push(3.0, 1.0);
+    CHECK(series.get_time(7) == 19.0);
+
+    series.clear();
+    CHECK(series.get_count() == 0);
+    CHECK(series.summarize(0.0).count == 0);
+    CHECK(series.get_percentile(0.0, 50.0) == 0.0);
+}
+
+TEST_CASE(time_series_windows_and_summaries) {
+    TimeSeries series(100);
+    for (int i = 0; i < 150; i++) {
+        series.push(i * 0.5, double(i % 7));
+    }
+    // Buffered: times 25.0 to 74.5, the last 10 seconds start at 64.5
+    CHECK(series.find_window_start(0.0) == 0);
+    CHECK(series.find_window_start(10.0) == 79);
+    CHECK(series.find_window_start(1000.0) == 0);
+
+    const TimeSeries::Summary &summary = series.summarize(10.0);
+    double sum = 0.0;
+    double low = 1e9;
+    double high = -1e9;
+    for (size_t i = 79; i < 100; i++) {
+        sum += series.get_value(i);
+        low = std::min(low, series.get_value(i));
+        high = std::max(high, series.get_value(i));
+    }
+    CHECK(summary.count == 21);
+    CHECK(summary.min == low);
+    CHECK(summary.max == high);
+    CHECK(std::fabs(summary.mean - sum / 21) < 1e-12);
+    CHECK(summary.last == double(149 % 7));
+}
+
+TEST_CASE(time_series_percentiles_match_a_sort) {
+    TimeSeries series(1000);
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> distribution(0.0, 100.0);
+    for (int i = 0; i < 1500; i++) {
+        series.push(i, distribution(random));
+    }
+    const double span = 400.0;
+    size_t start = series.find_window_start(span);
+    std::vector<double> sorted;
+    for (size_t i = start; i < series.get_count(); i++) {
+        sorted.push_back(series.get_value(i));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    int mismatches = 0;
+    const double percentiles[] = { 0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 100.0 };
+    for (double percentile : percentiles) {
+        size_t rank = size_t(std::ceil(percentile / 100.0 * sorted.size()));
+        double expected = sorted[rank > 0 ? rank - 1 : 0];
+        mismatches += series.get_percentile(span, percentile) != expected;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE(time_series_plots_stay_in_bounds) {
+    TimeSeries series(4096);
+    for (int i = 0; i < 4096; i++) {
+        series.push(i * 0.001, std::sin(i * 0.01) + (i == 2000 ? 50.0 : 0.0));
+    }
+    TimeSeries::PlotRequest request;
+    request.width = 200;
+    request.height = 100.0f;
+
+    auto in_bounds = [&](const std::vector<SeriesPoint> &points) {
+        bool inside = true;
+        for (const SeriesPoint &point : points) {
+            inside = inside && point.x >= -1e-3f && point.x <= request.width + 1e-3f && point.y >= -1e-3f &&
+                    point.y <= request.height + 1e-3f;
+        }
+        return inside;
+    };
+
+    // Min-max keeps the spike at the top edge, two points per column at most
+    const std::vector<SeriesPoint> &min_max = series.plot(request);
+    CHECK(!min_max.empty() && min_max.size() <= size_t(request.width) * 2);
+    CHECK(in_bounds(min_max));
+    bool spike = false;
+    for (const SeriesPoint &point : min_max) {
+        spike = spike || std::fabs(point.y) < 1e-3f;
+    }
+    CHECK(spike);
+
+    // Unchanged series and request reuse the points
+    uint64_t version = series.get_plot_version();
+    series.plot(request);
+    CHECK(series.get_plot_version() == version);
+
+    request.mode = TimeSeries::DECIMATION_LTTB;
+    const std::vector<SeriesPoint> &lttb = series.plot(request);
+    CHECK(series.get_plot_version() == version + 1);
+    CHECK(lttb.size() == size_t(request.width));
+    CHECK(in_bounds(lttb));
+    CHECK(lttb.front().x == 0.0f && std::fabs(lttb.back().x - request.width) < 1e-3f);
+
+    series.push(5.0, 0.0);
+    series.plot(request);
+    CHECK(series.get_plot_version() == version + 2);
+}
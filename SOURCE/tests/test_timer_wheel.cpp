@@ -0,0 +1,120 @@
+// TimerWheel: every timer fires once, never early and on the first advance past its tick,
+// across every level and beyond the top one; cancelled timers never fire.
+
+#include "test.h"
+
+#include "core/timer_wheel.h"
+
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+struct Expected {
+    uint64_t deadline_usec = 0;
+    uint32_t handle = TimerWheel::INVALID_TIMER;
+    int fired = 0;
+    bool cancelled = false;
+};
+
+} // namespace
+
+TEST_CASE(timer_wheel_fires_on_time) {
+    const uint64_t tick = 1000;
+    TimerWheel wheel(tick);
+    std::mt19937_64 random(7);
+    std::vector<Expected> timers(4000);
+
+    // Deadlines from under a tick to past the 4.6 hour reach of the top level
+    uint64_t now = 0;
+    const uint64_t spans[] = { 500, 64 * tick, 4096 * tick, 262144 * tick, uint64_t(6) * 3600 * 1000000 };
+    for (size_t i = 0; i < timers.size(); i++) {
+        timers[i].deadline_usec = 1 + random() % spans[i % 5];
+        timers[i].handle = wheel.schedule(timers[i].deadline_usec, uint32_t(i));
+        CHECK(timers[i].handle != TimerWheel::INVALID_TIMER);
+    }
+    for (size_t i = 0; i < timers.size(); i += 3) {
+        timers[i].cancelled = true;
+        CHECK(wheel.cancel(timers[i].handle));
+        CHECK(!wheel.cancel(timers[i].handle));
+    }
+
+    int early = 0;
+    int late = 0;
+    int out_of_order = 0;
+    while (wheel.get_pending_count() > 0 && now < uint64_t(7) * 3600 * 1000000) {
+        uint64_t previous = now;
+        now += 1 + random() % (20 * 60 * 1000000ull);
+        uint64_t last_tick = 0;
+        wheel.advance(now, [&](uint32_t cookie, uint64_t deadline_usec) {
+            Expected &timer = timers[cookie];
+            timer.fired++;
+            uint64_t due = (timer.deadline_usec + tick - 1) / tick * tick;
+            early += deadline_usec != timer.deadline_usec || due > now;
+            late += due <= previous;
+            out_of_order += due / tick < last_tick;
+            last_tick = due / tick;
+        });
+    }
+    CHECK(wheel.get_pending_count() == 0);
+    CHECK(early == 0);
+    CHECK(late == 0);
+    CHECK(out_of_order == 0);
+    int wrong_count = 0;
+    for (const Expected &timer : timers) {
+        wrong_count += timer.fired != (timer.cancelled ? 0 : 1);
+        // A fired handle is stale
+        wrong_count += wheel.cancel(timer.handle);
+    }
+    CHECK(wrong_count == 0);
+}
+
+TEST_CASE(timer_wheel_reschedules_from_callback) {
+    // A periodic timer re-arms itself from its own callback
+    TimerWheel wheel(1000);
+    const uint64_t period = 16667;
+    int fired = 0;
+    uint64_t last_deadline = 0;
+    wheel.schedule(period, 0);
+    for (uint64_t now = 0; now <= 100 * period + 5000; now += 5000) {
+        wheel.advance(now, [&](uint32_t, uint64_t deadline_usec) {
+            fired++;
+            last_deadline = deadline_usec;
+            wheel.schedule(deadline_usec + period, 0);
+        });
+    }
+    CHECK(fired == 100);
+    CHECK(last_deadline == 100 * period);
+    CHECK(wheel.get_pending_count() == 1);
+}
+
+TEST_CASE(timer_wheel_past_deadlines_and_clear) {
+    TimerWheel wheel(1000);
+    int fired = 0;
+    auto count = [&](uint32_t, uint64_t) {
+        fired++;
+    };
+    wheel.advance(10500, count);
+
+    // A deadline already passed fires on the next tick, not the current one
+    uint32_t past = wheel.schedule(2000, 0);
+    wheel.advance(10999, count);
+    CHECK(fired == 0);
+    wheel.advance(11000, count);
+    CHECK(fired == 1);
+    CHECK(!wheel.cancel(past));
+
+    uint32_t pending = wheel.schedule(50000, 0);
+    wheel.clear();
+    CHECK(wheel.get_pending_count() == 0);
+    CHECK(!wheel.cancel(pending));
+    wheel.advance(100000, count);
+    CHECK(fired == 1);
+
+    // Handles stay unique across a clear
+    uint32_t reused = wheel.schedule(200000, 0);
+    CHECK(reused != pending);
+    CHECK(wheel.cancel(reused));
+}
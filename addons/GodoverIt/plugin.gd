@@ -3,8 +3,7 @@ extends EditorPlugin
 
 # Called when the plugin is enabled
 func _enter_tree() -> void:
-	# Register the Overlay node
-	add_custom_type("OverlayNode", "Node", preload("res://addons/GodoverIt/overlay.gd"), null)
+	# OverlayNode is a native class, the extension registers it with the editor itself
 	call_deferred("add_input_action", "overlay_toggle_input", KEY_F1)
 	call_deferred("add_input_action", "overlay_toggle_visibility", KEY_F2)
 	call_deferred("toggle_settings", true)
@@ -12,8 +11,6 @@ func _enter_tree() -> void:
 
 # Called when the plugin is disabled
 func _exit_tree() -> void:
-	# Unregister the Overlay node
-	remove_custom_type("OverlayNode")
 	remove_input_action("overlay_toggle_input")
 	remove_input_action("overlay_toggle_visibility")
 	toggle_settings(false)
@@ -52,27 +49,13 @@ func remove_input_action(action_name: String) -> void:
 
 
 func toggle_settings(toggled_on: bool) -> void:
+	# Read by the game when it creates its window, the editor does not need a restart
 	ProjectSettings.set_setting("display/window/size/borderless", toggled_on)
 	ProjectSettings.set_setting("display/window/size/always_on_top", toggled_on)
 	ProjectSettings.set_setting("display/window/size/transparent", toggled_on)
 	ProjectSettings.set_setting("rendering/viewport/transparent_background", toggled_on)
 	ProjectSettings.set_setting("display/window/size/no_focus", toggled_on)
 	ProjectSettings.set_setting("display/window/per_pixel_transparency/allowed", toggled_on)
+	# Layered style and passthrough are applied natively before the first frame
+	ProjectSettings.set_setting("godoverit/bootstrap/enabled", toggled_on)
 	ProjectSettings.save()
-	show_confirmation_popup()
-
-
-func show_confirmation_popup() -> void:
-	close_project_settings()
-	var dialog = AcceptDialog.new()
-	dialog.set_text("Editor Restart Required To Apply Settings.\n(Ignore On Startup)")
-	EditorInterface.get_base_control().add_child(dialog)
-	dialog.popup_centered()
-
-
-func close_project_settings() -> void:
-	var children = EditorInterface.get_base_control().get_children()
-	for child in children:
-		if "ProjectSettings" in child.get_name():
-			child.hide()
-			break
@@ -0,0 +1,122 @@
+extends Node
+
+# Per-frame cost of driving an overlay from the scene tree, headless:
+#   godot --headless --path . res://assets/scenes/bench/overlay_node_bench.tscn
+# Three phases of FRAMES frames each: nothing, an Overlay processed from a GDScript
+# _process as the old overlay.gd node did, and the native OverlayNode. The cost is the
+# time between two probe nodes processed first and last in every frame, minus the empty
+# phase. Keybind reloads are checked too: an unrelated setting must not recompile the
+# keybinds, a changed toggle key must, once. Failures are counted as mismatches, which
+# must be 0; the exit code is the mismatch count.
+
+const WARMUP_FRAMES := 60
+const FRAMES := 3000
+const INPUT_SETTING := "input/overlay_toggle_input"
+
+
+# Processed first and last in every frame, the last one adds up the time in between
+class Probe extends Node:
+	var first: Probe = null
+	var started_usec := 0
+	var total_usec := 0
+	var frames := 0
+
+	func _process(_delta: float) -> void:
+		if first == null:
+			started_usec = Time.get_ticks_usec()
+		else:
+			total_usec += Time.get_ticks_usec() - first.started_usec
+			frames += 1
+
+
+# The bridge overlay.gd used to be: a script _process forwarding to Overlay.process
+class ScriptBridge extends Node:
+	var overlay: Overlay
+
+	func _ready() -> void:
+		overlay = Overlay.new()
+
+	func _process(delta: float) -> void:
+		overlay.process(delta)
+
+	func _exit_tree() -> void:
+		overlay.free()
+
+
+var first_probe := Probe.new()
+var last_probe := Probe.new()
+var results := {}
+var mismatches := 0
+
+
+func _ready() -> void:
+	first_probe.process_priority = -1000
+	last_probe.process_priority = 1000
+	last_probe.first = first_probe
+	add_child(first_probe)
+	add_child(last_probe)
+	_run.call_deferred()
+
+
+func _run() -> void:
+	var empty := await _measure(null)
+	results["gdscript_bridge_usec_per_frame"] = await _measure(ScriptBridge.new()) - empty
+	results["overlay_node_usec_per_frame"] = await _measure(OverlayNode.new()) - empty
+	results["empty_usec_per_frame"] = empty
+	await _check_keybind_reloads()
+	results["mismatches"] = mismatches
+	print(JSON.stringify(results))
+	get_tree().quit(mismatches)
+
+
+func _measure(subject: Node) -> float:
+	if subject:
+		add_child(subject)
+	await _frames(WARMUP_FRAMES)
+	last_probe.total_usec = 0
+	last_probe.frames = 0
+	await _frames(FRAMES)
+	var usec_per_frame := float(last_probe.total_usec) / max(last_probe.frames, 1)
+	if subject:
+		subject.queue_free()
+		await _frames(1)
+	return usec_per_frame
+
+
+func _check_keybind_reloads() -> void:
+	var node := OverlayNode.new()
+	add_child(node)
+	await _frames(2)
+	var updates := node.get_keybind_update_count()
+
+	# settings_changed fires for any setting, nothing is recompiled for this one
+	ProjectSettings.set_setting("godoverit/bench/unrelated", 1)
+	await _frames(2)
+	if node.get_keybind_update_count() != updates:
+		mismatches += 1
+
+	# A new toggle key reaches the overlay and the InputMap once
+	var previous = ProjectSettings.get_setting(INPUT_SETTING) if ProjectSettings.has_setting(INPUT_SETTING) else null
+	var event := InputEventKey.new()
+	event.set_keycode(KEY_F5)
+	event.set_ctrl_pressed(true)
+	ProjectSettings.set_setting(INPUT_SETTING, {"deadzone": 0.5, "events": [event]})
+	await _frames(2)
+	if node.get_keybind_update_count() != updates + 1:
+		mismatches += 1
+	var applied: InputEventKey = node.overlay.get_input_keybind()
+	if applied == null or applied.keycode != KEY_F5 or not applied.ctrl_pressed:
+		mismatches += 1
+	if not InputMap.event_is_action(event, "overlay_toggle_input", true):
+		mismatches += 1
+	results["keybind_updates"] = node.get_keybind_update_count() - updates
+
+	ProjectSettings.set_setting("godoverit/bench/unrelated", null)
+	ProjectSettings.set_setting(INPUT_SETTING, previous)
+	node.queue_free()
+	await _frames(1)
+
+
+func _frames(count: int) -> void:
+	for i in count:
+		await get_tree().process_frame